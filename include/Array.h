@@ -36,6 +36,7 @@
 #include "Logger.h"
 #include "Streamable.h"
 #include <iostream> //also has size_t
+#include <algorithm> //for swap
 
 /**
  * @class Array
@@ -74,11 +75,21 @@ class Array : public Streamable
     inline size_t size() const;
     inline size_t mem_size() const;
 
+    //! The number of elements that fit in the allocated memory
+    inline size_t capacity() const;
+
     //! Realocates new_size and copys the current content to the new
     //! location. When new_size is zero, it frees the current
     //! allocated memory
     inline void resize(size_t new_size);
 
+    //! Exchanges the content (the memory) with rhs, O(1)
+    inline void swap(Array &rhs);
+
+    //! True when the memory belongs to another container (see
+    //! SubView)
+    inline bool isView() const;
+
     inline iterator begin();
     inline const_iterator begin() const;
 
@@ -91,9 +102,15 @@ class Array : public Streamable
     virtual Error_t unpack(std::istream &is, Format format);
 
   protected:
+    //! Points to the memory of another container without owning
+    //! it. The memory is not freed by this array and a resize that
+    //! needs more memory moves the content to a new (owned) memory.
+    inline void setView(T *data, size_t size);
+
     size_t size_;
     size_t capacity_;
     T* data_;
+    bool owns_data_;
 
     //! private copy constructory to limit pass by value
     Array(Array const& rhs);
@@ -0,0 +1,118 @@
+/**
+ * @file   AsyncWriter.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  A background thread that writes the output files
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _ASYNCWRITER_H_
+#define _ASYNCWRITER_H_
+
+#include "Error.h"
+
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+//! Counters of the writer
+struct WriterStats
+{
+    size_t files;         ///< files written
+    size_t bytes;         ///< bytes written
+    size_t blocked_calls; ///< calls that waited for a free buffer
+    double blocked_time;  ///< seconds the callers waited (for a buffer or Flush)
+    double write_time;    ///< seconds the writer spent writing
+};
+
+/**
+ * A singleton class that writes files in a background thread so that
+ * the time stepping does not wait for the file system. The content of
+ * a file is handed to Submit() that swaps it into one of NUM_BUFFERS
+ * preallocated buffers and returns, the writer thread drains the
+ * buffers in order. When all the buffers are waiting to be written,
+ * Submit() blocks until the writer frees one (the memory of the
+ * pending output is bounded by the buffers).
+ *
+ * The time the callers spent waiting is counted as blocked time. The
+ * writes are synchronous when SetAsync(false) is called.
+ */
+class AsyncWriter
+{
+  public:
+    static const int NUM_BUFFERS = 2;
+
+    //! Queues content to be written to fname (or appended to it when
+    //! append is true). The content is swapped with a free buffer, so
+    //! that on return it holds the (unused) memory of that buffer.
+    static Error_t Submit(const std::string &fname, std::string &content,
+        bool append = false);
+
+    //! Blocks until all the submitted files are written, returns the
+    //! error of the writes since the last call (if any).
+    static Error_t Flush();
+
+    static void SetAsync(bool async);
+
+    static WriterStats GetStats();
+
+    //! Writes the counters
+    static void Report();
+
+  private:
+    AsyncWriter();
+};
+
+/**
+ * An output stream that appends to a string. The content of a file is
+ * formatted in place in the string that is handed to Submit(), which
+ * keeps the memory of the writer's buffers in use (a stringstream
+ * would format into its own memory and copy it out).
+ */
+class BufferStream : public std::ostream
+{
+  public:
+    explicit BufferStream(std::string &buffer);
+
+  private:
+    class Buf : public std::streambuf
+    {
+      public:
+        explicit Buf(std::string &buffer) : buffer_(buffer) {}
+
+      protected:
+        int_type overflow(int_type c);
+        std::streamsize xsputn(const char *s, std::streamsize n);
+
+      private:
+        std::string &buffer_;
+    };
+
+    Buf buf_;
+};
+
+#endif //_ASYNCWRITER_H_
@@ -0,0 +1,75 @@
+/**
+ * @file   BiCGStabBatched.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief Independent BiCGStab iterations for block diagonal systems
+ */
+
+#ifndef _BICGSTABBATCHED_H_
+#define _BICGSTABBATCHED_H_
+
+#include <vector>
+#include "Logger.h"
+#include "BiCGStab.h"
+
+/**
+ * BiCGStabBatched solves the block diagonal system Ax = b, where
+ * each block corresponds to one subfield of the container (one
+ * vesicle), by running an independent (unpreconditioned) BiCGStab
+ * iteration for each block. All the scalars of the iteration are
+ * per subfield and a subfield is masked out once its own relative
+ * residual is below the tolerance, so that convergence of one block
+ * is not governed by the others. The matvec is still applied to all
+ * the subfields at once.
+ *
+ * It is assumed that the container has <code>replicate()</code>,
+ * <code>getNumSubs()</code>, and <code>array_type</code> and that the
+ * per subfield <code>axpy()</code> and <code>AlgebraicDot()</code>
+ * (see HelperFuns.h) are defined.
+ */
+template<typename Container, typename MatVec>
+class BiCGStabBatched
+{
+  public:
+    typedef typename Container::value_type value_type;
+    typedef typename Container::array_type array_type;
+    typedef typename Container::device_type device_type;
+
+    /**
+     * @param MatVec   The block diagonal matvec
+     * @param x        The answer and also the initial guess
+     * @param b        The right hand side
+     * @param max_iter The maximum number of iterations, in return it
+     *                 holds the largest number of iterations taken by
+     *                 any of the blocks
+     * @param tol      Desired relative tolerance of each block, in
+     *                 return it holds the largest achieved relative
+     *                 residual
+     *
+     * @return BiCGSSuccess when all blocks converged, otherwise the
+     * failure of the worst block.
+     */
+    BiCGSReturn operator()(const MatVec &A, Container &x,
+        const Container &b, int &max_iter, value_type &tol) const;
+
+    /// Number of iterations taken by each block in the last solve
+    const std::vector<int>& IterationNumbers() const { return iter_; }
+
+  private:
+    // sets the scale of the masked blocks to zero and copies to device
+    void SetCoeff(const std::vector<value_type> &c) const;
+    void Dot(const Container &x, const Container &y, std::vector<value_type> &dot) const;
+    void RelNorm(const Container &x, const std::vector<value_type> &normb,
+        std::vector<value_type> &res) const;
+    size_t NumActive() const;
+
+    mutable Container p, s, t, v, r, rtilde;
+    mutable array_type coeff_, dots_;
+    mutable std::vector<value_type> ch_;
+    mutable std::vector<char> active_;
+    mutable std::vector<int> iter_;
+};
+
+#include "BiCGStabBatched.cc"
+
+#endif //_BICGSTABBATCHED_H_
@@ -0,0 +1,126 @@
+/**
+ * @file   CachingAllocator.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  A caching allocator for the host memory
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _CACHINGALLOCATOR_H_
+#define _CACHINGALLOCATOR_H_
+
+#include <cstddef>
+#include <string>
+
+namespace memory{
+
+    //! Allocation counters of the allocator or of one phase (for a
+    //! phase, live is the net of the bytes allocated and freed in it)
+    struct AllocStats
+    {
+        size_t live;        ///< bytes handed out and not freed
+        size_t peak;        ///< maximum of live
+        size_t cached;      ///< bytes kept in the free lists
+        size_t requests;    ///< calls to Malloc
+        size_t sys_allocs;  ///< requests that went to the system
+    };
+
+    /**
+     * A singleton class that caches the host memory blocks. The
+     * requests are rounded up to a size class (four classes per power
+     * of two) and a freed block is kept in the free list of the
+     * thread that allocated it to be handed out to the next request
+     * of the same class, so that the temporaries of a time step do
+     * not go to the system allocator after the first step. A block
+     * freed by another thread is handed back to the cache of its
+     * thread (it is moved to the free lists on the next miss of that
+     * thread). When a thread exits, its cached blocks are released
+     * to the system and its cache is reused by the next new thread.
+     *
+     * The returned memory is aligned to ALIGNMENT bytes. Blocks larger
+     * than HUGE_PAGE_SIZE are aligned to the huge page size and are
+     * advised to be backed by (transparent) huge pages when
+     * SetHugePages(true) is called.
+     *
+     * The counters are kept for the whole run and for each phase
+     * (set by SetPhase(), the requests before the first call are
+     * counted in "setup"). The phase may be set while other threads
+     * allocate, their requests are counted in either phase.
+     */
+    class CachingAllocator
+    {
+      public:
+        static const size_t ALIGNMENT = 64;
+        static const size_t HUGE_PAGE_SIZE = 2 << 20;
+        static const int MAX_PHASES = 16;
+        static const int MAX_THREADS = 256;
+
+        //! Allocates length bytes, returns NULL when length is zero
+        static void* Malloc(size_t length);
+
+        //! Returns the block to the free list of the thread that
+        //! allocated it, or to the system when the cached memory of
+        //! that thread exceeds the cache limit (or it has exited).
+        static void Free(void *ptr);
+
+        //! The size class (the usable size) of a request
+        static size_t SizeClass(size_t length);
+
+        static void SetHugePages(bool use_huge_pages);
+
+        //! The maximum bytes cached by each thread
+        static void SetCacheLimit(size_t bytes);
+
+        //! Sets the current phase and returns its index. The
+        //! counters of the following requests are added to the phase.
+        static int SetPhase(const std::string &name);
+
+        static AllocStats GetStats();
+        static AllocStats GetPhaseStats(const std::string &name);
+
+        //! Writes the counters of the allocator and of each phase
+        static void Report();
+
+        //! Releases the cached blocks of all the threads to the
+        //! system. It should be called outside the parallel regions.
+        static void Purge();
+
+      private:
+        CachingAllocator();
+
+        static int CurrentPhase();
+
+        static bool use_huge_pages_;
+        static size_t cache_limit_;
+        static int phase_;
+        static int num_phases_;
+        static std::string phase_names_[MAX_PHASES];
+        static AllocStats stats_;
+        static AllocStats phase_stats_[MAX_PHASES];
+    };
+}
+
+#endif //_CACHINGALLOCATOR_H_
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <cassert>
 #include <memory>
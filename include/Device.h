@@ -35,6 +35,7 @@
 #include <cassert>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <cmath>
 #include <omp.h>
 #include "VesBlas.h"
@@ -42,6 +43,7 @@
 #include "Error.h"
 #include "Enums.h"
 #include "CPUKernels.h"
+#include "CachingAllocator.h"
 
 #ifdef GPU_ACTIVE
 #include "cuda_runtime.h"
@@ -98,10 +100,11 @@ class Device
     //! Identifying cpu type with host
     static bool IsHost() {return DT==CPU;}
 
-    //! Memory allocation.
+    //! Memory allocation. On the CPU the memory is 64-byte aligned
+    //! and is cached by memory::CachingAllocator.
     void* Malloc(size_t length) const;
 
-    //! Freeing memory.
+    //! Freeing memory (returned to the cache on the CPU).
     void Free(void* ptr) const;
 
     //! Memory allocation and zero initialization for an array in
@@ -165,6 +168,12 @@ class Device
     T* apx(const T* a_in, const T* x_in, size_t stride,
         size_t n_subs, T* axpy_out) const;
 
+    //! Scaling and addition with a separate scale for each field.
+    //! a[j]*x[i,j]+y[i,j], i is point index and j is field index (y_in can be NULL)
+    template<typename T>
+    T* axpy(const T* a_in, const T* x_in, const T* y_in, size_t stride,
+        size_t n_subs, T* axpy_out) const;
+
     //! Element-wise scaling and addition.
     //! a[j]*v[i,j,k]+w[i,j,k] where i is point index, j is vector component and k is field index
     template<typename T>
@@ -228,6 +237,39 @@ class Device
     template<typename T>
     T AlgebraicDot(const T* x, const T* y, size_t length) const;
 
+    //! The algebraic dot product of each field.
+    //! dot[j] = sum_i x[i,j]*y[i,j], i is point index and j is field index
+    template<typename T>
+    T* AlgebraicDot(const T* x, const T* y, size_t stride, size_t n_subs,
+        T* dot_out) const;
+
+    //! The fundamental forms of surfaces from the derivatives of the
+    //! position in one pass. E, F, G are divided by W^2 and the
+    //! second forms (h and k) are skipped when duv, d2u, and d2v are
+    //! NULL. See Surface::updateFirstForms() and Surface::updateAll().
+    template<typename T>
+    void FundamentalForms(const T* du, const T* dv, const T* duv,
+        const T* d2u, const T* d2v, size_t stride, size_t n_surfs,
+        T* E, T* F, T* G, T* w, T* normal, T* cu, T* cv, T* h,
+        T* k) const;
+
+    //! Area, volume, centroid, and second moments of the enclosed
+    //! volume of closed surfaces (and the integrals of f and f^2 when
+    //! f is not NULL) in one pass; the degree selects the moments and
+    //! the layout of moms is explained in Surface::moments().
+    template<typename T>
+    void SurfaceMoments(const T* x, const T* normal, const T* w,
+        const T* quad_w, const T* f, size_t stride, size_t n_surfs,
+        int degree, T* moms) const;
+
+    //! The integral of the traction f and its symmetric first moment
+    //! about the centroid of closed surfaces in one pass, see
+    //! Surface::stresslet().
+    template<typename T>
+    void SurfaceStresslet(const T* x, const T* normal, const T* w,
+        const T* quad_w, const T* f, size_t stride, size_t n_surfs,
+        T* strs) const;
+
     template<typename T>
     bool isNumeric(const T* x, size_t length) const;
 
@@ -57,10 +57,13 @@ enum SolverScheme {JacobiBlockExplicit,     /* Jacobi iteration + only block ten
                    JacobiBlockGaussSeidel,  /* Jacobi iteration + tension solve + position solve              */
                    JacobiBlockImplicit,     /* Jacobi iteration + block coupled solve                         */
                    GloballyImplicit,        /* Fully implicit                                                 */
+                   GloballyImplicitBDF2,    /* Fully implicit, second order semi-implicit BDF                 */
+                   GloballyImplicitSDC,     /* Fully implicit, spectral deferred correction                   */
                    UnknownScheme};          /* Used to signal parsing errors                                  */
 
 ///The linear solver scheme for the vesicle evolution equation
 enum PrecondScheme {DiagonalSpectral,       /* Only the self preconditioner; diagonal in SH basis */
+                    TwoLevelSpectral,       /* Coarse SH order solve + diagonal for high freqs    */
                     NoPrecond,              /* No preconditioner at all                           */
                     UnknownPrecond};        /* Used to signal parsing errors                      */
 
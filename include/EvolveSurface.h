@@ -14,6 +14,8 @@
 #include "BgFlowBase.h"
 #include "InterfacialVelocity.h"
 #include "ParallelLinSolverInterface.h"
+#include "SnapshotRing.h"
+#include "Telemetry.h"
 
 //The default arguments classes for the template
 #include "BgFlow.h"
@@ -38,6 +40,15 @@
  *     . monitor
  *  }
  * \endcode
+ *
+ * When the snapshot stride is set, the state is also kept in memory
+ * every few steps and a step that fails (the solver does not converge
+ * or the monitor reports an accuracy error) is rolled back to the
+ * last snapshot with half the time step, see Rollback(). With the
+ * adaptive time steppers a failed solve is not rolled back, the step
+ * is rejected (the position is restored and dt is reduced) as for a
+ * large error, so only the monitor failures are rolled back. The
+ * snapshots are dropped when a repartition moves vesicles.
  */
 template<typename T,
          typename DT,
@@ -70,6 +81,7 @@ class EvolveSurface : public Streamable
     typedef InterfacialVelocity<Sur_t, Interaction_t> IntVel_t;
     typedef typename IntVel_t::VProp_t VProp_t;
     typedef Error_t (IntVel_t::*Scheme_t)(const Sur_t &, const value_type &, Vec_t &);
+    typedef SnapshotRing<Vec_t, Sca_t> SnapRing_t;
 
     EvolveSurface(Params_t *params, const Mats_t &mats,
         BgFlow_t *vInf,	Monitor_t *M = NULL, Interaction_t *I = NULL,
@@ -97,12 +109,37 @@ class EvolveSurface : public Streamable
     Interaction_t *interaction_;
     Repartition_t *repartition_;
     IntVel_t *F_;
+    //! Whether the last repartition moved vesicles (on any process)
+    bool repartitioned_;
 
     bool ownedObjs_[4];//for monitor, interaction, repartition, and ves_props
 
   private:
 
     Error_t AreaVolumeCorrection(const Sca_t& area, const Sca_t& vol, const value_type tol=1e-12);
+
+    //! The maximum of n values over all the processes, in place
+    static void GlobalMax(value_type *val, int n=1);
+
+    //! Restores the newest snapshot (when the failure is not the
+    //! rollback_max-th in a row) and halves its time step for each
+    //! consecutive rollback. The interfacial velocity is recreated
+    //! so that no state of the failed solve is reused. It returns
+    //! false when there is nothing to roll back to. It is collective,
+    //! failed is whether the step failed on this process.
+    bool Rollback(bool failed, SnapRing_t &snapshots, int &n_rollbacks,
+        value_type &t, value_type &dt, Vec_t &dx_prev, value_type &dt_prev);
+
+    // moments before and after the step for TimeAdapErrAreaVol
+    Arr_t tadap_moms0_, tadap_moms_;
+
+    // workspace of AreaVolumeCorrection, only the vesicles that are
+    // not converged are gathered in avc_S_ (and its upsampled avc_S_up_)
+    Sur_t *avc_S_, *avc_S_up_;
+    Sca_t avc_X_, avc_Y_, avc_wrk_;
+    Arr_t avc_moms_, avc_dX_, avc_dY_;
+    std::vector<size_t> avc_active_, avc_next_;
+    std::vector<value_type> avc_host_;
 };
 
 #include "EvolveSurface.cc"
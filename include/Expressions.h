@@ -0,0 +1,239 @@
+/**
+ * @file   Expressions.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief Expression templates for the pointwise operations on the
+ * Scalars and Vectors containers. The implementation is in
+ * src/Expressions.cc.
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _EXPRESSIONS_H_
+#define _EXPRESSIONS_H_
+
+#include <cstddef>  // for size_t
+#include "Logger.h"
+#include "Array.h"
+#include "Device.h"
+#include "Scalars.h"
+#include "Vectors.h"
+
+/**
+ * A chain of pointwise operations, e.g.
+ *
+ *     xv(s1, n, F); av(kb, F, F);
+ *
+ * is written as one expression
+ *
+ *     Evaluate(expr(kb) * expr(s1) * expr(n), F);
+ *
+ * that is evaluated in a single loop over the memory without
+ * temporaries. The terms of an expression are wrapped by expr():
+ *  - a Scalars is a scalar field, it is broadcast over the components
+ *    of a vector field,
+ *  - a Vectors is a vector field,
+ *  - an Array with one entry per sub-component is a per-surface
+ *    constant (e.g. the bending modulus of each vesicle),
+ * and are combined with +, -, *, / and by value_type constants. The
+ * operands of an expression should have the same number of
+ * sub-components and the same stride as the output.
+ *
+ * The output may be one of the operands. The evaluation is done on
+ * the host, hence the containers should be on the CPU.
+ */
+template<typename E>
+struct Expression
+{
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+/*
+ * Each node evaluates the point with index sca_idx in a scalar field
+ * and vec_idx in a vector field, on the sub-component sub.
+ */
+template<typename T>
+class ScalarTerm : public Expression<ScalarTerm<T> >
+{
+  public:
+    typedef T value_type;
+    enum {IS_VECTOR = 0};
+
+    ScalarTerm(const T *data, size_t stride, size_t num_subs) :
+        data_(data), stride_(stride), num_subs_(num_subs) {}
+
+    T operator()(size_t sca_idx, size_t vec_idx, size_t sub) const
+    { return data_[sca_idx]; }
+
+    bool conforms(size_t stride, size_t num_subs) const
+    { return stride_ == stride && num_subs_ == num_subs; }
+
+  private:
+    const T *data_;
+    size_t stride_, num_subs_;
+};
+
+template<typename T>
+class VectorTerm : public Expression<VectorTerm<T> >
+{
+  public:
+    typedef T value_type;
+    enum {IS_VECTOR = 1};
+
+    VectorTerm(const T *data, size_t stride, size_t num_subs) :
+        data_(data), stride_(stride), num_subs_(num_subs) {}
+
+    T operator()(size_t sca_idx, size_t vec_idx, size_t sub) const
+    { return data_[vec_idx]; }
+
+    bool conforms(size_t stride, size_t num_subs) const
+    { return stride_ == stride && num_subs_ == num_subs; }
+
+  private:
+    const T *data_;
+    size_t stride_, num_subs_;
+};
+
+template<typename T>
+class PerSubTerm : public Expression<PerSubTerm<T> >
+{
+  public:
+    typedef T value_type;
+    enum {IS_VECTOR = 0};
+
+    PerSubTerm(const T *data, size_t size) :
+        data_(data), size_(size) {}
+
+    T operator()(size_t sca_idx, size_t vec_idx, size_t sub) const
+    { return data_[sub]; }
+
+    bool conforms(size_t stride, size_t num_subs) const
+    { return size_ == num_subs; }
+
+  private:
+    const T *data_;
+    size_t size_;
+};
+
+template<typename T>
+class ConstantTerm : public Expression<ConstantTerm<T> >
+{
+  public:
+    typedef T value_type;
+    enum {IS_VECTOR = 0};
+
+    explicit ConstantTerm(T val) : val_(val) {}
+
+    T operator()(size_t sca_idx, size_t vec_idx, size_t sub) const
+    { return val_; }
+
+    bool conforms(size_t stride, size_t num_subs) const
+    { return true; }
+
+  private:
+    T val_;
+};
+
+namespace expr_ops
+{
+    struct Add { template<typename T> static T apply(T a, T b) { return a + b; } };
+    struct Sub { template<typename T> static T apply(T a, T b) { return a - b; } };
+    struct Mul { template<typename T> static T apply(T a, T b) { return a * b; } };
+    struct Div { template<typename T> static T apply(T a, T b) { return a / b; } };
+}
+
+template<typename Op, typename L, typename R>
+class BinaryExpression : public Expression<BinaryExpression<Op, L, R> >
+{
+  public:
+    typedef typename L::value_type value_type;
+    enum {IS_VECTOR = L::IS_VECTOR || R::IS_VECTOR};
+
+    BinaryExpression(const L &lhs, const R &rhs) : lhs_(lhs), rhs_(rhs) {}
+
+    value_type operator()(size_t sca_idx, size_t vec_idx, size_t sub) const
+    { return Op::apply(lhs_(sca_idx, vec_idx, sub), rhs_(sca_idx, vec_idx, sub)); }
+
+    bool conforms(size_t stride, size_t num_subs) const
+    { return lhs_.conforms(stride, num_subs) && rhs_.conforms(stride, num_subs); }
+
+  private:
+    L lhs_;
+    R rhs_;
+};
+
+///@name Terms of an expression
+///@{
+template<typename T, typename DT, const DT &DEVICE>
+inline ScalarTerm<T> expr(const Scalars<T, DT, DEVICE> &x);
+
+template<typename T, typename DT, const DT &DEVICE>
+inline VectorTerm<T> expr(const Vectors<T, DT, DEVICE> &x);
+
+template<typename T, typename DT, const DT &DEVICE>
+inline PerSubTerm<T> expr(const Array<T, DT, DEVICE> &a);
+///@}
+
+///@name Operators
+///@{
+template<typename L, typename R>
+inline BinaryExpression<expr_ops::Add, L, R> operator+(
+    const Expression<L> &lhs, const Expression<R> &rhs);
+
+template<typename L, typename R>
+inline BinaryExpression<expr_ops::Sub, L, R> operator-(
+    const Expression<L> &lhs, const Expression<R> &rhs);
+
+template<typename L, typename R>
+inline BinaryExpression<expr_ops::Mul, L, R> operator*(
+    const Expression<L> &lhs, const Expression<R> &rhs);
+
+template<typename L, typename R>
+inline BinaryExpression<expr_ops::Div, L, R> operator/(
+    const Expression<L> &lhs, const Expression<R> &rhs);
+
+template<typename R>
+inline BinaryExpression<expr_ops::Mul, ConstantTerm<typename R::value_type>, R>
+operator*(typename R::value_type a, const Expression<R> &rhs);
+
+template<typename L>
+inline BinaryExpression<expr_ops::Mul, L, ConstantTerm<typename L::value_type> >
+operator*(const Expression<L> &lhs, typename L::value_type a);
+
+template<typename R>
+inline BinaryExpression<expr_ops::Div, ConstantTerm<typename R::value_type>, R>
+operator/(typename R::value_type a, const Expression<R> &rhs);
+///@}
+
+/**
+ * Evaluates the expression e into out in one loop. out should be a
+ * Vectors when e has a vector term.
+ */
+template<typename E, typename Container>
+inline void Evaluate(const Expression<E> &e, Container &out);
+
+#include "Expressions.cc"
+
+#endif //_EXPRESSIONS_H_
@@ -0,0 +1,142 @@
+/**
+ * @file   GeometryFile.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief The initial geometry (and vesicle properties) in a binary
+ * file that is read in slices by the processes. The implementation
+ * is in src/GeometryFile.cc.
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef _GEOMETRYFILE_H_
+#define _GEOMETRYFILE_H_
+
+#include "ves3d_common.h"
+#include "Error.h"
+#include "Logger.h"
+#include "Streamable.h"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef HAS_MPI
+
+/**
+ * The binary counterpart of the ASCII geometry spec file (and of
+ * the vesicle properties file) used to set up a simulation. The
+ * file is:
+ *  - the header: the binary header (tag GEOMETRY), the offset of the
+ *    data, the number of vesicles, the number of fields of the
+ *    geometry spec of each vesicle (NUM_FIELDS: shape index, scale,
+ *    center, and rotation), the number of vesicle properties, and
+ *    the bounding box of the centers,
+ *  - one record per vesicle with its geometry spec followed by its
+ *    properties.
+ * The records are of fixed size, so the record of a vesicle is at a
+ * known offset and each process reads only its contiguous slice of
+ * the vesicles (collectively with MPI-IO). When the file is written
+ * sorted, the vesicles are ordered along the Morton curve of their
+ * centers (in the bounding box), so that the vesicles of a process
+ * are close to each other.
+ *
+ * The file is written by one process (see the geometry_convert
+ * utility) and read by all processes of the communicator.
+ */
+template<typename T>
+class GeometryFile : public Streamable
+{
+  public:
+    typedef T value_type;
+
+    static const int NUM_FIELDS = 8;
+    //! The largest block of one MPI-IO call (the counts are int)
+    static const size_t IO_CHUNK = 1 << 30;
+
+    explicit GeometryFile(MPI_Comm comm = VES3D_COMM_WORLD);
+    ~GeometryFile();
+
+    //! Writes the geometry spec (NUM_FIELDS values per vesicle) and
+    //! the properties (the same number of values per vesicle, or
+    //! empty) of all the vesicles (called by one process). The spec
+    //! and props are reordered when sort is set.
+    Error_t Write(const std::string &fname, std::vector<T> &spec,
+        std::vector<T> &props, bool sort = true);
+
+    //! Reads the geometry spec and properties of the vesicles of
+    //! this process, the vesicles are distributed evenly in the
+    //! order of the file (it is collective over the communicator)
+    Error_t Read(const std::string &fname, std::vector<T> &spec,
+        std::vector<T> &props);
+
+    //! Whether fname is a binary geometry file (detected from the
+    //! binary header)
+    static bool IsGeometryFile(const std::string &fname,
+        MPI_Comm comm = VES3D_COMM_WORLD);
+
+    //! Orders the vesicles along the Morton curve of their centers
+    //! (n_props is the number of properties of each vesicle)
+    void MortonSort(std::vector<T> &spec, std::vector<T> &props,
+        int n_props);
+
+    //! The vesicles of this process after the last read
+    size_t first_vesicle() const { return first_; }
+    size_t num_vesicles() const { return count_; }
+    size_t total_vesicles() const { return total_; }
+    int num_props() const { return n_props_; }
+
+    //! pack/unpack the header (only BIN)
+    Error_t pack(std::ostream &os, Streamable::Format format) const;
+    Error_t unpack(std::istream &is, Streamable::Format format);
+
+  private:
+    GeometryFile(const GeometryFile &);
+    GeometryFile& operator=(const GeometryFile &);
+
+    //! The Morton key of a center in the bounding box
+    uint64_t MortonKey(const T *center) const;
+
+    MPI_Comm comm_;
+    int nproc_, rank_;
+
+    // the header
+    uint64_t data_offset_;
+    uint64_t total_;
+    int32_t n_fields_, n_props_;
+    double box_[6];             // the lower and upper corners
+
+    size_t first_, count_;
+};
+
+#include "GeometryFile.cc"
+
+#endif //HAS_MPI
+
+#endif //_GEOMETRYFILE_H_
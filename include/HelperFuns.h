@@ -3,7 +3,9 @@
 
 #include <cassert>
 #include <iostream>
+#include <vector>
 #include "Device.h"
+#include "Expressions.h"
 #include "Logger.h"
 #include "SHTrans.h"
 
@@ -63,6 +65,11 @@ inline void avpw(const ScalarContainer &a_in,
 template<typename Arr_t, typename Vec_t>
 inline void av(const Arr_t &a_in, const Vec_t &v_in, Vec_t &av_out);
 
+///Per-subfield axpy, the scale a_in[j] is used for the j-th subfield
+template<typename Container>
+inline void axpy(const typename Container::array_type &a_in,
+    const Container &x_in, const Container &y_in, Container &axpy_out);
+
 template<typename ScalarContainer, typename VectorContainer>
 inline void xvpw(const ScalarContainer &x_in,
     const VectorContainer &v_in, const VectorContainer &w_in,
@@ -107,10 +114,46 @@ template<typename ScalarContainer>
 typename ScalarContainer::value_type AlgebraicDot(
     const ScalarContainer &x, const ScalarContainer &y);
 
+///@todo this need to be implemented for the GPU
+///The algebraic dot product of each subfield
+template<typename Container>
+void AlgebraicDot(const Container &x, const Container &y,
+    typename Container::array_type &dot);
+
 template<typename Container, typename SHT>
 inline void Resample(const Container &xp, const SHT &shtp, const SHT &shtq,
     Container &shcpq, Container &wrkpq, Container &xq);
 
+///Resample() of a field that is already transformed: shcp holds the
+///coefficients of order p and shcq (which should be of the order of
+///shtq) is set to the zero-padded or truncated coefficients, followed
+///by the backward transform to xq. No forward transform is done,
+///hence the coefficients can be shared when the same field is
+///resampled to several orders.
+template<typename Container, typename SHT>
+inline void ResampleShc(const Container &shcp, const SHT &shtq,
+    Container &shcq, Container &wrkq, Container &xq);
+
+///Copies the spherical harmonic coefficients that are common between
+///the orders of shcp and shcq (truncation when restricting to a lower
+///order). The higher frequencies of shcq are not touched; they should
+///be zeroed for a zero-padded prolongation.
+template<typename Container>
+inline void ResampleCoeffs(const Container &shcp, Container &shcq);
+
+///Copies the subfields idx[0], idx[1], ... of x into consecutive
+///subfields of y (y is resized). Consecutive indices are copied as
+///one block.
+template<typename Container>
+inline void GatherSubs(const Container &x, const std::vector<size_t> &idx,
+    Container &y);
+
+///The inverse of GatherSubs, copies the i'th subfield of y into the
+///subfield idx[i] of x.
+template<typename Container>
+inline void ScatterSubs(const Container &y, const std::vector<size_t> &idx,
+    Container &x);
+
 #include "HelperFuns.cc"
 
 #endif //_HELPERFUNS_H_
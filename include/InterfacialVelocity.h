@@ -7,16 +7,23 @@
 
 #include "InterfacialForce.h"
 #include "BiCGStab.h"
+#include "BiCGStabBatched.h"
 #include "SHTrans.h"
 #include "Device.h"
-#include <queue>
+#include "WorkSpace.h"
+#include <vector>
 #include <memory>
+#include <sstream>
+#include <limits>
+#include <algorithm>
 #include "Enums.h"
 #include "BgFlowBase.h"
 #include "OperatorsMats.h"
 #include "ParallelLinSolverInterface.h"
 #include "VesicleProps.h"
 #include "StokesVelocity.h"
+#include "VTKWriter.h"
+#include "Telemetry.h"
 
 template<typename SurfContainer, typename Interaction>
 class InterfacialVelocity
@@ -33,6 +40,8 @@ class InterfacialVelocity
     typedef typename PSolver_t::matvec_type POp_t;
     typedef typename PSolver_t::vec_type PVec_t;
     typedef StokesVelocity<value_type> Stokes_t;
+    typedef float lowp_type;
+    typedef StokesVelocity<lowp_type> StokesLowp_t;
     typedef SHTrans<Sca_t, SHTMats<value_type, device_type> > SHtrans_t;
     typedef VesicleProperties<Arr_t> VProp_t;
 
@@ -52,6 +61,7 @@ class InterfacialVelocity
     Error_t ImplicitMatvecPhysical(Vec_t &vox, Sca_t &ten) const;
 
     Error_t Solve(const PVec_t *rhs, PVec_t *u0, const value_type &dt, const SolverScheme &scheme) const;
+    Error_t SolveRefine(const PVec_t *rhs, PVec_t *u0) const;
     Error_t ConfigureSolver(const SolverScheme &scheme) const;
     Error_t ConfigurePrecond(const PrecondScheme &precond) const;
     Error_t Update(PVec_t *u0);
@@ -60,6 +70,18 @@ class InterfacialVelocity
     Error_t updateJacobiGaussSeidel(const SurfContainer& S_, const value_type &dt, Vec_t& dx);
     Error_t updateJacobiImplicit   (const SurfContainer& S_, const value_type &dt, Vec_t& dx);
     Error_t updateImplicit         (const SurfContainer& S_, const value_type &dt, Vec_t& dx);
+    Error_t updateImplicitBDF2     (const SurfContainer& S_, const value_type &dt, Vec_t& dx);
+    Error_t updateImplicitSDC      (const SurfContainer& S_, const value_type &dt, Vec_t& dx);
+
+    /// The positions at the start of the last two accepted steps
+    /// (x_prev[0] is the newest) and the time steps that ended at the
+    /// next position, used by the multistep schemes; dt_prev[i]<=0
+    /// marks no history
+    void SetHistory(const Vec_t *x_prev, const value_type *dt_prev);
+
+    /// The embedded error estimate of the last update and its order,
+    /// negative if the scheme doesn't have one
+    value_type LocalError(int &order) const;
 
     Error_t reparam();
 
@@ -76,6 +98,10 @@ class InterfacialVelocity
 
     value_type StokesError(const Vec_t &x) const;
 
+    /// W[(m-1)*M+j-1] is the integral of the j'th Lagrange polynomial
+    /// on the nodes j/M (j=1..M) over [(m-1)/M, m/M]
+    static void SDCWeights(int M, std::vector<value_type> &W);
+
     Sca_t& tension(){ return tension_;}
 
   private:
@@ -86,7 +112,7 @@ class InterfacialVelocity
     const VProp_t &ves_props_;
 
     InterfacialForce<SurfContainer> Intfcl_force_;
-    BiCGStab<Sca_t, InterfacialVelocity> linear_solver_;
+    BiCGStabBatched<Sca_t, InterfacialVelocity> linear_solver_;
     BiCGStab<Vec_t, InterfacialVelocity> linear_solver_vec_;
 
     // parallel solver
@@ -105,6 +131,14 @@ class InterfacialVelocity
 
     value_type dt_;
 
+    // the explicit state of the step when it is not the position of
+    // S_ (the geometry), used by the higher order schemes
+    mutable const Vec_t *x_hat_;
+    const Vec_t *x_prev_;
+    const value_type *dt_prev_;
+    value_type local_error_;
+    int local_error_order_;
+
     Error_t EvalFarInter_Imp(const Vec_t &src, const Vec_t &fi, Vec_t &vel) const;
     Error_t EvalFarInter_ImpUpsample(const Vec_t &src, const Vec_t &fi, Vec_t &vel) const;
 
@@ -118,24 +152,52 @@ class InterfacialVelocity
     SHtrans_t sht_upsample_;
 
     mutable Stokes_t stokes_;
+
+    // single precision copy of the stokes operator used by the inner
+    // solve of mixed precision iterative refinement
+    mutable StokesLowp_t *stokes_lowp_;
+    mutable bool lowp_matvec_;
+    mutable bool lowp_src_set_; // set on the first inner solve of a step
+    Error_t SetSrcCoordLowp() const;
+    Error_t StokesLowp(const Vec_t *fsl, const Vec_t *fdl, Vec_t &vel) const;
+
     mutable Vec_t pos_vel_;
     mutable Sca_t tension_;
     mutable Sca_t position_precond;
     mutable Sca_t tension_precond;
 
+    // coarse level of the two-level preconditioner, the same operator
+    // at params_.precond_coarse_order with its own parallel solver
+    mutable Parameters<value_type> *coarse_params_;
+    mutable Mats_t *coarse_mats_;
+    mutable SHtrans_t *sht_coarse_;
+    mutable SurfContainer *S_coarse_;
+    mutable PSolver_t *coarse_solver_;
+    mutable InterfacialVelocity *coarse_;
+    Error_t PrepareCoarse(const SolverScheme &scheme) const;
+    Error_t TwoLevelCorrection(Vec_t &vxs, Sca_t &tns) const;
+
+    // reparametrization workspace, the vesicles that are not
+    // converged yet are gathered in S_rep_
+    const Mats_t &mats_;
+    SurfContainer *S_rep_;
+    Arr_t rep_coeff_;
+    std::vector<size_t> rep_active_, rep_keep_;
+
     //Workspace
     mutable SurfContainer* S_up_;
-    mutable std::queue<Sca_t*> scalar_work_q_;
+    WorkSpace<Sca_t> sca_work_;
+    WorkSpace<Vec_t> vec_work_;
+
+    // the work containers have the shape of the argument (the
+    // position of the surface when not given)
     std::auto_ptr<Sca_t> checkoutSca() const;
+    std::auto_ptr<Sca_t> checkoutSca(const Sca_t &shape) const;
     void recycle(std::auto_ptr<Sca_t> scp) const;
-    mutable int checked_out_work_sca_;
 
-    mutable std::queue<Vec_t*> vector_work_q_;
     std::auto_ptr<Vec_t> checkoutVec() const;
+    std::auto_ptr<Vec_t> checkoutVec(const Sca_t &shape) const;
     void recycle(std::auto_ptr<Vec_t> vcp) const;
-    mutable int checked_out_work_vec_;
-
-    void purgeTheWorkSpace() const;
 };
 
 #include "InterfacialVelocity.cc"
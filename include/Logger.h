@@ -3,7 +3,8 @@
  * @author Rahimian, Abtin <arahimian@acm.org>
  * @date   2014-08-26 16:26
  *
- * @brief Logger singleton class as well as logging and printing macros
+ * @brief Logger singleton class as well as logging, profiling, and
+ * printing macros
  */
 
 /*
@@ -34,35 +35,15 @@
 #define _LOGGER_H_
 
 #include "ves3d_common.h"
+#include "Profiler.h"
 
 #include <iostream>
 #include <iomanip>  //for setpercision
-#include <map>
 #include <omp.h>
-#include <stack>
 #include <string>
 #include <cassert>
 #include <ctime>
 
-//! A log event recorded by the Logger class.
-struct LogEvent
-{
-    std::string       fun_name;
-    unsigned long int num_calls;
-    double            time;
-    double            flop;
-    double            flop_rate;
-};
-
-//! The print function for the LogEvent class.
-template<typename T>
-void PrintLogEvent(const std::pair<T, LogEvent>& ev);
-
-//! The enum type for the format of the report generated by
-//! Logger::Report().
-enum ReportFormat {SortFunName, SortNumCalls, SortTime,
-                   SortFlop, SortFlopRate};
-
 //! A singleton class handling the logging.
 class Logger
 {
@@ -70,23 +51,15 @@ class Logger
     //! Returns the current wall-time.
     static double Now();
 
-    //! Gets the current wall-time, saves it in a stack and also
-    //! returns it as output.
+    //! Gets the current wall-time, saves it in a stack of the
+    //! calling thread and also returns it as output.
     static double Tic();
 
     //! Gets the current wall-time, pops the corresponding Tic() value
-    //! form the stack, i.e. the last Tic(), and returns the difference.
+    //! form the stack of the thread, i.e. the last Tic(), and returns
+    //! the difference.
     static double Toc();
 
-    //! Records accumulative log events corresponding to functions
-    //! calling this method.
-    static void Record(std::string fun_name, std::string prefix, double time,
-        double flop);
-
-    //! Reports all accumulative data corresponding to all the calls to
-    //! the Record() function.
-    static void Report(enum ReportFormat rf);
-
     //! The setter function of the log file.
     static void SetLogFile(std::string file_name);
 
@@ -97,39 +70,25 @@ class Logger
     //! Log event to file
     static void Log(std::ostream &event);
 
-    //! Clears the slate of profiler
-    static void PurgeProfileHistory();
-
-    static double GetFlops();
-
   private:
     //! The constructor, since the class is a singleton class, the
     //! constructor is set private to avoid instantiation of the
     //! object.
     Logger();
 
-    //! The map holding the data corresponding the Record() method.
-    static std::map<std::string, LogEvent> PrflMap;
-
-    //! The stack used by Tic() and Toc().
-    static std::stack<double> TicStack;
-
-    //! The stack to have cumulative
-    static std::stack<double> FlopStack;
-
     //! The file name for the logger.
     static std::string log_file;
 };
 
 /*
- * Profiling Macros
+ * Profiling Macros, PROFILESTART() opens a scope of the enclosing
+ * function that is closed by PROFILEEND() or at the end of the block
  */
 #ifdef PROFILING
-#define PROFILESTART() (Logger::Tic())
-#define PROFILEEND(str,flps) (                                  \
-        Logger::Record(__FUNCTION__, str, Logger::Toc(), flps))
-#define PROFILECLEAR() (Logger::PurgeProfileHistory())
-#define PROFILEREPORT(format) (Logger::Report(format))
+#define PROFILESTART() Profiler::Scope _profile_scope_(__FUNCTION__)
+#define PROFILEEND(str,flps) (_profile_scope_.Stop(str, flps))
+#define PROFILECLEAR() (Profiler::Clear())
+#define PROFILEREPORT(format) (Profiler::Report(format))
 #define PROFILEING_EXPR(expr) (expr)
 #else
 #define PROFILESTART()
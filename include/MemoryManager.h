@@ -37,6 +37,7 @@
 
 #include <memory>
 #include "Error.h"
+#include "CachingAllocator.h"
 #include "tr1.h"
 
 namespace memory{
@@ -113,6 +114,9 @@ namespace memory{
 
 	size_type max_size() const;
 
+	//! The counters of the host allocator (zero for other devices)
+	AllocStats stats() const;
+
       protected:
 	static MemoryManager instance_;
 
@@ -134,7 +138,11 @@ namespace memory{
     template<typename T>
     Error_t MemoryManager<DT,DEVICE>::allocate(size_type n, ResourcePtr<T, MemoryManager> *p) const
     {
+	// on the host, the memory comes from CachingAllocator
 	void *mem(DEVICE.Malloc(n * sizeof(T)));
+	if (mem == NULL && n > 0)
+	    return ErrorEvent::MemoryError;
+
 	*p = (T*) mem;
 	return ErrorEvent::Success;
     }
@@ -148,8 +156,18 @@ namespace memory{
     }
 
     template<typename DT, const DT &DEVICE>
-    MemoryManager<DT,DEVICE>::size_type MemoryManager<DT,DEVICE>::max_size() const
+    typename MemoryManager<DT,DEVICE>::size_type MemoryManager<DT,DEVICE>::max_size() const
     { return 0;}
+
+    template<typename DT, const DT &DEVICE>
+    AllocStats MemoryManager<DT,DEVICE>::stats() const
+    {
+	if (DT::IsHost())
+	    return CachingAllocator::GetStats();
+
+	AllocStats empty = {0, 0, 0, 0, 0};
+	return empty;
+    }
 }
 
 #endif //_MEMORYMANAGER_H_
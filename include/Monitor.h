@@ -4,6 +4,13 @@
 #include "Logger.h"
 #include "Spharm.h"
 #include "Enums.h"
+#include "ParallelCheckpoint.h"
+#include "AsyncWriter.h"
+#include "SHTrans.h"
+#include "Trajectory.h"
+#include "Rheology.h"
+#include "InterfacialForce.h"
+#include "Telemetry.h"
 
 template<typename EvolveSurface>
 class MonitorBase{
@@ -22,15 +29,26 @@ class Monitor : public MonitorBase<EvolveSurface>
 {
   private:
     typedef typename EvolveSurface::value_type value_type;
+    typedef typename EvolveSurface::Vec_t Vec_t;
+    typedef SHTrans<typename EvolveSurface::Sca_t,
+                    typename EvolveSurface::Mats_t::SHMats_t> SHT_t;
+    typedef Rheology<typename EvolveSurface::Sur_t> Rheology_t;
+    typedef InterfacialForce<typename EvolveSurface::Sur_t> Force_t;
 
     bool checkpoint_flag_;
     value_type checkpoint_stride_;
-    DataIO IO_;
+    std::string buffer_;
     mutable value_type A0_, V0_;
-    typename EvolveSurface::Sca_t area0_, vol0_;
-    typename EvolveSurface::Sca_t area_new, vol_new;
+    typename EvolveSurface::Arr_t moms0_, moms_new_;
     int last_checkpoint_;
     int time_idx_;
+    Trajectory<Vec_t> trajectory_;
+    SHT_t *trajectory_sht_;
+    int last_frame_;
+    Rheology_t *rheology_;
+    Force_t *rheology_force_;
+    Vec_t traction_, tensile_;
+    int last_rheology_;
     DictString_t d_;
     const Parameters<value_type> *params_;
 
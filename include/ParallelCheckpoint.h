@@ -0,0 +1,159 @@
+/**
+ * @file   ParallelCheckpoint.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief A single checkpoint file for all the processes, written and
+ * read collectively with MPI-IO. The implementation is in
+ * src/ParallelCheckpoint.cc.
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _PARALLELCHECKPOINT_H_
+#define _PARALLELCHECKPOINT_H_
+
+#include "ves3d_common.h"
+#include "Error.h"
+#include "Logger.h"
+#include "Enums.h"
+#include "Parameters.h"
+#include "Streamable.h"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef HAS_MPI
+
+/**
+ * The checkpoint of all processes in one file (instead of one file
+ * per process), so that it can be read by a different number of
+ * processes. The file is:
+ *  - the global header: the binary header (tag PCHECKPOINT), the
+ *    offset of the data, the number of processes that wrote the file,
+ *    the total number of vesicles, the stride and the point order of
+ *    the positions, the number of vesicle properties, the parameters
+ *    (in the BIN format), and the offset table with the first
+ *    vesicle and the number of vesicles of each process,
+ *  - the positions of all vesicles ordered by vesicle ID (the ID of
+ *    a vesicle is its index on its process plus the number of
+ *    vesicles on the lower ranks),
+ *  - the vesicle properties, each property ordered by vesicle ID.
+ * The data starts at a multiple of DATA_ALIGNMENT bytes.
+ *
+ * The header is written and read by the first process and each
+ * process writes (reads) its own block of the data with the
+ * collective MPI-IO calls. When the file is read by the same number
+ * of processes, each process gets the vesicles it had (as in the
+ * offset table), otherwise the vesicles are distributed evenly by
+ * their ID.
+ *
+ * All the functions are collective over the communicator and the
+ * file name of the first process is used.
+ */
+template<typename Vec, typename VProp>
+class ParallelCheckpoint : public Streamable
+{
+  public:
+    typedef typename Vec::value_type value_type;
+    typedef typename Vec::device_type device_type;
+    typedef Parameters<value_type> Params_t;
+
+    static const size_t DATA_ALIGNMENT = 4096;
+    //! The largest block of one MPI-IO call (the counts are int)
+    static const size_t IO_CHUNK = 1 << 30;
+
+    explicit ParallelCheckpoint(MPI_Comm comm = VES3D_COMM_WORLD);
+    ~ParallelCheckpoint();
+
+    //! Writes the parameters (of the first process), the positions
+    //! x and the vesicle properties to fname
+    Error_t Write(const std::string &fname, const Params_t &params,
+        const Vec &x, const VProp &props);
+
+    //! Reads the global header and the parameters of the file, it
+    //! should be called before ReadState().
+    Error_t ReadHeader(const std::string &fname, Params_t &params);
+
+    //! Reads the positions and vesicle properties of this process
+    //! (x and props are resized and x should have the sh_order of
+    //! the file)
+    Error_t ReadState(const std::string &fname, Vec &x, VProp &props);
+
+    //! Whether fname is a parallel checkpoint file (detected from
+    //! the binary header)
+    static bool IsParallelCheckpoint(const std::string &fname,
+        MPI_Comm comm = VES3D_COMM_WORLD);
+
+    //! The vesicles of this process after the last read or write
+    size_t first_vesicle() const { return first_; }
+    size_t num_vesicles() const { return count_; }
+    size_t total_vesicles() const { return total_; }
+
+    //! pack/unpack the global header (only BIN)
+    Error_t pack(std::ostream &os, Streamable::Format format) const;
+    Error_t unpack(std::istream &is, Streamable::Format format);
+
+  private:
+    ParallelCheckpoint(const ParallelCheckpoint &);
+    ParallelCheckpoint& operator=(const ParallelCheckpoint &);
+
+    Error_t Open(const std::string &fname, int amode, MPI_File &fh) const;
+    void Distribute();
+
+    // the first error of all the processes, so that they all skip the
+    // following collective calls together
+    Error_t ReduceError(Error_t ierr) const;
+
+    // the blocks are written (read) in chunks of at most IO_CHUNK
+    // bytes, all the processes make the same number of calls
+    template<typename Arr>
+    Error_t WriteBlock(MPI_File fh, MPI_Offset offset, const Arr &arr, size_t n) const;
+
+    template<typename Arr>
+    Error_t ReadBlock(MPI_File fh, MPI_Offset offset, Arr &arr, size_t n) const;
+
+    MPI_Comm comm_;
+    int nproc_, rank_;
+
+    // the global header
+    std::string params_;            // the parameters in the BIN format
+    uint64_t data_offset_;
+    int32_t file_nproc_;
+    uint64_t total_, stride_;
+    int32_t point_order_, n_props_;
+    std::vector<uint64_t> table_;   // first vesicle and count of each process
+
+    size_t first_, count_;
+};
+
+#include "ParallelCheckpoint.cc"
+
+#endif //HAS_MPI
+
+#endif //_PARALLELCHECKPOINT_H_
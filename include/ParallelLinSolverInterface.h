@@ -174,6 +174,10 @@ class ParallelLinSolver{
     virtual Error_t Configure() = 0;
     virtual Error_t InitialGuessNonzero(bool flg) const = 0;
 
+    // use a Krylov method that allows a preconditioner that changes
+    // between the iterations (e.g. one with an iterative solve)
+    virtual Error_t SetFlexible() = 0;
+
     // factories
     virtual Error_t VecFactory(vec_type **newvec) const = 0;
     virtual Error_t LinOpFactory(matvec_type **newop) const = 0;
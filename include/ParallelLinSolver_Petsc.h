@@ -39,6 +39,7 @@
 #include "ves3d_common.h"
 #include "petscksp.h"
 #include "Logger.h"
+#include "Telemetry.h"
 
 template<typename T>
 class ParallelVecPetsc : public ParallelVec<T>
@@ -180,6 +181,7 @@ class ParallelLinSolverPetsc : public ParallelLinSolver<T>
 
     Error_t Configure();
     Error_t InitialGuessNonzero(bool flg) const;
+    Error_t SetFlexible();
 
     // factories
     Error_t VecFactory(vec_type **newvec) const;
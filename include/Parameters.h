@@ -42,12 +42,20 @@ class Parameters : public Streamable
     T ts;
     T time_tol;
     int time_iter_max;
+    int time_sdc_order;
     bool time_adaptive;
+    bool time_adap_doubling;
     bool solve_for_velocity;
     bool pseudospectral;
+    bool mixed_precision;
+    int refine_iter_max;
+    int snapshot_stride;
+    int snapshot_count;
+    int rollback_max;
 
     enum SolverScheme scheme;
     enum PrecondScheme time_precond;
+    int precond_coarse_order;
     enum BgFlowType bg_flow;
     enum SingularStokesRot singular_stokes;
 
@@ -71,13 +79,26 @@ class Parameters : public Streamable
 
     //Startup and Monitoring
     bool checkpoint;
+    bool checkpoint_bin;
+    bool checkpoint_parallel;
     T checkpoint_stride;
     std::string write_vtk;
+    int vtk_order;
+    bool vtk_collective;
+    bool vtk_float;
     std::string shape_gallery_file;
     std::string vesicle_props_file;
     std::string vesicle_geometry_file;
     std::string checkpoint_file_name;
     std::string load_checkpoint;
+    std::string trajectory_file_name;
+    T trajectory_stride;
+    bool trajectory_quantize;
+    std::string rheology_file_name;
+    T rheology_stride;
+    int rheology_bins;
+    std::string telemetry_file_name;
+    bool profile_step;
     T error_factor;
     int num_threads;
 
@@ -93,6 +114,11 @@ class Parameters : public Streamable
     virtual Error_t pack(std::ostream &os, Format format) const;
     virtual Error_t unpack(std::istream &is, Format format);
 
+    //! The format of the BIN layout, incremented when a field is
+    //! appended; the fields of a newer format keep their default
+    //! values when older data is unpacked
+    static const int BIN_FORMAT = 3;
+
   private:
     Parameters(Parameters<T> &rhs);
     Parameters<T>& operator=(Parameters<T> &rhs);
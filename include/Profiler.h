@@ -0,0 +1,120 @@
+/**
+ * @file   Profiler.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  Hierarchical per-thread profiler aggregated over the processes
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include "ves3d_common.h"
+
+#include <string>
+#include <vector>
+
+//! The enum type for the format of the report generated by
+//! Profiler::Report().
+enum ReportFormat {SortFunName, SortNumCalls, SortTime,
+                   SortFlop, SortFlopRate};
+
+struct ProfileNode;
+
+//! The statistics of a call path over the processes; the triplets
+//! are the minimum, mean, and maximum.
+struct ProfileStat
+{
+    std::string path;       //!< the names of the scopes joined by '/'
+    int         depth;      //!< the number of enclosing scopes
+    double      calls;      //!< mean over the processes
+    double      incl[3];    //!< inclusive time
+    double      excl[3];    //!< exclusive time (without the child scopes)
+    double      flop;       //!< mean over the processes (with the child scopes)
+    double      imbalance;  //!< the maximum over the mean of the inclusive time
+};
+
+/**
+ * A singleton class that times the nested Scope objects of each
+ * thread in a call tree. The tree of a thread is only touched by
+ * that thread, so the scopes can be opened inside parallel regions;
+ * a worker thread starts its own tree and its paths are merged with
+ * the paths of the other threads (their times are summed).
+ *
+ * Collect() and Report() merge the threads and reduce each call path
+ * over the processes of VES3D_COMM_WORLD (a process that did not take
+ * a path counts as zero). They are collective and should be called
+ * outside of the parallel regions.
+ */
+class Profiler
+{
+  public:
+    //! Times its lifetime (or until Stop()) as a child of the
+    //! innermost open scope of the thread
+    class Scope
+    {
+      public:
+        explicit Scope(const char *name);
+        ~Scope();
+
+        //! Closes the scope, the prefix is prepended to the name of
+        //! the call path (on its first record) and the flop include
+        //! those of the child scopes
+        void Stop(const char *prefix = "", double flop = 0);
+
+        //! The flop recorded by the closed child scopes
+        double ChildFlop() const;
+
+      private:
+        Scope(const Scope &);
+        Scope& operator=(const Scope &);
+
+        ProfileNode *node_;
+        Scope *parent_;
+        double tic_;
+        double child_flop_;
+        bool active_;
+    };
+
+    //! Zeros the records of all threads, the open scopes are kept
+    static void Clear();
+
+    //! The statistics of all call paths (on every process) in tree
+    //! order
+    static void Collect(std::vector<ProfileStat> &stats);
+
+    //! Prints the statistics on the first process
+    static void Report(enum ReportFormat rf);
+
+    //! The flop recorded in the innermost open scope of the thread
+    static double GetFlops();
+
+  private:
+    Profiler();
+};
+
+#endif //_PROFILER_H_
@@ -2,6 +2,7 @@
 #define _REPARTIONGATEWAY_H_
 
 #include <omp.h>
+#include <algorithm>
 #include <cassert>
 #include "Error.h"
 
@@ -40,9 +41,12 @@ class Repartition
      * @param tension The tension associated with each point.
      * @param user_ptr the user-defined pointer that may be needed
      * depending on the external repartitioning function.
+     * @param moved If not NULL, set to whether the vesicles of this
+     * process changed (their number or their positions).
      */
     template<typename VecContainer, typename ScaContainer>
-    Error_t operator()(VecContainer &coord, ScaContainer &tension) const;
+    Error_t operator()(VecContainer &coord, ScaContainer &tension,
+        bool *moved = NULL) const;
 
   private:
     GlobalRepart_t g_repart_handle_;
@@ -0,0 +1,144 @@
+/**
+ * @file   Rheology.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief In-situ rheology and suspension statistics (bulk stresslet,
+ * shape and velocity of the vesicles) as a small time series. The
+ * implementation is in src/Rheology.cc.
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _RHEOLOGY_H_
+#define _RHEOLOGY_H_
+
+#include "Error.h"
+#include "Logger.h"
+#include "Enums.h"
+#include "ves3d_common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+/**
+ * The per-step aggregates of a suspension, computed from the surfaces
+ * and the traction jump of their membranes without the full output:
+ *  - the bulk stresslet, the sum over the vesicles of the symmetric
+ *    first moment of the traction about the centroid (divide by the
+ *    volume of the domain for the particle stress),
+ *  - the shape of each vesicle from its inertia tensor (the second
+ *    moments of the enclosed volume): the Taylor deformation
+ *    parameter D = (L-B)/(L+B) of the ellipsoid with the same
+ *    moments and its inclination angle in the x-z plane (the shear
+ *    plane of ShearFlow) from the x axis, in [-pi/2, pi/2),
+ *  - the velocity of the centroids, by the difference of the
+ *    centroids between two calls; it is skipped when the number of
+ *    vesicles of a process changes or after ResetHistory() (call it
+ *    when the vesicles of the processes are exchanged). In a periodic
+ *    domain the displacement is the minimum image,
+ *  - the histograms of D (in [0,1)) and of the inclination.
+ *
+ * The moments and the stresslets are from one pass over the surfaces
+ * each (Surface::moments() and Surface::stresslet()), the aggregates
+ * of the processes are reduced with a single MPI_Allreduce. The time
+ * series is one line per call (see WriteLine()).
+ */
+template<typename SurfContainer>
+class Rheology
+{
+  public:
+    typedef typename SurfContainer::value_type value_type;
+    typedef typename SurfContainer::device_type device_type;
+    typedef typename SurfContainer::Vec_t Vec_t;
+    typedef typename SurfContainer::Arr_t Arr_t;
+
+    //! The layout of the aggregates, the histograms follow
+    enum Field {NUM_VES = 0, VOLUME = 1, STRESSLET = 2, DEFORM = 8,
+                DEFORM_SQ = 9, INCLIN = 10, VELOCITY = 11, NUM_VEL = 14,
+                NUM_FIELDS = 15};
+
+    //! period is the length of the periodic domain (non-positive
+    //! when it is not periodic)
+    Rheology(int n_bins = 10, value_type period = 0,
+        MPI_Comm comm = VES3D_COMM_WORLD);
+    ~Rheology();
+
+    //! The statistics of the surfaces S with the traction jump f at
+    //! time t, it is collective over the communicator
+    Error_t Compute(const SurfContainer &S, const Vec_t &f, value_type t);
+
+    //! Drops the centroids of the previous call, the next Compute()
+    //! has no velocity
+    void ResetHistory() { cent_prev_.clear(); }
+
+    //! The names of the columns (a comment line)
+    void WriteHeader(std::ostream &os) const;
+    //! The line of the last Compute(): the time, the number of
+    //! vesicles, their volume, the bulk stresslet (xx, xy, xz, yy, yz,
+    //! zz), the mean and the standard deviation of D, the mean
+    //! inclination, the mean centroid velocity, and the histograms
+    void WriteLine(std::ostream &os) const;
+
+    value_type time() const { return t_; }
+    size_t num_vesicles() const { return glb_[NUM_VES]; }
+    int num_bins() const { return n_bins_; }
+    const value_type* stresslet() const { return &glb_[STRESSLET]; }
+    value_type mean_deformation() const;
+    value_type mean_inclination() const;
+    //! the mean centroid velocity (zero when it is not known)
+    void mean_velocity(value_type *vel) const;
+    const value_type* deformation_hist() const { return &glb_[NUM_FIELDS]; }
+    const value_type* inclination_hist() const { return &glb_[NUM_FIELDS + n_bins_]; }
+
+    //! The deformation parameter and the inclination angle of the
+    //! ellipsoid with the second moments mom (xx, xy, xz, yy, yz, zz)
+    static void Shape(const value_type *mom, value_type &deform,
+        value_type &inclin);
+
+    //! The eigenvalues (ascending) and the eigenvectors (the columns
+    //! of the row-major vec) of the symmetric matrix a (xx, xy, xz,
+    //! yy, yz, zz) by Jacobi rotations
+    static void SymEig3(const value_type *a, value_type *lambda,
+        value_type *vec);
+
+  private:
+    Rheology(const Rheology &);
+    Rheology& operator=(const Rheology &);
+
+    MPI_Comm comm_;
+    int n_bins_;
+    value_type period_;
+    value_type t_, t_prev_;
+    Arr_t moms_, strs_;
+    std::vector<value_type> host_moms_, host_strs_, cent_prev_;
+    std::vector<value_type> loc_, glb_;
+};
+
+#include "Rheology.cc"
+
+#endif //_RHEOLOGY_H_
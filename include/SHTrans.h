@@ -1,6 +1,8 @@
 #ifndef _SHTRANS_H_
 #define _SHTRANS_H_
 
+#include "Telemetry.h"
+
 /**
  * Spherical Harmonics Transform (SHT) class. The template parameter
  * <code>Container</code> is assumed to have a static method <code>
@@ -50,6 +52,16 @@ class SHTrans
     void FirstDerivatives(const Container &in, Container &work,
         Container &shc, Container &du, Container &dv) const;
 
+    /**
+     * All the first and second derivatives from the coefficients
+     * shc. The Legendre transform (and transpose) is shared between
+     * the derivatives with the same latitude derivative (dv and d2v,
+     * du and duv), i.e. three Legendre transforms instead of five.
+     */
+    void AllDerivatives(const Container &shc, Container &work,
+        Container &du, Container &dv, Container &d2u, Container &d2v,
+        Container &duv) const;
+
     void lowPassFilter(const Container &in, Container &work,
         Container &shc, Container &out) const;
 
@@ -103,6 +115,13 @@ class SHTrans
         int n_funs, value_type *outputs, value_type *trans,
         value_type *dft) const;
 
+    ///The two stages of back(), the Legendre transform (the result
+    ///is transposed into work_arr) and the Fourier transform
+    void backDLT(const value_type *inputs, value_type *work_arr,
+        int n_funs, value_type *outputs, value_type *trans) const;
+    void backDFT(const value_type *work_arr, int n_funs,
+        value_type *outputs, value_type *dft) const;
+
     value_type* filter_coeff_;
     value_type* filter_coeff_poly_;
 };
@@ -112,6 +112,9 @@ class Scalars : public Array<T, DT, DEVICE>
     //! resizing so that this is the same size as rhs
     inline void match_size(Scalars<T, DT, DEVICE> const& rhs);
 
+    //! Exchanges the content and the shape with rhs, O(1)
+    inline void swap(Scalars<T, DT, DEVICE> &rhs);
+
     //! head of each sub component
     inline iterator getSubN_begin(size_t n);
     //! tail of each sub component
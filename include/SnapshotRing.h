@@ -0,0 +1,102 @@
+/**
+ * @file   SnapshotRing.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief In-memory snapshots of the time stepping state, used to roll
+ * back a failed step. The implementation is in src/SnapshotRing.cc.
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef _SNAPSHOTRING_H_
+#define _SNAPSHOTRING_H_
+
+#include "Error.h"
+#include "Logger.h"
+
+#include <vector>
+
+/**
+ * A ring buffer of the last few states of the time stepper: the
+ * positions, the tension (the initial guess of the next solve), the
+ * time, the time step, and the increment of the last accepted step
+ * with its time step (the history of the multistep schemes and of
+ * the error estimate). Each snapshot is about two vector containers
+ * and one scalar container of the size of the positions, and their
+ * memory is reused once the ring is full.
+ *
+ * The snapshots are restored newest first and a restored snapshot is
+ * dropped from the ring, so that a step that fails again is rolled
+ * back to an older state.
+ */
+template<typename Vec, typename Sca>
+class SnapshotRing
+{
+  public:
+    typedef typename Vec::value_type value_type;
+    typedef typename Vec::device_type device_type;
+
+    explicit SnapshotRing(int capacity = 0);
+    ~SnapshotRing();
+
+    //! Copies the state into the slot of the oldest snapshot (when
+    //! the ring is full)
+    void Take(value_type t, value_type dt, const Vec &x, const Sca &tension,
+        const Vec &dx_prev, value_type dt_prev);
+
+    //! Copies the newest snapshot to the state and drops it from the
+    //! ring, returns false when the ring is empty
+    bool Restore(value_type &t, value_type &dt, Vec &x, Sca &tension,
+        Vec &dx_prev, value_type &dt_prev);
+
+    void clear() { size_ = 0; }
+    int size() const { return size_; }
+    int capacity() const { return snaps_.size(); }
+
+    //! The time of the newest snapshot (when size() > 0)
+    value_type newest_time() const;
+
+  private:
+    SnapshotRing(const SnapshotRing &);
+    SnapshotRing& operator=(const SnapshotRing &);
+
+    struct Snapshot{
+        value_type t, dt, dt_prev;
+        Vec x, dx_prev;
+        Sca tension;
+    };
+
+    template<typename Container>
+    static void Copy(const Container &src, Container &dst);
+
+    std::vector<Snapshot*> snaps_;
+    int head_;                  // the slot of the next snapshot
+    int size_;
+};
+
+#include "SnapshotRing.cc"
+
+#endif //_SNAPSHOTRING_H_
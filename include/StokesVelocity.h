@@ -4,6 +4,8 @@
 #include <mpi.h>
 #include "PVFMMInterface.h"
 #include "NearSingular.h"
+#include "VTKWriter.h"
+#include "Telemetry.h"
 #include <matrix.hpp>
 
 template <class Real>
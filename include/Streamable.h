@@ -37,7 +37,12 @@
 
 #include "Error.h"
 #include "Logger.h"
+#include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <stdint.h> //for fixed width integers
 
 /**
  * Base class for streamable objects. Subclasses provide interface for
@@ -67,7 +72,7 @@ class Streamable{
     virtual Error_t unpack(std::istream &is, Format format) = 0;
 
     // ------------------------------------------------------------------------
-    // unimplemented function (should be virtual ... )
+    // buffer interface (the cstring functions are not implemented)
     // ------------------------------------------------------------------------
     //! converts the streamable to an ascii cstring stored in the
     //! buffer. If buffer is NULL, it is allocated. The length of
@@ -76,24 +81,29 @@ class Streamable{
     virtual Error_t pack_cstring(char** buffer, size_t &len, size_t offset) const
     { return ErrorEvent::NotImplementedError; }
 
-    //! Similar to pack_cstring but binary
-    virtual Error_t pack_bin(void** buffer, size_t &len, size_t offset) const
-    { return ErrorEvent::NotImplementedError; }
+    //! Similar to pack_cstring but binary (the BIN format of
+    //! pack). An allocated buffer should be freed by free().
+    virtual Error_t pack_bin(void** buffer, size_t &len, size_t offset) const;
 
     //! Unpack data from ascii buffer to self. This may change the
     //! object's state.
     virtual Error_t unpack_cstring(const char* buffer, size_t len, size_t offset)
     { return ErrorEvent::NotImplementedError; }
 
-    //! Similar to pack_cstring but binary
-    virtual Error_t unpack_bin(const void* buffer, size_t len, size_t offset)
-    { return ErrorEvent::NotImplementedError; }
+    //! Similar to unpack_cstring but binary, len is the length of
+    //! the data after offset
+    virtual Error_t unpack_bin(const void* buffer, size_t len, size_t offset);
+
+    //! Detects the format of the data in the stream (by the magic
+    //! number of the binary header) without consuming it
+    static Format peek_format(std::istream &is);
 
     // ------------------------------------------------------------------------
     // utility function
     // ------------------------------------------------------------------------
 
-    //! pack an array of type T and size n to the stream.
+    //! pack an array of type T and size n to the stream. In the BIN
+    //! format the memory of the array is written as is.
     template<typename T>
     Error_t pack_array(std::ostream &os, Format format, const T* arr, size_t n, const char *sep=" ") const;
 
@@ -105,6 +115,57 @@ class Streamable{
     template<typename T>
     Error_t unpack_array(std::istream &is, Format format, T* arr, size_t &n, const char *sep=" ") const;
 
+    /*
+     * Binary format: each object starts with a header holding a
+     * magic number (also used to detect a different byte order), the
+     * tag of the object (e.g. ARRAY), the version of the code that
+     * wrote it, the format of its fields, and the size of its
+     * floating point type, followed by the fields of the object with
+     * no separator. The fields are positional; when a field is
+     * appended to an object its format is incremented and the reader
+     * only reads the field from data of that format or newer.
+     */
+    static const uint32_t BIN_MAGIC = 0x56334442; // "V3DB"
+    static const int BIN_TAG_LENGTH = 16;
+
+    struct BinHeader{
+        uint32_t magic;
+        char tag[BIN_TAG_LENGTH];
+        int32_t version;
+        int32_t format;
+        int32_t value_size;
+    };
+
+    //! Writes the binary header of an object with given tag,
+    //! value_size (sizeof its floating point type, 0 if none), and
+    //! format of its fields
+    Error_t pack_header(std::ostream &os, const char *tag, int value_size, int format=1) const;
+
+    //! Reads and checks the binary header, the version of the data is
+    //! returned in version. The data should be of the first format.
+    Error_t unpack_header(std::istream &is, const char *tag, int value_size, int &version) const;
+
+    //! Reads and checks the binary header, the format of the data is
+    //! returned in format and data of a format newer than max_format
+    //! is rejected
+    Error_t unpack_header(std::istream &is, const char *tag, int value_size, int &version,
+        int &format, int max_format) const;
+
+    //! pack/unpack one value (of a fixed size type) in the BIN format
+    template<typename T>
+    Error_t pack_value(std::ostream &os, const T &val) const;
+
+    template<typename T>
+    Error_t unpack_value(std::istream &is, T &val) const;
+
+    //! pack/unpack a string (preceded by its length) in the BIN format
+    Error_t pack_string(std::ostream &os, const std::string &str) const;
+    Error_t unpack_string(std::istream &is, std::string &str) const;
+
+    //! The VERSION as a number, incremented when it is marked as
+    //! modified with +
+    static int version_number();
+
   protected:
     std::string name_;
 };
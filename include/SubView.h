@@ -0,0 +1,42 @@
+/**
+ * @file   SubView.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief A container over a range of sub-components of another
+ * container
+ */
+
+#ifndef _SUBVIEW_H_
+#define _SUBVIEW_H_
+
+#include "Logger.h"
+
+/**
+ * SubView is a Scalars or Vectors (Container) that shares the memory
+ * of num_subs sub-components of another container starting from the
+ * sub-component first (e.g. the position of a single vesicle). It can
+ * be passed to any function taking a Container and writing to it
+ * writes to the viewed container. The view does not own the memory,
+ * it should not outlive the viewed container or be used after that
+ * container is resized.
+ *
+ * Resizing the view to a larger size moves its content to a new
+ * memory owned by the view (it is no longer a view).
+ */
+template<typename Container>
+class SubView : public Container
+{
+  public:
+    SubView(Container &c, size_t first, size_t num_subs = 1);
+
+    //! Views another range (or container)
+    void reset(Container &c, size_t first, size_t num_subs = 1);
+
+  private:
+    SubView(const SubView&);
+    SubView& operator=(const SubView&);
+};
+
+#include "SubView.cc"
+
+#endif //_SUBVIEW_H_
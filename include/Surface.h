@@ -14,8 +14,8 @@
 #include "GLIntegrator.h"
 #include "OperatorsMats.h"
 #include "Streamable.h"
+#include "WorkSpace.h"
 
-#include <queue>
 #include <memory>
 
 template <typename ScalarContainer, typename VectorContainer>
@@ -24,6 +24,17 @@ class Surface;
 template <typename S, typename V>
 std::ostream& operator<<(std::ostream& output, const Surface<S, V> &sur);
 
+/**
+ * The extrema of the area and volume over all the surfaces of all
+ * MPI processes, see Surface::areaVolumeStats().
+ */
+template<typename T>
+struct AreaVolumeStats
+{
+    T area, vol;         /* max of |A0| and |V0| (the reference) */
+    T area_err, vol_err; /* max of |A-A0| and |V-V0| */
+};
+
 template <typename ScalarContainer, typename VectorContainer>
 class Surface : public Streamable
 {
@@ -43,12 +54,31 @@ class Surface : public Streamable
     ~Surface();
 
     void setPosition(const Vec_t& x_in);
+
+    //! Exchanges the position with x (no copy), x gets the current
+    //! position (e.g. to be restored by another swap)
+    void swapPosition(Vec_t& x);
+
     int getNumberOfSurfaces() const { return(getPosition().getNumSubs()); }
     int getShOrder() const { return sh_order_; }
 
     Vec_t& getPositionModifiable();
     const Vec_t& getPosition() const;
 
+    /**
+     * Stamp of the position, it changes (and is unique among all
+     * surfaces) whenever the position is set or handed out by
+     * getPositionModifiable().
+     */
+    size_t getPositionVersion() const { return position_version_; }
+
+    /**
+     * The spherical harmonic coefficients of the position, they are
+     * computed once for each position version and shared by the
+     * geometric quantities and resample().
+     */
+    const Vec_t& getPositionCoeffs() const;
+
     const Vec_t& getNormal() const;
     const Sca_t& getAreaElement() const;
     const Sca_t& getMeanCurv() const;
@@ -61,6 +91,37 @@ class Surface : public Streamable
     void volume(Sca_t &vol) const;
     void getCenters(Vec_t &centers) const;
 
+    /**
+     * Area, volume, and the moments of the enclosed volume of all
+     * surfaces in one pass over the geometry. For each surface moms
+     * holds getNumMoments(degree, f!=NULL) consecutive values:
+     *   area, volume,
+     *   centroid x, y, z                    (degree > 0),
+     *   xx, xy, xz, yy, yz, zz second moments about the centroid
+     *   divided by the volume               (degree > 1),
+     *   int(f), int(f^2) over the surface   (f != NULL).
+     */
+    void moments(Arr_t &moms, int degree = 0, const Sca_t *f = NULL) const;
+    static int getNumMoments(int degree, bool with_field = false);
+
+    /**
+     * The net force and the stresslet of the traction f of all
+     * surfaces in one pass. For each surface strs holds 9 values:
+     *   int(f) x, y, z,
+     *   xx, xy, xz, yy, yz, zz of the symmetric first moment of f
+     *   about the centroid, int((x-c)f + f(x-c))/2.
+     */
+    void stresslet(const Vec_t &f, Arr_t &strs) const;
+
+    /**
+     * The global area and volume extrema with a single MPI_Allreduce.
+     * moms is set to the degree zero moments() of this surface and
+     * moms0 (of the same layout) is the reference; when moms0 is NULL
+     * the surface is its own reference.
+     */
+    void areaVolumeStats(AreaVolumeStats<value_type> &stats, Arr_t &moms,
+        const Arr_t *moms0 = NULL) const;
+
     void getSmoothedShapePosition(Vec_t &smthd_pos) const;
     void getSmoothedShapePositionReparam(Vec_t &smthd_pos) const;
     void mapToTangentSpace(Vec_t &vec_fld, bool upsample=true) const;
@@ -73,6 +134,17 @@ class Surface : public Streamable
      * The resampled container will have the same _relative_
      * differentiation frequency, e.g. 2/3, and _absolute_
      * reparametrization frequency, e.g. 4.
+     *
+     * The resampling is done on the (cached) coefficients of the
+     * position, by zero-padding or truncation, followed by a backward
+     * transform of the target order; the coefficients are also passed
+     * to new_surf. The target order can be any order when new_surf is
+     * already constructed, otherwise one with precomputed matrices in
+     * OperatorsMats.
+     *
+     * When new_surf is the result of an earlier resample of this
+     * surface and neither position has changed since (see
+     * getPositionVersion()), it is returned as is with its geometry.
      */
     Error_t resample(int new_sh_freq, Surface **new_surf) const;
 
@@ -112,6 +184,18 @@ class Surface : public Streamable
     mutable bool first_forms_are_stale_;
     mutable bool second_forms_are_stale_;
 
+    // the position stamp, and the stamps of the source and this
+    // surface when this surface was set by the source's resample()
+    size_t position_version_;
+    size_t resampled_src_version_;
+    size_t resampled_version_;
+    static size_t version_counter_;
+
+    // position coefficients and the position version they belong to
+    mutable Vec_t shc_x_;
+    mutable size_t shc_x_version_;
+    void positionChanged();
+
     void updateFirstForms() const;
     void updateAll() const;
     void checkContainers() const;
@@ -122,17 +206,13 @@ class Surface : public Streamable
     ///@todo these can be removed, but updateAll should be rewritten
     mutable Sca_t E, F, G;
 
-    mutable std::queue<Sca_t*> scalar_work_q_;
+    // work containers (of the shape of the position)
+    WorkSpace<Sca_t> sca_work_;
+    WorkSpace<Vec_t> vec_work_;
     std::auto_ptr<Sca_t> checkoutSca() const;
     void recycle(std::auto_ptr<Sca_t> scp) const;
-    mutable int checked_out_work_sca_;
-
-    mutable std::queue<Vec_t*> vector_work_q_;
     std::auto_ptr<Vec_t> checkoutVec() const;
     void recycle(std::auto_ptr<Vec_t> vcp) const;
-    mutable int checked_out_work_vec_;
-
-    void purgeTheWorkSpace() const;
 
     friend std::ostream& operator<< <Sca_t,Vec_t>(std::ostream& output, const Surface &sur);
 };
@@ -0,0 +1,119 @@
+/**
+ * @file   Telemetry.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  Per-step performance records of the time stepping (JSON lines)
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include "Error.h"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A singleton class that collects the counters of each time step
+ * and writes them as one JSON record (one line) per step:
+ *   {"step": 3, "t": 0.3, "dt": 0.1, "advance": 0.2, "dt_next": 0.1,
+ *    "accepted": true,
+ *    "iterations": 12, "residuals": [1.0, 0.1, ...],
+ *    "step_time": {"min": .., "max": .., "avg": ..},
+ *    "fmm": {...}, "near": {...}, ..., "bytes_live": {...},
+ *    "sys_allocs": {...}}
+ *
+ * dt is the time step that is taken (after the adaptive clamp at the
+ * time horizon) and advance the time that the step advances (e.g.
+ * 2*dt with step doubling and 0 for a rejected step).
+ *
+ * The phase times are wall clock seconds of the process (the phases
+ * may nest, e.g. sht in self), the bytes are the live bytes of the
+ * CachingAllocator at the end of the step and sys_allocs the requests
+ * of the step that went to the system. Their minimum, maximum, and
+ * average over the processes are gathered with one reduction and the
+ * first process writes the record with the AsyncWriter. The iterations
+ * and the residual norms are those of the linear solves of the step
+ * on the first process.
+ *
+ * The counters are only kept between Open() and Close() (the Timer is
+ * a no-op otherwise) and the times of the parallel regions are
+ * ignored.
+ */
+class Telemetry
+{
+  public:
+    enum Phase {FMM, Near, Self, SHT, Reparam, AreaVolume, Repartition,
+                IO, NUM_PHASES};
+
+    //! The residual norms kept per step
+    static const size_t MAX_RESIDUALS = 1000;
+
+    //! Starts the records of fname (truncated), an empty name
+    //! disables the telemetry. It is collective.
+    static Error_t Open(const std::string &fname);
+
+    //! Writes the pending records and disables the telemetry
+    static Error_t Close();
+
+    static bool Enabled();
+
+    //! Starts the record of a step from time t
+    static void BeginStep(double t);
+
+    //! Reduces the counters of the step and writes its record, it is
+    //! collective. dt is the time step taken, advance the time that
+    //! the step advanced and dt_next the time step of the next step.
+    static Error_t EndStep(bool accepted, double dt, double advance,
+        double dt_next);
+
+    static void AddTime(Phase phase, double seconds);
+    static void AddIterations(size_t iter);
+    static void AddResidual(double res);
+
+    static const char* PhaseName(Phase phase);
+
+    //! Adds the wall time of its scope to a phase
+    class Timer
+    {
+      public:
+        explicit Timer(Phase phase);
+        ~Timer();
+
+      private:
+        Timer(const Timer &);
+        Timer& operator=(const Timer &);
+
+        Phase phase_;
+        double tic_;
+    };
+
+  private:
+    Telemetry();
+};
+
+#endif //_TELEMETRY_H_
@@ -0,0 +1,136 @@
+/**
+ * @file   Trajectory.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief Compact output of the vesicle shapes over time (truncated
+ * spherical harmonic coefficients) for post-processing. The
+ * implementation is in src/Trajectory.cc.
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _TRAJECTORY_H_
+#define _TRAJECTORY_H_
+
+#include "Error.h"
+#include "Logger.h"
+#include "Enums.h"
+#include "Streamable.h"
+#include "HelperFuns.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+/**
+ * The trajectory of the vesicles as a stream of frames. Each frame
+ * holds the spherical harmonic coefficients of the positions
+ * truncated to the frequency freq (typically the filter_freq of the
+ * simulation, the higher frequencies are filtered anyway), which is
+ * (freq+1)^2-1 coefficients per coordinate instead of the 2p(p+1)
+ * grid points. The stream is (only BIN):
+ *  - the header: the binary header (tag TRAJECTORY), the sh_order
+ *    of the simulation, the truncation frequency, and whether the
+ *    coefficients are quantized,
+ *  - the frames until the end of the stream: the time, the number of
+ *    vesicles, and for each vesicle its ID followed by the
+ *    coefficients of the x, y, and z coordinates ordered as the
+ *    coefficients of order freq (see SHTrans::forward()).
+ *
+ * The coefficients are written in single precision or, when
+ * quantized, the first coefficient (the mean) of each coordinate is
+ * written in single precision and the others as 16 bit integers
+ * scaled by their maximum magnitude (relative error of about 1e-5
+ * of the largest coefficient).
+ *
+ * The positions are reconstructed at any order by zero padding (or
+ * truncating) the coefficients, see ReadFrame().
+ */
+template<typename Container>
+class Trajectory : public Streamable
+{
+  public:
+    typedef typename Container::value_type value_type;
+    typedef typename Container::device_type device_type;
+
+    //! sh_order is the order of the positions and freq the truncation
+    //! frequency (it is not larger than sh_order)
+    Trajectory(int sh_order = 0, int freq = 0, bool quantize = false);
+    ~Trajectory();
+
+    //! Appends a frame of the positions x at time t to os, the IDs
+    //! of the vesicles are first_id, first_id+1, ... The sht should
+    //! be of order sh_order.
+    template<typename SHT>
+    Error_t WriteFrame(std::ostream &os, const SHT &sht, value_type t,
+        size_t first_id, const Container &x);
+
+    //! Appends a frame given the coefficients of the positions (of
+    //! order sh_order)
+    Error_t WriteCoeffs(std::ostream &os, value_type t, size_t first_id,
+        const Container &shc) const;
+
+    //! Reads the next frame and reconstructs the positions at the
+    //! order of sht (x is resized)
+    template<typename SHT>
+    Error_t ReadFrame(std::istream &is, const SHT &sht, value_type &t,
+        std::vector<size_t> &ids, Container &x);
+
+    //! Reads the next frame, the coefficients are set in shc (resized
+    //! to order freq)
+    Error_t ReadCoeffs(std::istream &is, value_type &t,
+        std::vector<size_t> &ids, Container &shc) const;
+
+    //! Whether there is no frame left in the stream
+    static bool AtEnd(std::istream &is);
+
+    int sh_order() const { return sh_order_; }
+    int freq() const { return freq_; }
+    bool quantize() const { return quantize_; }
+
+    //! pack/unpack the header of the stream (only BIN)
+    Error_t pack(std::ostream &os, Streamable::Format format) const;
+    Error_t unpack(std::istream &is, Streamable::Format format);
+
+  private:
+    Trajectory(const Trajectory &);
+    Trajectory& operator=(const Trajectory &);
+
+    //! number of coefficients of each coordinate
+    size_t NumCoeffs() const;
+
+    int sh_order_, freq_;
+    bool quantize_;
+
+    // work space
+    Container shc_, wrk_, shcq_;
+    mutable std::vector<value_type> host_;
+    mutable std::vector<float> fbuf_;
+    mutable std::vector<int16_t> qbuf_;
+};
+
+#include "Trajectory.cc"
+
+#endif //_TRAJECTORY_H_
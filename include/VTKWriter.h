@@ -0,0 +1,106 @@
+/**
+ * @file   VTKWriter.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  Writing the VTK files of the surfaces (and of the velocity
+ * field) of all the processes
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _VTKWRITER_H_
+#define _VTKWRITER_H_
+
+#include "ves3d_common.h"
+#include "Error.h"
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#ifdef HAS_MPI
+
+//! The mesh of one process. The points have three coordinates and
+//! (optionally) the same number of values each, a cell is the list
+//! of its points in connect (local indices) that ends at the
+//! corresponding entry of offset. The cell types are only used for
+//! an unstructured grid.
+struct VTKPiece
+{
+    VTKPiece() : rank_data(false) {}
+
+    std::vector<double> coord;
+    std::vector<double> value;
+    std::vector<int32_t> connect;
+    std::vector<int32_t> offset;
+    std::vector<uint8_t> types;
+    bool rank_data;             ///< add the rank of the points as point data
+};
+
+/**
+ * Writes the pieces of all processes of a communicator in the VTK
+ * XML format (with the raw appended data), either
+ *  - one file per process (fname_<rank>.vtp, the separator is set
+ *    by the caller) and an index file
+ *    (fname.pvtp) written by the first process; the files are
+ *    written by the AsyncWriter, or
+ *  - a single file (fname.vtp) written collectively with MPI-IO:
+ *    the points and cells of the processes are concatenated in the
+ *    order of the ranks, the first process writes the XML header and
+ *    the size of each data array and each process writes its part of
+ *    the arrays. The connectivity is shifted by the points of the
+ *    lower ranks and it is written as 64 bit integers (as the block
+ *    sizes), so that the file is not limited by the number of
+ *    points.
+ * The extensions are .vtu/.pvtu for an unstructured grid. The
+ * coordinates and values are in single precision when single is set.
+ */
+class VTKWriter
+{
+  public:
+    enum MeshType {PolyData, UnstructuredGrid};
+
+    //! Writes the piece of this process, it is collective over comm.
+    //! The file of a piece is fname, piece_sep and the rank.
+    static Error_t Write(const std::string &fname, const VTKPiece &piece,
+        MeshType type, bool collective, bool single, MPI_Comm comm,
+        const char *piece_sep = "_");
+
+  private:
+    VTKWriter();
+
+    // ncomp (the components of the values) and rank_data are the
+    // point data of all the processes
+    static Error_t WritePieces(const std::string &fname, const VTKPiece &piece,
+        int ncomp, bool rank_data, MeshType type, bool single, MPI_Comm comm,
+        const char *piece_sep);
+
+    static Error_t WriteCollective(const std::string &fname, const VTKPiece &piece,
+        int ncomp, bool rank_data, MeshType type, bool single, MPI_Comm comm);
+};
+
+#endif //HAS_MPI
+
+#endif //_VTKWRITER_H_
@@ -75,6 +75,9 @@ class Vectors : public Scalars<T, DT, DEVICE>
     inline void setPointOrder(enum CoordinateOrder new_order);
     inline enum CoordinateOrder getPointOrder() const;
 
+    //! Exchanges the content and the shape with rhs, O(1)
+    inline void swap(Vectors<T, DT, DEVICE> &rhs);
+
     // From streamable class --------------------------------------------------
     // ------------------------------------------------------------------------
     virtual Error_t pack(std::ostream &os, Streamable::Format format) const;
@@ -4,6 +4,7 @@
 #include <typeinfo>
 #include "Enums.h"
 #include "Error.h"
+#include "CachingAllocator.h"
 #include <omp.h>
 /**
  * The gateway function between the local code and FMM code. This
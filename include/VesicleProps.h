@@ -51,6 +51,7 @@ struct VesicleProperties : public Streamable
     VesicleProperties();
     Error_t update();
     T* getPropIdx(int i); /* for loading convenience */
+    const T* getPropIdx(int i) const;
     Error_t setFromParams(Parameters<value_type> &params);
 
     Error_t pack(std::ostream &os, Streamable::Format format) const;
@@ -0,0 +1,91 @@
+/**
+ * @file   WorkSpace.h
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief A pool of work containers shared between the subsystems
+ */
+
+#ifndef _WORKSPACE_H_
+#define _WORKSPACE_H_
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include "Logger.h"
+#include "Spharm.h"
+
+/**
+ * WorkSpace is a handle to the pool of work containers (Scalars or
+ * Vectors) that is shared by all the handles of the same container
+ * type. Each object that needs work containers (e.g. Surface or
+ * InterfacialVelocity) owns a handle with the name of its subsystem
+ * and checks out containers of a given shape.
+ *
+ * The free containers are kept by their capacity and a checkout takes
+ * the smallest one that is large enough, so that containers of
+ * different sizes (e.g. of order p and p_up) are handed out without
+ * reallocation. Once the pool is warm (after the first time step) no
+ * allocation is needed.
+ *
+ * The number of checked out containers, its high-water mark, and the
+ * number of allocations are tracked for each handle, each subsystem
+ * (all the handles with the same name), and the whole pool.
+ */
+template<typename Container>
+class WorkSpace
+{
+  public:
+    struct Stats
+    {
+        Stats() : checked_out(0), high_water(0), allocs(0) {}
+        int checked_out;    ///< containers currently checked out
+        int high_water;     ///< maximum of checked_out
+        size_t allocs;      ///< containers created or grown by checkout
+    };
+    typedef std::map<std::string, Stats> StatsMap_t;
+
+    explicit WorkSpace(const std::string &name);
+    ~WorkSpace();
+
+    /**
+     * A container with the same number of subfields, order, and grid
+     * as shape. The content is not initialized.
+     */
+    template<typename Shape>
+    std::auto_ptr<Container> checkout(const Shape &shape) const;
+    std::auto_ptr<Container> checkout(size_t num_subs, int sh_order,
+        std::pair<int, int> grid_dim = EMPTY_GRID) const;
+    void recycle(std::auto_ptr<Container> c) const;
+
+    const std::string& getName() const { return name_; }
+    const Stats& getStats() const { return stats_; }
+    static const Stats& getPoolStats() { return pool_stats_; }
+    static const StatsMap_t& getSubsystemStats() { return subsystem_stats_; }
+
+    /// Number of free containers and their total capacity (elements)
+    static size_t getNumFree();
+    static size_t getFreeCapacity();
+
+    /// Frees the containers that are not checked out
+    static void purge();
+
+  private:
+    WorkSpace(const WorkSpace&);
+    WorkSpace& operator=(const WorkSpace&);
+
+    void count(int checkout, bool alloc) const;
+
+    std::string name_;
+    mutable Stats stats_;
+    Stats *subsystem_; //entry of this handle in subsystem_stats_
+
+    typedef std::multimap<size_t, Container*> FreeMap_t;
+    static FreeMap_t free_;
+    static Stats pool_stats_;
+    static StatsMap_t subsystem_stats_;
+};
+
+#include "WorkSpace.cc"
+
+#endif //_WORKSPACE_H_
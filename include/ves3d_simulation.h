@@ -41,6 +41,8 @@
 #include "ves3d_common.h"
 #include "Logger.h"
 #include "DataIO.h"
+#include "ParallelCheckpoint.h"
+#include "GeometryFile.h"
 
 #include <fstream>
 #include <sstream>
@@ -66,6 +68,9 @@ class Simulation{
     typedef typename Evolve_t::Mats_t Mats_t;
     typedef BgFlowBase<Vec_t> Flow_t;
     typedef ParallelLinSolver<real_t> LinSol_t;
+#ifdef HAS_MPI
+    typedef ParallelCheckpoint<Vec_t, VProp_t> PCheckpoint_t;
+#endif
 
     Simulation(const Param_t &ip);
     Simulation(int argc, char **argv, const DictString_t *dict);
@@ -80,6 +85,11 @@ class Simulation{
     Error_t setup_basics();
     Error_t setup_from_options();
     Error_t setup_from_checkpoint();
+#ifdef HAS_MPI
+    //! the initial state from a binary geometry file (see GeometryFile)
+    Error_t setup_from_geometry_file(const std::string &fname,
+        const std::vector<value_type> &shapes);
+#endif
     Error_t cleanup_run();
     Error_t prepare_run_params(const Param_t &ip);
     Error_t prepare_run_params(int argc, char **argv, const DictString_t *dict);
@@ -89,6 +99,8 @@ class Simulation{
     std::stringstream checkpoint_data_;
 
     bool load_checkpoint_;
+    Streamable::Format checkpoint_format_; //detected from the checkpoint file
+    std::string parallel_checkpoint_; //the file name when loading a parallel checkpoint
     VProp_t *ves_props_;
     Mats_t *Mats_;
     Flow_t *vInf_;
@@ -2,7 +2,8 @@ template<typename T, typename DT, const DT &DEVICE>
 Array<T, DT, DEVICE>::Array(size_t size) :
     size_(size),
     capacity_(size_),
-    data_((capacity_ > 0) ? (T*) DEVICE.Malloc(capacity_ * sizeof(T)) : NULL)
+    data_((capacity_ > 0) ? (T*) DEVICE.Malloc(capacity_ * sizeof(T)) : NULL),
+    owns_data_(true)
 {
     //to count the number of calls
     PROFILESTART();
@@ -11,7 +12,7 @@ Array<T, DT, DEVICE>::Array(size_t size) :
 
 template<typename T, typename DT, const DT &DEVICE>
 Array<T, DT, DEVICE>::Array(std::istream &is, Format format) :
-    size_(0), capacity_(0), data_(NULL)
+    size_(0), capacity_(0), data_(NULL), owns_data_(true)
 {
     //to count the number of calls
     PROFILESTART();
@@ -24,7 +25,7 @@ Array<T, DT, DEVICE>::~Array()
 {
     //mostly for counting the # of calls
     PROFILESTART();
-    DEVICE.Free(this->data_);
+    if (owns_data_) DEVICE.Free(this->data_);
     PROFILEEND("",0);
 }
 
@@ -46,6 +47,12 @@ size_t Array<T, DT, DEVICE>::mem_size() const
     return(this->size_ * sizeof(T));
 }
 
+template<typename T, typename DT, const DT &DEVICE>
+size_t Array<T, DT, DEVICE>::capacity() const
+{
+    return(this->capacity_);
+}
+
 template<typename T, typename DT, const DT &DEVICE>
 void Array<T, DT, DEVICE>::resize(size_t new_size)
 {
@@ -63,22 +70,48 @@ void Array<T, DT, DEVICE>::resize(size_t new_size)
                 this->mem_size(),
                 DT::MemcpyDeviceToDevice);
 
-            DEVICE.Free(data_);
+            if ( owns_data_ ) DEVICE.Free(data_);
         }
         data_ = data_new;
         capacity_ = new_size;
+        owns_data_ = true;
     }
     else if ( new_size == 0 && data_ != NULL )
     {
-        DEVICE.Free(data_);
+        if ( owns_data_ ) DEVICE.Free(data_);
         data_ = NULL;
         capacity_ = 0;
+        owns_data_ = true;
     }
 
     size_ = new_size;
     PROFILEEND("",0);
 }
 
+template<typename T, typename DT, const DT &DEVICE>
+void Array<T, DT, DEVICE>::swap(Array &rhs)
+{
+    std::swap(size_, rhs.size_);
+    std::swap(capacity_, rhs.capacity_);
+    std::swap(data_, rhs.data_);
+    std::swap(owns_data_, rhs.owns_data_);
+}
+
+template<typename T, typename DT, const DT &DEVICE>
+bool Array<T, DT, DEVICE>::isView() const
+{
+    return(!owns_data_);
+}
+
+template<typename T, typename DT, const DT &DEVICE>
+void Array<T, DT, DEVICE>::setView(T *data, size_t size)
+{
+    if (owns_data_) DEVICE.Free(data_);
+    data_ = data;
+    size_ = capacity_ = size;
+    owns_data_ = false;
+}
+
 template<typename T, typename DT, const DT &DEVICE>
 typename Array<T, DT, DEVICE>::iterator Array<T, DT, DEVICE>::begin()
 {
@@ -106,11 +139,9 @@ typename Array<T, DT, DEVICE>::const_iterator Array<T, DT, DEVICE>::end() const
 template<typename T, typename DT, const DT &DEVICE>
 Error_t Array<T, DT, DEVICE>::pack(std::ostream &os, Format format) const
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
-
     const T *buffer(begin());
 
-    if (DT::IsHost()){
+    if (!DT::IsHost()){
 	T* bb = new T[size()];
 	buffer = bb;
 	DEVICE.Memcpy(
@@ -120,13 +151,20 @@ Error_t Array<T, DT, DEVICE>::pack(std::ostream &os, Format format) const
 	    DT::MemcpyDeviceToHost);
     }
 
-    os<<"ARRAY\n";
-    os<<"version: "<<VERSION<<"\n";
-    os<<"name: "<<Streamable::name_<<"\n";
-    os<<"size: "<<size()<<"\n";
-    os<<"data: ";
-    pack_array(os, format, buffer, size());
-    os<<"\n/ARRAY\n";
+    if (format==Streamable::BIN){
+        CHK(pack_header(os, "ARRAY", sizeof(T)));
+        CHK(pack_string(os, Streamable::name_));
+        CHK(pack_value(os, static_cast<uint64_t>(size())));
+        CHK(pack_array(os, format, buffer, size()));
+    } else {
+        os<<"ARRAY\n";
+        os<<"version: "<<VERSION<<"\n";
+        os<<"name: "<<Streamable::name_<<"\n";
+        os<<"size: "<<size()<<"\n";
+        os<<"data: ";
+        pack_array(os, format, buffer, size());
+        os<<"\n/ARRAY\n";
+    }
 
     if (!DT::IsHost())
 	delete[] buffer;
@@ -137,7 +175,31 @@ Error_t Array<T, DT, DEVICE>::pack(std::ostream &os, Format format) const
 template<typename T, typename DT, const DT &DEVICE>
 Error_t Array<T, DT, DEVICE>::unpack(std::istream &is, Format format)
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        int version(0);
+        uint64_t sz(0);
+        Error_t ierr(unpack_header(is, "ARRAY", sizeof(T), version));
+        if (ierr) return ierr;
+        CHK(unpack_string(is, Streamable::name_));
+        ierr = unpack_value(is, sz);
+        if (ierr) return ierr;
+        resize(sz);
+
+        size_t n(sz);
+        if (DT::IsHost()){
+            CHK(unpack_array(is, format, begin(), n));
+        } else {
+            T* bb = new T[n];
+            Error_t err(unpack_array(is, format, bb, n));
+            DEVICE.Memcpy(begin(), bb, mem_size(), DT::MemcpyHostToDevice);
+            delete[] bb;
+            CHK(err);
+        }
+
+        COUTDEBUG("Unpacked "<<Streamable::name_<<" data from version "<<version<<" (current version "<<VERSION<<")");
+        return ErrorEvent::Success;
+    }
+
     std::string s, key;
     int version(0);
     is>>s;
@@ -0,0 +1,226 @@
+/**
+ * @file   AsyncWriter.cc
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  The implementation of the AsyncWriter class.
+ */
+
+#include "AsyncWriter.h"
+#include "Logger.h"
+
+#include <fstream>
+#include <pthread.h>
+
+namespace {
+    enum BufferState {Free, Pending, Writing};
+
+    struct Buffer
+    {
+        Buffer() : append(false), state(Free) {}
+        std::string fname;
+        std::string content;
+        bool append;
+        BufferState state;
+    };
+
+    // the buffers are filled at tail and written from head (in the
+    // order of submission)
+    Buffer buffers[AsyncWriter::NUM_BUFFERS];
+    int head(0), tail(0);
+
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t buffer_filled = PTHREAD_COND_INITIALIZER;
+    pthread_cond_t buffer_freed = PTHREAD_COND_INITIALIZER;
+    pthread_t writer;
+
+    bool async(true), running(false), stop(false);
+    Error_t write_error(ErrorEvent::Success);
+    WriterStats stats = {0, 0, 0, 0, 0};
+
+    Error_t WriteFile(const std::string &fname, const std::string &content,
+        bool append)
+    {
+        std::ofstream file(fname.c_str(), std::ios::out | std::ios::binary |
+            (append ? std::ios::app : std::ios::trunc));
+        if (!file){
+            CERR("Could not open the file "<<fname);
+            return ErrorEvent::IOError;
+        }
+
+        file.write(content.data(), content.size());
+        file.close();
+        if (file.fail()){
+            CERR("Failed to write the file "<<fname);
+            return ErrorEvent::IOError;
+        }
+        return ErrorEvent::Success;
+    }
+
+    // should be called with the lock held
+    void Record(const std::string &content, double time, Error_t err)
+    {
+        ++stats.files;
+        stats.bytes += content.size();
+        stats.write_time += time;
+        if (err && !write_error) write_error = err;
+    }
+
+    void* WriterLoop(void *)
+    {
+        pthread_mutex_lock(&lock);
+        while (true){
+            while (buffers[head].state != Pending && !stop)
+                pthread_cond_wait(&buffer_filled, &lock);
+
+            // the pending buffers are written before stopping
+            if (buffers[head].state != Pending) break;
+
+            Buffer &buf(buffers[head]);
+            buf.state = Writing;
+            pthread_mutex_unlock(&lock);
+
+            double tic(GETSECONDS());
+            Error_t err(WriteFile(buf.fname, buf.content, buf.append));
+            double toc(GETSECONDS());
+
+            pthread_mutex_lock(&lock);
+            Record(buf.content, toc - tic, err);
+            buf.state = Free;
+            head = (head + 1) % AsyncWriter::NUM_BUFFERS;
+            pthread_cond_broadcast(&buffer_freed);
+        }
+        pthread_mutex_unlock(&lock);
+        return NULL;
+    }
+
+    // writes the pending buffers and joins the thread at exit
+    struct WriterGuard
+    {
+        ~WriterGuard()
+        {
+            pthread_mutex_lock(&lock);
+            stop = true;
+            bool join(running);
+            pthread_cond_signal(&buffer_filled);
+            pthread_mutex_unlock(&lock);
+            if (join) pthread_join(writer, NULL);
+        }
+    } guard;
+}
+
+Error_t AsyncWriter::Submit(const std::string &fname, std::string &content,
+    bool append)
+{
+    pthread_mutex_lock(&lock);
+    if (async && !running){
+        running = (pthread_create(&writer, NULL, &WriterLoop, NULL) == 0);
+        if (!running){
+            WARN("Failed to start the writer thread, the files are written synchronously");
+            async = false;
+        }
+    }
+
+    // when synchronous, the caller is blocked for the whole write
+    if (!async){
+        pthread_mutex_unlock(&lock);
+        double tic(GETSECONDS());
+        Error_t err(WriteFile(fname, content, append));
+        double toc(GETSECONDS());
+
+        pthread_mutex_lock(&lock);
+        Record(content, toc - tic, err);
+        stats.blocked_time += toc - tic;
+        pthread_mutex_unlock(&lock);
+        content.clear();
+        return err;
+    }
+
+    double tic(GETSECONDS());
+    bool blocked(false);
+    while (buffers[tail].state != Free){
+        blocked = true;
+        pthread_cond_wait(&buffer_freed, &lock);
+    }
+
+    if (blocked){
+        ++stats.blocked_calls;
+        stats.blocked_time += GETSECONDS() - tic;
+    }
+
+    Buffer &buf(buffers[tail]);
+    buf.fname = fname;
+    buf.append = append;
+    buf.content.swap(content);
+    content.clear();
+    buf.state = Pending;
+    tail = (tail + 1) % NUM_BUFFERS;
+
+    // the error of the previous writes
+    Error_t err(write_error);
+    write_error = ErrorEvent::Success;
+
+    pthread_cond_signal(&buffer_filled);
+    pthread_mutex_unlock(&lock);
+    return err;
+}
+
+Error_t AsyncWriter::Flush()
+{
+    pthread_mutex_lock(&lock);
+    double tic(GETSECONDS());
+    for (int ii=0; ii<NUM_BUFFERS; ++ii)
+        while (buffers[ii].state != Free)
+            pthread_cond_wait(&buffer_freed, &lock);
+    stats.blocked_time += GETSECONDS() - tic;
+
+    Error_t err(write_error);
+    write_error = ErrorEvent::Success;
+    pthread_mutex_unlock(&lock);
+    return err;
+}
+
+void AsyncWriter::SetAsync(bool async_write)
+{
+    Flush();
+    pthread_mutex_lock(&lock);
+    async = async_write;
+    pthread_mutex_unlock(&lock);
+}
+
+WriterStats AsyncWriter::GetStats()
+{
+    pthread_mutex_lock(&lock);
+    WriterStats st(stats);
+    pthread_mutex_unlock(&lock);
+    return(st);
+}
+
+void AsyncWriter::Report()
+{
+    WriterStats st(GetStats());
+    if (st.files == 0) return;
+
+    INFO("Writer: files = "<<st.files<<", bytes = "<<st.bytes
+        <<", write time = "<<st.write_time<<" s, blocked time = "<<st.blocked_time
+        <<" s ("<<st.blocked_calls<<" calls waited for a buffer)");
+}
+
+BufferStream::BufferStream(std::string &buffer) :
+    std::ostream(NULL),
+    buf_(buffer)
+{
+    rdbuf(&buf_);
+}
+
+BufferStream::Buf::int_type BufferStream::Buf::overflow(int_type c)
+{
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+        buffer_.push_back(traits_type::to_char_type(c));
+    return traits_type::not_eof(c);
+}
+
+std::streamsize BufferStream::Buf::xsputn(const char *s, std::streamsize n)
+{
+    buffer_.append(s, n);
+    return n;
+}
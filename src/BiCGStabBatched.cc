@@ -0,0 +1,168 @@
+template<typename Container, typename MatVec>
+void BiCGStabBatched<Container, MatVec>::SetCoeff(
+    const std::vector<value_type> &c) const
+{
+    size_t ns(active_.size());
+    ch_.resize(ns);
+    for (size_t ii=0; ii<ns; ++ii)
+        ch_[ii] = active_[ii] ? c[ii] : 0;
+
+    coeff_.resize(ns);
+    coeff_.getDevice().Memcpy(coeff_.begin(), &ch_[0],
+        ns * sizeof(value_type), device_type::MemcpyHostToDevice);
+}
+
+template<typename Container, typename MatVec>
+void BiCGStabBatched<Container, MatVec>::Dot(const Container &x,
+    const Container &y, std::vector<value_type> &dot) const
+{
+    AlgebraicDot(x, y, dots_);
+    dot.resize(dots_.size());
+    dots_.getDevice().Memcpy(&dot[0], dots_.begin(),
+        dots_.size() * sizeof(value_type), device_type::MemcpyDeviceToHost);
+}
+
+template<typename Container, typename MatVec>
+void BiCGStabBatched<Container, MatVec>::RelNorm(const Container &x,
+    const std::vector<value_type> &normb, std::vector<value_type> &res) const
+{
+    Dot(x, x, res);
+    for (size_t ii=0; ii<res.size(); ++ii)
+        res[ii] = sqrt(res[ii]) / normb[ii];
+}
+
+template<typename Container, typename MatVec>
+size_t BiCGStabBatched<Container, MatVec>::NumActive() const
+{
+    size_t na(0);
+    for (size_t ii=0; ii<active_.size(); ++ii)
+        na += active_[ii];
+    return na;
+}
+
+template<typename Container, typename MatVec>
+enum BiCGSReturn BiCGStabBatched<Container, MatVec>::operator()(const MatVec &A,
+    Container &x, const Container &b, int &max_iter, value_type &tol) const
+{
+    PROFILESTART();
+    size_t ns(x.getNumSubs());
+    enum BiCGSReturn ret(BiCGSSuccess);
+
+    p.replicate(x);
+    s.replicate(x);
+    t.replicate(x);
+    v.replicate(x);
+    r.replicate(x);
+    rtilde.replicate(x);
+
+    std::vector<value_type> normb(ns), res(ns), c(ns), rho_1(ns);
+    std::vector<value_type> rho_2(ns, 1), alpha(ns, 1), omega(ns, 1);
+    std::vector<value_type> tdots(ns), ttdot(ns);
+    active_.assign(ns, 1);
+    iter_.assign(ns, 0);
+
+    Dot(b, b, normb);
+    for (size_t ii=0; ii<ns; ++ii)
+        normb[ii] = (normb[ii] == 0.0) ? 1.0 : sqrt(normb[ii]);
+
+    A(x, r);
+    axpy((value_type) -1.0, r, b, r);
+    axpy((value_type)  0.0, r, r, rtilde);
+
+    RelNorm(r, normb, res);
+    for (size_t ii=0; ii<ns; ++ii)
+        active_[ii] = (res[ii] > tol);
+
+    for (int i = 1; i <= max_iter && NumActive(); ++i) {
+
+        Dot(rtilde, r, rho_1);
+        for (size_t ii=0; ii<ns; ++ii){
+            if (!active_[ii]) continue;
+            iter_[ii] = i;
+            if ( res[ii] != res[ii] ){
+                ret = RelresIsNan;
+                active_[ii] = 0;
+            } else if ( rho_1[ii] == 0 ){
+                ret = BreakDownRhoZero;
+                active_[ii] = 0;
+            }
+        }
+
+        // p = r + beta * (p - omega * v)
+        if (i == 1)
+            axpy((value_type) 0.0, r, r, p);
+        else {
+            for (size_t ii=0; ii<ns; ++ii) c[ii] = -omega[ii];
+            SetCoeff(c);
+            axpy(coeff_, v, p, p);
+
+            for (size_t ii=0; ii<ns; ++ii)
+                c[ii] = (rho_1[ii]/rho_2[ii]) * (alpha[ii]/omega[ii]);
+            SetCoeff(c);
+            axpy(coeff_, p, r, p);
+        }
+
+        A(p, v);
+        Dot(rtilde, v, tdots);
+        for (size_t ii=0; ii<ns; ++ii){
+            alpha[ii] = active_[ii] ? rho_1[ii] / tdots[ii] : 0;
+            c[ii]     = -alpha[ii];
+        }
+        SetCoeff(c);
+        axpy(coeff_, v, r, s);
+
+        // the blocks that converge at the half step only take the
+        // alpha update and are masked for the rest
+        SetCoeff(alpha);
+        axpy(coeff_, p, x, x);
+
+        RelNorm(s, normb, res);
+        for (size_t ii=0; ii<ns; ++ii)
+            if (active_[ii] && res[ii] < tol) active_[ii] = 0;
+
+        if (!NumActive()) break;
+
+        A(s, t);
+        Dot(t, s, tdots);
+        Dot(t, t, ttdot);
+        for (size_t ii=0; ii<ns; ++ii){
+            omega[ii] = (active_[ii] && ttdot[ii] != 0) ? tdots[ii] / ttdot[ii] : 0;
+            c[ii]     = -omega[ii];
+        }
+        SetCoeff(omega);
+        axpy(coeff_, s, x, x);
+
+        // r = s - omega * t (r = s for masked blocks)
+        SetCoeff(c);
+        axpy(coeff_, t, s, r);
+
+        rho_2 = rho_1;
+        RelNorm(r, normb, res);
+        for (size_t ii=0; ii<ns; ++ii){
+            if (!active_[ii]) continue;
+            if (res[ii] < tol){
+                active_[ii] = 0;
+            } else if (omega[ii] == 0){
+                ret = BreakDownOmegaZero;
+                active_[ii] = 0;
+            }
+        }
+        COUTDEBUG("BiCGStabBatched: iter = "<<i<<", active blocks = "<<NumActive());
+    }
+
+    if ( NumActive() && ret == BiCGSSuccess )
+        ret = MaxIterReached;
+
+    tol      = 0;
+    max_iter = 0;
+    for (size_t ii=0; ii<ns; ++ii){
+        tol      = (res[ii] > tol) ? res[ii] : tol;
+        max_iter = (iter_[ii] > max_iter) ? iter_[ii] : max_iter;
+    }
+
+    COUTDEBUG("BiCGStabBatched: "<<ret<<", max iter = "<<max_iter
+        <<", max relres = "<<SCI_PRINT_FRMT<<tol);
+    PROFILEEND("",0);
+
+    return ret;
+}
@@ -0,0 +1,365 @@
+/**
+ * @file   CachingAllocator.cc
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  The implementation of the CachingAllocator class.
+ */
+
+#include "CachingAllocator.h"
+#include "Logger.h"
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include <pthread.h>
+#include <sys/mman.h>
+
+namespace memory{
+
+    bool CachingAllocator::use_huge_pages_(false);
+    size_t CachingAllocator::cache_limit_(size_t(1) << 30);
+    int CachingAllocator::phase_(0);
+    int CachingAllocator::num_phases_(1);
+    std::string CachingAllocator::phase_names_[MAX_PHASES] = {"setup"};
+    AllocStats CachingAllocator::stats_ = {0, 0, 0, 0, 0};
+    AllocStats CachingAllocator::phase_stats_[MAX_PHASES];
+
+    namespace {
+        // free blocks of one thread, by size class. The free lists
+        // are only used by the thread, the blocks that other threads
+        // free are put in remote (under the lock) and the thread
+        // moves them to its free lists.
+        struct ThreadCache
+        {
+            ThreadCache() : cached(0), remote_bytes(0), orphan(false)
+            {
+                pthread_mutex_init(&lock, NULL);
+            }
+
+            std::map<size_t, std::vector<void*> > free_list;
+            size_t cached;
+
+            pthread_mutex_t lock;
+            std::vector<void*> remote;
+            size_t remote_bytes;
+            bool orphan;        // the thread has exited
+        };
+
+        // the caches are never deleted so that the containers that
+        // are destroyed at exit can still return their memory, the
+        // cache of an exited thread is reused by a new thread
+        __thread ThreadCache *thread_cache(NULL);
+        ThreadCache *all_caches[CachingAllocator::MAX_THREADS];
+        int num_caches(0);
+        pthread_key_t cache_key;
+        pthread_once_t cache_key_once = PTHREAD_ONCE_INIT;
+
+        // the bytes in the caches of all the threads (it is updated
+        // when a thread exits)
+        size_t cached_bytes(0);
+
+        // the names of the phases
+        pthread_mutex_t phase_lock = PTHREAD_MUTEX_INITIALIZER;
+
+        void AddTo(size_t *counter, size_t n) { __sync_fetch_and_add(counter, n); }
+        void SubFrom(size_t *counter, size_t n) { __sync_fetch_and_sub(counter, n); }
+
+        void Raise(size_t *peak, size_t val)
+        {
+            size_t old(*peak);
+            while (old < val){
+                size_t prev(__sync_val_compare_and_swap(peak, old, val));
+                if (prev == old) break;
+                old = prev;
+            }
+        }
+
+        // The size class is stored in the first word of the block,
+        // the cache of the allocating thread in the second, and the
+        // user pointer is ALIGNMENT bytes after the start
+        void* SystemMalloc(size_t size, bool huge, ThreadCache *owner)
+        {
+            size_t alignment(CachingAllocator::ALIGNMENT);
+            size_t length(size + CachingAllocator::ALIGNMENT);
+            huge = huge && (size >= CachingAllocator::HUGE_PAGE_SIZE);
+            if (huge) alignment = CachingAllocator::HUGE_PAGE_SIZE;
+
+            void *base(NULL);
+            if (posix_memalign(&base, alignment, length) != 0)
+                return(NULL);
+
+#ifdef MADV_HUGEPAGE
+            if (huge) madvise(base, length, MADV_HUGEPAGE);
+#endif
+            static_cast<size_t*>(base)[0] = size;
+            static_cast<ThreadCache**>(base)[1] = owner;
+            return(static_cast<char*>(base) + CachingAllocator::ALIGNMENT);
+        }
+
+        void* BlockBase(void *ptr)
+        {
+            return(static_cast<char*>(ptr) - CachingAllocator::ALIGNMENT);
+        }
+
+        size_t BlockSize(void *ptr)
+        {
+            return(static_cast<size_t*>(BlockBase(ptr))[0]);
+        }
+
+        ThreadCache* BlockOwner(void *ptr)
+        {
+            return(static_cast<ThreadCache**>(BlockBase(ptr))[1]);
+        }
+
+        // releases the blocks of the cache to the system, the lock of
+        // the cache is held
+        void ReleaseBlocks(ThreadCache *tc)
+        {
+            std::map<size_t, std::vector<void*> >::iterator it(tc->free_list.begin());
+            for ( ; it != tc->free_list.end(); ++it){
+                for (size_t jj=0; jj<it->second.size(); ++jj)
+                    ::free(BlockBase(it->second[jj]));
+                SubFrom(&cached_bytes, it->first * it->second.size());
+            }
+            tc->free_list.clear();
+            tc->cached = 0;
+
+            for (size_t jj=0; jj<tc->remote.size(); ++jj)
+                ::free(BlockBase(tc->remote[jj]));
+            SubFrom(&cached_bytes, tc->remote_bytes);
+            tc->remote.clear();
+            tc->remote_bytes = 0;
+        }
+
+        // moves the blocks freed by other threads to the free lists
+        void Reclaim(ThreadCache *tc)
+        {
+            pthread_mutex_lock(&tc->lock);
+            for (size_t jj=0; jj<tc->remote.size(); ++jj)
+                tc->free_list[BlockSize(tc->remote[jj])].push_back(tc->remote[jj]);
+            tc->cached += tc->remote_bytes;
+            tc->remote.clear();
+            tc->remote_bytes = 0;
+            pthread_mutex_unlock(&tc->lock);
+        }
+
+        // the destructor of the thread's cache key, the cache waits
+        // for a new thread
+        void ReleaseThreadCache(void *arg)
+        {
+            ThreadCache *tc(static_cast<ThreadCache*>(arg));
+            pthread_mutex_lock(&tc->lock);
+            ReleaseBlocks(tc);
+            tc->orphan = true;
+            pthread_mutex_unlock(&tc->lock);
+            thread_cache = NULL;
+        }
+
+        void CreateCacheKey()
+        {
+            pthread_key_create(&cache_key, &ReleaseThreadCache);
+        }
+
+        ThreadCache* GetThreadCache()
+        {
+            if (thread_cache != NULL) return(thread_cache);
+
+            pthread_once(&cache_key_once, &CreateCacheKey);
+            int nc(num_caches < CachingAllocator::MAX_THREADS ?
+                num_caches : CachingAllocator::MAX_THREADS);
+            for (int ii=0; ii<nc && thread_cache == NULL; ++ii){
+                ThreadCache *tc(all_caches[ii]);
+                if (tc == NULL) continue;
+                pthread_mutex_lock(&tc->lock);
+                if (tc->orphan){
+                    tc->orphan = false;
+                    thread_cache = tc;
+                }
+                pthread_mutex_unlock(&tc->lock);
+            }
+
+            if (thread_cache == NULL){
+                thread_cache = new ThreadCache;
+                int idx(__sync_fetch_and_add(&num_caches, 1));
+                if (idx < CachingAllocator::MAX_THREADS)
+                    all_caches[idx] = thread_cache;
+            }
+            pthread_setspecific(cache_key, thread_cache);
+            return(thread_cache);
+        }
+    }
+
+    void* CachingAllocator::Malloc(size_t length)
+    {
+        if (length == 0) return(NULL);
+
+        size_t size(SizeClass(length));
+        ThreadCache *tc(GetThreadCache());
+        AllocStats &ps(phase_stats_[CurrentPhase()]);
+        void *ptr(NULL);
+
+        // on a miss, the blocks that other threads returned are
+        // moved to the free lists first
+        std::map<size_t, std::vector<void*> >::iterator it(tc->free_list.find(size));
+        if (it == tc->free_list.end() || it->second.empty()){
+            Reclaim(tc);
+            it = tc->free_list.find(size);
+        }
+
+        if (it != tc->free_list.end() && !it->second.empty()){
+            ptr = it->second.back();
+            it->second.pop_back();
+            tc->cached -= size;
+            SubFrom(&cached_bytes, size);
+        } else {
+            ptr = SystemMalloc(size, use_huge_pages_, tc);
+            if (ptr == NULL){
+                CERR("Failed to allocate "<<length<<" bytes");
+                return(NULL);
+            }
+            AddTo(&stats_.sys_allocs, 1);
+            AddTo(&ps.sys_allocs, 1);
+        }
+
+        AddTo(&stats_.requests, 1);
+        AddTo(&ps.requests, 1);
+        AddTo(&stats_.live, size);
+        AddTo(&ps.live, size);
+        Raise(&stats_.peak, stats_.live);
+        Raise(&ps.peak, stats_.live);
+
+        return(ptr);
+    }
+
+    void CachingAllocator::Free(void *ptr)
+    {
+        if (ptr == NULL) return;
+
+        size_t size(BlockSize(ptr));
+        ThreadCache *tc(GetThreadCache()), *owner(BlockOwner(ptr));
+        SubFrom(&stats_.live, size);
+        SubFrom(&phase_stats_[CurrentPhase()].live, size);
+
+        bool keep(false);
+        if (owner == tc){
+            keep = (tc->cached + size <= cache_limit_);
+            if (keep){
+                tc->free_list[size].push_back(ptr);
+                tc->cached += size;
+            }
+        } else {
+            // a block of another thread is handed back to its cache
+            pthread_mutex_lock(&owner->lock);
+            keep = !owner->orphan && (owner->remote_bytes + size <= cache_limit_);
+            if (keep){
+                owner->remote.push_back(ptr);
+                owner->remote_bytes += size;
+            }
+            pthread_mutex_unlock(&owner->lock);
+        }
+
+        if (keep)
+            AddTo(&cached_bytes, size);
+        else
+            ::free(BlockBase(ptr));
+    }
+
+    size_t CachingAllocator::SizeClass(size_t length)
+    {
+        if (length <= ALIGNMENT) return(ALIGNMENT);
+
+        // four classes per power of two, multiple of ALIGNMENT
+        int msb(0);
+        while ((length - 1) >> (msb + 1)) ++msb;
+        size_t step(size_t(1) << (msb > 2 ? msb - 2 : 0));
+        step = (step < ALIGNMENT) ? ALIGNMENT : step;
+
+        return((length + step - 1) / step * step);
+    }
+
+    void CachingAllocator::SetHugePages(bool use_huge_pages)
+    {
+        use_huge_pages_ = use_huge_pages;
+    }
+
+    void CachingAllocator::SetCacheLimit(size_t bytes)
+    {
+        cache_limit_ = bytes;
+    }
+
+    int CachingAllocator::SetPhase(const std::string &name)
+    {
+        pthread_mutex_lock(&phase_lock);
+        int idx(0);
+        while (idx < num_phases_ && phase_names_[idx] != name) ++idx;
+
+        if (idx == num_phases_){
+            if (num_phases_ == MAX_PHASES){
+                idx = CurrentPhase();
+                WARN("Too many allocation phases, "<<name<<" is counted in "<<phase_names_[idx]);
+                pthread_mutex_unlock(&phase_lock);
+                return(idx);
+            }
+            phase_names_[num_phases_++] = name;
+        }
+
+        // the threads that allocate read the phase without the lock
+        __atomic_store_n(&phase_, idx, __ATOMIC_RELEASE);
+        Raise(&phase_stats_[idx].peak, stats_.live);
+        pthread_mutex_unlock(&phase_lock);
+        return(idx);
+    }
+
+    int CachingAllocator::CurrentPhase()
+    {
+        return(__atomic_load_n(&phase_, __ATOMIC_ACQUIRE));
+    }
+
+    AllocStats CachingAllocator::GetStats()
+    {
+        AllocStats st(stats_);
+        st.cached = cached_bytes;
+        return(st);
+    }
+
+    AllocStats CachingAllocator::GetPhaseStats(const std::string &name)
+    {
+        AllocStats st = {0, 0, 0, 0, 0};
+        pthread_mutex_lock(&phase_lock);
+        for (int ii=0; ii<num_phases_; ++ii)
+            if (phase_names_[ii] == name)
+                st = phase_stats_[ii];
+        pthread_mutex_unlock(&phase_lock);
+        return(st);
+    }
+
+    void CachingAllocator::Report()
+    {
+        AllocStats st(GetStats());
+        INFO("Allocator: live = "<<st.live<<" B, peak = "<<st.peak
+            <<" B, cached = "<<st.cached<<" B, requests = "<<st.requests
+            <<", system allocations = "<<st.sys_allocs);
+
+        pthread_mutex_lock(&phase_lock);
+        for (int ii=0; ii<num_phases_; ++ii){
+            const AllocStats &ps(phase_stats_[ii]);
+            if (ps.requests == 0) continue;
+            INFO("  phase "<<phase_names_[ii]<<": net = "<<(long) ps.live
+                <<" B, peak = "<<ps.peak<<" B, requests = "<<ps.requests
+                <<", system allocations = "<<ps.sys_allocs);
+        }
+        pthread_mutex_unlock(&phase_lock);
+    }
+
+    void CachingAllocator::Purge()
+    {
+        int nc(num_caches < MAX_THREADS ? num_caches : MAX_THREADS);
+        for (int ii=0; ii<nc; ++ii){
+            ThreadCache *tc(all_caches[ii]);
+            if (tc == NULL) continue;
+            pthread_mutex_lock(&tc->lock);
+            ReleaseBlocks(tc);
+            pthread_mutex_unlock(&tc->lock);
+        }
+    }
+}
@@ -76,7 +76,7 @@ bool DataIO::ResizeOutBuffer(size_t buffer_size) const
 
 Error_t DataIO::SlurpFile(const char* fname, std::ostream &content)
 {
-    std::ifstream fh(fname, std::ios::in);
+    std::ifstream fh(fname, std::ios::in | std::ios::binary);
 
     if(!fh)
 	CERR_LOC("Cannot open file for reading: "<<fname, "", exit(1));
@@ -89,7 +89,7 @@ Error_t DataIO::SlurpFile(const char* fname, std::ostream &content)
 
 Error_t DataIO::DumpFile(const char* fname, std::ostream &content)
 {
-    std::ofstream fh(fname, std::ios::out);
+    std::ofstream fh(fname, std::ios::out | std::ios::binary);
 
     if(!fh)
 	CERR_LOC("Cannot open file for writing: "<<fname, "", exit(1));
@@ -20,7 +20,7 @@ template<>
 void* Device<CPU>::Malloc(size_t length) const
 {
     PROFILESTART();
-    void* ptr = ::malloc(length);
+    void* ptr = memory::CachingAllocator::Malloc(length);
     PROFILEEND("CPU",0);
     return(ptr);
 }
@@ -29,7 +29,7 @@ template<>
 void Device<CPU>::Free(void* ptr) const
 {
     PROFILESTART();
-    ::free(ptr);
+    memory::CachingAllocator::Free(ptr);
     ptr = 0;
     PROFILEEND("CPU",0);
 }
@@ -38,7 +38,8 @@ template<>
 void* Device<CPU>::Calloc(size_t num, size_t size) const
 {
     PROFILESTART();
-    void * ptr = ::calloc(num, size);
+    void * ptr = memory::CachingAllocator::Malloc(num * size);
+    if (ptr != NULL) ::memset(ptr, 0, num * size);
     PROFILEEND("CPU",0);
     return(ptr);
 }
@@ -296,6 +297,38 @@ T*  Device<CPU>::apx(const T* a_in, const T* x_in, size_t stride,
     return apx_out;
 }
 
+template<>
+template<typename T>
+T*  Device<CPU>::axpy(const T* a_in, const T* x_in, const T* y_in,
+    size_t stride, size_t n_subs, T* axpy_out) const
+{
+    PROFILESTART();
+    assert(a_in != NULL || n_subs == 0);
+    assert(x_in != NULL || n_subs == 0);
+
+    if(y_in !=NULL)
+    {
+#pragma omp parallel for
+        for (size_t ii = 0; ii < n_subs; ++ii)
+            for(size_t jj=0; jj < stride; ++jj)
+                axpy_out[ii * stride + jj] = a_in[ii] * x_in[ii * stride + jj]
+                    + y_in[ii * stride + jj];
+
+        PROFILEEND("CPU", 2 * stride * n_subs);
+    }
+    else
+    {
+#pragma omp parallel for
+        for (size_t ii = 0; ii < n_subs; ++ii)
+            for(size_t jj=0; jj < stride; ++jj)
+                axpy_out[ii * stride + jj] = a_in[ii] * x_in[ii * stride + jj];
+
+        PROFILEEND("CPU", stride * n_subs);
+    }
+
+    return axpy_out;
+}
+
 template<>
 template<typename T>
 T*  Device<CPU>::avpw(const T* a_in, const T*  v_in, const T*  w_in, size_t stride, size_t num_surfs, T*  avpw_out) const
@@ -624,6 +657,242 @@ T Device<CPU>::AlgebraicDot(const T* x, const T* y, size_t length) const
     return(dot);
 }
 
+template<>
+template<typename T>
+T* Device<CPU>::AlgebraicDot(const T* x, const T* y, size_t stride,
+    size_t n_subs, T* dot_out) const
+{
+    PROFILESTART();
+
+#pragma omp parallel for
+    for (size_t ii = 0; ii < n_subs; ++ii){
+        T dot(0.0);
+        for(size_t jj=0; jj < stride; ++jj)
+            dot += x[ii * stride + jj] * y[ii * stride + jj];
+        dot_out[ii] = dot;
+    }
+
+    PROFILEEND("CPU", 2 * stride * n_subs);
+    return(dot_out);
+}
+
+template<>
+template<typename T>
+void Device<CPU>::FundamentalForms(const T* du, const T* dv, const T* duv,
+    const T* d2u, const T* d2v, size_t stride, size_t n_surfs,
+    T* E, T* F, T* G, T* w, T* normal, T* cu, T* cv, T* h,
+    T* k) const
+{
+    PROFILESTART();
+    assert(DIM==3);
+    bool second(duv != NULL && d2u != NULL && d2v != NULL);
+
+#pragma omp parallel
+    {
+        T xu[DIM], xv[DIM], n[DIM];
+        T e, f, g, W2, W, L, M, N;
+        size_t base, resbase, idx, surf, s;
+
+#pragma omp for
+        for (surf = 0; surf < n_surfs; surf++) {
+            resbase = surf * stride;
+            base = resbase * DIM;
+            for(s = 0; s < stride; s++) {
+                for(int dd=0;dd<DIM;++dd)
+                {
+                    xu[dd] = du[base + s + dd * stride];
+                    xv[dd] = dv[base + s + dd * stride];
+                }
+
+                // First fundamental coefficients and area element
+                e = xu[0] * xu[0] + xu[1] * xu[1] + xu[2] * xu[2];
+                f = xu[0] * xv[0] + xu[1] * xv[1] + xu[2] * xv[2];
+                g = xv[0] * xv[0] + xv[1] * xv[1] + xv[2] * xv[2];
+                W2 = e * g - f * f;
+                W  = ::sqrt(W2);
+                e /= W2;
+                f /= W2;
+                g /= W2;
+
+                n[0] = (xu[1] * xv[2] - xu[2] * xv[1]) / W;
+                n[1] = (xu[2] * xv[0] - xu[0] * xv[2]) / W;
+                n[2] = (xu[0] * xv[1] - xu[1] * xv[0]) / W;
+
+                idx = resbase + s;
+                E[idx] = e;
+                F[idx] = f;
+                G[idx] = g;
+                w[idx] = W;
+
+                //Div and Grad coefficients
+                for(int dd=0;dd<DIM;++dd)
+                {
+                    normal[base + s + dd * stride] = n[dd];
+                    cu[base + s + dd * stride] = g * xu[dd] - f * xv[dd];
+                    cv[base + s + dd * stride] = e * xv[dd] - f * xu[dd];
+                }
+
+                if (!second) continue;
+
+                // Second fundamental coefficients
+                L = M = N = 0;
+                for(int dd=0;dd<DIM;++dd)
+                {
+                    L += d2u[base + s + dd * stride] * n[dd];
+                    M += duv[base + s + dd * stride] * n[dd];
+                    N += d2v[base + s + dd * stride] * n[dd];
+                }
+                h[idx] = (e * N + g * L) / 2 - f * M;
+                k[idx] = (L * N - M * M) / W2;
+            }
+        }
+    }
+
+    PROFILEEND("CPU", (second ? 60 : 40) * stride * n_surfs);
+}
+
+template<>
+template<typename T>
+void Device<CPU>::SurfaceMoments(const T* x, const T* normal,
+    const T* w, const T* quad_w, const T* f, size_t stride,
+    size_t n_surfs, int degree, T* moms) const
+{
+    PROFILESTART();
+    assert(DIM==3);
+    int n_moms(2 + (degree > 0) * DIM + (degree > 1) * 6 + (f != NULL) * 2);
+
+#pragma omp parallel
+    {
+        // the volume integrals are from the divergence theorem,
+        // int_V x^a dV = int_S x^a (x.n) dA / (3 + |a|)
+        T m[13];
+        T xx[DIM], wq, xn, fw;
+        size_t base, resbase, surf, s;
+
+#pragma omp for
+        for (surf = 0; surf < n_surfs; surf++) {
+            resbase = surf * stride;
+            base = resbase * DIM;
+            for(int ii=0; ii<13; ++ii) m[ii] = 0;
+
+            for(s = 0; s < stride; s++) {
+                xn = 0;
+                for(int dd=0;dd<DIM;++dd)
+                {
+                    xx[dd] = x[base + s + dd * stride];
+                    xn    += xx[dd] * normal[base + s + dd * stride];
+                }
+                wq = w[resbase + s] * quad_w[s];
+
+                m[0] += wq;
+                m[1] += xn * wq;
+                xn   *= wq;
+                if (degree > 0)
+                    for(int dd=0;dd<DIM;++dd)
+                        m[2 + dd] += xx[dd] * xn;
+                if (degree > 1){
+                    m[5]  += xx[0] * xx[0] * xn;
+                    m[6]  += xx[0] * xx[1] * xn;
+                    m[7]  += xx[0] * xx[2] * xn;
+                    m[8]  += xx[1] * xx[1] * xn;
+                    m[9]  += xx[1] * xx[2] * xn;
+                    m[10] += xx[2] * xx[2] * xn;
+                }
+                if (f != NULL){
+                    fw     = f[resbase + s] * wq;
+                    m[11] += fw;
+                    m[12] += fw * f[resbase + s];
+                }
+            }
+
+            T *out(moms + surf * n_moms), vol(m[1] / 3);
+            *out++ = m[0];
+            *out++ = vol;
+
+            // centroid and the second moments about it (per unit volume)
+            T c[DIM];
+            for(int dd=0;dd<DIM;++dd)
+                c[dd] = m[2 + dd] / 4 / vol;
+            if (degree > 0)
+                for(int dd=0;dd<DIM;++dd)
+                    *out++ = c[dd];
+            if (degree > 1)
+                for(int ii=0, kk=5; ii<DIM; ++ii)
+                    for(int jj=ii; jj<DIM; ++jj, ++kk)
+                        *out++ = m[kk] / 5 / vol - c[ii] * c[jj];
+            if (f != NULL){
+                *out++ = m[11];
+                *out++ = m[12];
+            }
+        }
+    }
+
+    PROFILEEND("CPU", (8 + (degree > 0) * 3 + (degree > 1) * 12 +
+            (f != NULL) * 3) * stride * n_surfs);
+}
+
+template<>
+template<typename T>
+void Device<CPU>::SurfaceStresslet(const T* x, const T* normal,
+    const T* w, const T* quad_w, const T* f, size_t stride,
+    size_t n_surfs, T* strs) const
+{
+    PROFILESTART();
+    assert(DIM==3);
+
+#pragma omp parallel
+    {
+        // the centroid is from the same pass (see SurfaceMoments()),
+        // int (x-c)f = int xf - c int f
+        T m[4], fi[DIM], xf[DIM][DIM];
+        T xx[DIM], ff[DIM], wq, xn;
+        size_t base, resbase, surf, s;
+
+#pragma omp for
+        for (surf = 0; surf < n_surfs; surf++) {
+            resbase = surf * stride;
+            base = resbase * DIM;
+            for(int ii=0; ii<4; ++ii) m[ii] = 0;
+            for(int ii=0; ii<DIM; ++ii){
+                fi[ii] = 0;
+                for(int jj=0; jj<DIM; ++jj) xf[ii][jj] = 0;
+            }
+
+            for(s = 0; s < stride; s++) {
+                xn = 0;
+                for(int dd=0;dd<DIM;++dd)
+                {
+                    xx[dd] = x[base + s + dd * stride];
+                    ff[dd] = f[base + s + dd * stride];
+                    xn    += xx[dd] * normal[base + s + dd * stride];
+                }
+                wq  = w[resbase + s] * quad_w[s];
+                xn *= wq;
+
+                m[0] += xn;
+                for(int ii=0;ii<DIM;++ii){
+                    m[1 + ii] += xx[ii] * xn;
+                    fi[ii]    += ff[ii] * wq;
+                    for(int jj=0;jj<DIM;++jj)
+                        xf[ii][jj] += xx[ii] * ff[jj] * wq;
+                }
+            }
+
+            T *out(strs + surf * 9), c[DIM];
+            for(int dd=0;dd<DIM;++dd){
+                c[dd]  = m[1 + dd] / 4 / (m[0] / 3);
+                *out++ = fi[dd];
+            }
+            for(int ii=0; ii<DIM; ++ii)
+                for(int jj=ii; jj<DIM; ++jj)
+                    *out++ = (xf[ii][jj] + xf[jj][ii]) / 2 -
+                        (c[ii] * fi[jj] + c[jj] * fi[ii]) / 2;
+        }
+    }
+
+    PROFILEEND("CPU", 33 * stride * n_surfs);
+}
+
 template<>
 template<typename T>
 bool Device<CPU>::isNumeric(const T* x, size_t length) const
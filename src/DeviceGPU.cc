@@ -167,6 +167,26 @@ T*  Device<GPU>::axpy(T a_in, const T*  x_in, const T*  y_in,
     return axpy_out;
 }
 
+// the scales are in device memory, they are copied to the host and
+// each field is a call of the kernel
+template<>
+template<typename T>
+T*  Device<GPU>::axpy(const T* a_in, const T* x_in, const T* y_in,
+    size_t stride, size_t n_subs, T* axpy_out) const
+{
+    PROFILESTART();
+    std::vector<T> a(n_subs);
+    if (n_subs)
+        Memcpy(&a[0], a_in, n_subs * sizeof(T), MemcpyDeviceToHost);
+
+    for (size_t ii = 0; ii < n_subs; ++ii)
+        axpy(a[ii], x_in + ii * stride, y_in ? y_in + ii * stride : NULL,
+            stride, axpy_out + ii * stride);
+
+    PROFILEEND("GPU", 0);
+    return axpy_out;
+}
+
 template<>
 template<typename T>
 T* Device<GPU>::apx(const T* a_in, const T* x_in, size_t stride,
@@ -302,6 +322,55 @@ T Device<GPU>::AlgebraicDot(const T* x, const T* y, size_t length) const
     return(dot);
 }
 
+// The fused surface kernels have no GPU version yet, they submit an
+// error (so that the run stops) and leave the output untouched
+template<>
+template<typename T>
+void Device<GPU>::FundamentalForms(const T* du, const T* dv, const T* duv,
+    const T* d2u, const T* d2v, size_t stride, size_t n_surfs,
+    T* E, T* F, T* G, T* w, T* normal, T* cu, T* cv, T* h,
+    T* k) const
+{
+    CERR("FundamentalForms is not implemented on the GPU");
+    CHK(ErrorEvent::NotImplementedError);
+}
+
+template<>
+template<typename T>
+void Device<GPU>::SurfaceMoments(const T* x, const T* normal, const T* w,
+    const T* quad_w, const T* f, size_t stride, size_t n_surfs,
+    int degree, T* moms) const
+{
+    CERR("SurfaceMoments is not implemented on the GPU");
+    CHK(ErrorEvent::NotImplementedError);
+}
+
+template<>
+template<typename T>
+void Device<GPU>::SurfaceStresslet(const T* x, const T* normal, const T* w,
+    const T* quad_w, const T* f, size_t stride, size_t n_surfs,
+    T* strs) const
+{
+    CERR("SurfaceStresslet is not implemented on the GPU");
+    CHK(ErrorEvent::NotImplementedError);
+}
+
+template<>
+template<typename T>
+T* Device<GPU>::AlgebraicDot(const T* x, const T* y, size_t stride,
+    size_t n_subs, T* dot_out) const
+{
+    PROFILESTART();
+    std::vector<T> dot(n_subs);
+    for (size_t ii = 0; ii < n_subs; ++ii)
+        dot[ii] = AlgebraicDotGpu(x + ii * stride, y + ii * stride, stride);
+
+    if (n_subs)
+        Memcpy(dot_out, &dot[0], n_subs * sizeof(T), MemcpyHostToDevice);
+    PROFILEEND("GPU", 2 * stride * n_subs);
+    return(dot_out);
+}
+
 template<>
 Device<GPU>::~Device()
 {
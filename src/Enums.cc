@@ -22,6 +22,10 @@ enum SolverScheme EnumifyScheme(const char * name)
       return JacobiBlockGaussSeidel;
   else if ( ns.compare(0,12,"JacobiBlockI") == 0 )
       return JacobiBlockImplicit;
+  else if ( ns.compare(0,19,"GloballyImplicitBDF") == 0 )
+      return GloballyImplicitBDF2;
+  else if ( ns.compare(0,19,"GloballyImplicitSDC") == 0 )
+      return GloballyImplicitSDC;
   else if ( ns.compare(0,6 ,"Global") == 0 )
       return GloballyImplicit;
   else
@@ -34,6 +38,8 @@ enum PrecondScheme EnumifyPrecond(const char * name)
 
   if      ( ns.compare(0,8,"Diagonal") == 0 )
       return DiagonalSpectral;
+  else if ( ns.compare(0,8,"TwoLevel") == 0 )
+      return TwoLevelSpectral;
   else if ( ns.compare(0,9,"NoPrecond") == 0 )
       return NoPrecond;
   else
@@ -119,6 +125,12 @@ std::ostream& operator<<(std::ostream& output, const enum SolverScheme &SS)
         case GloballyImplicit:
             output<<"GloballyImplicit";
             break;
+        case GloballyImplicitBDF2:
+            output<<"GloballyImplicitBDF2";
+            break;
+        case GloballyImplicitSDC:
+            output<<"GloballyImplicitSDC";
+            break;
         default:
             output<<"UnknownScheme";
             break;
@@ -134,6 +146,9 @@ std::ostream& operator<<(std::ostream& output, const enum PrecondScheme &PS)
 	case DiagonalSpectral:
             output<<"DiagonalSpectral";
             break;
+	case TwoLevelSpectral:
+            output<<"TwoLevelSpectral";
+            break;
 	case NoPrecond:
             output<<"NoPrecond";
             break;
@@ -12,7 +12,10 @@ EvolveSurface<T, DT, DEVICE, Interact, Repart>::EvolveSurface(Params_t *params,
     monitor_(M),
     interaction_(I),
     repartition_(R),
-    F_(NULL)
+    F_(NULL),
+    repartitioned_(false),
+    avc_S_(NULL),
+    avc_S_up_(NULL)
 {
     ownedObjs_[0] = ownedObjs_[1] = ownedObjs_[2] = ownedObjs_[3] = false;
 
@@ -61,6 +64,12 @@ EvolveSurface<T, DT, DEVICE, Interact, Repart>::~EvolveSurface()
     if ( ownedObjs_[2] ) delete repartition_;
     if ( ownedObjs_[3] ) delete ves_props_;
     if (S_up_) delete S_up_;
+    delete avc_S_;
+    delete avc_S_up_;
+
+    // the work containers are shared by all the surfaces
+    WorkSpace<Sca_t>::purge();
+    WorkSpace<Vec_t>::purge();
 }
 
 template<typename T, typename DT, const DT &DEVICE,
@@ -105,6 +114,14 @@ Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::Evolve()
 	    updater = &IntVel_t::updateImplicit;
 	    break;
 
+	case GloballyImplicitBDF2:
+	    updater = &IntVel_t::updateImplicitBDF2;
+	    break;
+
+	case GloballyImplicitSDC:
+	    updater = &IntVel_t::updateImplicitSDC;
+	    break;
+
 	default:
 	  return ErrorEvent::InvalidParameterError;
     }
@@ -112,9 +129,12 @@ Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::Evolve()
     enum TimeAdaptive{
       TimeAdapErr,
       TimeAdapErrAreaVol,
+      TimeAdapEmbedded,
       TimeAdapNone
     };
-    TimeAdaptive time_adap=(params_->time_adaptive?TimeAdapErr:TimeAdapNone);
+    TimeAdaptive time_adap(TimeAdapNone);
+    if (params_->time_adaptive)
+        time_adap=(params_->time_adap_doubling?TimeAdapErr:TimeAdapEmbedded);
 
     Sca_t area, vol;
     { // Compute area, vol
@@ -136,13 +156,10 @@ Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::Evolve()
         value_type max_err=MaxAbs(y0);
 
         { // max_err = MPI_MAX(max_err)
-            ASSERT(typeid(T)==typeid(double),"Only works for double"); // @bug this only works for T==double
-            value_type loc;
-
-            loc=max_y0;
-            MPI_Allreduce(&loc, &max_y0, 1, MPI_DOUBLE, MPI_MAX, VES3D_COMM_WORLD);
-            loc=max_err;
-            MPI_Allreduce(&loc, &max_err, 1, MPI_DOUBLE, MPI_MAX, VES3D_COMM_WORLD);
+            value_type glb[2]={max_y0, max_err};
+            GlobalMax(glb, 2);
+            max_y0 =glb[0];
+            max_err=glb[1];
         }
         //@bug I (ABT) think tolerance is true when solving for
         //velocity, not for position
@@ -155,22 +172,48 @@ Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::Evolve()
     }
 
     Vec_t dx, x0, x_dt, x_2dt;
+    Vec_t dx_prev;          // increment of the last accepted step
+    value_type dt_prev(0);  // zero when there is no valid dx_prev
+
+    // the positions at the start of the last two accepted steps and
+    // the steps from them (zero when not valid), for the multistep
+    // scheme; x_begin is the position at the start of the step
+    Vec_t x_hist[2], x_begin;
+    value_type dt_hist[2]={0, 0};
+    bool keep_hist(params_->scheme==GloballyImplicitBDF2 &&
+        (time_adap==TimeAdapEmbedded || time_adap==TimeAdapNone));
     CHK( (*monitor_)( this, 0, dt) );
     INFO("Stepping with "<<params_->scheme);
 
+    // the in-memory snapshots for rollback (none when the stride is zero)
+    int step(0), n_rollbacks(0);
+    SnapRing_t snapshots(params_->snapshot_stride > 0 ? params_->snapshot_count : 0);
+    snapshots.Take(t, dt, S_->getPosition(), F_->tension(), dx_prev, dt_prev);
+
     MPI_Comm comm=MPI_COMM_WORLD;
     pvfmm::Profile::Enable(true);
+    memory::CachingAllocator::SetPhase("time stepping");
+    CHK(Telemetry::Open(params_->telemetry_file_name));
     while ( ERRORSTATUS() && t < time_horizon && dt>1e-10 )
     {
         pvfmm::Profile::Tic("TimeStep",&comm,true);
+        Telemetry::BeginStep(t);
+        F_->SetHistory(x_hist, dt_hist);
+        if(keep_hist){
+            x_begin.replicate(S_->getPosition());
+            axpy(static_cast<value_type>(1.0), S_->getPosition(), x_begin);
+        }
+        Error_t step_err(ErrorEvent::Success);
+        bool accepted(true);
+        value_type t_begin(t), dt_step(dt); // for the telemetry
 
         if(time_adap==TimeAdapErr){ // Adaptive using 2*dt time-step for error
             dt=std::min((time_horizon-t)/2, dt);
+            dt_step=dt;
             Error_t err=ErrorEvent::Success;
 
-            // Copy S_->getPosition
-            x0.replicate(S_->getPosition());
-            axpy(static_cast<value_type>(0.0), S_->getPosition(), S_->getPosition(), x0);
+            // The updaters do not change S_, the steps from the
+            // initial position are written to x_dt and x_2dt
 
             // dt time-step
             pvfmm::Profile::Tic("GMRES1",&comm,true);
@@ -185,34 +228,26 @@ Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::Evolve()
             // 2*dt time-step
             pvfmm::Profile::Tic("GMRES2",&comm,true);
             x_2dt.replicate(S_->getPosition());
-            axpy(static_cast<value_type>(0.0), x0, x0, S_->getPositionModifiable());
             if(err==ErrorEvent::Success) err=(F_->*updater)(*S_, 2*dt, dx);
             axpy(static_cast<value_type>(1.0), dx, S_->getPosition(), x_2dt);
             pvfmm::Profile::Toc();
 
-            // dt time-step
+            // dt time-step, x0 keeps the initial position
             pvfmm::Profile::Tic("GMRES3",&comm,true);
-            axpy(static_cast<value_type>(0.0), x_dt, x_dt, S_->getPositionModifiable());
+            S_->swapPosition(x_dt);
+            x0.swap(x_dt);
             if(err==ErrorEvent::Success) err=(F_->*updater)(*S_, dt, dx);
             axpy(static_cast<value_type>(1.0), dx, S_->getPosition(), S_->getPositionModifiable());
             pvfmm::Profile::Toc();
 
             // Check integration error
             stokes_error=std::max(stokes_error, F_->StokesError(S_->getPosition()));
-            { // stokes_error = MPI_MAX(stokes_error)
-              assert(typeid(T)==typeid(double)); // @bug this only works for T==double
-              value_type error_loc=stokes_error;
-              MPI_Allreduce(&error_loc, &stokes_error, 1, MPI_DOUBLE, MPI_MAX, VES3D_COMM_WORLD);
-            }
+            GlobalMax(&stokes_error);
 
             // Compute error
             axpy(static_cast<value_type>(-1.0), S_->getPosition(), x_2dt, x_2dt);
             value_type error=MaxAbs(x_2dt);
-            { // error = MPI_MAX(error)
-              assert(typeid(T)==typeid(double)); // @bug this only works for T==double
-              value_type error_loc=error;
-              MPI_Allreduce(&error_loc, &error, 1, MPI_DOUBLE, MPI_MAX, VES3D_COMM_WORLD);
-            }
+            GlobalMax(&error);
 
             int accept=1;
             value_type dt_new=dt;
@@ -233,58 +268,38 @@ Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::Evolve()
                 accept=(beta_scale<0.5?0:1);
                 dt_new=beta_scale * dt;
             }
+            accepted=accept;
             if(accept){ // Increment t
                 t += 2*dt;
             }else{ // Restore original S_
-                axpy(static_cast<value_type>(0.0), x0, x0, S_->getPositionModifiable());
+                S_->swapPosition(x0);
             }
 
             INFO("Time-adaptive: error/dt = "<<error/dt<<", error/dt^2 = "<<error/dt/dt<<", dt_new = "<<dt_new);
             dt=dt_new;
         }else if(time_adap==TimeAdapErrAreaVol){ // Adaptive using area, volume error
             dt=std::min(time_horizon-t, dt);
+            dt_step=dt;
             Error_t err=ErrorEvent::Success;
 
-            // Copy S_->getPosition
-            x0.replicate(S_->getPosition());
-            axpy(static_cast<value_type>(0.0), S_->getPosition(), S_->getPosition(), x0);
-
             // Compute initial area/volume
-            value_type A0, V0;
-            static Sca_t area0, vol0;
-            size_t N_ves=S_->getPosition().getNumSubs();
             S_->resample(params_->upsample_freq, &S_up_); // up-sample
-            area0.replicate(S_up_->getPosition()); S_up_->area  (area0);
-            vol0 .replicate(S_up_->getPosition()); S_up_->volume( vol0);
-            A0=Sca_t::getDevice().MaxAbs(area0.begin(), N_ves);
-            V0=Sca_t::getDevice().MaxAbs( vol0.begin(), N_ves);
+            S_up_->moments(tadap_moms0_);
 
-            // dt time-step
+            // dt time-step, x0 keeps the initial position
             pvfmm::Profile::Tic("GMRES",&comm,true);
             err=(F_->*updater)(*S_, dt, dx);
-            axpy(static_cast<value_type>(1.0), dx, S_->getPosition(), S_->getPositionModifiable());
+            x0.replicate(S_->getPosition());
+            axpy(static_cast<value_type>(1.0), dx, S_->getPosition(), x0);
+            S_->swapPosition(x0);
             pvfmm::Profile::Toc();
 
-            // Compute area/volume error
-            value_type A_err, V_err;
-            static Sca_t area_err, vol_err;
+            // Compute area/volume error (global max, one reduction)
+            AreaVolumeStats<value_type> stats;
             S_->resample(params_->upsample_freq, &S_up_); // up-sample
-            area_err.replicate(S_up_->getPosition()); S_up_->area  (area_err);
-            vol_err .replicate(S_up_->getPosition()); S_up_->volume( vol_err);
-            axpy(static_cast<value_type>(-1.0), area0, area_err, area_err);
-            axpy(static_cast<value_type>(-1.0),  vol0,  vol_err,  vol_err);
-            A_err=Sca_t::getDevice().MaxAbs(area_err.begin(), N_ves);
-            V_err=Sca_t::getDevice().MaxAbs( vol_err.begin(), N_ves);
-            { // error = MPI_MAX(error)
-              assert(typeid(T)==typeid(double)); // @bug this only works for T==double
-              value_type error_loc;
-
-              error_loc=A_err;
-              MPI_Allreduce(&error_loc, &A_err, 1, MPI_DOUBLE, MPI_MAX, VES3D_COMM_WORLD);
-
-              error_loc=V_err;
-              MPI_Allreduce(&error_loc, &V_err, 1, MPI_DOUBLE, MPI_MAX, VES3D_COMM_WORLD);
-            }
+            S_up_->areaVolumeStats(stats, tadap_moms_, &tadap_moms0_);
+            value_type A0(stats.area), V0(stats.vol);
+            value_type A_err(stats.area_err), V_err(stats.vol_err);
 
             int accept=1;
             value_type dt_new=dt;
@@ -310,39 +325,210 @@ Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::Evolve()
                 accept=(beta_scale<0.5?0:1);
                 dt_new=beta_scale * dt;
             }
+            accepted=accept;
             if(accept){ // Increment t
                 t += dt;
             }else{ // Restore original S_
-                axpy(static_cast<value_type>(0.0), x0, x0, S_->getPositionModifiable());
+                S_->swapPosition(x0);
             }
 
             INFO("Time-adaptive: A_err/dt = "<<(A_err/A0)/dt<<", V_err/dt = "<<(V_err/V0)/dt<<", dt_new = "<<dt_new);
             dt=dt_new;
+        }else if(time_adap==TimeAdapEmbedded){ // Adaptive using the increment of the previous step for error
+            dt=std::min(time_horizon-t, dt);
+            dt_step=dt;
+            Error_t err=ErrorEvent::Success;
+
+            // dt time-step, x0 keeps the initial position
+            pvfmm::Profile::Tic("GMRES",&comm,true);
+            err=(F_->*updater)(*S_, dt, dx);
+            x0.replicate(S_->getPosition());
+            axpy(static_cast<value_type>(1.0), dx, S_->getPosition(), x0);
+            S_->swapPosition(x0);
+            pvfmm::Profile::Toc();
+
+            // The increment of a first order step over dt is the mean
+            // velocity on the step, so the local error dt^2/2 x'' is
+            // estimated by dt^2/(dt+dt_prev) * (dx/dt - dx_prev/dt_prev),
+            // unless the updater has its own (higher order) estimate.
+            // dx_prev is the increment of the solve, before the
+            // reparametrization and the area/volume correction of the
+            // last step; the nodes of the two increments differ by the
+            // (tangential) reparametrization, which is neglected
+            int timestep_order(1);
+            value_type error=F_->LocalError(timestep_order);
+            if(error>=0){
+                GlobalMax(&error);
+            }else if(dt_prev>0){
+                timestep_order=1;
+                x_dt.replicate(dx);
+                axpy(static_cast<value_type>(-1.0/dt_prev), dx_prev, x_dt);
+                axpy(static_cast<value_type>( 1.0/dt     ), dx, x_dt, x_dt);
+                error=MaxAbs(x_dt)*dt*dt/(dt+dt_prev);
+                GlobalMax(&error);
+            }else if(err!=ErrorEvent::Success){
+                error=0; // the step is rejected below
+            }else{
+                // Without history (first step, after a rollback or a
+                // repartition that moved vesicles) the step is
+                // compared with two dt/2 steps from the initial
+                // position; the local error of the dt step is twice
+                // their difference and the two half steps are kept
+                timestep_order=1;
+                pvfmm::Profile::Tic("GMRESHalf",&comm,true);
+                S_->swapPosition(x0);  // S_ at the initial position
+                x_2dt.swap(x0);        // x_2dt is the dt step
+                err=(F_->*updater)(*S_, dt/2, dx);
+                x0.replicate(S_->getPosition());
+                axpy(static_cast<value_type>(1.0), dx, S_->getPosition(), x0);
+                S_->swapPosition(x0);
+                x_dt.swap(x0);         // x_dt keeps the initial position
+                if(err==ErrorEvent::Success) err=(F_->*updater)(*S_, dt/2, dx);
+                x0.replicate(S_->getPosition());
+                axpy(static_cast<value_type>(1.0), dx, S_->getPosition(), x0);
+                S_->swapPosition(x0);
+                x0.swap(x_dt);         // x0 keeps the initial position
+                pvfmm::Profile::Toc();
+
+                axpy(static_cast<value_type>(-1.0), S_->getPosition(), x_2dt, x_2dt);
+                error=2*MaxAbs(x_2dt);
+                GlobalMax(&error);
+
+                // the increment of the whole step, for the history
+                axpy(static_cast<value_type>(-1.0), x0, S_->getPosition(), dx);
+            }
+
+            // Check integration error
+            value_type stokes_error=F_->StokesError(S_->getPosition());
+            GlobalMax(&stokes_error);
+
+            int accept=1;
+            value_type dt_new=dt;
+            { // Compute dt_new
+                value_type time_horizon=params_->time_horizon;
+
+                // the tolerance of TimeAdapErr is for the error of a
+                // 2*dt advance, this step advances dt, so its error is
+                // doubled for the same error per unit time
+                value_type beta(1.0);
+                if(error>0) beta = (1.0/(2*error)) * (dt/time_horizon) * params_->error_factor;
+                beta = std::pow(beta, static_cast<value_type>(1.0)/timestep_order);
+                if(err!=ErrorEvent::Success) beta=0.5;
+                if(stokes_error*dt>params_->time_tol) beta=params_->time_tol/(stokes_error*dt); // This is required for GMRES to converge
+
+                beta=std::min(beta,1.5);
+                beta=std::max(beta,0.5);
+
+                value_type beta_scale=std::pow(sqrt(0.9),static_cast<value_type>(1.0)/timestep_order) * beta;
+                accept=(beta_scale<0.5?0:1);
+                dt_new=beta_scale * dt;
+            }
+            accepted=accept;
+            if(accept){ // Increment t
+                t += dt;
+                dx_prev.swap(dx); // dx is overwritten by the next step
+                dt_prev=dt;
+            }else{ // Restore original S_
+                // the history is kept, dx_prev is still the increment
+                // that ended at the restored position
+                S_->swapPosition(x0);
+            }
+
+            INFO("Time-adaptive: error/dt = "<<error/dt<<", error/dt^2 = "<<error/dt/dt<<", dt_new = "<<dt_new);
+            dt=dt_new;
         }else if(time_adap==TimeAdapNone){ // No adaptive
             pvfmm::Profile::Tic("GMRES",&comm,true);
-            CHK( (F_->*updater)(*S_, dt, dx) );
-            axpy(static_cast<value_type>(1.0), dx, S_->getPosition(), S_->getPositionModifiable());
+            step_err=(F_->*updater)(*S_, dt, dx);
+            accepted=(step_err==ErrorEvent::Success);
+            if(accepted){
+                axpy(static_cast<value_type>(1.0), dx, S_->getPosition(), S_->getPositionModifiable());
+                t += dt;
+                dx_prev.swap(dx); // dx is overwritten by the next step
+                dt_prev=dt;
+            }
             pvfmm::Profile::Toc();
+        }
 
-            t += dt;
+        // a failed step is rolled back (or stops the run)
+        if(params_->snapshot_stride>0 &&
+            Rollback(step_err!=ErrorEvent::Success, snapshots, n_rollbacks, t, dt, dx_prev, dt_prev)){
+            dt_hist[0]=dt_hist[1]=0;
+            CHK(Telemetry::EndStep(false, dt_step, 0, dt));
+            pvfmm::Profile::Toc();
+            continue;
         }
+        CHK(step_err);
 
         pvfmm::Profile::Tic("Reparam",&comm,true);
-        F_->reparam();
+        {
+            Telemetry::Timer timer(Telemetry::Reparam);
+            F_->reparam();
+        }
         pvfmm::Profile::Toc();
         pvfmm::Profile::Tic("AreaVolume",&comm,true);
-        AreaVolumeCorrection(area, vol);
+        {
+            Telemetry::Timer timer(Telemetry::AreaVolume);
+            AreaVolumeCorrection(area, vol);
+        }
         pvfmm::Profile::Toc();
+
+        // the start of an accepted step is the newest history level,
+        // the corrected position is the next start
+        if(keep_hist && accepted){
+            x_hist[1].swap(x_hist[0]);
+            x_hist[0].swap(x_begin);
+            dt_hist[1]=dt_hist[0];
+            dt_hist[0]=t-t_begin;
+        }
         pvfmm::Profile::Tic("Repartition",&comm,true);
-        (*repartition_)(S_->getPositionModifiable(), F_->tension());
+        {
+            Telemetry::Timer timer(Telemetry::Repartition);
+            // when a process has new vesicles, the history and the
+            // snapshots of the processes are not valid; all the
+            // processes drop them so they have the same history
+            bool moved(false);
+            repartitioned_=false;
+            if ( (*repartition_)(S_->getPositionModifiable(), F_->tension(), &moved) == ErrorEvent::Success ){
+                int loc(moved), glb(0);
+                MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MAX, VES3D_COMM_WORLD);
+                repartitioned_=glb;
+                if ( glb ){
+                    dt_prev=0;
+                    dt_hist[0]=dt_hist[1]=0;
+                    snapshots.clear();
+                }
+            }
+        }
         pvfmm::Profile::Toc();
         pvfmm::Profile::Tic("Monitor",&comm,true);
-        CHK( (*monitor_)( this, t, dt) );
+        Error_t monitor_err( (*monitor_)( this, t, dt) );
         pvfmm::Profile::Toc();
 
+        if ( params_->snapshot_stride > 0 ){
+            if ( Rollback(monitor_err!=ErrorEvent::Success, snapshots, n_rollbacks, t, dt, dx_prev, dt_prev) ){
+                dt_hist[0]=dt_hist[1]=0;
+                monitor_err=ErrorEvent::Success;
+                accepted=false;
+            } else if ( monitor_err==ErrorEvent::Success &&
+                (++step % params_->snapshot_stride == 0 || snapshots.size() == 0) ){
+                snapshots.Take(t, dt, S_->getPosition(), F_->tension(), dx_prev, dt_prev);
+                n_rollbacks=0;
+            }
+        }
+        CHK( monitor_err );
+        // the time advanced by the step (2*dt with step doubling)
+        CHK(Telemetry::EndStep(accepted, dt_step, accepted ? t-t_begin : 0, dt));
+
         pvfmm::Profile::Toc();
-        pvfmm::Profile::print(&comm);
+        if ( params_->profile_step )
+            pvfmm::Profile::print(&comm);
     }
+    CHK(Telemetry::Close());
+
+    // the checkpoints are complete when this returns
+    CHK(AsyncWriter::Flush());
+    AsyncWriter::Report();
+    memory::CachingAllocator::Report();
     PROFILEEND("",0);
     return ErrorEvent::Success;
 }
@@ -351,125 +537,139 @@ template<typename T, typename DT, const DT &DEVICE,
          typename Interact, typename Repart>
 Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::AreaVolumeCorrection(const Sca_t& area, const Sca_t& vol, const value_type tol)
 {
-    static GaussLegendreIntegrator<Sca_t> integrator;
+    PROFILESTART();
     const DT& device=Sca_t::getDevice();
-    int N_ves=S_->getNumberOfSurfaces();
+    size_t N_ves=S_->getNumberOfSurfaces();
     int iter(-1);
 
-    while (++iter < params_->rep_maxit){
-        S_->resample(params_->upsample_freq, &S_up_); // up-sample
-
-        const Vec_t& Normal  =S_up_->getNormal();
-        const Sca_t& AreaElem=S_up_->getAreaElement();
-        const Sca_t& MeanCurv=S_up_->getMeanCurv();
+    // the host buffer holds the target area and volume of all
+    // vesicles followed by the moments (area, vol, int(X), int(X^2))
+    // and dX, dY of the active ones
+    avc_host_.resize(8*N_ves);
+    value_type *area0(&avc_host_[0]), *vol0(area0+N_ves);
+    if (N_ves){
+        device.Memcpy(area0, area.begin(), N_ves*sizeof(value_type), device.MemcpyDeviceToHost);
+        device.Memcpy( vol0,  vol.begin(), N_ves*sizeof(value_type), device.MemcpyDeviceToHost);
+    }
 
-        Sca_t X; // First perturbation direction
-        { // X = -2.0*MeanCurv
-            X.replicate(MeanCurv);
-            axpy(-2.0, MeanCurv, X);
+    avc_active_.resize(N_ves);
+    for (size_t i=0; i<N_ves; ++i) avc_active_[i]=i;
+
+    while (avc_active_.size() && ++iter < params_->rep_maxit){
+        size_t n_act(avc_active_.size());
+        if (avc_S_==NULL)
+            avc_S_ = new Sur_t(params_->sh_order, mats_, NULL, params_->filter_freq,
+                params_->rep_filter_freq, params_->rep_type, params_->rep_exponent);
+        GatherSubs(S_->getPosition(), avc_active_, avc_S_->getPositionModifiable());
+        avc_S_->resample(params_->upsample_freq, &avc_S_up_); // up-sample
+
+        const Vec_t& Normal  =avc_S_up_->getNormal();
+        const Sca_t& MeanCurv=avc_S_up_->getMeanCurv();
+
+        // The perturbation directions are X = -2.0*MeanCurv and Y = 1,
+        // so that (with A the area of the upsampled surface)
+        // dA/dX = int(X^2), dA/dY = dV/dX = int(X), dV/dY = A
+        avc_X_.replicate(MeanCurv);
+        axpy(static_cast<value_type>(-2.0), MeanCurv, avc_X_);
+        avc_Y_.replicate(MeanCurv);
+        device.Memset(avc_Y_.begin(), 1, avc_Y_.size()*sizeof(value_type));
+        xyInv(avc_Y_,avc_Y_,avc_Y_);
+        avc_wrk_.replicate(MeanCurv);
+
+        // area, vol, int(X), int(X^2) of each vesicle in one pass
+        avc_S_up_->moments(avc_moms_, 0, &avc_X_);
+
+        value_type *M(vol0+N_ves), *dX(M+4*n_act), *dY(dX+n_act);
+        device.Memcpy(M, avc_moms_.begin(), 4*n_act*sizeof(value_type), device.MemcpyDeviceToHost);
+
+        // Newton step of each vesicle, the converged ones are masked
+        // by a zero step and dropped from the next iteration
+        value_type max_err(0);
+        avc_next_.clear();
+        for (size_t i=0; i<n_act; ++i){
+            size_t v(avc_active_[i]);
+            value_type A(M[4*i]), V(M[4*i+1]), IX(M[4*i+2]), IXX(M[4*i+3]);
+            value_type area_err(area0[v]-A), vol_err(vol0[v]-V);
+            value_type err(std::max(std::abs(area_err/area0[v]), std::abs(vol_err/vol0[v])));
+            max_err=std::max(max_err,err);
+
+            // DetInv = (dA/dX.dV/dY - dA/dY.dV/dX)^-1
+            value_type DetInv(IXX*A - IX*IX);
+            DetInv = (DetInv==0) ? 0 : 1.0/DetInv;
+            dX[i] = dY[i] = 0;
+            if (err < tol || DetInv==0) continue;
+
+            dX[i] = ( A *area_err - IX *vol_err)*DetInv; // dX/dA*area_err + dX/dV*vol_err
+            dY[i] = (-IX*area_err + IXX*vol_err)*DetInv; // dY/dA*area_err + dY/dV*vol_err
+            avc_next_.push_back(v);
         }
-
-        Sca_t Y; // Second perturbation direction
-        { // Y = [1, ..., 1]
-            Y.replicate(MeanCurv);
-            device.Memset(Y.begin(), 1, Y.size()*sizeof(value_type));
-            xyInv(Y,Y,Y);
+        COUTDEBUG("Iteration = "<<iter<<", active vesicles = "<<n_act<<", max relative error = "<<max_err);
+        if (avc_next_.empty()){
+            avc_active_.clear();
+            break;
         }
 
-        Sca_t dX(N_ves,1);
-        Sca_t dY(N_ves,1);
-        { // Set dX, dY
-            Sca_t area_err, vol_err;
-            { // compute error
-                area_err.resize(N_ves,1); S_up_->area  (area_err);
-                vol_err .resize(N_ves,1); S_up_->volume( vol_err);
-                device.axpy(-1.0, area_err.begin(), area.begin(), N_ves, area_err.begin());
-                device.axpy(-1.0,  vol_err.begin(),  vol.begin(), N_ves,  vol_err.begin());
-
-                value_type area_max_err=device.MaxAbs<value_type>(area_err.begin(),N_ves)/device.MaxAbs<value_type>(area.begin(),N_ves);
-                value_type  vol_max_err=device.MaxAbs<value_type>( vol_err.begin(),N_ves)/device.MaxAbs<value_type>( vol.begin(),N_ves);
-                COUTDEBUG("Iteration = "<<iter<<", area error="<<area_max_err<<", vol error="<<vol_max_err);
-                if(std::max(area_max_err, vol_max_err)<tol) break;
-            }
+        avc_dX_.resize(n_act);
+        avc_dY_.resize(n_act);
+        device.Memcpy(avc_dX_.begin(), dX, n_act*sizeof(value_type), device.MemcpyHostToDevice);
+        device.Memcpy(avc_dY_.begin(), dY, n_act*sizeof(value_type), device.MemcpyHostToDevice);
 
-            Sca_t dAdX(N_ves,1);
-            Sca_t dAdY(N_ves,1);
-            Sca_t dVdX(N_ves,1);
-            Sca_t dVdY(N_ves,1);
-            { // dA/dX
-                Sca_t tmp; tmp.replicate(MeanCurv);
-                xy(X, X, tmp); integrator(tmp,AreaElem,dAdX);
-            }
-            { // dA/dY
-                Sca_t tmp; tmp.replicate(MeanCurv);
-                xy(X, Y, tmp); integrator(tmp,AreaElem,dAdY);
-            }
-            { // dV/dX
-                Sca_t tmp; tmp.replicate(MeanCurv);
-                xy(Y, X, tmp); integrator(tmp,AreaElem,dVdX);
-            }
-            { // dV/dY
-                Sca_t tmp; tmp.replicate(MeanCurv);
-                xy(Y, Y, tmp); integrator(tmp,AreaElem,dVdY);
-            }
-
-            Sca_t DetInv(N_ves,1);
-            { // Set DetInv = (dA/dX.dV/dY - dA/dY.dV/dX)^-1
-                device.xy(dAdX.begin(), dVdY.begin(), N_ves, dX.begin());
-                device.xy(dAdY.begin(), dVdX.begin(), N_ves, dY.begin());
-                device.axpy(-1.0, dY.begin(), dX.begin(), N_ves, DetInv.begin());
-                device.xyInv<value_type>(NULL, DetInv.begin(), N_ves, DetInv.begin());
-            }
+        { // position += (dX*X + dY*Y).*Normal
+            Vec_t& position=avc_S_up_->getPositionModifiable();
+            device.template axpy<value_type>(avc_dY_.begin(), avc_Y_.begin(), NULL, avc_Y_.getSubLength(), n_act, avc_wrk_.begin());
+            axpy(avc_dX_, avc_X_, avc_wrk_, avc_wrk_);
+            xvpw(avc_wrk_, Normal, position, position);
+        }
 
-            Sca_t dXdA(N_ves,1);
-            Sca_t dXdV(N_ves,1);
-            Sca_t dYdA(N_ves,1);
-            Sca_t dYdV(N_ves,1);
-            { // dX/dA =  dVdY * DetInv
-                device.xy(dVdY.begin(), DetInv.begin(), N_ves, dXdA.begin());
-            }
-            { // dX/dV = -dAdY * DetInv
-                device.xy(dAdY.begin(), DetInv.begin(), N_ves, dXdV.begin());
-                device.axpy<value_type>(-1.0, dXdV.begin(), NULL, N_ves, dXdV.begin());
-            }
-            { // dY/dA = -dVdX * DetInv
-                device.xy(dVdX.begin(), DetInv.begin(), N_ves, dYdA.begin());
-                device.axpy<value_type>(-1.0, dYdA.begin(), NULL, N_ves, dYdA.begin());
-            }
-            { // dY/dV =  dAdX * DetInv
-                device.xy(dAdX.begin(), DetInv.begin(), N_ves, dYdV.begin());
-            }
+        avc_S_up_->resample(params_->sh_order, &avc_S_); // down-sample
+        ScatterSubs(avc_S_->getPosition(), avc_active_, S_->getPositionModifiable());
+        avc_active_.swap(avc_next_);
+    }
+    INFO("Number of iterations : "<<iter<<", vesicles not converged : "<<avc_active_.size());
+    PROFILEEND("",0);
 
-            { // dX = dX/dA*area_err + dX/dV*vol_err
-              device.xy(dXdA.begin(), area_err.begin(), N_ves, dXdA.begin());
-              device.xy(dXdV.begin(),  vol_err.begin(), N_ves, dXdV.begin());
-              device.axpy(1.0, dXdA.begin(), dXdV.begin(), N_ves, dX.begin());
-            }
-            { // dY = dY/dA*area_err + dY/dV*vol_err
-              device.xy(dYdA.begin(), area_err.begin(), N_ves, dYdA.begin());
-              device.xy(dYdV.begin(),  vol_err.begin(), N_ves, dYdV.begin());
-              device.axpy(1.0, dYdA.begin(), dYdV.begin(), N_ves, dY.begin());
-            }
-        }
+    return ErrorEvent::Success;
+}
 
-        Vec_t dS; dS.replicate(Normal);
-        Vec_t& position=S_up_->getPositionModifiable();
-        { // position += dX*X.*Normal
-            device.xvpw<value_type>( X.begin(), Normal.begin(), NULL, Normal.getStride(), Normal.getNumSubs(), dS.begin());
-            device.avpw<value_type>(dX.begin(),     dS.begin(), NULL, Normal.getStride(), Normal.getNumSubs(), dS.begin());
-            axpy(1, dS, position, position);
-        }
-        { // position += dY*Y.*Normal
-            device.xvpw<value_type>( Y.begin(), Normal.begin(), NULL, Normal.getStride(), Normal.getNumSubs(), dS.begin());
-            device.avpw<value_type>(dY.begin(),     dS.begin(), NULL, Normal.getStride(), Normal.getNumSubs(), dS.begin());
-            axpy(1, dS, position, position);
-        }
+template<typename T, typename DT, const DT &DEVICE,
+         typename Interact, typename Repart>
+void EvolveSurface<T, DT, DEVICE, Interact, Repart>::GlobalMax(value_type *val, int n)
+{
+    std::vector<value_type> loc(val, val + n);
+    MPI_Allreduce(&loc[0], val, n, (sizeof(value_type)==sizeof(double)) ? MPI_DOUBLE : MPI_FLOAT,
+        MPI_MAX, VES3D_COMM_WORLD);
+}
 
-        S_up_->resample(params_->sh_order, &S_); // down-sample
+template<typename T, typename DT, const DT &DEVICE,
+         typename Interact, typename Repart>
+bool EvolveSurface<T, DT, DEVICE, Interact, Repart>::Rollback(bool failed,
+    SnapRing_t &snapshots, int &n_rollbacks, value_type &t, value_type &dt,
+    Vec_t &dx_prev, value_type &dt_prev)
+{
+    // all the processes roll back together
+    int loc(failed), glb(0);
+    MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MAX, VES3D_COMM_WORLD);
+    if (!glb) return false;
+
+    if (n_rollbacks >= params_->rollback_max || snapshots.size() == 0){
+        CERR("Step failed at t="<<t<<" with no snapshot to roll back to ("
+            <<n_rollbacks<<" rollbacks in a row)");
+        return false;
     }
-    INFO("Number of iterations : "<<iter);
 
-    return ErrorEvent::Success;
+    value_type t_failed(t);
+    Sca_t tension;
+    snapshots.Restore(t, dt, S_->getPositionModifiable(), tension, dx_prev, dt_prev);
+    ++n_rollbacks;
+    dt *= std::pow(static_cast<value_type>(0.5), n_rollbacks);
+
+    // the initial guesses of the failed solve are not reused
+    ReinitInterfacialVelocity();
+    F_->tension().swap(tension);
+
+    WARN("Step failed at t="<<t_failed<<", rolled back to t="<<t<<" with dt="<<dt
+        <<" (rollback "<<n_rollbacks<<" of "<<params_->rollback_max<<")");
+    return true;
 }
 
 template<typename T, typename DT, const DT &DEVICE,
@@ -477,7 +677,12 @@ template<typename T, typename DT, const DT &DEVICE,
 Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::pack(
     std::ostream &os, Streamable::Format format) const{
 
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        CHK(pack_header(os, "EVOLVE", sizeof(value_type)));
+        CHK(pack_string(os, Streamable::name_));
+        CHK(ves_props_->pack(os,format));
+        return S_->pack(os,format);
+    }
 
     os<<"EVOLVE\n";
     os<<"version: "<<VERSION<<"\n";
@@ -494,7 +699,19 @@ template<typename T, typename DT, const DT &DEVICE,
 Error_t EvolveSurface<T, DT, DEVICE, Interact, Repart>::unpack(
     std::istream &is, Streamable::Format format){
 
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        int version(0);
+        Error_t ierr(unpack_header(is, "EVOLVE", sizeof(value_type), version));
+        if (ierr) return ierr;
+        CHK(unpack_string(is, Streamable::name_));
+        ierr = ves_props_->unpack(is,format);
+        if (ierr) return ierr;
+        ierr = S_->unpack(is,format);
+        if (ierr) return ierr;
+        INFO("Unpacked "<<Streamable::name_<<" data from version "<<version<<" (current version "<<VERSION<<")");
+        return ErrorEvent::Success;
+    }
+
     std::string s,key;
     int version;
 
@@ -0,0 +1,99 @@
+template<typename T, typename DT, const DT &DEVICE>
+inline ScalarTerm<T> expr(const Scalars<T, DT, DEVICE> &x)
+{
+    return(ScalarTerm<T>(x.begin(), x.getStride(), x.getNumSubs()));
+}
+
+template<typename T, typename DT, const DT &DEVICE>
+inline VectorTerm<T> expr(const Vectors<T, DT, DEVICE> &x)
+{
+    return(VectorTerm<T>(x.begin(), x.getStride(), x.getNumSubs()));
+}
+
+template<typename T, typename DT, const DT &DEVICE>
+inline PerSubTerm<T> expr(const Array<T, DT, DEVICE> &a)
+{
+    return(PerSubTerm<T>(a.begin(), a.size()));
+}
+
+template<typename L, typename R>
+inline BinaryExpression<expr_ops::Add, L, R> operator+(
+    const Expression<L> &lhs, const Expression<R> &rhs)
+{
+    return(BinaryExpression<expr_ops::Add, L, R>(lhs.self(), rhs.self()));
+}
+
+template<typename L, typename R>
+inline BinaryExpression<expr_ops::Sub, L, R> operator-(
+    const Expression<L> &lhs, const Expression<R> &rhs)
+{
+    return(BinaryExpression<expr_ops::Sub, L, R>(lhs.self(), rhs.self()));
+}
+
+template<typename L, typename R>
+inline BinaryExpression<expr_ops::Mul, L, R> operator*(
+    const Expression<L> &lhs, const Expression<R> &rhs)
+{
+    return(BinaryExpression<expr_ops::Mul, L, R>(lhs.self(), rhs.self()));
+}
+
+template<typename L, typename R>
+inline BinaryExpression<expr_ops::Div, L, R> operator/(
+    const Expression<L> &lhs, const Expression<R> &rhs)
+{
+    return(BinaryExpression<expr_ops::Div, L, R>(lhs.self(), rhs.self()));
+}
+
+template<typename R>
+inline BinaryExpression<expr_ops::Mul, ConstantTerm<typename R::value_type>, R>
+operator*(typename R::value_type a, const Expression<R> &rhs)
+{
+    typedef ConstantTerm<typename R::value_type> C;
+    return(BinaryExpression<expr_ops::Mul, C, R>(C(a), rhs.self()));
+}
+
+template<typename L>
+inline BinaryExpression<expr_ops::Mul, L, ConstantTerm<typename L::value_type> >
+operator*(const Expression<L> &lhs, typename L::value_type a)
+{
+    typedef ConstantTerm<typename L::value_type> C;
+    return(BinaryExpression<expr_ops::Mul, L, C>(lhs.self(), C(a)));
+}
+
+template<typename R>
+inline BinaryExpression<expr_ops::Div, ConstantTerm<typename R::value_type>, R>
+operator/(typename R::value_type a, const Expression<R> &rhs)
+{
+    typedef ConstantTerm<typename R::value_type> C;
+    return(BinaryExpression<expr_ops::Div, C, R>(C(a), rhs.self()));
+}
+
+template<typename E, typename Container>
+inline void Evaluate(const Expression<E> &e, Container &out)
+{
+    typedef typename Container::value_type T;
+    const E &ex(e.self());
+    size_t stride(out.getStride());
+    size_t num_subs(out.getNumSubs());
+    size_t dim(out.getTheDim());
+
+    ASSERT(out.getDevice().type() == CPU, "Expressions are evaluated on the host");
+    ASSERT(!E::IS_VECTOR || dim == DIM, "A vector expression needs a vector output");
+    ASSERT(ex.conforms(stride, num_subs), "Incompatible containers");
+
+    PROFILESTART();
+    T *o(out.begin());
+    long num_blocks(num_subs * dim);
+
+    // one block is a scalar field or a component of a vector field
+#pragma omp parallel for
+    for (long bb = 0; bb < num_blocks; ++bb){
+        size_t sub(bb / dim);
+        size_t sca_idx(sub * stride);
+        size_t vec_idx(bb * stride);
+
+        for (size_t ss = 0; ss < stride; ++ss)
+            o[vec_idx + ss] = ex(sca_idx + ss, vec_idx + ss, sub);
+    }
+    PROFILEEND("CPU", 0);
+}
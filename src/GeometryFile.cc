@@ -0,0 +1,278 @@
+template<typename T>
+GeometryFile<T>::GeometryFile(MPI_Comm comm) :
+    Streamable("geometry_file"),
+    comm_(comm),
+    nproc_(1),
+    rank_(0),
+    data_offset_(0),
+    total_(0),
+    n_fields_(NUM_FIELDS),
+    n_props_(0),
+    first_(0),
+    count_(0)
+{
+    MPI_Comm_size(comm_, &nproc_);
+    MPI_Comm_rank(comm_, &rank_);
+    std::fill(box_, box_ + 6, 0);
+}
+
+template<typename T>
+GeometryFile<T>::~GeometryFile()
+{}
+
+template<typename T>
+Error_t GeometryFile<T>::Write(const std::string &fname, std::vector<T> &spec,
+    std::vector<T> &props, bool sort)
+{
+    PROFILESTART();
+    ASSERT(spec.size() % NUM_FIELDS == 0, "The geometry spec should have NUM_FIELDS values per vesicle");
+    total_    = spec.size() / NUM_FIELDS;
+    n_fields_ = NUM_FIELDS;
+    n_props_  = total_ ? props.size() / total_ : 0;
+    ASSERT(props.size() == total_ * n_props_, "The properties should have the same number of values per vesicle");
+
+    // the bounding box of the centers
+    for (int ii=0; ii<3; ++ii){
+        box_[ii] = box_[ii+3] = total_ ? spec[2+ii] : 0;
+        for (size_t iv=0; iv<total_; ++iv){
+            box_[ii  ] = std::min<double>(box_[ii  ], spec[iv * NUM_FIELDS + 2 + ii]);
+            box_[ii+3] = std::max<double>(box_[ii+3], spec[iv * NUM_FIELDS + 2 + ii]);
+        }
+    }
+
+    if (sort) MortonSort(spec, props, n_props_);
+
+    std::ostringstream header;
+    CHK(pack(header, Streamable::BIN));
+    data_offset_ = header.str().size();
+    header.str("");
+    CHK(pack(header, Streamable::BIN));
+
+    std::ofstream file(fname.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.good()){
+        CERR("Could not open the geometry file "<<fname);
+        return ErrorEvent::IOError;
+    }
+
+    std::string h(header.str());
+    file.write(h.data(), h.size());
+    for (size_t iv=0; iv<total_ && file.good(); ++iv){
+        file.write(reinterpret_cast<const char*>(&spec[iv * n_fields_]), n_fields_ * sizeof(T));
+        if (n_props_)
+            file.write(reinterpret_cast<const char*>(&props[iv * n_props_]), n_props_ * sizeof(T));
+    }
+    file.close();
+
+    if (file.fail()){
+        CERR("Failed to write the geometry file "<<fname);
+        return ErrorEvent::IOError;
+    }
+
+    INFO("Wrote "<<total_<<" vesicles with "<<n_props_<<" properties to "<<fname
+        <<(sort ? " (Morton ordered)" : ""));
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
+template<typename T>
+Error_t GeometryFile<T>::Read(const std::string &fname, std::vector<T> &spec,
+    std::vector<T> &props)
+{
+    PROFILESTART();
+
+    // the file name of the first process
+    std::string name(fname);
+    int len(name.size());
+    MPI_Bcast(&len, 1, MPI_INT, 0, comm_);
+    name.resize(len);
+    MPI_Bcast(&name[0], len, MPI_CHAR, 0, comm_);
+
+    MPI_File fh;
+    if (MPI_File_open(comm_, const_cast<char*>(name.c_str()), MPI_MODE_RDONLY,
+            MPI_INFO_NULL, &fh) != MPI_SUCCESS){
+        CERR("Failed to open the geometry file "<<name);
+        return ErrorEvent::IOError;
+    }
+
+    // the header is of fixed size, it is read by the first process
+    std::ostringstream empty;
+    CHK(pack(empty, Streamable::BIN));
+    std::vector<char> buffer(empty.str().size());
+    int nread(0);
+    if (rank_ == 0){
+        MPI_Status status;
+        if (MPI_File_read_at(fh, 0, &buffer[0], buffer.size(), MPI_BYTE, &status) == MPI_SUCCESS)
+            MPI_Get_count(&status, MPI_BYTE, &nread);
+    }
+    MPI_Bcast(&nread, 1, MPI_INT, 0, comm_);
+    MPI_Bcast(&buffer[0], buffer.size(), MPI_BYTE, 0, comm_);
+
+    Error_t ierr(ErrorEvent::IOBadStream);
+    if (size_t(nread) == buffer.size()){
+        std::istringstream is(std::string(buffer.begin(), buffer.end()));
+        ierr = unpack(is, Streamable::BIN);
+    }
+    if (ierr){
+        MPI_File_close(&fh);
+        CERR("Bad geometry file "<<name);
+        return ierr;
+    }
+
+    // the even share of the vesicles
+    size_t share(total_ / nproc_), rem(total_ % nproc_);
+    size_t rank(rank_);
+    count_ = share + (rank < rem);
+    first_ = rank * share + std::min(rank, rem);
+
+    size_t rec(n_fields_ + n_props_);
+    size_t n(count_ * rec);
+
+    // the count of a collective read is not reliable at the end of
+    // the file, so the size is checked first
+    MPI_Offset fsize(0);
+    MPI_File_get_size(fh, &fsize);
+    if (uint64_t(fsize) < data_offset_ + total_ * rec * sizeof(T)){
+        MPI_File_close(&fh);
+        CERR("The geometry file "<<name<<" is truncated");
+        return ErrorEvent::IOBadStream;
+    }
+
+    // the counts of MPI-IO are int, a large slice is read in chunks
+    // of at most IO_CHUNK bytes (the same number of calls on all the
+    // processes)
+    std::vector<T> records(n);
+    MPI_Offset offset(data_offset_ + first_ * rec * sizeof(T));
+    size_t bytes(n * sizeof(T));
+    int loc((bytes + IO_CHUNK - 1) / IO_CHUNK), nchunk(0);
+    MPI_Allreduce(&loc, &nchunk, 1, MPI_INT, MPI_MAX, comm_);
+
+    char *p(n ? reinterpret_cast<char*>(&records[0]) : NULL);
+    bool ok(true);
+    for (int ii=0; ii<nchunk; ++ii){
+        size_t b(bytes < IO_CHUNK ? bytes : IO_CHUNK);
+        MPI_Status status;
+        int err(MPI_File_read_at_all(fh, offset, p, b, MPI_BYTE, &status));
+        nread = 0;
+        MPI_Get_count(&status, MPI_BYTE, &nread);
+        ok = ok && (err == MPI_SUCCESS) && (size_t(nread) == b);
+        offset += b;
+        p      += b;
+        bytes  -= b;
+    }
+    MPI_File_close(&fh);
+
+    if (!ok){
+        CERR("The geometry file "<<name<<" is truncated");
+        return ErrorEvent::IOBadStream;
+    }
+
+    spec.resize(count_ * n_fields_);
+    props.resize(count_ * n_props_);
+    for (size_t iv=0; iv<count_; ++iv){
+        std::copy(&records[iv * rec], &records[iv * rec] + n_fields_, &spec[iv * n_fields_]);
+        std::copy(&records[iv * rec] + n_fields_, &records[iv * rec] + rec,
+            props.begin() + iv * n_props_);
+    }
+
+    COUTDEBUG("Read vesicles "<<first_<<" to "<<first_+count_<<" of "<<total_<<" from "<<name);
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
+template<typename T>
+bool GeometryFile<T>::IsGeometryFile(const std::string &fname, MPI_Comm comm)
+{
+    int rank(0), is_geo(0);
+    MPI_Comm_rank(comm, &rank);
+
+    if (rank == 0){
+        std::ifstream file(fname.c_str(), std::ios::in | std::ios::binary);
+        BinHeader h;
+        file.read(reinterpret_cast<char*>(&h), sizeof(h));
+        h.tag[BIN_TAG_LENGTH-1] = '\0';
+        is_geo = file.good() && h.magic == BIN_MAGIC &&
+            std::string(h.tag) == "GEOMETRY";
+    }
+    MPI_Bcast(&is_geo, 1, MPI_INT, 0, comm);
+
+    return is_geo;
+}
+
+template<typename T>
+void GeometryFile<T>::MortonSort(std::vector<T> &spec, std::vector<T> &props,
+    int n_props)
+{
+    size_t nv(spec.size() / NUM_FIELDS);
+    std::vector<std::pair<uint64_t, size_t> > keys(nv);
+    for (size_t iv=0; iv<nv; ++iv)
+        keys[iv] = std::make_pair(MortonKey(&spec[iv * NUM_FIELDS + 2]), iv);
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<T> spec_s(spec.size()), props_s(props.size());
+    for (size_t iv=0; iv<nv; ++iv){
+        size_t src(keys[iv].second);
+        std::copy(&spec[src * NUM_FIELDS], &spec[src * NUM_FIELDS] + NUM_FIELDS,
+            &spec_s[iv * NUM_FIELDS]);
+        std::copy(props.begin() + src * n_props, props.begin() + (src + 1) * n_props,
+            props_s.begin() + iv * n_props);
+    }
+    spec.swap(spec_s);
+    props.swap(props_s);
+}
+
+template<typename T>
+uint64_t GeometryFile<T>::MortonKey(const T *center) const
+{
+    // 21 bits per coordinate, interleaved
+    const uint64_t MAX_COORD((1 << 21) - 1);
+    uint64_t key(0);
+    for (int ii=0; ii<3; ++ii){
+        double len(box_[ii+3] - box_[ii]);
+        double s(len > 0 ? (center[ii] - box_[ii]) / len : 0);
+        uint64_t c(static_cast<uint64_t>(std::min(std::max(s, 0.0), 1.0) * MAX_COORD));
+        for (int b=0; b<21; ++b)
+            key |= ((c >> b) & 1) << (3 * b + 2 - ii);
+    }
+    return key;
+}
+
+template<typename T>
+Error_t GeometryFile<T>::pack(std::ostream &os, Streamable::Format format) const
+{
+    if (format != Streamable::BIN)
+        return ErrorEvent::NotImplementedError;
+
+    CHK(pack_header(os, "GEOMETRY", sizeof(T)));
+    CHK(pack_value(os, data_offset_));
+    CHK(pack_value(os, total_));
+    CHK(pack_value(os, n_fields_));
+    CHK(pack_value(os, n_props_));
+    return pack_array(os, format, box_, 6);
+}
+
+template<typename T>
+Error_t GeometryFile<T>::unpack(std::istream &is, Streamable::Format format)
+{
+    if (format != Streamable::BIN)
+        return ErrorEvent::NotImplementedError;
+
+    int version(0);
+    Error_t ierr(unpack_header(is, "GEOMETRY", sizeof(T), version));
+    if (ierr) return ierr;
+
+    CHK(unpack_value(is, data_offset_));
+    CHK(unpack_value(is, total_));
+    CHK(unpack_value(is, n_fields_));
+    CHK(unpack_value(is, n_props_));
+
+    size_t n(6);
+    ierr = unpack_array(is, format, box_, n);
+    if (ierr) return ierr;
+
+    if (n_fields_ != NUM_FIELDS){
+        CERR("The geometry file has "<<n_fields_<<" fields per vesicle instead of "<<NUM_FIELDS);
+        return ErrorEvent::IOBadStream;
+    }
+
+    return ErrorEvent::Success;
+}
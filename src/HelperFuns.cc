@@ -63,7 +63,7 @@ void axpy(typename ScalarContainer::value_type a_in,
 {
     ASSERT(AreCompatible(x_in,axpy_out),"Incompatible containers");
 
-    x_in.getDevice().axpy<typename ScalarContainer::value_type>(
+    x_in.getDevice().template axpy<typename ScalarContainer::value_type>(
         a_in, x_in.begin(), 0, x_in.size(), axpy_out.begin());
 }
 
@@ -190,7 +190,7 @@ inline void av(const Arr_t &a_in, const Vec_t &v_in, Vec_t &av_out)
     ASSERT(a_in.size() == v_in.getNumSubs(),"Incompatible containers");
     ASSERT(AreCompatible(v_in,av_out),"Incompatible containers");
 
-    Arr_t::getDevice().avpw<Arr_t::value_type>(a_in.begin(),
+    Arr_t::getDevice().template avpw<typename Arr_t::value_type>(a_in.begin(),
 					       v_in.begin(),
 					       NULL,
 					       v_in.getStride(),
@@ -198,6 +198,18 @@ inline void av(const Arr_t &a_in, const Vec_t &v_in, Vec_t &av_out)
 					       av_out.begin());
 }
 
+template<typename Container>
+inline void axpy(const typename Container::array_type &a_in,
+    const Container &x_in, const Container &y_in, Container &axpy_out)
+{
+    ASSERT(a_in.size() == x_in.getNumSubs(),"Incompatible containers");
+    ASSERT(AreCompatible(x_in,y_in),"Incompatible containers");
+    ASSERT(AreCompatible(y_in,axpy_out),"Incompatible containers");
+
+    x_in.getDevice().axpy(a_in.begin(), x_in.begin(), y_in.begin(),
+        x_in.getSubLength(), x_in.getNumSubs(), axpy_out.begin());
+}
+
 template<typename ScalarContainer, typename VectorContainer>
 inline void xvpw(const ScalarContainer &x_in,
     const VectorContainer &v_in, const VectorContainer &w_in,
@@ -227,7 +239,7 @@ inline void xv(const ScalarContainer &x_in,
     ASSERT(AreCompatible(x_in,v_in),"Incompatible containers");
     ASSERT(AreCompatible(v_in,xv_out),"Incompatible containers");
 
-    x_in.getDevice().xvpw<typename ScalarContainer::value_type>(
+    x_in.getDevice().template xvpw<typename ScalarContainer::value_type>(
         x_in.begin(), v_in.begin(), NULL, v_in.getStride(),
         v_in.getNumSubs(), xv_out.begin());
 }
@@ -427,6 +439,16 @@ typename ScalarContainer::value_type AlgebraicDot(const ScalarContainer &x,
     return(ScalarContainer::getDevice().AlgebraicDot(x.begin(), y.begin(), x.size()));
 }
 
+template<typename Container>
+void AlgebraicDot(const Container &x, const Container &y,
+    typename Container::array_type &dot)
+{
+    ASSERT(AreCompatible(x,y),"Incompatible containers");
+    dot.resize(x.getNumSubs());
+    x.getDevice().AlgebraicDot(x.begin(), y.begin(), x.getSubLength(),
+        x.getNumSubs(), dot.begin());
+}
+
 template<typename Container>
 typename Container::value_type MaxAbs(Container &x)
 {
@@ -491,3 +513,91 @@ void Resample(const Container &xp, const SHT &shtp, const SHT &shtq,
 
     shtq.backward(shcpq, wrkpq, xq);
 }
+
+template<typename Container, typename SHT>
+void ResampleShc(const Container &shcp, const SHT &shtq,
+    Container &shcq, Container &wrkq, Container &xq)
+{
+    typedef typename Container::value_type value_type;
+
+    ASSERT(shcq.getShOrder() == shtq.getShOrder(),
+        "The coefficient container should have the target order");
+
+    if(shcp.getShOrder() < shcq.getShOrder())
+        Container::getDevice().Memset(shcq.begin(), 0,
+            shcq.size() * sizeof(value_type));
+
+    ResampleCoeffs(shcp, shcq);
+    shtq.backward(shcq, wrkq, xq);
+}
+
+template<typename Container>
+void ResampleCoeffs(const Container &shcp, Container &shcq)
+{
+    typedef typename Container::value_type value_type;
+    typedef typename Container::device_type DT;
+
+    int p = shcp.getShOrder();
+    int q = shcq.getShOrder();
+    int n_funs = shcp.getNumSubFuncs();
+    ASSERT(n_funs == shcq.getNumSubFuncs(), "Incompatible containers");
+
+    COUTDEBUG("resampling coefficients from "<<p<<" to "<<q);
+    const value_type *shc_p(shcp.begin());
+    value_type *shc_q(shcq.begin());
+
+    int len_p, len_q, cpy_len;
+    int minfreq = ( p > q ) ? q : p;
+    for(int ii=0; ii< 2 * minfreq; ++ii)
+    {
+        len_p   = p  + 1 - (ii+1)/2;
+        len_q   = q  + 1 - (ii+1)/2;
+        cpy_len = minfreq + 1 - (ii+1)/2;
+
+        for(int jj = 0; jj<n_funs; ++jj)
+        {
+            Container::getDevice().Memcpy(shc_q, shc_p,
+                cpy_len * sizeof(value_type), DT::MemcpyDeviceToDevice);
+
+            shc_p += len_p;
+            shc_q += len_q;
+        }
+    }
+}
+
+template<typename Container>
+void GatherSubs(const Container &x, const std::vector<size_t> &idx,
+    Container &y)
+{
+    typedef typename Container::value_type value_type;
+    typedef typename Container::device_type DT;
+
+    y.resize(idx.size(), x.getShOrder(), x.getGridDim());
+    size_t len(x.getSubLength());
+
+    for (size_t ii=0, jj; ii<idx.size(); ii=jj){
+        ASSERT(idx[ii]<x.getNumSubs(), "Index exceeds the number of subfields");
+        for (jj=ii+1; jj<idx.size() && idx[jj]==idx[jj-1]+1; ++jj);
+        Container::getDevice().Memcpy(y.getSubN_begin(ii), x.getSubN_begin(idx[ii]),
+            (jj-ii) * len * sizeof(value_type), DT::MemcpyDeviceToDevice);
+    }
+}
+
+template<typename Container>
+void ScatterSubs(const Container &y, const std::vector<size_t> &idx,
+    Container &x)
+{
+    typedef typename Container::value_type value_type;
+    typedef typename Container::device_type DT;
+
+    ASSERT(y.getNumSubs()==idx.size(), "Incompatible containers");
+    ASSERT(y.getSubLength()==x.getSubLength(), "Incompatible containers");
+    size_t len(x.getSubLength());
+
+    for (size_t ii=0, jj; ii<idx.size(); ii=jj){
+        ASSERT(idx[ii]<x.getNumSubs(), "Index exceeds the number of subfields");
+        for (jj=ii+1; jj<idx.size() && idx[jj]==idx[jj-1]+1; ++jj);
+        Container::getDevice().Memcpy(x.getSubN_begin(idx[ii]), y.getSubN_begin(ii),
+            (jj-ii) * len * sizeof(value_type), DT::MemcpyDeviceToDevice);
+    }
+}
@@ -28,17 +28,18 @@ void InterfacialForce<SurfContainer>::bendingForce(const SurfContainer &S,
     s1.replicate(S_up->getPosition());
     s2.replicate(S_up->getPosition());
 
-    xy(S_up->getMeanCurv(), S_up->getMeanCurv(), s2);
-    axpy(static_cast<typename SurfContainer::value_type>(-1.0),
-         S_up->getGaussianCurv(), s2, s2);
-    xy(S_up->getMeanCurv(), s2, s2);
+    // s2 = H (H^2 - K)
+    Evaluate(expr(S_up->getMeanCurv()) *
+        (expr(S_up->getMeanCurv()) * expr(S_up->getMeanCurv()) -
+            expr(S_up->getGaussianCurv())), s2);
 
     S_up->grad(S_up->getMeanCurv(), Fb_up);
     S_up->div(Fb_up, s1);
 
-    axpy(static_cast<typename SurfContainer::value_type>(2), s2, s1, s1);
-    xv(s1, S_up->getNormal(), Fb_up);
-    av(ves_props_.bending_coeff,Fb_up, Fb_up);
+    // Fb = kb (lap(H) + 2 H (H^2 - K)) n
+    Evaluate(expr(ves_props_.bending_coeff) *
+        ((static_cast<value_type>(2) * expr(s2) + expr(s1)) *
+            expr(S_up->getNormal())), Fb_up);
 
     { // downsample Fb
       Vec_t wrk[2]; // TODO: Pre-allocate
@@ -70,17 +71,16 @@ void InterfacialForce<SurfContainer>::linearBendingForce(const SurfContainer &S,
 
     S_up->linearizedMeanCurv(x_new_up, s1);
 
-    xy(S_up->getMeanCurv(), S_up->getMeanCurv(), s2);
-    axpy(static_cast<typename SurfContainer::value_type>(-1.0),
-        S_up->getGaussianCurv(), s2, s2);
-    xy(s1, s2, s2);
+    Evaluate(expr(s1) *
+        (expr(S_up->getMeanCurv()) * expr(S_up->getMeanCurv()) -
+            expr(S_up->getGaussianCurv())), s2);
 
     S_up->grad(s1, Fb_up);
     S_up->div(Fb_up, s1);
-    axpy(static_cast<typename SurfContainer::value_type>(2), s2, s1, s1);
 
-    xv(s1, S_up->getNormal(), Fb_up);
-    av(ves_props_.bending_coeff, Fb_up, Fb_up);
+    Evaluate(expr(ves_props_.bending_coeff) *
+        ((static_cast<value_type>(2) * expr(s2) + expr(s1)) *
+            expr(S_up->getNormal())), Fb_up);
 
     { // downsample Fb
       Vec_t wrk[2]; // TODO: Pre-allocate
@@ -109,10 +109,11 @@ void InterfacialForce<SurfContainer>::tensileForce(const SurfContainer &S,
     Fs_up.replicate(S_up->getPosition());
     v1.replicate(S_up->getPosition());
 
-    xv(S_up->getMeanCurv(), S_up->getNormal(), Fs_up);
-    xv(tension_up, Fs_up, Fs_up);
+    // Fs = 2 sigma H n + grad(sigma)
     S_up->grad(tension_up, v1);
-    axpy(static_cast<typename SurfContainer::value_type>(2), Fs_up, v1, Fs_up);
+    Evaluate(static_cast<value_type>(2) *
+        (expr(tension_up) * (expr(S_up->getMeanCurv()) * expr(S_up->getNormal()))) +
+        expr(v1), Fs_up);
 
     { // downsample Fs
       Vec_t wrk[2]; // TODO: Pre-allocate
@@ -19,13 +19,33 @@ InterfacialVelocity(SurfContainer &S_in, const Interaction &Inter,
     parallel_u_(NULL),
     //
     dt_(params_.ts),
+    x_hat_(NULL),
+    x_prev_(NULL),
+    dt_prev_(NULL),
+    local_error_(-1),
+    local_error_order_(0),
     sht_(mats.p_, mats.mats_p_),
     sht_upsample_(mats.p_up_, mats.mats_p_up_),
-    checked_out_work_sca_(0),
-    checked_out_work_vec_(0),
+    sca_work_("InterfacialVelocity"),
+    vec_work_("InterfacialVelocity"),
     stokes_(params_.sh_order,params_.upsample_freq,params_.periodic_length,params_.repul_dist),
+    stokes_lowp_(NULL),
+    lowp_matvec_(false),
+    lowp_src_set_(false),
+    coarse_params_(NULL),
+    coarse_mats_(NULL),
+    sht_coarse_(NULL),
+    S_coarse_(NULL),
+    coarse_solver_(NULL),
+    coarse_(NULL),
+    mats_(mats),
+    S_rep_(NULL),
     S_up_(NULL)
 {
+    if (params_.mixed_precision)
+        stokes_lowp_ = new StokesLowp_t(params_.sh_order, params_.upsample_freq,
+            params_.periodic_length, params_.repul_dist);
+
     pos_vel_.replicate(S_.getPosition());
     tension_.replicate(S_.getPosition());
 
@@ -68,7 +88,8 @@ InterfacialVelocity(SurfContainer &S_in, const Interaction &Inter,
         device_type::MemcpyDeviceToDevice);
 
     //spectrum in harmonic space, diagonal
-    if (params_.time_precond == DiagonalSpectral){
+    if (params_.time_precond == DiagonalSpectral ||
+        params_.time_precond == TwoLevelSpectral){
         position_precond.resize(1,p);
         tension_precond.resize(1,p);
     }
@@ -79,15 +100,20 @@ InterfacialVelocity<SurfContainer, Interaction>::
 ~InterfacialVelocity()
 {
     COUTDEBUG("Destroying an instance of interfacial velocity");
-    assert(!checked_out_work_sca_);
-    assert(!checked_out_work_vec_);
-
-    purgeTheWorkSpace();
-
     COUTDEBUG("Deleting parallel matvec and containers");
     delete parallel_matvec_;
     delete parallel_rhs_;
     delete parallel_u_;
+    delete stokes_lowp_;
+
+    COUTDEBUG("Deleting the coarse level");
+    delete coarse_;
+    delete coarse_solver_;
+    delete S_coarse_;
+    delete sht_coarse_;
+    delete coarse_mats_;
+    delete coarse_params_;
+    delete S_rep_;
 
     if(S_up_) delete S_up_;
 }
@@ -206,6 +232,7 @@ updateImplicit(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
 {
     PROFILESTART();
     this->dt_ = dt;
+    local_error_ = -1;
     SolverScheme scheme(GloballyImplicit);
     INFO("Taking a time step using "<<scheme<<" scheme");
     CHK(Prepare(scheme));
@@ -223,8 +250,8 @@ updateImplicit(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
 
     if(0)
     if (params_.solve_for_velocity && !params_.pseudospectral){ // Save velocity field to VTK
-      std::auto_ptr<Vec_t> vel_ = checkoutVec();
-      std::auto_ptr<Sca_t> ten_ = checkoutSca();
+      std::auto_ptr<Vec_t> vel_ = checkoutVec(pos_vel_);
+      std::auto_ptr<Sca_t> ten_ = checkoutSca(tension_);
       { // Set vel_, ten_
           typename PVec_t::iterator i(NULL);
           typename PVec_t::size_type rsz;
@@ -232,16 +259,10 @@ updateImplicit(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
           size_t vsz(stokesBlockSize()), tsz(tensionBlockSize());
           ASSERT(rsz==vsz+tsz,"Bad sizes");
 
-          vel_->replicate(pos_vel_);
-          ten_->replicate(tension_);
           {
-              std::auto_ptr<Vec_t> voxSh = checkoutVec();
-              std::auto_ptr<Sca_t> tSh   = checkoutSca();
-              std::auto_ptr<Vec_t> wrk   = checkoutVec();
-
-              voxSh->replicate(*vel_);
-              tSh->replicate(*ten_);
-              wrk->replicate(*vel_);
+              std::auto_ptr<Vec_t> voxSh = checkoutVec(*vel_);
+              std::auto_ptr<Sca_t> tSh   = checkoutSca(*ten_);
+              std::auto_ptr<Vec_t> wrk   = checkoutVec(*vel_);
 
               voxSh->getDevice().Memcpy(voxSh->begin(), i    , vsz * sizeof(value_type), device_type::MemcpyHostToDevice);
               tSh  ->getDevice().Memcpy(tSh  ->begin(), i+vsz, tsz * sizeof(value_type), device_type::MemcpyHostToDevice);
@@ -286,8 +307,7 @@ updateImplicit(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
         stokes_(*Sf);
 
         { // Add bg_vel
-          std::auto_ptr<Vec_t> bg_vel = checkoutVec();
-          bg_vel->replicate(S_.getPosition());
+          std::auto_ptr<Vec_t> bg_vel = checkoutVec(S_.getPosition());
           CHK(BgFlow(*bg_vel, dt));
           axpy(static_cast<value_type>(1.0), *bg_vel, *Sf, *Sf);
           recycle(bg_vel);
@@ -320,16 +340,9 @@ updateImplicit(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
         MPI_Comm_rank(comm,&myrank);
         MPI_Comm_size(comm,&np);
 
-        typedef float VTKReal;
-        struct VTKData{
-          std::vector<VTKReal> coord;
-          std::vector<VTKReal> value;
-
-          std::vector<int32_t> connect;
-          std::vector<int32_t> offset ;
-          std::vector<uint8_t> types  ;
-        };
-        VTKData vtk_data;
+        typedef double VTKReal;
+        VTKPiece vtk_data;
+        vtk_data.rank_data = true;
 
         { // Set vtk_data
           value_type range[6];
@@ -413,135 +426,10 @@ updateImplicit(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
           }
         }
 
+        // the pieces keep the names of the old writer (vis/vel000000.vtu)
         const char* fname="vis/vel";
-        { // WriteVTK
-          std::vector<VTKReal>& coord=vtk_data.coord;
-          std::vector<VTKReal>& value=vtk_data.value;
-
-          std::vector<int32_t>& connect=vtk_data.connect;
-          std::vector<int32_t>& offset =vtk_data.offset;
-          std::vector<uint8_t>& types  =vtk_data.types;
-
-          int pt_cnt=coord.size()/3;
-          int cell_cnt=types.size();
-
-          std::vector<int32_t> mpi_rank;  //MPI_Rank at points.
-          int new_myrank=myrank;//rand();
-          mpi_rank.resize(pt_cnt,new_myrank);
-
-          bool isLittleEndian;
-          { // Set isLittleEndian
-            uint16_t number = 0x1;
-            uint8_t *numPtr = (uint8_t*)&number;
-            isLittleEndian=(numPtr[0] == 1);
-          }
-
-          //Open file for writing.
-          std::stringstream vtufname;
-          vtufname<<fname<<std::setfill('0')<<std::setw(6)<<myrank<<".vtu";
-          std::ofstream vtufile;
-          vtufile.open(vtufname.str().c_str());
-          if(!vtufile.fail()){ // write .vtu
-            size_t data_size=0;
-            vtufile<<"<?xml version=\"1.0\"?>\n";
-            if(isLittleEndian) vtufile<<"<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
-            else               vtufile<<"<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\">\n";
-            //===========================================================================
-            vtufile<<"  <UnstructuredGrid>\n";
-            vtufile<<"    <Piece NumberOfPoints=\""<<pt_cnt<<"\" NumberOfCells=\""<<cell_cnt<<"\">\n";
-
-            //---------------------------------------------------------------------------
-            vtufile<<"      <Points>\n";
-            vtufile<<"        <DataArray type=\"Float"<<sizeof(VTKReal)*8<<"\" NumberOfComponents=\""<<3<<"\" Name=\"Position\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-            data_size+=sizeof(uint32_t)+coord.size()*sizeof(VTKReal);
-            vtufile<<"      </Points>\n";
-            //---------------------------------------------------------------------------
-            vtufile<<"      <PointData>\n";
-            if(value.size()){ // value
-              vtufile<<"        <DataArray type=\"Float"<<sizeof(VTKReal)*8<<"\" NumberOfComponents=\""<<value.size()/pt_cnt<<"\" Name=\""<<"value"<<"\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-              data_size+=sizeof(uint32_t)+value.size()*sizeof(VTKReal);
-            }
-            { // mpi_rank
-              vtufile<<"        <DataArray type=\"Int32\" NumberOfComponents=\"1\" Name=\"mpi_rank\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-              data_size+=sizeof(uint32_t)+mpi_rank.size()*sizeof(int32_t);
-            }
-            vtufile<<"      </PointData>\n";
-            //---------------------------------------------------------------------------
-            //---------------------------------------------------------------------------
-            vtufile<<"      <Cells>\n";
-            vtufile<<"        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-            data_size+=sizeof(uint32_t)+connect.size()*sizeof(int32_t);
-            vtufile<<"        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-            data_size+=sizeof(uint32_t)+offset.size() *sizeof(int32_t);
-            vtufile<<"        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-            data_size+=sizeof(uint32_t)+types.size()  *sizeof(uint8_t);
-            vtufile<<"      </Cells>\n";
-            //---------------------------------------------------------------------------
-            //vtufile<<"      <CellData>\n";
-            //vtufile<<"        <DataArray type=\"Float"<<sizeof(VTKReal)*8<<"\" Name=\"Velocity\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-            //vtufile<<"      </CellData>\n";
-            //---------------------------------------------------------------------------
-
-            vtufile<<"    </Piece>\n";
-            vtufile<<"  </UnstructuredGrid>\n";
-            //===========================================================================
-            vtufile<<"  <AppendedData encoding=\"raw\">\n";
-            vtufile<<"    _";
-
-            int32_t block_size;
-            block_size=coord   .size()*sizeof(VTKReal); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&coord   [0], coord   .size()*sizeof(VTKReal));
-            if(value.size()){ // value
-              block_size=value .size()*sizeof(VTKReal); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&value   [0], value   .size()*sizeof(VTKReal));
-            }
-            block_size=mpi_rank.size()*sizeof(int32_t); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&mpi_rank[0], mpi_rank.size()*sizeof(int32_t));
-
-            block_size=connect .size()*sizeof(int32_t); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&connect [0], connect .size()*sizeof(int32_t));
-            block_size=offset  .size()*sizeof(int32_t); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&offset  [0], offset  .size()*sizeof(int32_t));
-            block_size=types   .size()*sizeof(uint8_t); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&types   [0], types   .size()*sizeof(uint8_t));
-
-            vtufile<<"\n";
-            vtufile<<"  </AppendedData>\n";
-            //===========================================================================
-            vtufile<<"</VTKFile>\n";
-            vtufile.close();
-          }
-          if(!myrank){ // write .pvtu
-            std::stringstream pvtufname;
-            pvtufname<<fname<<".pvtu";
-            std::ofstream pvtufile;
-            pvtufile.open(pvtufname.str().c_str());
-            if(!pvtufile.fail()){
-              pvtufile<<"<?xml version=\"1.0\"?>\n";
-              pvtufile<<"<VTKFile type=\"PUnstructuredGrid\">\n";
-              pvtufile<<"  <PUnstructuredGrid GhostLevel=\"0\">\n";
-              pvtufile<<"      <PPoints>\n";
-              pvtufile<<"        <PDataArray type=\"Float"<<sizeof(VTKReal)*8<<"\" NumberOfComponents=\""<<3<<"\" Name=\"Position\"/>\n";
-              pvtufile<<"      </PPoints>\n";
-              pvtufile<<"      <PPointData>\n";
-              if(value.size()){ // value
-                pvtufile<<"        <PDataArray type=\"Float"<<sizeof(VTKReal)*8<<"\" NumberOfComponents=\""<<value.size()/pt_cnt<<"\" Name=\""<<"value"<<"\"/>\n";
-              }
-              { // mpi_rank
-                pvtufile<<"        <PDataArray type=\"Int32\" NumberOfComponents=\"1\" Name=\"mpi_rank\"/>\n";
-              }
-              pvtufile<<"      </PPointData>\n";
-              {
-                // Extract filename from path.
-                std::stringstream vtupath;
-                vtupath<<'/'<<fname;
-                std::string pathname = vtupath.str();
-                unsigned found = pathname.find_last_of("/\\");
-                std::string fname_ = pathname.substr(found+1);
-                //char *fname_ = (char*)strrchr(vtupath.str().c_str(), '/') + 1;
-                //std::string fname_ = boost::filesystem::path(fname).filename().string().
-                for(int i=0;i<np;i++) pvtufile<<"      <Piece Source=\""<<fname_<<std::setfill('0')<<std::setw(6)<<i<<".vtu\"/>\n";
-              }
-              pvtufile<<"  </PUnstructuredGrid>\n";
-              pvtufile<<"</VTKFile>\n";
-              pvtufile.close();
-            }
-          }
-        }
+        CHK(VTKWriter::Write(fname, vtk_data, VTKWriter::UnstructuredGrid,
+                params_.vtk_collective, true, comm, ""));
       }
 
       recycle(vel_);
@@ -551,6 +439,10 @@ updateImplicit(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
     dx.replicate(S_.getPosition());
     if (params_.solve_for_velocity){
         axpy(dt, pos_vel_, dx);
+        if (x_hat_){ // the step is from x_hat_
+            axpy(static_cast<value_type>( 1.0), *x_hat_, dx, dx);
+            axpy(static_cast<value_type>(-1.0), S_.getPosition(), dx, dx);
+        }
     } else {
         axpy(-1.0, S_.getPosition(), pos_vel_, dx);
     }
@@ -559,6 +451,217 @@ updateImplicit(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
     return err;
 }
 
+// Second order semi-implicit BDF with variable step, w = dt/dt_prev:
+// x_e   = (1+w) x_n - w x_{n-1}                   // geometry (extrapolated)
+// x_hat = ((1+w)^2 x_n - w^2 x_{n-1})/(1+2w)      // explicit state
+// x_{n+1} - dt(1+w)/(1+2w) A_e[x_{n+1}] = x_hat + dt(1+w)/(1+2w) b_e
+//
+// The local error is estimated by the difference of x_{n+1} and the
+// quadratic predictor P through x_{n-2}, x_{n-1}, and x_n (steps
+// h1 = dt_prev and h2 before it). The errors of x_{n+1} and P are
+// x''' dt^2 (dt+h1)^2/(6(2dt+h1)) and -x''' dt(dt+h1)(dt+h1+h2)/6,
+// so with a = dt(dt+h1)/(2dt+h1)
+// err = a/(a+dt+h1+h2) |x_{n+1} - P|       // 2/11 |x_{n+1} - P| for uniform steps
+//
+// Notes: x_{n-1} and x_{n-2} are the accepted positions (after the
+// reparametrization and the area/volume correction). Without history
+// (first step, after a rollback or a repartition that moved vesicles)
+// this is the implicit Euler step, and without x_{n-2} there is no
+// error estimate. A rejected step restores x_n, so the retry keeps
+// the same history with the new step ratio.
+template<typename SurfContainer, typename Interaction>
+Error_t InterfacialVelocity<SurfContainer, Interaction>::
+updateImplicitBDF2(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
+{
+    if (x_prev_ == NULL || dt_prev_[0] <= 0){
+        INFO("No history for "<<GloballyImplicitBDF2<<", taking a first order step");
+        return updateImplicit(S_, dt, dx);
+    }
+
+    PROFILESTART();
+    ASSERT(x_prev_[0].size() == S_.getPosition().size(), "The history should be of the same vesicles");
+    value_type h1(dt_prev_[0]), h2(dt_prev_[1]);
+    value_type w(dt/h1);
+    value_type dts(dt*(1+w)/(1+2*w));
+    INFO("Taking a time step using "<<GloballyImplicitBDF2<<" scheme, step ratio "<<w);
+
+    std::auto_ptr<Vec_t> dxp = checkoutVec();
+    std::auto_ptr<Vec_t> xe = checkoutVec();
+    std::auto_ptr<Vec_t> xh = checkoutVec();
+    axpy(static_cast<value_type>(-1.0), x_prev_[0], S_.getPosition(), *dxp);
+    axpy(w, *dxp, S_.getPosition(), *xe);
+    axpy(w*w/(1+2*w), *dxp, S_.getPosition(), *xh);
+
+    // xe holds the initial position while the step is taken from x_e
+    this->S_.swapPosition(*xe);
+    x_hat_ = xh.get();
+    Error_t err = updateImplicit(this->S_, dts, dx);
+    x_hat_ = NULL;
+    this->S_.swapPosition(*xe);
+
+    // dx was relative to x_e
+    axpy(w, *dxp, dx, dx);
+
+    // x_{n+1} - P = dx + l1 (x_n - x_{n-1}) + l2 (x_n - x_{n-2}), l1
+    // and l2 are the Lagrange weights of x_{n-1} and x_{n-2} at t+dt
+    if (h2 > 0){
+        ASSERT(x_prev_[1].size() == S_.getPosition().size(), "The history should be of the same vesicles");
+        value_type l1(-dt*(dt+h1+h2)/(h1*h2));
+        value_type l2(dt*(dt+h1)/((h1+h2)*h2));
+        value_type a(dt*(dt+h1)/(2*dt+h1));
+        axpy(l1, *dxp, dx, *xe);
+        axpy(static_cast<value_type>(-1.0), x_prev_[1], S_.getPosition(), *xh);
+        axpy(l2, *xh, *xe, *xe);
+        local_error_       = a/(a+dt+h1+h2)*MaxAbs(*xe);
+        local_error_order_ = 2;
+    }
+
+    recycle(dxp);
+    recycle(xe);
+    recycle(xh);
+
+    PROFILEEND("",0);
+    return err;
+}
+
+// Semi-implicit spectral deferred correction on M=time_sdc_order
+// uniform nodes t_m = m h (h = dt/M, m=1..M) with M sweeps. The
+// first sweep is implicit Euler and each correction sweep solves
+// x^{k+1}_m - h A[x^{k+1}_m] = x^{k+1}_{m-1} - h v^k_m + I_{m-1}^m[v^k]
+// where v^k_m is the velocity of the node m in sweep k and I is the
+// integral of the polynomial interpolating v^k on the nodes.
+//
+// Notes: the geometry of the correction solve of a node is its value
+// from the previous sweep, so that at convergence the velocities are
+// evaluated at the node itself. The difference of the last two sweeps
+// at t+dt is kept as the error estimate.
+template<typename SurfContainer, typename Interaction>
+Error_t InterfacialVelocity<SurfContainer, Interaction>::
+updateImplicitSDC(const SurfContainer& S_, const value_type &dt, Vec_t& dx)
+{
+    int M(params_.time_sdc_order);
+    if (M < 2)
+        return updateImplicit(S_, dt, dx);
+
+    PROFILESTART();
+    value_type h(dt/M);
+    INFO("Taking a time step using "<<GloballyImplicitSDC<<" scheme with "<<M<<" nodes");
+
+    std::vector<value_type> W;
+    SDCWeights(M, W);
+
+    // node positions and velocities of the previous (o) and current (n) sweep
+    std::vector<Vec_t*> xo(M+1), xn(M+1), vo(M+1), vn(M+1);
+    for (int m=0; m<=M; ++m){
+        xo[m] = checkoutVec().release();
+        xn[m] = checkoutVec().release();
+        vo[m] = checkoutVec().release();
+        vn[m] = checkoutVec().release();
+    }
+    std::auto_ptr<Vec_t> xh = checkoutVec();
+    std::auto_ptr<Vec_t> dxs = checkoutVec();
+
+    axpy(static_cast<value_type>(1.0), S_.getPosition(), *xn[0]);
+    axpy(static_cast<value_type>(1.0), S_.getPosition(), *xo[0]);
+
+    Error_t err(ErrorEvent::Success);
+    COUTDEBUG("SDC predictor sweep");
+    for (int m=1; m<=M && err==ErrorEvent::Success; ++m){
+        this->S_.setPosition(*xn[m-1]);
+        err = updateImplicit(this->S_, h, *dxs);
+        axpy(static_cast<value_type>(1.0), *dxs, *xn[m-1], *xn[m]);
+        axpy(static_cast<value_type>(1.0/h), *dxs, *vn[m]);
+    }
+
+    for (int k=1; k<M && err==ErrorEvent::Success; ++k){
+        COUTDEBUG("SDC correction sweep "<<k);
+        std::swap(xo, xn);
+        std::swap(vo, vn);
+        for (int m=1; m<=M && err==ErrorEvent::Success; ++m){
+            // x_hat = x_{m-1} - h v_m + dt sum_j W_{mj} v_j
+            axpy(-h, *vo[m], *xn[m-1], *xh);
+            for (int j=1; j<=M; ++j)
+                axpy(dt*W[(m-1)*M+j-1], *vo[j], *xh, *xh);
+
+            this->S_.setPosition(*xo[m]);
+            x_hat_ = xh.get();
+            err = updateImplicit(this->S_, h, *dxs);
+            x_hat_ = NULL;
+
+            // dxs is relative to the geometry xo[m]
+            axpy(static_cast<value_type>(1.0), *dxs, *xo[m], *xn[m]);
+            axpy(static_cast<value_type>(-1.0), *xh, *xn[m], *vn[m]);
+            axpy(static_cast<value_type>(1.0/h), *vn[m], *vn[m]);
+        }
+    }
+
+    this->S_.setPosition(*xn[0]);
+    dx.replicate(S_.getPosition());
+    axpy(static_cast<value_type>(-1.0), *xn[0], *xn[M], dx);
+
+    axpy(static_cast<value_type>(-1.0), *xo[M], *xn[M], *dxs);
+    local_error_       = MaxAbs(*dxs);
+    local_error_order_ = M-1;
+
+    for (int m=0; m<=M; ++m){
+        recycle(std::auto_ptr<Vec_t>(xo[m]));
+        recycle(std::auto_ptr<Vec_t>(xn[m]));
+        recycle(std::auto_ptr<Vec_t>(vo[m]));
+        recycle(std::auto_ptr<Vec_t>(vn[m]));
+    }
+    recycle(xh);
+    recycle(dxs);
+
+    PROFILEEND("",0);
+    return err;
+}
+
+template<typename SurfContainer, typename Interaction>
+void InterfacialVelocity<SurfContainer, Interaction>::
+SDCWeights(int M, std::vector<value_type> &W)
+{
+    W.assign(M*M, 0);
+    std::vector<value_type> c(M);
+    for (int j=1; j<=M; ++j){
+        // coefficients of the Lagrange polynomial (lowest degree first)
+        c.assign(M, 0);
+        c[0] = 1;
+        int deg(0);
+        for (int i=1; i<=M; ++i){
+            if (i==j) continue;
+            value_type den((j-i)*1.0/M);
+            ++deg;
+            for (int d=deg; d>=0; --d)
+                c[d] = ((d>0 ? c[d-1] : 0) - c[d]*i/M)/den;
+        }
+        for (int m=1; m<=M; ++m){
+            value_type a((m-1)*1.0/M), b(m*1.0/M), pa(a), pb(b);
+            for (int d=0; d<M; ++d){
+                W[(m-1)*M+j-1] += c[d]*(pb-pa)/(d+1);
+                pa *= a;
+                pb *= b;
+            }
+        }
+    }
+}
+
+template<typename SurfContainer, typename Interaction>
+void InterfacialVelocity<SurfContainer, Interaction>::
+SetHistory(const Vec_t *x_prev, const value_type *dt_prev)
+{
+    x_prev_  = x_prev;
+    dt_prev_ = dt_prev;
+}
+
+template<typename SurfContainer, typename Interaction>
+typename InterfacialVelocity<SurfContainer, Interaction>::value_type
+InterfacialVelocity<SurfContainer, Interaction>::
+LocalError(int &order) const
+{
+    order = local_error_order_;
+    return local_error_;
+}
+
 template<typename SurfContainer, typename Interaction>
 size_t InterfacialVelocity<SurfContainer, Interaction>::stokesBlockSize() const{
 
@@ -596,10 +699,14 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::Prepare(const SolverSch
 
     INFO("Setting interaction source and target");
     stokes_.SetSrcCoord(S_.getPosition());
+    lowp_src_set_ = false;
 
     if (!precond_configured_ && params_.time_precond!=NoPrecond)
         ConfigurePrecond(params_.time_precond);
 
+    if (params_.time_precond==TwoLevelSpectral && scheme==GloballyImplicit)
+        CHK(PrepareCoarse(scheme));
+
     //!@bug doesn't support repartitioning
     if (!psolver_configured_ && scheme==GloballyImplicit){
         ASSERT(parallel_solver_ != NULL, "need a working parallel solver");
@@ -640,15 +747,27 @@ ConfigureSolver(const SolverScheme &scheme) const
     CHK(parallel_rhs_->ReplicateTo(&parallel_u_));
     CHK(parallel_u_->SetName("solution"));
 
-    // setting up the solver
+    // setting up the solver; with mixed precision the tolerance is
+    // for the inner (single precision) solve, which can't do better
+    // than the round-off of its operator
+    value_type rtol(params_.time_tol);
+    if (params_.mixed_precision)
+        rtol = std::max(rtol, (value_type) 1e2*std::numeric_limits<lowp_type>::epsilon());
+
     CHK(parallel_solver_->SetOperator(parallel_matvec_));
-    CHK(parallel_solver_->SetTolerances(params_.time_tol,
+    CHK(parallel_solver_->SetTolerances(rtol,
             PSolver_t::PLS_DEFAULT,
             PSolver_t::PLS_DEFAULT,
             params_.time_iter_max));
 
     CHK(parallel_solver_->Configure());
 
+    // the coarse solve of the two-level preconditioner is iterative
+    // and inexact, so the preconditioner changes between the outer
+    // iterations and the outer method should be flexible
+    if (params_.time_precond == TwoLevelSpectral)
+        CHK(parallel_solver_->SetFlexible());
+
     // setting up the preconditioner
     if (params_.time_precond != NoPrecond){
         ASSERT(precond_configured_, "The preconditioner isn't configured yet");
@@ -666,11 +785,12 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::
 ConfigurePrecond(const PrecondScheme &precond) const{
 
     PROFILESTART();
-    if (precond!=DiagonalSpectral)
+    if (precond!=DiagonalSpectral && precond!=TwoLevelSpectral)
         return ErrorEvent::NotImplementedError; /* Unsupported preconditioner scheme */
 
     INFO("Setting up the diagonal preceonditioner");
-    value_type *buffer = new value_type[position_precond.size() * sizeof(value_type)];
+    size_t buffer_size(std::max(position_precond.size(), tension_precond.size()));
+    value_type *buffer = (value_type*) memory::CachingAllocator::Malloc(buffer_size * sizeof(value_type));
 
     { //bending precond
         int idx(0), N(0);
@@ -705,13 +825,80 @@ ConfigurePrecond(const PrecondScheme &precond) const{
             device_type::MemcpyHostToDevice);
     }
 
-    delete[] buffer;
+    memory::CachingAllocator::Free(buffer);
     precond_configured_=true;
     PROFILEEND("",0);
 
     return ErrorEvent::Success;
 }
 
+// Sets up (on the first call) and updates the coarse level of the
+// two-level preconditioner. The coarse level is a copy of this
+// operator (self and far interactions) for the vesicles resampled to
+// params_.precond_coarse_order.
+template<typename SurfContainer, typename Interaction>
+Error_t InterfacialVelocity<SurfContainer, Interaction>::
+PrepareCoarse(const SolverScheme &scheme) const
+{
+    PROFILESTART();
+    int p(S_.getPosition().getShOrder());
+    int q(params_.precond_coarse_order);
+    ASSERT(q>0 && q<p, "The coarse order should be lower than the sh order");
+
+    // the coarse solve is only an approximation
+    const value_type coarse_tol(1e-2);
+    const int coarse_maxit(10);
+
+    if (coarse_params_ == NULL){
+        INFO("Setting up the coarse level of the preconditioner with order "<<q);
+        std::stringstream ss;
+        params_.pack(ss, Streamable::ASCII);
+        coarse_params_ = new Parameters<value_type>(ss, Streamable::ASCII);
+        coarse_params_->sh_order        = q;
+        coarse_params_->upsample_freq   = params_.upsample_freq   * q / p;
+        coarse_params_->filter_freq     = params_.filter_freq     * q / p;
+        coarse_params_->rep_filter_freq = params_.rep_filter_freq * q / p;
+        coarse_params_->time_precond    = DiagonalSpectral;
+        coarse_params_->time_tol        = coarse_tol;
+        coarse_params_->time_iter_max   = coarse_maxit;
+        coarse_params_->mixed_precision = false;
+        coarse_mats_ = new Mats_t(true, *coarse_params_);
+        sht_coarse_  = new SHtrans_t(q, coarse_mats_->mats_p_);
+    }
+
+    COUTDEBUG("Resampling the position to the coarse order");
+    std::auto_ptr<Vec_t> xc  = checkoutVec();
+    std::auto_ptr<Vec_t> shc = checkoutVec();
+    std::auto_ptr<Vec_t> wrk = checkoutVec();
+    xc->resize(xc->getNumSubs(), q);
+    Resample(S_.getPosition(), sht_, *sht_coarse_, *shc, *wrk, *xc);
+
+    if (S_coarse_ == NULL){
+        S_coarse_ = new SurfContainer(q, *coarse_mats_, xc.get(),
+            coarse_params_->filter_freq, coarse_params_->rep_filter_freq,
+            coarse_params_->rep_type, coarse_params_->rep_exponent);
+        S_coarse_->set_name("coarse_surface");
+    } else {
+        S_coarse_->setPosition(*xc);
+    }
+
+    recycle(xc);
+    recycle(shc);
+    recycle(wrk);
+
+    if (coarse_ == NULL){
+        CHK(parallel_solver_->LinSolverFactory(&coarse_solver_));
+        coarse_ = new InterfacialVelocity(*S_coarse_, interaction_, *coarse_mats_,
+            *coarse_params_, ves_props_, bg_flow_, coarse_solver_);
+    }
+
+    coarse_->dt_ = dt_;
+    CHK(coarse_->Prepare(scheme));
+
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
 template<typename SurfContainer, typename Interaction>
 Error_t InterfacialVelocity<SurfContainer, Interaction>::
 AssembleRhsVel(PVec_t *rhs, const value_type &dt, const SolverScheme &scheme) const
@@ -722,14 +909,20 @@ AssembleRhsVel(PVec_t *rhs, const value_type &dt, const SolverScheme &scheme) co
 
     // rhs=[u_inf+Bx;div(u_inf+Bx)]
     COUTDEBUG("Evaluate background flow");
-    std::auto_ptr<Vec_t> vRhs = checkoutVec();
-    vRhs->replicate(S_.getPosition());
+    std::auto_ptr<Vec_t> vRhs = checkoutVec(S_.getPosition());
     CHK(BgFlow(*vRhs, dt));
 
     COUTDEBUG("Computing the far-field interaction due to explicit traction jump");
     std::auto_ptr<Vec_t> f  = checkoutVec();
     std::auto_ptr<Vec_t> Sf = checkoutVec();
-    Intfcl_force_.explicitTractionJump(S_, *f);
+    if (x_hat_){
+        // traction of the explicit state with the linearized operators
+        std::auto_ptr<Sca_t> ten = checkoutSca();
+        ten->getDevice().Memset(ten->begin(), 0, ten->size() * sizeof(value_type));
+        Intfcl_force_.implicitTractionJump(S_, *x_hat_, *ten, *f);
+        recycle(ten);
+    } else
+        Intfcl_force_.explicitTractionJump(S_, *f);
     stokes_.SetDensitySL(f.get(),true);
     stokes_.SetDensityDL(NULL);
     stokes_(*Sf);
@@ -755,13 +948,9 @@ AssembleRhsVel(PVec_t *rhs, const value_type &dt, const SolverScheme &scheme) co
         tRhs->getDevice().Memcpy(i+xsz, tRhs->begin(), tsz * sizeof(value_type), device_type::MemcpyDeviceToHost);
     } else {  /* Galerkin */
         COUTDEBUG("Project RHS to spectral coefficient");
-        std::auto_ptr<Vec_t> vRhsSh  = checkoutVec();
-        std::auto_ptr<Sca_t> tRhsSh  = checkoutSca();
-        std::auto_ptr<Vec_t> wrk     = checkoutVec();
-
-        vRhsSh->replicate(*vRhs);
-        tRhsSh->replicate(*tRhs);
-        wrk->replicate(*vRhs);
+        std::auto_ptr<Vec_t> vRhsSh  = checkoutVec(*vRhs);
+        std::auto_ptr<Sca_t> tRhsSh  = checkoutSca(*tRhs);
+        std::auto_ptr<Vec_t> wrk     = checkoutVec(*vRhs);
 
         sht_.forward(*vRhs, *wrk, *vRhsSh);
         sht_.forward(*tRhs, *wrk, *tRhsSh);
@@ -795,17 +984,18 @@ AssembleRhsPos(PVec_t *rhs, const value_type &dt, const SolverScheme &scheme) co
     INFO("Assembling RHS to solve for position");
 
     COUTDEBUG("Evaluate background flow");
-    std::auto_ptr<Vec_t> pRhs = checkoutVec();
-    std::auto_ptr<Vec_t> pRhs2 = checkoutVec();
-    pRhs->replicate(S_.getPosition());
-    pRhs2->replicate(S_.getPosition());
+    std::auto_ptr<Vec_t> pRhs = checkoutVec(S_.getPosition());
+    std::auto_ptr<Vec_t> pRhs2 = checkoutVec(S_.getPosition());
     CHK(BgFlow(*pRhs, dt));
 
+    // the state of the step (x_hat_ for the higher order schemes)
+    const Vec_t &x0(x_hat_ ? *x_hat_ : S_.getPosition());
+
     if( ves_props_.has_contrast ){
         COUTDEBUG("Computing the rhs due to viscosity contrast");
         std::auto_ptr<Vec_t> x  = checkoutVec();
         std::auto_ptr<Vec_t> Dx = checkoutVec();
-        av(ves_props_.dl_coeff, S_.getPosition(), *x);
+        av(ves_props_.dl_coeff, x0, *x);
         stokes_.SetDensitySL(NULL, true);
         stokes_.SetDensityDL(x.get());
         stokes_(*Dx);
@@ -821,7 +1011,7 @@ AssembleRhsPos(PVec_t *rhs, const value_type &dt, const SolverScheme &scheme) co
     std::auto_ptr<Sca_t> tRhs = checkoutSca();
     S_.div(*pRhs, *tRhs);
 
-    av(ves_props_.vel_coeff, S_.getPosition(), *pRhs2);
+    av(ves_props_.vel_coeff, x0, *pRhs2);
     axpy(static_cast<value_type>(1.0), *pRhs, *pRhs2, *pRhs);
 
     ASSERT( pRhs->getDevice().isNumeric(pRhs->begin(), pRhs->size()), "Non-numeric rhs");
@@ -840,13 +1030,9 @@ AssembleRhsPos(PVec_t *rhs, const value_type &dt, const SolverScheme &scheme) co
         tRhs->getDevice().Memcpy(i+xsz, tRhs->begin(), tsz * sizeof(value_type), device_type::MemcpyDeviceToHost);
     } else {  /* Galerkin */
         COUTDEBUG("Project RHS to spectral coefficient");
-        std::auto_ptr<Vec_t> pRhsSh  = checkoutVec();
-        std::auto_ptr<Sca_t> tRhsSh  = checkoutSca();
-        std::auto_ptr<Vec_t> wrk     = checkoutVec();
-
-        pRhsSh->replicate(*pRhs);
-        tRhsSh->replicate(*tRhs);
-        wrk->replicate(*pRhs);
+        std::auto_ptr<Vec_t> pRhsSh  = checkoutVec(*pRhs);
+        std::auto_ptr<Sca_t> tRhsSh  = checkoutSca(*tRhs);
+        std::auto_ptr<Vec_t> wrk     = checkoutVec(*pRhs);
 
         sht_.forward(*pRhs, *wrk, *pRhsSh);
         sht_.forward(*tRhs, *wrk, *tRhsSh);
@@ -892,13 +1078,9 @@ AssembleInitial(PVec_t *u0, const value_type &dt, const SolverScheme &scheme) co
         tension_.getDevice().Memcpy(i+vsz, tension_.begin(), tsz * sizeof(value_type), device_type::MemcpyDeviceToHost);
     } else {  /* Galerkin */
             COUTDEBUG("Project initial guess to spectral coefficient");
-        std::auto_ptr<Vec_t> voxSh  = checkoutVec();
-        std::auto_ptr<Sca_t> tSh    = checkoutSca();
-        std::auto_ptr<Vec_t> wrk    = checkoutVec();
-
-        voxSh->replicate(pos_vel_);
-        tSh->replicate(tension_);
-        wrk->replicate(pos_vel_);
+        std::auto_ptr<Vec_t> voxSh  = checkoutVec(pos_vel_);
+        std::auto_ptr<Sca_t> tSh    = checkoutSca(tension_);
+        std::auto_ptr<Vec_t> wrk    = checkoutVec(pos_vel_);
 
         sht_.forward(pos_vel_, *wrk, *voxSh);
         sht_.forward(tension_, *wrk, *tSh);
@@ -923,12 +1105,9 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::ImplicitMatvecPhysical(
 {
     PROFILESTART();
 
-    std::auto_ptr<Vec_t> f   = checkoutVec();
-    std::auto_ptr<Vec_t> Sf  = checkoutVec();
-    std::auto_ptr<Vec_t> Du  = checkoutVec();
-    f->replicate(vox);
-    Sf->replicate(vox);
-    Du->replicate(vox);
+    std::auto_ptr<Vec_t> f   = checkoutVec(vox);
+    std::auto_ptr<Vec_t> Sf  = checkoutVec(vox);
+    std::auto_ptr<Vec_t> Du  = checkoutVec(vox);
 
     COUTDEBUG("Computing the interfacial forces and setting single-layer density");
     if (params_.solve_for_velocity){
@@ -940,18 +1119,22 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::ImplicitMatvecPhysical(
         Intfcl_force_.implicitTractionJump(S_, vox, ten, *f);
         axpy(dt_, *f, *f);
     }
-    stokes_.SetDensitySL(f.get());
 
     if( ves_props_.has_contrast ){
         COUTDEBUG("Setting the double-layer density");
         av(ves_props_.dl_coeff, vox, *Du);
-        stokes_.SetDensityDL(Du.get());
-    } else {
-        stokes_.SetDensityDL(NULL);
     }
 
-    COUTDEBUG("Calling stokes");
-    stokes_(*Sf);
+    if (lowp_matvec_){
+        COUTDEBUG("Calling single precision stokes");
+        CHK(StokesLowp(f.get(), ves_props_.has_contrast ? Du.get() : NULL, *Sf));
+    } else {
+        stokes_.SetDensitySL(f.get());
+        stokes_.SetDensityDL(ves_props_.has_contrast ? Du.get() : NULL);
+
+        COUTDEBUG("Calling stokes");
+        stokes_(*Sf);
+    }
 
     COUTDEBUG("Computing the div term");
     //! @note For some reason, doing the linear algebraic manipulation
@@ -963,9 +1146,9 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::ImplicitMatvecPhysical(
     axpy((value_type) -1.0, ten, ten);
 
     if( ves_props_.has_contrast )
-        av(ves_props_.vel_coeff, vox, vox);
-
-    axpy((value_type) -1.0, *Sf, vox, vox);
+        Evaluate(expr(ves_props_.vel_coeff) * expr(vox) - expr(*Sf), vox);
+    else
+        axpy((value_type) -1.0, *Sf, vox, vox);
 
     ASSERT(vox.getDevice().isNumeric(vox.begin(), vox.size()), "Non-numeric velocity");
     ASSERT(ten.getDevice().isNumeric(ten.begin(), ten.size()), "Non-numeric divergence");
@@ -987,23 +1170,18 @@ ImplicitApply(const POp_t *o, const value_type *x, value_type *y)
     o->Context((const void**) &F);
     size_t vsz(F->stokesBlockSize()), tsz(F->tensionBlockSize());
 
-    std::auto_ptr<Vec_t> vox = F->checkoutVec();
-    std::auto_ptr<Sca_t> ten = F->checkoutSca();
-    vox->replicate(F->pos_vel_);
-    ten->replicate(F->tension_);
+    std::auto_ptr<Vec_t> vox = F->checkoutVec(F->pos_vel_);
+    std::auto_ptr<Sca_t> ten = F->checkoutSca(F->tension_);
 
     COUTDEBUG("Unpacking the input from parallel vector");
     if (F->params_.pseudospectral){
         vox->getDevice().Memcpy(vox->begin(), x    , vsz * sizeof(value_type), device_type::MemcpyHostToDevice);
         ten->getDevice().Memcpy(ten->begin(), x+vsz, tsz * sizeof(value_type), device_type::MemcpyHostToDevice);
     } else {  /* Galerkin */
-        std::auto_ptr<Vec_t> voxSh = F->checkoutVec();
-        std::auto_ptr<Sca_t> tSh   = F->checkoutSca();
-        std::auto_ptr<Vec_t> wrk   = F->checkoutVec();
+        std::auto_ptr<Vec_t> voxSh = F->checkoutVec(*vox);
+        std::auto_ptr<Sca_t> tSh   = F->checkoutSca(*ten);
+        std::auto_ptr<Vec_t> wrk   = F->checkoutVec(*vox);
 
-        voxSh->replicate(*vox);
-        tSh->replicate(*ten);
-        wrk->replicate(*vox);
         voxSh->getDevice().Memcpy(voxSh->begin(), x    , vsz * sizeof(value_type), device_type::MemcpyHostToDevice);
         tSh  ->getDevice().Memcpy(tSh->begin()  , x+vsz, tsz * sizeof(value_type), device_type::MemcpyHostToDevice);
 
@@ -1024,13 +1202,9 @@ ImplicitApply(const POp_t *o, const value_type *x, value_type *y)
         ten->getDevice().Memcpy(y+vsz, ten->begin(), tsz * sizeof(value_type), device_type::MemcpyDeviceToHost);
     } else {  /* Galerkin */
         COUTDEBUG("Mapping the matvec to physical space");
-        std::auto_ptr<Vec_t> voxSh = F->checkoutVec();
-        std::auto_ptr<Sca_t> tSh   = F->checkoutSca();
-        std::auto_ptr<Vec_t> wrk   = F->checkoutVec();
-
-        voxSh->replicate(*vox);
-        tSh->replicate(*ten);
-        wrk->replicate(*vox);
+        std::auto_ptr<Vec_t> voxSh = F->checkoutVec(*vox);
+        std::auto_ptr<Sca_t> tSh   = F->checkoutSca(*ten);
+        std::auto_ptr<Vec_t> wrk   = F->checkoutVec(*vox);
 
         F->sht_.forward(*vox, *wrk, *voxSh);
         F->sht_.forward(*ten, *wrk, *tSh);
@@ -1061,17 +1235,12 @@ ImplicitPrecond(const PSolver_t *ksp, const value_type *x, value_type *y)
 
     size_t vsz(F->stokesBlockSize()), tsz(F->tensionBlockSize());
 
-    std::auto_ptr<Vec_t> vox = F->checkoutVec();
-    std::auto_ptr<Vec_t> vxs = F->checkoutVec();
-    std::auto_ptr<Vec_t> wrk = F->checkoutVec();
-    vox->replicate(F->pos_vel_);
-    vxs->replicate(F->pos_vel_);
-    wrk->replicate(F->pos_vel_);
+    std::auto_ptr<Vec_t> vox = F->checkoutVec(F->pos_vel_);
+    std::auto_ptr<Vec_t> vxs = F->checkoutVec(F->pos_vel_);
+    std::auto_ptr<Vec_t> wrk = F->checkoutVec(F->pos_vel_);
 
-    std::auto_ptr<Sca_t> ten = F->checkoutSca();
-    std::auto_ptr<Sca_t> tns = F->checkoutSca();
-    ten->replicate(F->tension_);
-    tns->replicate(F->tension_);
+    std::auto_ptr<Sca_t> ten = F->checkoutSca(F->tension_);
+    std::auto_ptr<Sca_t> tns = F->checkoutSca(F->tension_);
 
     COUTDEBUG("Unpacking the input parallel vector");
     if (F->params_.pseudospectral){
@@ -1084,9 +1253,14 @@ ImplicitPrecond(const PSolver_t *ksp, const value_type *x, value_type *y)
         tns->getDevice().Memcpy(tns->begin(), x+vsz, tsz * sizeof(value_type), device_type::MemcpyHostToDevice);
     }
 
-    COUTDEBUG("Applying diagonal preconditioner");
-    F->sht_.ScaleFreq(vxs->begin(), vxs->getNumSubFuncs(), F->position_precond.begin(), vxs->begin());
-    F->sht_.ScaleFreq(tns->begin(), tns->getNumSubFuncs(), F->tension_precond.begin() , tns->begin());
+    if (F->params_.time_precond == TwoLevelSpectral){
+        COUTDEBUG("Applying two-level preconditioner");
+        CHK(F->TwoLevelCorrection(*vxs, *tns));
+    } else {
+        COUTDEBUG("Applying diagonal preconditioner");
+        F->sht_.ScaleFreq(vxs->begin(), vxs->getNumSubFuncs(), F->position_precond.begin(), vxs->begin());
+        F->sht_.ScaleFreq(tns->begin(), tns->getNumSubFuncs(), F->tension_precond.begin() , tns->begin());
+    }
 
     if (F->params_.pseudospectral){
         F->sht_.backward(*vxs, *wrk, *vox);
@@ -1108,6 +1282,83 @@ ImplicitPrecond(const PSolver_t *ksp, const value_type *x, value_type *y)
     return ErrorEvent::Success;
 }
 
+// Two-level preconditioner on the SH coefficients of the residual:
+// r_c  = R r                     // truncation to the coarse order
+// e_c ~= A_c^{-1} r_c            // loose solve with the coarse operator
+// y    = P e_c + (I - P R) D r   // D is the diagonal preconditioner
+//
+// Notes: the coarse solve is inexact, so the preconditioner changes
+// between applications and a flexible Krylov method should be used.
+template<typename SurfContainer, typename Interaction>
+Error_t InterfacialVelocity<SurfContainer, Interaction>::
+TwoLevelCorrection(Vec_t &vxs, Sca_t &tns) const
+{
+    PROFILESTART();
+    ASSERT(coarse_ != NULL, "The coarse level isn't set up yet");
+    const InterfacialVelocity *C(coarse_);
+    size_t vsz(C->stokesBlockSize()), tsz(C->tensionBlockSize());
+
+    std::auto_ptr<Vec_t> vxc = C->checkoutVec(C->pos_vel_);
+    std::auto_ptr<Vec_t> vox = C->checkoutVec(C->pos_vel_);
+    std::auto_ptr<Vec_t> wrk = C->checkoutVec(C->pos_vel_);
+    std::auto_ptr<Sca_t> tnc = C->checkoutSca(C->tension_);
+    std::auto_ptr<Sca_t> ten = C->checkoutSca(C->tension_);
+
+    COUTDEBUG("Restricting the residual to the coarse order");
+    ResampleCoeffs(vxs, *vxc);
+    ResampleCoeffs(tns, *tnc);
+
+    sht_.ScaleFreq(vxs.begin(), vxs.getNumSubFuncs(), position_precond.begin(), vxs.begin());
+    sht_.ScaleFreq(tns.begin(), tns.getNumSubFuncs(), tension_precond.begin() , tns.begin());
+
+    typename PVec_t::iterator i(NULL);
+    typename PVec_t::size_type rsz;
+    CHK(C->parallel_rhs_->GetArray(i, rsz));
+    ASSERT(rsz==vsz+tsz,"Bad sizes");
+
+    if (C->params_.pseudospectral){
+        C->sht_.backward(*vxc, *wrk, *vox);
+        C->sht_.backward(*tnc, *wrk, *ten);
+        vox->getDevice().Memcpy(i    , vox->begin(), vsz * sizeof(value_type), device_type::MemcpyDeviceToHost);
+        ten->getDevice().Memcpy(i+vsz, ten->begin(), tsz * sizeof(value_type), device_type::MemcpyDeviceToHost);
+    } else {  /* Galerkin */
+        vxc->getDevice().Memcpy(i    , vxc->begin(), vsz * sizeof(value_type), device_type::MemcpyDeviceToHost);
+        tnc->getDevice().Memcpy(i+vsz, tnc->begin(), tsz * sizeof(value_type), device_type::MemcpyDeviceToHost);
+    }
+    CHK(C->parallel_rhs_->RestoreArray(i));
+
+    CHK(C->parallel_solver_->InitialGuessNonzero(false));
+    Error_t err = C->parallel_solver_->Solve(C->parallel_rhs_, C->parallel_u_);
+    size_t iter;
+    CHK(C->parallel_solver_->IterationNumber(iter));
+    COUTDEBUG("Coarse solver returned after "<<iter<<" iteration(s)");
+
+    CHK(C->parallel_u_->GetArray(i, rsz));
+    if (C->params_.pseudospectral){
+        vox->getDevice().Memcpy(vox->begin(), i    , vsz * sizeof(value_type), device_type::MemcpyHostToDevice);
+        ten->getDevice().Memcpy(ten->begin(), i+vsz, tsz * sizeof(value_type), device_type::MemcpyHostToDevice);
+        C->sht_.forward(*vox, *wrk, *vxc);
+        C->sht_.forward(*ten, *wrk, *tnc);
+    } else {  /* Galerkin */
+        vxc->getDevice().Memcpy(vxc->begin(), i    , vsz * sizeof(value_type), device_type::MemcpyHostToDevice);
+        tnc->getDevice().Memcpy(tnc->begin(), i+vsz, tsz * sizeof(value_type), device_type::MemcpyHostToDevice);
+    }
+    CHK(C->parallel_u_->RestoreArray(i));
+
+    COUTDEBUG("Prolongating the coarse correction");
+    ResampleCoeffs(*vxc, vxs);
+    ResampleCoeffs(*tnc, tns);
+
+    C->recycle(vxc);
+    C->recycle(vox);
+    C->recycle(wrk);
+    C->recycle(tnc);
+    C->recycle(ten);
+
+    PROFILEEND("",0);
+    return err;
+}
+
 template<typename SurfContainer, typename Interaction>
 Error_t InterfacialVelocity<SurfContainer, Interaction>::
 Solve(const PVec_t *rhs, PVec_t *u0, const value_type &dt, const SolverScheme &scheme) const
@@ -1115,17 +1366,148 @@ Solve(const PVec_t *rhs, PVec_t *u0, const value_type &dt, const SolverScheme &s
     PROFILESTART();
     INFO("Solving for position/velocity and tension using "<<scheme<<" scheme.");
 
+    if (params_.mixed_precision){
+        Error_t err = SolveRefine(rhs, u0);
+        PROFILEEND("",0);
+        return err;
+    }
+
     Error_t err = parallel_solver_->Solve(parallel_rhs_, parallel_u_);
     typename PVec_t::size_type iter;
     CHK(parallel_solver_->IterationNumber(iter));
 
     INFO("Parallel solver returned after "<<iter<<" iteration(s).");
+    Telemetry::AddIterations(iter);
     parallel_solver_->ViewReport();
 
     PROFILEEND("",0);
     return err;
 }
 
+// Mixed precision iterative refinement:
+// r    = rhs - A u                 // residual with the working precision operator
+// A du = r                         // correction with the single precision operator
+// u    = u + du
+//
+// Notes: the stokes evaluation (FMM, near-singular, and self
+// interaction) of the inner matvec is in single precision; the
+// outer loop recovers the accuracy of the working precision solve.
+// A failed inner solve or a residual that is not within time_tol
+// after refine_iter_max steps is returned as an error so that the
+// step is rejected.
+template<typename SurfContainer, typename Interaction>
+Error_t InterfacialVelocity<SurfContainer, Interaction>::
+SolveRefine(const PVec_t *rhs, PVec_t *u0) const
+{
+    PROFILESTART();
+    ASSERT(stokes_lowp_ != NULL, "Single precision stokes is not set up");
+
+    PVec_t *res(NULL), *du(NULL);
+    CHK(rhs->ReplicateTo(&res));
+    CHK(rhs->ReplicateTo(&du));
+    CHK(res->SetName("refinement residual"));
+    CHK(du->SetName("refinement correction"));
+
+    value_type rhs_nrm(0), res_nrm(0);
+    CHK(rhs->Norm(rhs_nrm));
+    rhs_nrm = (rhs_nrm > 0) ? rhs_nrm : 1.0;
+
+    Error_t err(ErrorEvent::Success);
+    size_t iter(0), total_iter(0);
+    int it(0);
+    for (; it<=params_.refine_iter_max; ++it){
+        // the sign is flipped, res = A u - rhs, and corrected below
+        lowp_matvec_ = false;
+        CHK(parallel_matvec_->Apply(u0, res));
+        CHK(res->axpy(-1.0, rhs));
+        CHK(res->Norm(res_nrm));
+        INFO("Refinement step "<<it<<", relative residual "<<res_nrm/rhs_nrm);
+
+        if (res_nrm <= params_.time_tol*rhs_nrm || it==params_.refine_iter_max) break;
+
+        // the single precision sources are set up only for the steps
+        // that need a correction
+        if (!lowp_src_set_){
+            CHK(SetSrcCoordLowp());
+            lowp_src_set_ = true;
+        }
+
+        lowp_matvec_ = true;
+        CHK(parallel_solver_->InitialGuessNonzero(false));
+        CHK(parallel_solver_->Solve(res, du));
+        lowp_matvec_ = false;
+
+        CHK(parallel_solver_->IterationNumber(iter));
+        total_iter += iter;
+        err = parallel_solver_->ViewReport();
+        if (err != ErrorEvent::Success){
+            CERR("The inner solve of the iterative refinement diverged");
+            break;
+        }
+        CHK(u0->axpy(-1.0, du));
+    }
+
+    INFO("Iterative refinement returned after "<<it<<" step(s) and "<<total_iter<<" inner iteration(s).");
+    Telemetry::AddIterations(total_iter);
+    if (err == ErrorEvent::Success && res_nrm > params_.time_tol*rhs_nrm){
+        CERR("Iterative refinement did not reach the tolerance (relative residual "<<res_nrm/rhs_nrm<<")");
+        err = ErrorEvent::AccuracyError;
+    }
+
+    delete res;
+    delete du;
+
+    PROFILEEND("",0);
+    return err;
+}
+
+template<typename SurfContainer, typename Interaction>
+Error_t InterfacialVelocity<SurfContainer, Interaction>::
+SetSrcCoordLowp() const
+{
+    PROFILESTART();
+    const Vec_t &x(S_.getPosition());
+    pvfmm::Vector<lowp_type> lx(x.size());
+    std::copy(x.begin(), x.end(), &lx[0]);
+    stokes_lowp_->SetSrcCoord(lx);
+
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
+template<typename SurfContainer, typename Interaction>
+Error_t InterfacialVelocity<SurfContainer, Interaction>::
+StokesLowp(const Vec_t *fsl, const Vec_t *fdl, Vec_t &vel) const
+{
+    PROFILESTART();
+    typedef pvfmm::Vector<lowp_type> LVec_t;
+    LVec_t lf;
+
+    // the densities are copied by stokes, lf can be reused
+    if (fsl){
+        lf.ReInit(fsl->size());
+        std::copy(fsl->begin(), fsl->end(), &lf[0]);
+        stokes_lowp_->SetDensitySL(&lf);
+    } else {
+        stokes_lowp_->SetDensitySL((const LVec_t*) NULL);
+    }
+
+    if (fdl){
+        lf.ReInit(fdl->size());
+        std::copy(fdl->begin(), fdl->end(), &lf[0]);
+        stokes_lowp_->SetDensityDL(&lf);
+    } else {
+        stokes_lowp_->SetDensityDL((const LVec_t*) NULL);
+    }
+
+    const LVec_t &lv((*stokes_lowp_)());
+    ASSERT(lv.Dim()==vel.size(), "Size mismatch in single precision stokes");
+    std::copy(&lv[0], &lv[0]+lv.Dim(), vel.begin());
+
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
 template<typename SurfContainer, typename Interaction>
 Error_t InterfacialVelocity<SurfContainer, Interaction>::Update(PVec_t *u0)
 {
@@ -1145,13 +1527,9 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::Update(PVec_t *u0)
         tension_.getDevice().Memcpy(tension_.begin(), i+vsz, tsz * sizeof(value_type), device_type::MemcpyHostToDevice);
     } else { /* Galerkin */
         COUTDEBUG("Unpacking the solution from parallel vector");
-        std::auto_ptr<Vec_t> voxSh = checkoutVec();
-        std::auto_ptr<Sca_t> tSh   = checkoutSca();
-        std::auto_ptr<Vec_t> wrk   = checkoutVec();
-
-        voxSh->replicate(pos_vel_);
-        tSh->replicate(tension_);
-        wrk->replicate(pos_vel_);
+        std::auto_ptr<Vec_t> voxSh = checkoutVec(pos_vel_);
+        std::auto_ptr<Sca_t> tSh   = checkoutSca(tension_);
+        std::auto_ptr<Vec_t> wrk   = checkoutVec(pos_vel_);
 
         voxSh->getDevice().Memcpy(voxSh->begin(), i    , vsz * sizeof(value_type), device_type::MemcpyHostToDevice);
         tSh  ->getDevice().Memcpy(tSh  ->begin(), i+vsz, tsz * sizeof(value_type), device_type::MemcpyHostToDevice);
@@ -1190,10 +1568,8 @@ updateFarField() const
     CHK(this->BgFlow(pos_vel_, this->dt_));
 
     if (this->interaction_.HasInteraction()){
-        std::auto_ptr<Vec_t>        fi  = checkoutVec();
-        std::auto_ptr<Vec_t>        vel = checkoutVec();
-        fi->replicate(pos_vel_);
-        vel->replicate(pos_vel_);
+        std::auto_ptr<Vec_t>        fi  = checkoutVec(pos_vel_);
+        std::auto_ptr<Vec_t>        vel = checkoutVec(pos_vel_);
 
         Intfcl_force_.bendingForce(S_, *fi);
         Intfcl_force_.tensileForce(S_, tension_, *vel);
@@ -1214,13 +1590,9 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::
 CallInteraction(const Vec_t &src, const Vec_t &den, Vec_t &pot) const
 {
     PROFILESTART();
-    std::auto_ptr<Vec_t>        X = checkoutVec();
-    std::auto_ptr<Vec_t>        D = checkoutVec();
-    std::auto_ptr<Vec_t>        P = checkoutVec();
-
-    X->replicate(src);
-    D->replicate(den);
-    P->replicate(pot);
+    std::auto_ptr<Vec_t>        X = checkoutVec(src);
+    std::auto_ptr<Vec_t>        D = checkoutVec(den);
+    std::auto_ptr<Vec_t>        P = checkoutVec(pot);
 
     // shuffle
     ShufflePoints(src, *X);
@@ -1261,11 +1633,8 @@ template<typename SurfContainer, typename Interaction>
 Error_t InterfacialVelocity<SurfContainer, Interaction>::
 EvalFarInter_Imp(const Vec_t &src, const Vec_t &fi, Vec_t &vel) const
 {
-    std::auto_ptr<Vec_t> den    = checkoutVec();
-    std::auto_ptr<Vec_t> slf    = checkoutVec();
-
-    den->replicate(src);
-    slf->replicate(vel);
+    std::auto_ptr<Vec_t> den    = checkoutVec(src);
+    std::auto_ptr<Vec_t> slf    = checkoutVec(vel);
 
     // multiply area elment into density
     xv(S_.getAreaElement(), fi, *den);
@@ -1348,6 +1717,9 @@ EvalFarInter_ImpUpsample(const Vec_t &src, const Vec_t &fi, Vec_t &vel) const
 
 // Linear solve to compute tension such that surface divergence:
 // surf_div( velocity + stokes(tension) ) = 0
+//
+// Notes: the operator is block diagonal (self interaction only) and
+// each vesicle is solved to the tolerance independently.
 template<typename SurfContainer, typename Interaction>
 Error_t InterfacialVelocity<SurfContainer, Interaction>::getTension(
     const Vec_t &vel_in, Sca_t &tension) const
@@ -1362,18 +1734,17 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::getTension(
     axpy(static_cast<value_type>(-1), *rhs, *rhs);
 
     int iter(params_.time_iter_max);
-    int rsrt(params_.time_iter_max);
     value_type tol(params_.time_tol),relres(params_.time_tol);
     enum BiCGSReturn solver_ret;
     Error_t ret_val(ErrorEvent::Success);
 
     COUTDEBUG("Solving for tension");
-    solver_ret = linear_solver_(*this, tension, *rhs, rsrt, iter, relres);
+    solver_ret = linear_solver_(*this, tension, *rhs, iter, relres);
 
     if ( solver_ret  != BiCGSSuccess )
         ret_val = ErrorEvent::DivergenceError;
 
-    COUTDEBUG("Tension solve: Total iter = "<< iter<<", relres = "<<relres);
+    COUTDEBUG("Tension solve: max iter = "<< iter<<", max relres = "<<relres);
     COUTDEBUG("Checking true relres");
     ASSERT(((*this)(tension, *wrk),
             axpy(static_cast<value_type>(-1), *wrk, *rhs, *wrk),
@@ -1533,47 +1904,40 @@ StokesError(const Vec_t &x) const
     return stokes_error;
 }
 
-template <class Vec_t, class SHT>
-static std::vector<typename Vec_t::value_type> inner_prod(const Vec_t& v1, const Vec_t& v2, SHT* sh_trans, int rep_exp){
+// weights of the reparametrization energy, the energy of a vesicle
+// is sum_n A[n] |x_n|^2 where x_n are the coefficients of order n
+template <class value_type>
+static void rep_weights(int p, int rep_exp, std::vector<value_type> &A){
+  A.resize(p+1);
+  long filter_freq_=(rep_exp?p/2:p/3);
+  for(int ii=0; ii<= p; ++ii){
+    value_type a = 1.0 - (rep_exp?std::pow(ii*1.0/filter_freq_,rep_exp):0);
+    a *= (ii > filter_freq_ ? 0.0 : 1.0 );
+    A[ii] = 1.0 - a;
+  }
+}
+
+// inner product of the coefficients v1_ and v2_ of each vesicle,
+// weighted by A (unweighted when A is NULL)
+template <class Vec_t>
+static void coeff_prod(const Vec_t& v1_, const Vec_t& v2_,
+    const std::vector<typename Vec_t::value_type> *A,
+    std::vector<typename Vec_t::value_type> &E){
   typedef typename Vec_t::value_type value_type;
 
-  static Vec_t w, v1_, v2_;
-  { // Set v1_
-    v1_.replicate(v1);
-    w  .replicate(v1);
-    sh_trans->forward(v1, w, v1_);
-  }
-  { // Set v2_
-    v2_.replicate(v2);
-    w  .replicate(v2);
-    sh_trans->forward(v2, w, v2_);
-  }
-  size_t p=v1.getShOrder();
-  int ns_x = v1.getNumSubFuncs();
-
-  assert(p<256);
-  assert(rep_exp<128);
-  static std::vector<value_type> A_[256*128];
-  std::vector<value_type>& A=A_[rep_exp*256+p];
-  if(!A.size()){
-    A.resize(p+1);
-    long filter_freq_=(rep_exp?p/2:p/3);
-    for(int ii=0; ii<= p; ++ii){
-      value_type a = 1.0 - (rep_exp?std::pow(ii*1.0/filter_freq_,rep_exp):0);
-      a *= (ii > filter_freq_ ? 0.0 : 1.0 );
-      A[ii] = 1.0 - a;
-    }
-  }
+  size_t p=v1_.getShOrder();
+  int ns_x = v1_.getNumSubFuncs();
 
-  std::vector<value_type> E(ns_x/COORD_DIM,0);
+  E.assign(ns_x/COORD_DIM,0);
   for(int ii=0; ii<= p; ++ii){
-    value_type* inPtr_v1 = v1_.begin() + ii;
-    value_type* inPtr_v2 = v2_.begin() + ii;
+    const value_type* inPtr_v1 = v1_.begin() + ii;
+    const value_type* inPtr_v2 = v2_.begin() + ii;
+    value_type a = A ? (*A)[ii] : 1.0;
     int len = 2*ii + 1 - (ii/p);
     for(int jj=0; jj< len; ++jj){
       int dist = (p + 1 - (jj + 1)/2);
       for(int ss=0; ss<ns_x; ++ss){
-        E[ss/COORD_DIM] += A[ii]*(*inPtr_v1)*(*inPtr_v2);
+        E[ss/COORD_DIM] += a*(*inPtr_v1)*(*inPtr_v2);
         inPtr_v1 += dist;
         inPtr_v2 += dist;
       }
@@ -1583,58 +1947,57 @@ static std::vector<typename Vec_t::value_type> inner_prod(const Vec_t& v1, const
       inPtr_v2 += jj%2;
     }
   }
-
-  return E;
 }
 
-template <class Vec_t, class SHT>
-static void sht_filter(const Vec_t& v1, Vec_t& v2, SHT* sh_trans, int rep_exp){
+// v2_ = alpha * A .* v1_ in the coefficient space (the gradient of
+// the energy for alpha=2)
+template <class Vec_t>
+static void coeff_scale(const Vec_t& v1_, const std::vector<typename Vec_t::value_type> &A,
+    typename Vec_t::value_type alpha, Vec_t& v2_){
   typedef typename Vec_t::value_type value_type;
 
-  static Vec_t w, v1_;
-  { // Set v1_
-    v1_.replicate(v1);
-    w  .replicate(v1);
-    sh_trans->forward(v1, w, v1_);
-  }
-  size_t p=v1.getShOrder();
-  int ns_x = v1.getNumSubFuncs();
-
-  assert(p<256);
-  assert(rep_exp<128);
-  static std::vector<value_type> A_[256*128];
-  std::vector<value_type>& A=A_[rep_exp*256+p];
-  if(!A.size()){
-    A.resize(p+1);
-    long filter_freq_=(rep_exp?p/2:p/3);
-    for(int ii=0; ii<= p; ++ii){
-      value_type a = 1.0 - (rep_exp?std::pow(ii*1.0/filter_freq_,rep_exp):0);
-      a *= (ii > filter_freq_ ? 0.0 : 1.0 );
-      A[ii] = 1.0 - a;
-    }
-  }
+  v2_.replicate(v1_);
+  size_t p=v1_.getShOrder();
+  int ns_x = v1_.getNumSubFuncs();
 
-  value_type E=0;
   for(int ii=0; ii<= p; ++ii){
-    value_type* inPtr_v1 = v1_.begin() + ii;
+    const value_type* inPtr_v1 = v1_.begin() + ii;
+    value_type* outPtr_v2 = v2_.begin() + ii;
     int len = 2*ii + 1 - (ii/p);
     for(int jj=0; jj< len; ++jj){
       int dist = (p + 1 - (jj + 1)/2);
       for(int ss=0; ss<ns_x; ++ss){
-        inPtr_v1[0] *= -A[ii];
+        *outPtr_v2 = alpha*A[ii]*(*inPtr_v1);
         inPtr_v1 += dist;
+        outPtr_v2 += dist;
       }
       inPtr_v1--;
+      outPtr_v2--;
       inPtr_v1 += jj%2;
+      outPtr_v2 += jj%2;
     }
   }
+}
 
-  { // Set v2
-    v2 .replicate(v1);
-    sh_trans->backward(v1_, w, v2);
-  }
+// replaces x by its subfields keep[0], keep[1], ..., tmp is workspace
+template <class Container>
+static void compact_subs(std::auto_ptr<Container> &x,
+    const std::vector<size_t> &keep, std::auto_ptr<Container> &tmp){
+  GatherSubs(*x, keep, *tmp);
+  Container *t = x.release();
+  x.reset(tmp.release());
+  tmp.reset(t);
 }
 
+// Minimizes the reparametrization energy by a nonlinear conjugate
+// gradient (Polak-Ribiere) iteration with exact line search along
+// the tangential search direction. Each vesicle has its own direction
+// and step and it is dropped from the iteration once its step is
+// below rep_tol. The remaining vesicles are then gathered into S_rep_
+// so that the transforms are only applied to them.
+//
+// Notes: the position is kept in coefficient space (xc) along with the
+// geometry, so the energy and the line search need no transforms.
 template<typename SurfContainer, typename Interaction>
 Error_t InterfacialVelocity<SurfContainer, Interaction>::reparam()
 {
@@ -1663,124 +2026,187 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::reparam()
         sh_trans = &sht_;
     }
 
-    std::auto_ptr<Vec_t> u1 = checkoutVec();
-    std::auto_ptr<Vec_t> u2 = checkoutVec();
-    std::auto_ptr<Sca_t> wrk = checkoutSca();
-    u1 ->replicate(Surf->getPosition());
-    u2 ->replicate(Surf->getPosition());
-    wrk->replicate(Surf->getPosition());
-    long N_ves = u1->getNumSubs();
+    //Advecting tension (useless for implicit)
+    bool adv_tension(params_.scheme != GloballyImplicit &&
+        params_.scheme != GloballyImplicitBDF2 &&
+        params_.scheme != GloballyImplicitSDC);
+    if (adv_tension && params_.rep_upsample){
+        WARN("Reparametrizaition is not advecting the tension in the upsample mode (fix!)");
+        adv_tension = false;
+    }
+
+    int p(Surf->getShOrder());
+    std::vector<value_type> A;
+    rep_weights(p, rep_exp, A);
+
+    std::auto_ptr<Vec_t> xc   = checkoutVec(Surf->getPosition()); // coefficients of the position
+    std::auto_ptr<Vec_t> uc   = checkoutVec(Surf->getPosition()); // coefficients of the descent direction
+    std::auto_ptr<Vec_t> gc   = checkoutVec(Surf->getPosition()); // uc of the previous iteration
+    std::auto_ptr<Vec_t> dc   = checkoutVec(Surf->getPosition()); // coefficients of the search direction
+    std::auto_ptr<Vec_t> u1   = checkoutVec(Surf->getPosition());
+    std::auto_ptr<Vec_t> u2   = checkoutVec(Surf->getPosition());
+    std::auto_ptr<Vec_t> w    = checkoutVec(Surf->getPosition());
+    std::auto_ptr<Vec_t> vtmp = checkoutVec();
+    std::auto_ptr<Sca_t> tns  = checkoutSca();
+    std::auto_ptr<Sca_t> wrk  = checkoutSca(Surf->getPosition());
+    size_t N_ves(Surf->getNumberOfSurfaces());
+
+    sh_trans->forward(Surf->getPosition(), *w, *xc);
+    std::vector<value_type> xx, xu, xd, dd, uu, ug, gg, beta, c;
 
     value_type E0=0;
     { // Compute energy E0
-        std::vector<value_type>  x2=inner_prod(Surf->getPosition(), Surf->getPosition(), sh_trans, rep_exp);
-        for(long i=0;i<x2.size();i++) E0+=x2[i];
+        coeff_prod(*xc, *xc, &A, xx);
+        for(long i=0;i<xx.size();i++) E0+=xx[i];
     }
 
+    SurfContainer *R(Surf); // the surface of the active vesicles
+    Sca_t *tension(&tension_);
+    rep_active_.resize(N_ves);
+    for (size_t i=0; i<N_ves; ++i) rep_active_[i]=i;
+
     int ii(0);
-    std::vector<value_type> E;
-    while ( ii < rep_maxit )
+    while ( ii < rep_maxit && rep_active_.size() )
     {
-        //Surf->getSmoothedShapePositionReparam(*u1);
-        //axpy(static_cast<value_type>(-1), Surf->getPosition(), *u1, *u1);
-        sht_filter(Surf->getPosition(), *u1, sh_trans, rep_exp);
-        Surf->mapToTangentSpace(*u1, false /* upsample */);
-        { // Filter u1
-            static Vec_t u_, w;
-            u_.replicate(*u1);
-            w .replicate(*u1);
-            sh_trans->forward(*u1, w, u_);
-            sh_trans->backward(u_, w, *u1);
-        }
-        Surf->mapToTangentSpace(*u1, false /* upsample */);
-        { // Filter u1
-            static Vec_t u_, w;
-            u_.replicate(*u1);
-            w .replicate(*u1);
-            sh_trans->forward(*u1, w, u_);
-            sh_trans->backward(u_, w, *u1);
-        }
-
-        { // normalize u1 for each vesicle
-            long N = u1->getNumSubFuncs();
-            long M=u1->size()/N;
-            value_type* u=u1->begin();
-            for(long i=0;i<N/COORD_DIM;i++){
-                value_type max_v=0;
-                for(long j=0;j<M;j++){
-                    value_type x=u[j+M*(0+i*COORD_DIM)];
-                    value_type y=u[j+M*(1+i*COORD_DIM)];
-                    value_type z=u[j+M*(2+i*COORD_DIM)];
-                    max_v=std::max(max_v, sqrt(x*x+y*y+z*z));
-                }
-                for(long j=0;j<M;j++){
-                    u[j+M*(0+i*COORD_DIM)]/=max_v;
-                    u[j+M*(1+i*COORD_DIM)]/=max_v;
-                    u[j+M*(2+i*COORD_DIM)]/=max_v;
-                }
+        size_t n_act(rep_active_.size());
+
+        // steepest descent direction -A.*x, projected to the tangent
+        // space and filtered (twice)
+        coeff_scale(*xc, A, static_cast<value_type>(-1.0), *uc);
+        sh_trans->backward(*uc, *w, *u1);
+        R->mapToTangentSpace(*u1, false /* upsample */);
+        sh_trans->forward(*u1, *w, *uc);
+        sh_trans->backward(*uc, *w, *u1);
+        R->mapToTangentSpace(*u1, false /* upsample */);
+        sh_trans->forward(*u1, *w, *uc);
+
+        // search direction d = u + beta*d_prev, beta is reset to zero
+        // when d is not a descent direction
+        beta.assign(n_act, 0);
+        if (ii){
+            coeff_prod(*uc, *uc, NULL, uu);
+            coeff_prod(*uc, *gc, NULL, ug);
+            coeff_prod(*gc, *gc, NULL, gg);
+            coeff_prod(*xc, *uc, &A, xu);
+            coeff_prod(*xc, *dc, &A, xd);
+            for(size_t i=0; i<n_act; i++){
+                beta[i] = (gg[i]>0) ? std::max(static_cast<value_type>(0), (uu[i]-ug[i])/gg[i]) : 0;
+                if (xu[i]+beta[i]*xd[i] >= 0) beta[i]=0;
             }
-        }
-
-        std::vector<value_type>  x_dot_x =inner_prod(Surf->getPosition(), Surf->getPosition(), sh_trans, rep_exp);
-        std::vector<value_type>  x_dot_u1=inner_prod(Surf->getPosition(),                 *u1, sh_trans, rep_exp);
-        std::vector<value_type> u1_dot_u1=inner_prod(                *u1,                 *u1, sh_trans, rep_exp);
-
+            rep_coeff_.resize(n_act);
+            rep_coeff_.getDevice().Memcpy(rep_coeff_.begin(), &beta[0],
+                n_act * sizeof(value_type), device_type::MemcpyHostToDevice);
+            axpy(rep_coeff_, *dc, *uc, *dc);
+        } else
+            axpy(static_cast<value_type>(1.0), *uc, *dc);
+        axpy(static_cast<value_type>(1.0), *uc, *gc);
+        sh_trans->backward(*dc, *w, *u1);
+
+        // exact line search along the direction normalized by its
+        // largest pointwise norm, the step is capped by ts
+        coeff_prod(*xc, *dc, &A, xd);
+        coeff_prod(*dc, *dc, &A, dd);
+        c.assign(n_act, 0);
+        rep_keep_.clear();
         value_type dt_max(0);
-        std::vector<value_type> dt(x_dot_u1.size(),0);
-        for(long i=0; i<N_ves; i++){
-            dt[i]=std::min(ts, -x_dot_u1[i]/u1_dot_u1[i]);
-            if( dt[i]<rep_tol || (E.size() && (E[i]==0 /*|| E[i]-x_dot_x[i]<rep_tol*rep_tol*E[i]*/ )) ){
-                x_dot_x[i]=0;
-                dt[i]=0;
+        for(size_t i=0; i<n_act; i++){
+            long M=u1->getStride();
+            const value_type* u=u1->getSubN_begin(i);
+            value_type max_v=0;
+            for(long j=0;j<M;j++){
+                value_type x=u[j+M*0];
+                value_type y=u[j+M*1];
+                value_type z=u[j+M*2];
+                max_v=std::max(max_v, sqrt(x*x+y*y+z*z));
             }
-            dt_max=std::max(dt_max,dt[i]);
 
-            long N=u1->getStride()*DIM;
-            value_type* u1_=u1->getSubN_begin(i);
-            for(long j=0;j<N;j++) u1_[j]*=dt[i];
+            value_type dt(0);
+            if (max_v>0 && dd[i]>0) dt=std::min(ts, -xd[i]*max_v/dd[i]);
+            if (dt<rep_tol) continue; // converged
+            c[i]=dt/max_v;
+            dt_max=std::max(dt_max,dt);
+            rep_keep_.push_back(i);
         }
         if(dt_max==0) break;
-        E=x_dot_x;
-
-        //Advecting tension (useless for implicit)
-        if (params_.scheme != GloballyImplicit){
-            if (params_.rep_upsample)
-                WARN("Reparametrizaition is not advecting the tension in the upsample mode (fix!)");
-            else {
-                Surf->grad(tension_, *u2);
-                GeometricDot(*u2, *u1, *wrk);
-                axpy(1.0, *wrk, tension_, tension_);
-            }
+
+        rep_coeff_.resize(n_act);
+        rep_coeff_.getDevice().Memcpy(rep_coeff_.begin(), &c[0],
+            n_act * sizeof(value_type), device_type::MemcpyHostToDevice);
+
+        if (adv_tension){
+            R->grad(*tension, *u2);
+            av(rep_coeff_, *u1, *vtmp);
+            GeometricDot(*u2, *vtmp, *wrk);
+            axpy(static_cast<value_type>(1.0), *wrk, *tension, *tension);
         }
 
         //updating position
-        axpy(1.0, *u1, Surf->getPosition(), Surf->getPositionModifiable());
+        axpy(rep_coeff_, *u1, R->getPosition(), R->getPositionModifiable());
+        axpy(rep_coeff_, *dc, *xc, *xc);
 
-        COUTDEBUG("Iteration = "<<ii<<", dt = "<<dt_max);
+        COUTDEBUG("Iteration = "<<ii<<", dt = "<<dt_max<<", active vesicles = "<<rep_keep_.size());
         ++ii;
+
+        if (rep_keep_.size() < n_act){ // drop the converged vesicles
+            if (R != Surf){
+                ScatterSubs(R->getPosition(), rep_active_, Surf->getPositionModifiable());
+                if (adv_tension) ScatterSubs(*tension, rep_active_, tension_);
+            }
+            for (size_t i=0; i<rep_keep_.size(); ++i)
+                rep_active_[i] = rep_active_[rep_keep_[i]];
+            rep_active_.resize(rep_keep_.size());
+
+            if (S_rep_ && S_rep_->getShOrder() != p){
+                delete S_rep_;
+                S_rep_ = NULL;
+            }
+            if (S_rep_ == NULL)
+                S_rep_ = new SurfContainer(p, mats_, NULL, Surf->diffFilterFreq(),
+                    Surf->reparamFilterFreq(), params_.rep_type, params_.rep_exponent);
+
+            GatherSubs(Surf->getPosition(), rep_active_, S_rep_->getPositionModifiable());
+            if (adv_tension) GatherSubs(tension_, rep_active_, *tns);
+            R = S_rep_;
+            tension = tns.get();
+
+            compact_subs(xc, rep_keep_, vtmp);
+            compact_subs(dc, rep_keep_, vtmp);
+            compact_subs(gc, rep_keep_, vtmp);
+            uc->replicate(*xc);
+            u1->replicate(*xc);
+            u2->replicate(*xc);
+            w ->replicate(*xc);
+            vtmp->replicate(*xc);
+            wrk->replicate(*xc);
+        }
+    }
+
+    if (R != Surf){
+        ScatterSubs(R->getPosition(), rep_active_, Surf->getPositionModifiable());
+        if (adv_tension) ScatterSubs(*tension, rep_active_, tension_);
+    }
+    u1->replicate(Surf->getPosition());
+    u2->replicate(Surf->getPosition());
+    w ->replicate(Surf->getPosition());
+
+    { // coefficients of the final position
+        sh_trans->forward(Surf->getPosition(), *w, *u1);
     }
 
     value_type E1=0;
     { // Compute energy E1
-        std::vector<value_type>  x2=inner_prod(Surf->getPosition(), Surf->getPosition(), sh_trans, rep_exp);
-        for(long i=0;i<x2.size();i++) E1+=x2[i];
+        coeff_prod(*u1, *u1, &A, xx);
+        for(long i=0;i<xx.size();i++) E1+=xx[i];
     }
     INFO("Iterations = "<<ii<<", Energy = "<<E1<<", dE = "<<E1-E0);
     { // print log(coeff)
-      std::auto_ptr<Vec_t> x = checkoutVec();
-      { // Set x
-        std::auto_ptr<Vec_t> w   = checkoutVec();
-        x  ->replicate(Surf->getPosition());
-        w  ->replicate(Surf->getPosition());
-        sh_trans->forward(Surf->getPosition(), *w, *x);
-        recycle(w);
-      }
+      const Vec_t *x = u1.get();
       {
           size_t p=x->getShOrder();
           int ns_x = x->getNumSubFuncs();
           std::vector<value_type> coeff_norm0(p+1,0);
           for(int ii=0; ii<= p; ++ii){
-              value_type* inPtr_x = x->begin() + ii;
+              const value_type* inPtr_x = x->begin() + ii;
 
               int len = 2*ii + 1 - (ii/p);
               for(int jj=0; jj< len; ++jj){
@@ -1803,15 +2229,21 @@ Error_t InterfacialVelocity<SurfContainer, Interaction>::reparam()
           ss<<'\n';
           INFO(ss.str());
       }
-      recycle(x);
     }
 
     if (params_.rep_upsample)
         Resample(Surf->getPosition(), sht_upsample_, sht_, *u1, *u2,
             S_.getPositionModifiable());
 
+    recycle(xc);
+    recycle(uc);
+    recycle(gc);
+    recycle(dc);
     recycle(u1);
     recycle(u2);
+    recycle(w);
+    recycle(vtmp);
+    recycle(tns);
     recycle(wrk);
     PROFILEEND("",0);
 
@@ -1822,69 +2254,40 @@ template<typename SurfContainer, typename Interaction>
 std::auto_ptr<typename SurfContainer::Sca_t> InterfacialVelocity<SurfContainer, Interaction>::
 checkoutSca() const
 {
-    std::auto_ptr<Sca_t> scp;
-
-    if(scalar_work_q_.empty())
-        scp = static_cast<std::auto_ptr<Sca_t> >(new Sca_t);
-    else
-    {
-        scp = static_cast<std::auto_ptr<Sca_t> >(scalar_work_q_.front());
-        scalar_work_q_.pop();
-    }
+    return(sca_work_.checkout(S_.getPosition()));
+}
 
-    scp->replicate(S_.getPosition());
-    ++checked_out_work_sca_;
-    return(scp);
+template<typename SurfContainer, typename Interaction>
+std::auto_ptr<typename SurfContainer::Sca_t> InterfacialVelocity<SurfContainer, Interaction>::
+checkoutSca(const Sca_t &shape) const
+{
+    return(sca_work_.checkout(shape));
 }
+
 template<typename SurfContainer, typename Interaction>
 void InterfacialVelocity<SurfContainer, Interaction>::
 recycle(std::auto_ptr<Sca_t> scp) const
 {
-    scalar_work_q_.push(scp.release());
-    --checked_out_work_sca_;
+    sca_work_.recycle(scp);
 }
 
 template<typename SurfContainer, typename Interaction>
 std::auto_ptr<typename SurfContainer::Vec_t> InterfacialVelocity<SurfContainer, Interaction>::
 checkoutVec() const
 {
-    std::auto_ptr<Vec_t> vcp;
-
-    if(vector_work_q_.empty())
-        vcp = static_cast<std::auto_ptr<Vec_t> >(new Vec_t);
-    else
-    {
-        vcp = static_cast<std::auto_ptr<Vec_t> >(vector_work_q_.front());
-        vector_work_q_.pop();
-    }
-
-    vcp->replicate(S_.getPosition());
-    ++checked_out_work_vec_;
-
-    return(vcp);
+    return(vec_work_.checkout(S_.getPosition()));
 }
 
 template<typename SurfContainer, typename Interaction>
-void InterfacialVelocity<SurfContainer, Interaction>::
-recycle(std::auto_ptr<Vec_t> vcp) const
+std::auto_ptr<typename SurfContainer::Vec_t> InterfacialVelocity<SurfContainer, Interaction>::
+checkoutVec(const Sca_t &shape) const
 {
-    vector_work_q_.push(vcp.release());
-    --checked_out_work_vec_;
+    return(vec_work_.checkout(shape));
 }
 
 template<typename SurfContainer, typename Interaction>
 void InterfacialVelocity<SurfContainer, Interaction>::
-purgeTheWorkSpace() const
+recycle(std::auto_ptr<Vec_t> vcp) const
 {
-    while ( !scalar_work_q_.empty() )
-    {
-         delete scalar_work_q_.front();
-        scalar_work_q_.pop();
-    }
-
-    while ( !vector_work_q_.empty() )
-    {
-        delete vector_work_q_.front();
-        vector_work_q_.pop();
-    }
+    vec_work_.recycle(vcp);
 }
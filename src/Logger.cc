@@ -1,32 +1,23 @@
 #include "Logger.h"
 
-#include <algorithm> //to get for_each()
 #include <fstream>   //ofstream type
 #include <unistd.h>  //to get sleep()
 
 
-std::stack<double> Logger::TicStack;
-std::stack<double> Logger::FlopStack;
-std::map<std::string, LogEvent> Logger::PrflMap;
 std::string Logger::log_file;
 
+namespace {
+    // the Tic() values of each thread
+    const int MAX_TIC_DEPTH = 128;
+    double tic_stack[MAX_TIC_DEPTH];
+    int tic_depth(0);
+#pragma omp threadprivate(tic_stack, tic_depth)
+}
+
 // //The variables for the timing macro.
 // struct timeval  tt;
 // struct timezone ttz;
 
-template<typename T>
-void PrintLogEvent(const std::pair<T, LogEvent> &ev)
-{
-    int print_length = 27;
-    std::string printstr = ev.second.fun_name;
-    printstr.resize(print_length,' ');
-    printstr= "  " + printstr +
-        "%-8u \t %-4.3e \t %-4.3e \t %-4.3e \n";
-
-    printf(printstr.c_str(), ev.second.num_calls, ev.second.time,
-        ev.second.flop/1e9, ev.second.flop_rate);
-}
-
 double Logger::Now()
 {
     return(GETSECONDS());
@@ -35,129 +26,28 @@ double Logger::Now()
 double Logger::Tic()
 {
     double now = Logger::Now();
-    Logger::TicStack.push(now);
-
-    if ( Logger::FlopStack.empty() )
-        Logger::FlopStack.push(0); //in order to have the total number of flops
-
-    Logger::FlopStack.push(0);
+    if ( tic_depth < MAX_TIC_DEPTH )
+        tic_stack[tic_depth] = now;
+    else
+        CERR_LOC("Too many nested Logger::Tic() calls.","",sleep(0));
+    ++tic_depth;
     return(now);
 }
 
 double Logger::Toc()
 {
     double toc;
-    if(Logger::TicStack.empty())
+    if( tic_depth == 0 )
         CERR_LOC("There is no matching Logger::Tic() call.","", toc=0);
     else
     {
+        --tic_depth;
         toc = Logger::Now();
-        toc -= Logger::TicStack.top();
-        Logger::TicStack.pop();
+        toc -= (tic_depth < MAX_TIC_DEPTH) ? tic_stack[tic_depth] : toc;
     }
     return(toc);
 }
 
-void Logger::Record(std::string fun_name, std::string prefix,
-    double time, double flop)
-{
-#pragma omp critical (loggerRecord)
-    {
-        fun_name = prefix+fun_name;
-        flop += Logger::FlopStack.top();
-        Logger::FlopStack.pop();
-        if ( !Logger::FlopStack.empty() )
-            Logger::FlopStack.top() += flop;
-
-        if(Logger::PrflMap.count(fun_name))
-        {
-            Logger::PrflMap[fun_name].num_calls++;
-            Logger::PrflMap[fun_name].time +=time;
-            Logger::PrflMap[fun_name].flop +=flop;
-        }
-        else
-        {
-            LogEvent ev;
-            ev.fun_name  = fun_name;
-            ev.num_calls = 1;
-            ev.time      = time;
-            ev.flop      = flop;
-            Logger::PrflMap.insert(make_pair(fun_name, ev));
-        }
-    }
-}
-
-void Logger::PurgeProfileHistory()
-{
-    Logger::PrflMap.clear();
-
-    while ( !Logger::TicStack.empty() )
-        Logger::TicStack.pop();
-
-    while ( !Logger::FlopStack.empty() )
-        Logger::FlopStack.pop();
-}
-
-void Logger::Report(enum ReportFormat rf)
-{
-    std::multimap<double, LogEvent> ReportMap;
-    std::map<std::string, LogEvent>::iterator it;
-
-    for (it = Logger::PrflMap.begin();it != Logger::PrflMap.end(); ++it)
-        it->second.flop_rate = it->second.flop/it->second.time/1e9;
-
-    switch ( rf )
-    {
-        case SortFunName:
-            COUT("=====================================================================================\n"
-                <<" >Function name              Calls       Total time      GFlop           GFlop/sec\n"
-                <<"------------------------------------------------------------------------------------");
-            for_each(PrflMap.begin(), PrflMap.end(), &PrintLogEvent<std::string>);
-            break;
-
-        case SortNumCalls:
-            COUT("=====================================================================================\n"
-                <<"  Function name             >Calls       Total time      GFlop           GFlop/sec\n"
-                <<"------------------------------------------------------------------------------------");
-            for (it = Logger::PrflMap.begin();it != Logger::PrflMap.end(); ++it)
-                ReportMap.insert(std::make_pair(it->second.num_calls, it->second));
-            for_each(ReportMap.begin(), ReportMap.end(), &PrintLogEvent<double>);
-            break;
-
-        case SortTime:
-            COUT("=====================================================================================\n"
-                <<"  Function name              Calls      >Total time      GFlop           GFlop/sec\n"
-                <<"------------------------------------------------------------------------------------");
-            for (it = Logger::PrflMap.begin();it != Logger::PrflMap.end(); ++it)
-                ReportMap.insert(std::make_pair(it->second.time, it->second));
-            for_each(ReportMap.begin(), ReportMap.end(), &PrintLogEvent<double>);
-            break;
-
-        case SortFlop:
-            COUT("=====================================================================================\n"
-                <<"  Function name              Calls       Total time     >GFlop           GFlop/sec\n"
-                <<"------------------------------------------------------------------------------------");
-            for (it = Logger::PrflMap.begin();it != Logger::PrflMap.end(); ++it)
-                ReportMap.insert(std::make_pair(it->second.flop, it->second));
-            for_each(ReportMap.begin(), ReportMap.end(), &PrintLogEvent<double>);
-            break;
-
-        case SortFlopRate:
-            COUT("=====================================================================================\n"
-                <<"  Function name              Calls       Total time      GFlop          >GFlop/sec\n"
-                <<"------------------------------------------------------------------------------------");
-            for (it = Logger::PrflMap.begin();it != Logger::PrflMap.end(); ++it)
-                ReportMap.insert(std::make_pair(it->second.flop_rate, it->second));
-            for_each(ReportMap.begin(), ReportMap.end(), &PrintLogEvent<double>);
-            break;
-
-    }
-    COUT("=====================================================================================");
-
-    if(TicStack.size())
-        CERR_LOC("There may be unbalanced Tic() and Toc() calls.","",sleep(0));
-}
-
 void Logger::SetLogFile(std::string file_name)
 {
     log_file = file_name;
@@ -205,14 +95,6 @@ void Logger::Log(std::ostream &event)
     out.close();
 }
 
-double Logger::GetFlops()
-{
-    if ( !Logger::FlopStack.empty() )
-        return(Logger::FlopStack.top());
-    else
-        return(0);
-}
-
 std::ostream& alert(std::ostream& os)
 {
     if(os.iword(alert_xalloc) == false)
@@ -12,38 +12,40 @@ Monitor<EvolveSurface>::Monitor(const Parameters<value_type> *params) :
     V0_(-1),
     last_checkpoint_(-1),
     time_idx_(-1),
+    trajectory_(params->sh_order, params->filter_freq, params->trajectory_quantize),
+    trajectory_sht_(NULL),
+    last_frame_(-1),
+    rheology_(NULL),
+    rheology_force_(NULL),
+    last_rheology_(-1),
     params_(params)
 {}
 
 template<typename EvolveSurface>
 Monitor<EvolveSurface>::~Monitor()
-{}
+{
+    delete trajectory_sht_;
+    delete rheology_;
+    delete rheology_force_;
+}
 
 template<typename EvolveSurface>
 Error_t Monitor<EvolveSurface>::operator()(const EvolveSurface *state,
     const value_type &t, value_type &dt)
 {
-    const typename EvolveSurface::Sca_t::device_type& device=EvolveSurface::Sca_t::getDevice();
-    size_t N_ves=state->S_->getPosition().getNumSubs();
-
-    area_new.replicate(state->S_->getPosition());
-    vol_new .replicate(state->S_->getPosition());
-    state->S_->area  (area_new);
-    state->S_->volume( vol_new);
-
-    if(A0_ < 0){ // Initialize area0_, vol0_
-        area0_.replicate(state->S_->getPosition());
-        vol0_ .replicate(state->S_->getPosition());
-        device.Memcpy(area0_.begin(), area_new.begin(), N_ves*sizeof(value_type), device.MemcpyDeviceToDevice);
-        device.Memcpy( vol0_.begin(),  vol_new.begin(), N_ves*sizeof(value_type), device.MemcpyDeviceToDevice);
-        A0_=(device.MaxAbs(area0_.begin(), N_ves));
-        V0_=(device.MaxAbs( vol0_.begin(), N_ves));
-    }
+    // the initial area and volume are the reference
+    AreaVolumeStats<value_type> stats;
+    state->S_->areaVolumeStats(stats, moms_new_, (A0_ < 0) ? NULL : &moms0_);
 
-    device.axpy(-1.0, area0_.begin(), area_new.begin(), N_ves, area_new.begin());
-    device.axpy(-1.0,  vol0_.begin(),  vol_new.begin(), N_ves,  vol_new.begin());
-    value_type DA(device.MaxAbs(area_new.begin(), N_ves));
-    value_type DV(device.MaxAbs( vol_new.begin(), N_ves));
+    if(A0_ < 0){ // Initialize moms0_
+        moms0_.resize(moms_new_.size());
+        moms0_.getDevice().Memcpy(moms0_.begin(), moms_new_.begin(),
+            moms_new_.size()*sizeof(value_type), moms0_.getDevice().MemcpyDeviceToDevice);
+        A0_=stats.area;
+        V0_=stats.vol;
+    }
+    value_type DA(stats.area_err);
+    value_type DV(stats.vol_err);
 
 #pragma omp critical (monitor)
     {
@@ -59,6 +61,7 @@ Error_t Monitor<EvolveSurface>::operator()(const EvolveSurface *state,
 
         if ( checkpoint_flag_ && checkpoint_index > last_checkpoint_ )
         {
+            Telemetry::Timer io_timer(Telemetry::IO);
             ++time_idx_;
             std::string fname(params_->checkpoint_file_name);
             char suffix[7];
@@ -66,15 +69,27 @@ Error_t Monitor<EvolveSurface>::operator()(const EvolveSurface *state,
             d_["time_idx"] = std::string(suffix);
             expand_template(&fname, d_);
 
-            //This order of packing is used when loading checkpoints
-            //in ves3d_simulation file
-            std::stringstream ss;
-            ss<<std::scientific<<std::setprecision(16);
-            params_->pack(ss, Streamable::ASCII);
-            state->pack(ss, Streamable::ASCII);
-
             INFO("Writing data to file "<<fname);
-            IO_.DumpFile(fname.c_str(), ss);
+#ifdef HAS_MPI
+            if (params_->checkpoint_parallel){
+                ParallelCheckpoint<typename EvolveSurface::Vec_t,
+                                   typename EvolveSurface::VProp_t> pc;
+                CHK(pc.Write(fname, *params_, state->S_->getPosition(), *state->ves_props_));
+            } else
+#endif
+            {
+                //This order of packing is used when loading checkpoints
+                //in ves3d_simulation file. The state is packed in the
+                //buffer (that keeps the memory of the writer's
+                //buffers) and the file is written in the background.
+                Streamable::Format format(params_->checkpoint_bin ? Streamable::BIN : Streamable::ASCII);
+                buffer_.clear();
+                BufferStream os(buffer_);
+                os<<std::scientific<<std::setprecision(16);
+                params_->pack(os, format);
+                state->pack(os, format);
+                CHK(AsyncWriter::Submit(fname, buffer_));
+            }
             ++last_checkpoint_;
 
 #if HAVE_PVFMM
@@ -82,10 +97,75 @@ Error_t Monitor<EvolveSurface>::operator()(const EvolveSurface *state,
                 std::string vtkfbase(params_->write_vtk);
                 vtkfbase += suffix;
                 INFO("Writing VTK file");
-                WriteVTK(*state->S_,vtkfbase.c_str(), MPI_COMM_WORLD, NULL, -1, params_->periodic_length);
+                CHK(WriteVTK(*state->S_,vtkfbase.c_str(), MPI_COMM_WORLD, NULL, params_->vtk_order,
+                        params_->periodic_length, params_->vtk_collective, params_->vtk_float));
             }
 #endif // HAVE_PVFMM
         }
+
+        int frame_index(params_->trajectory_stride <= 0 ? last_frame_+1 : t/params_->trajectory_stride);
+
+        if ( params_->trajectory_file_name.size() && frame_index > last_frame_ )
+        {
+            Telemetry::Timer io_timer(Telemetry::IO);
+            const Vec_t &x(state->S_->getPosition());
+            if (trajectory_sht_ == NULL)
+                trajectory_sht_ = new SHT_t(x.getShOrder(), state->mats_.mats_p_);
+
+            // the vesicle IDs follow the vesicles of the lower ranks
+            uint64_t first_id(0);
+#ifdef HAS_MPI
+            uint64_t nv(x.getNumSubs());
+            int rank(0);
+            MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+            MPI_Exscan(&nv, &first_id, 1, MPI_UINT64_T, MPI_SUM, VES3D_COMM_WORLD);
+            if (rank == 0) first_id = 0;
+#endif
+
+            // the first frame starts the file with the header and
+            // the rest are appended
+            buffer_.clear();
+            BufferStream os(buffer_);
+            if (last_frame_ < 0) CHK(trajectory_.pack(os, Streamable::BIN));
+            CHK(trajectory_.WriteFrame(os, *trajectory_sht_, t, first_id, x));
+            CHK(AsyncWriter::Submit(params_->trajectory_file_name, buffer_, last_frame_ >= 0));
+            last_frame_ = frame_index;
+        }
+
+        // the centroids of the last call are of other vesicles
+        if (rheology_ != NULL && state->repartitioned_)
+            rheology_->ResetHistory();
+
+        int rheology_index(params_->rheology_stride <= 0 ? last_rheology_+1 : t/params_->rheology_stride);
+
+        if ( params_->rheology_file_name.size() && rheology_index > last_rheology_ )
+        {
+            Telemetry::Timer io_timer(Telemetry::IO);
+            if (rheology_ == NULL){
+                rheology_ = new Rheology_t(params_->rheology_bins, params_->periodic_length);
+                rheology_force_ = new Force_t(*params_, *state->ves_props_, state->mats_);
+            }
+
+            // the traction jump of the membranes (bending and tension)
+            rheology_force_->bendingForce(*state->S_, traction_);
+            rheology_force_->tensileForce(*state->S_, state->F_->tension(), tensile_);
+            axpy(static_cast<value_type>(1), tensile_, traction_, traction_);
+            CHK(rheology_->Compute(*state->S_, traction_, t));
+
+            // only the first process writes the time series
+            int rank(0);
+#ifdef HAS_MPI
+            MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+#endif
+            if (rank == 0){
+                buffer_.clear();
+                BufferStream os(buffer_);
+                if (last_rheology_ < 0) rheology_->WriteHeader(os);
+                rheology_->WriteLine(os);
+                CHK(AsyncWriter::Submit(params_->rheology_file_name, buffer_, last_rheology_ >= 0));
+            }
+            last_rheology_ = rheology_index;
+        }
     }
 
     Error_t return_val(ErrorEvent::Success);
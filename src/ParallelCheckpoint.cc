@@ -0,0 +1,384 @@
+template<typename Vec, typename VProp>
+ParallelCheckpoint<Vec, VProp>::ParallelCheckpoint(MPI_Comm comm) :
+    Streamable("parallel_checkpoint"),
+    comm_(comm),
+    nproc_(1),
+    rank_(0),
+    data_offset_(0),
+    file_nproc_(0),
+    total_(0),
+    stride_(0),
+    point_order_(AxisMajor),
+    n_props_(0),
+    first_(0),
+    count_(0)
+{
+    MPI_Comm_size(comm_, &nproc_);
+    MPI_Comm_rank(comm_, &rank_);
+}
+
+template<typename Vec, typename VProp>
+ParallelCheckpoint<Vec, VProp>::~ParallelCheckpoint()
+{}
+
+template<typename Vec, typename VProp>
+Error_t ParallelCheckpoint<Vec, VProp>::Write(const std::string &fname,
+    const Params_t &params, const Vec &x, const VProp &props)
+{
+    PROFILESTART();
+    std::ostringstream ps;
+    CHK(params.pack(ps, Streamable::BIN));
+    params_      = ps.str();
+    file_nproc_  = nproc_;
+    stride_      = x.getStride();
+    point_order_ = x.getPointOrder();
+    n_props_     = VProp::n_props;
+
+    // the offset table
+    uint64_t count(x.getNumSubs());
+    std::vector<uint64_t> counts(nproc_);
+    MPI_Allgather(&count, 1, MPI_UINT64_T, &counts[0], 1, MPI_UINT64_T, comm_);
+
+    table_.resize(2 * nproc_);
+    total_ = 0;
+    for (int ii=0; ii<nproc_; ++ii){
+        table_[2*ii    ] = total_;
+        table_[2*ii + 1] = counts[ii];
+        total_ += counts[ii];
+    }
+    first_ = table_[2*rank_];
+    count_ = count;
+
+    // only the parameters of the first process are written, so the
+    // size of the header is set there
+    std::ostringstream header;
+    if (rank_ == 0){
+        CHK(pack(header, Streamable::BIN));
+        data_offset_  = header.str().size();
+        data_offset_  = (data_offset_ + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+        header.str("");
+        CHK(pack(header, Streamable::BIN));
+    }
+    MPI_Bcast(&data_offset_, 1, MPI_UINT64_T, 0, comm_);
+
+    MPI_File fh;
+    Error_t ierr(Open(fname, MPI_MODE_CREATE | MPI_MODE_WRONLY, fh));
+    if (ierr) return ierr;
+    MPI_File_set_size(fh, 0);
+
+    if (rank_ == 0){
+        std::string h(header.str());
+        MPI_Status status;
+        if (MPI_File_write_at(fh, 0, const_cast<char*>(h.data()), h.size(),
+                MPI_BYTE, &status) != MPI_SUCCESS)
+            ierr = ErrorEvent::IOError;
+    }
+    ierr = ReduceError(ierr);
+
+    size_t vsize(DIM * stride_);
+    MPI_Offset offset(data_offset_ + first_ * vsize * sizeof(value_type));
+    if (!ierr) ierr = ReduceError(WriteBlock(fh, offset, x, count_ * vsize));
+
+    for (int ii=0; ii<n_props_ && !ierr; ++ii){
+        offset  = data_offset_ + total_ * vsize * sizeof(value_type);
+        offset += (ii * total_ + first_) * sizeof(value_type);
+        ierr = ReduceError(WriteBlock(fh, offset, *props.getPropIdx(ii), count_));
+    }
+
+    MPI_File_close(&fh);
+    if (ierr){
+        CERR("Failed to write the parallel checkpoint "<<fname);
+        return ierr;
+    }
+
+    INFO("Wrote "<<total_<<" vesicles of "<<nproc_<<" processes to "<<fname);
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
+template<typename Vec, typename VProp>
+Error_t ParallelCheckpoint<Vec, VProp>::ReadHeader(const std::string &fname,
+    Params_t &params)
+{
+    PROFILESTART();
+    MPI_File fh;
+    Error_t ierr(Open(fname, MPI_MODE_RDONLY, fh));
+    if (ierr) return ierr;
+
+    // the first process reads the fixed part of the header (to get
+    // its size) and then the whole header, that is broadcast
+    std::vector<char> buffer;
+    uint64_t hsize(0);
+    if (rank_ == 0){
+        MPI_Status status;
+        int nread(0);
+        buffer.resize(sizeof(BinHeader) + sizeof(uint64_t));
+        if (MPI_File_read_at(fh, 0, &buffer[0], buffer.size(), MPI_BYTE, &status) == MPI_SUCCESS)
+            MPI_Get_count(&status, MPI_BYTE, &nread);
+
+        int version(0);
+        std::istringstream is(std::string(buffer.begin(), buffer.end()));
+        if (size_t(nread) == buffer.size() &&
+            unpack_header(is, "PCHECKPOINT", sizeof(value_type), version) == ErrorEvent::Success)
+            unpack_value(is, hsize);
+
+        // a failed read of the whole header is reported as an empty
+        // header to all the processes
+        buffer.resize(hsize);
+        nread = 0;
+        if (hsize > 0 && hsize < INT_MAX &&
+            MPI_File_read_at(fh, 0, &buffer[0], hsize, MPI_BYTE, &status) == MPI_SUCCESS)
+            MPI_Get_count(&status, MPI_BYTE, &nread);
+        if (size_t(nread) != hsize)
+            hsize = 0;
+    }
+    MPI_File_close(&fh);
+
+    MPI_Bcast(&hsize, 1, MPI_UINT64_T, 0, comm_);
+    if (hsize == 0){
+        CERR("Bad parallel checkpoint file "<<fname);
+        return ErrorEvent::IOBadStream;
+    }
+
+    buffer.resize(hsize);
+    MPI_Bcast(&buffer[0], hsize, MPI_BYTE, 0, comm_);
+
+    std::istringstream is(std::string(buffer.begin(), buffer.end()));
+    ierr = unpack(is, Streamable::BIN);
+    if (ierr) return ierr;
+
+    std::istringstream ps(params_);
+    ierr = params.unpack(ps, Streamable::BIN);
+    if (ierr) return ierr;
+
+    INFO("Parallel checkpoint "<<fname<<" has "<<total_<<" vesicles of "<<file_nproc_<<" processes");
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
+template<typename Vec, typename VProp>
+Error_t ParallelCheckpoint<Vec, VProp>::ReadState(const std::string &fname,
+    Vec &x, VProp &props)
+{
+    PROFILESTART();
+    ASSERT(file_nproc_ > 0, "The header should be read first");
+
+    if (n_props_ != VProp::n_props){
+        CERR("The checkpoint has "<<n_props_<<" vesicle properties instead of "<<VProp::n_props);
+        return ErrorEvent::IOBadStream;
+    }
+
+    Distribute();
+    x.resize(count_);
+    x.setPointOrder(static_cast<CoordinateOrder>(point_order_));
+    if (x.getStride() != stride_){
+        CERR("The sh_order of the container does not match the checkpoint (stride "
+            <<x.getStride()<<" instead of "<<stride_<<")");
+        return ErrorEvent::IOBadStream;
+    }
+
+    MPI_File fh;
+    Error_t ierr(Open(fname, MPI_MODE_RDONLY, fh));
+    if (ierr) return ierr;
+
+    size_t vsize(DIM * stride_);
+    MPI_Offset offset(data_offset_ + first_ * vsize * sizeof(value_type));
+    ierr = ReduceError(ReadBlock(fh, offset, x, count_ * vsize));
+
+    for (int ii=0; ii<n_props_ && !ierr; ++ii){
+        typename VProp::container_type *prp(props.getPropIdx(ii));
+        prp->resize(count_);
+        offset  = data_offset_ + total_ * vsize * sizeof(value_type);
+        offset += (ii * total_ + first_) * sizeof(value_type);
+        ierr = ReduceError(ReadBlock(fh, offset, *prp, count_));
+    }
+
+    MPI_File_close(&fh);
+    if (ierr){
+        CERR("Failed to read the parallel checkpoint "<<fname);
+        return ierr;
+    }
+    props.update();
+
+    COUTDEBUG("Read vesicles "<<first_<<" to "<<first_+count_<<" of "<<total_);
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
+template<typename Vec, typename VProp>
+bool ParallelCheckpoint<Vec, VProp>::IsParallelCheckpoint(const std::string &fname,
+    MPI_Comm comm)
+{
+    int rank(0), is_pc(0);
+    MPI_Comm_rank(comm, &rank);
+
+    if (rank == 0){
+        std::ifstream file(fname.c_str(), std::ios::in | std::ios::binary);
+        BinHeader h;
+        file.read(reinterpret_cast<char*>(&h), sizeof(h));
+        h.tag[BIN_TAG_LENGTH-1] = '\0';
+        is_pc = file.good() && h.magic == BIN_MAGIC &&
+            std::string(h.tag) == "PCHECKPOINT";
+    }
+    MPI_Bcast(&is_pc, 1, MPI_INT, 0, comm);
+
+    return is_pc;
+}
+
+template<typename Vec, typename VProp>
+Error_t ParallelCheckpoint<Vec, VProp>::pack(std::ostream &os,
+    Streamable::Format format) const
+{
+    if (format != Streamable::BIN)
+        return ErrorEvent::NotImplementedError;
+
+    CHK(pack_header(os, "PCHECKPOINT", sizeof(value_type)));
+    CHK(pack_value(os, data_offset_));
+    CHK(pack_value(os, file_nproc_));
+    CHK(pack_value(os, total_));
+    CHK(pack_value(os, stride_));
+    CHK(pack_value(os, point_order_));
+    CHK(pack_value(os, n_props_));
+    CHK(pack_string(os, params_));
+    return pack_array(os, format, &table_[0], table_.size());
+}
+
+template<typename Vec, typename VProp>
+Error_t ParallelCheckpoint<Vec, VProp>::unpack(std::istream &is,
+    Streamable::Format format)
+{
+    if (format != Streamable::BIN)
+        return ErrorEvent::NotImplementedError;
+
+    int version(0);
+    Error_t ierr(unpack_header(is, "PCHECKPOINT", sizeof(value_type), version));
+    if (ierr) return ierr;
+
+    CHK(unpack_value(is, data_offset_));
+    CHK(unpack_value(is, file_nproc_));
+    CHK(unpack_value(is, total_));
+    CHK(unpack_value(is, stride_));
+    CHK(unpack_value(is, point_order_));
+    CHK(unpack_value(is, n_props_));
+    CHK(unpack_string(is, params_));
+
+    size_t n(2 * file_nproc_);
+    table_.resize(n);
+    return unpack_array(is, format, &table_[0], n);
+}
+
+template<typename Vec, typename VProp>
+Error_t ParallelCheckpoint<Vec, VProp>::Open(const std::string &fname,
+    int amode, MPI_File &fh) const
+{
+    // the file name of the first process
+    std::string name(fname);
+    int len(name.size());
+    MPI_Bcast(&len, 1, MPI_INT, 0, comm_);
+    name.resize(len);
+    MPI_Bcast(&name[0], len, MPI_CHAR, 0, comm_);
+
+    if (MPI_File_open(comm_, const_cast<char*>(name.c_str()), amode,
+            MPI_INFO_NULL, &fh) != MPI_SUCCESS){
+        CERR("Failed to open the parallel checkpoint file "<<name);
+        return ErrorEvent::IOError;
+    }
+
+    return ErrorEvent::Success;
+}
+
+template<typename Vec, typename VProp>
+void ParallelCheckpoint<Vec, VProp>::Distribute()
+{
+    if (file_nproc_ == nproc_){
+        first_ = table_[2*rank_];
+        count_ = table_[2*rank_ + 1];
+    } else {
+        size_t share(total_ / nproc_), rem(total_ % nproc_);
+        size_t rank(rank_);
+        count_ = share + (rank < rem);
+        first_ = rank * share + std::min(rank, rem);
+    }
+}
+
+template<typename Vec, typename VProp>
+Error_t ParallelCheckpoint<Vec, VProp>::ReduceError(Error_t ierr) const
+{
+    int loc(ierr), glb(0);
+    MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MAX, comm_);
+    return static_cast<Error_t>(glb);
+}
+
+template<typename Vec, typename VProp>
+template<typename Arr>
+Error_t ParallelCheckpoint<Vec, VProp>::WriteBlock(MPI_File fh,
+    MPI_Offset offset, const Arr &arr, size_t n) const
+{
+    // device memory is written through a host buffer
+    std::vector<value_type> buffer;
+    const value_type *data(arr.begin());
+    if (!device_type::IsHost() && n > 0){
+        buffer.resize(n);
+        arr.getDevice().Memcpy(&buffer[0], arr.begin(), n * sizeof(value_type),
+            device_type::MemcpyDeviceToHost);
+        data = &buffer[0];
+    }
+
+    size_t bytes(n * sizeof(value_type));
+    int loc((bytes + IO_CHUNK - 1) / IO_CHUNK), nchunk(0);
+    MPI_Allreduce(&loc, &nchunk, 1, MPI_INT, MPI_MAX, comm_);
+
+    char *p(reinterpret_cast<char*>(const_cast<value_type*>(data)));
+    int err(MPI_SUCCESS);
+    for (int ii=0; ii<nchunk; ++ii){
+        size_t b(bytes < IO_CHUNK ? bytes : IO_CHUNK);
+        MPI_Status status;
+        if (MPI_File_write_at_all(fh, offset, p, b, MPI_BYTE, &status) != MPI_SUCCESS)
+            err = MPI_ERR_IO;
+        offset += b;
+        p      += b;
+        bytes  -= b;
+    }
+
+    return (err == MPI_SUCCESS) ? ErrorEvent::Success : ErrorEvent::IOError;
+}
+
+template<typename Vec, typename VProp>
+template<typename Arr>
+Error_t ParallelCheckpoint<Vec, VProp>::ReadBlock(MPI_File fh,
+    MPI_Offset offset, Arr &arr, size_t n) const
+{
+    std::vector<value_type> buffer;
+    value_type *data(arr.begin());
+    if (!device_type::IsHost() && n > 0){
+        buffer.resize(n);
+        data = &buffer[0];
+    }
+
+    size_t bytes(n * sizeof(value_type));
+    int loc((bytes + IO_CHUNK - 1) / IO_CHUNK), nchunk(0);
+    MPI_Allreduce(&loc, &nchunk, 1, MPI_INT, MPI_MAX, comm_);
+
+    char *p(reinterpret_cast<char*>(data));
+    bool ok(true);
+    for (int ii=0; ii<nchunk; ++ii){
+        size_t b(bytes < IO_CHUNK ? bytes : IO_CHUNK);
+        MPI_Status status;
+        int nread(0);
+        int err(MPI_File_read_at_all(fh, offset, p, b, MPI_BYTE, &status));
+        MPI_Get_count(&status, MPI_BYTE, &nread);
+        ok = ok && (err == MPI_SUCCESS) && (size_t(nread) == b);
+        offset += b;
+        p      += b;
+        bytes  -= b;
+    }
+
+    if (!ok)
+        return ErrorEvent::IOBadStream;
+
+    if (!device_type::IsHost() && n > 0)
+        arr.getDevice().Memcpy(arr.begin(), &buffer[0], n * sizeof(value_type),
+            device_type::MemcpyHostToDevice);
+
+    return ErrorEvent::Success;
+}
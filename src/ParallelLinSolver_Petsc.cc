@@ -558,6 +558,16 @@ Error_t ParallelLinSolverPetsc<T>::InitialGuessNonzero(bool flg) const
     return ErrorEvent::Success;
 }
 
+template<typename T>
+Error_t ParallelLinSolverPetsc<T>::SetFlexible()
+{
+    // overrides the type given in the options
+    COUTDEBUG("Setting the linear solver type to FGMRES");
+    ierr = KSPSetType(ps_, KSPFGMRES); CHK_PETSC(ierr);
+    ierr = KSPGMRESSetRestart(ps_, 1000); CHK_PETSC(ierr);
+    return ErrorEvent::Success;
+}
+
 template<typename T>
 Error_t ParallelLinSolverPetsc<T>::VecFactory(vec_type **newvec) const
 {
@@ -706,5 +716,6 @@ PetscErrorCode PetscPrecondWrapper(PC P, Vec x, Vec y){
 template<typename T>
 PetscErrorCode PetscKSPMonitor(KSP K,PetscInt n, PetscReal rnorm, void *dummy){
     INFO("KSP residual norm at iteration "<<n<<": "<<SCI_PRINT_FRMT<<rnorm);
+    Telemetry::AddResidual(rnorm);
     return 0;
 }
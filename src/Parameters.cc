@@ -13,6 +13,7 @@ Parameters<T>::Parameters(int argc, char** argv)
 
 template<typename T>
 Parameters<T>::Parameters(std::istream &is, Format format){
+    init();
     unpack(is, format);
 }
 
@@ -24,6 +25,8 @@ void Parameters<T>::init()
     bg_flow                 = ShearFlow;
     bg_flow_param           = 1e-1;
     checkpoint              = false;
+    checkpoint_bin          = false;
+    checkpoint_parallel     = false;
     checkpoint_stride	    = -1;
     error_factor            = 1;
     excess_density          = 0.0;
@@ -32,10 +35,14 @@ void Parameters<T>::init()
     gravity_field[1]        = 0;
     gravity_field[2]        = -1.0;
     interaction_upsample    = false;
+    mixed_precision         = false;
     n_surfs                 = 1;
     num_threads             = -1;
     periodic_length         = -1;
+    precond_coarse_order    = 6;
+    profile_step            = false;
     pseudospectral          = false;
+    refine_iter_max         = 10;
     rep_exponent            = 4.0;
     rep_filter_freq         = 4;
     rep_maxit               = 10;
@@ -43,19 +50,31 @@ void Parameters<T>::init()
     rep_ts                  = -1.0;
     rep_type                = PolyKReparam;
     rep_upsample            = false;
+    rheology_bins           = 10;
+    rheology_stride         = -1;
     repul_dist              = 5e-2;
+    rollback_max            = 4;
     scheme                  = JacobiBlockImplicit;
     sh_order                = 12;
     singular_stokes         = ViaSpHarm;
+    snapshot_count          = 2;
+    snapshot_stride         = 0;
     solve_for_velocity      = false;
+    time_adap_doubling      = false;
     time_adaptive           = false;
     time_horizon            = 1;
     time_iter_max           = 100;
     time_precond            = NoPrecond;
+    time_sdc_order          = 2;
     time_tol                = 1e-6;
+    trajectory_quantize     = false;
+    trajectory_stride       = -1;
     ts                      = 1;
     upsample_freq           = 24;
     viscosity_contrast      = 1.0;
+    vtk_collective          = false;
+    vtk_float               = false;
+    vtk_order               = -1;
 }
 
 template<typename T>
@@ -129,6 +148,9 @@ Error_t Parameters<T>::expand_templates(const DictString_t *dict){
     CHK(::expand_template(&checkpoint_file_name  , d));
     CHK(::expand_template(&load_checkpoint       , d));
     CHK(::expand_template(&write_vtk             , d));
+    CHK(::expand_template(&trajectory_file_name  , d));
+    CHK(::expand_template(&rheology_file_name    , d));
+    CHK(::expand_template(&telemetry_file_name   , d));
 
     return ErrorEvent::Success;
 }
@@ -159,7 +181,7 @@ void Parameters<T>::setUsage(AnyOption *opt)
     opt->addUsage( "      -l  --load-checkpoint        Checkpoint file to load and start from (commandline/file options override)" );
     opt->addUsage( "          --n-surfs                The number of surfaces *per MPI process*" );
     opt->addUsage( "          --shape-gallery-file     The possible shapes of vesicles");
-    opt->addUsage( "          --vesicle-geometry-file  Each line defines a vesicle by the index of a shape in the shape gallery file, the location, and the scale (for all MPI processes)");
+    opt->addUsage( "          --vesicle-geometry-file  Each line defines a vesicle by the index of a shape in the shape gallery file, the location, and the scale (for all MPI processes), or a binary geometry file (see geometry_convert)");
     opt->addUsage( "          --vesicle-props-file     The physical properties of each vesicle (overrides commandline)");
     opt->addUsage( "" );
     opt->addUsage( "  Physical properties for all (for more control use vesicle-props-file):" );
@@ -170,14 +192,22 @@ void Parameters<T>::setUsage(AnyOption *opt)
     opt->addUsage( "" );
     opt->addUsage( "  Time stepping:" );
     opt->addUsage( "          --error-factor           The permissible increase factor in error");
+    opt->addUsage( "          --mixed-precision    [F] Refine the implicit solve in working precision around a single precision inner solve" );
+    opt->addUsage( "          --precond-coarse-order   The SH order of the coarse level for the TwoLevel preconditioner" );
     opt->addUsage( "          --pseudospectral     [F] Form and solve the system for function values on grid points (otherwise Galerkin)" );
+    opt->addUsage( "          --refine-iter-max        Maximum number of iterative refinement steps (with mixed-precision)" );
+    opt->addUsage( "          --rollback-max           Maximum number of consecutive rollbacks to the in-memory snapshots" );
     opt->addUsage( "          --singular-stokes        The scheme for the singular stokes evaluation" );
+    opt->addUsage( "          --snapshot-count         The number of in-memory snapshots of the state (for rollback)" );
+    opt->addUsage( "          --snapshot-stride        The number of time steps between in-memory snapshots (0 for no rollback)" );
     opt->addUsage( "          --solve-for-velocity [F] If true, set up the linear system to solve for velocity and tension otherwise for position" );
     opt->addUsage( "          --time-adaptive      [F] Use adaptive time-stepping" );
+    opt->addUsage( "          --time-adap-doubling [F] Estimate the adaptive time step error by step doubling (three solves per step)" );
     opt->addUsage( "          --time-horizon           The time horizon of the simulation" );
     opt->addUsage( "          --time-iter-max          Maximum number of iteration for the choice of time stepper" );
     opt->addUsage( "          --time-precond           The type of preconditioner to use" );
     opt->addUsage( "          --time-scheme            The time stepping scheme" );
+    opt->addUsage( "          --time-sdc-order         The number of nodes and sweeps (the order) of the SDC scheme" );
     opt->addUsage( "          --time-tol               The desired error tolerance in the time stepping" );
     opt->addUsage( "          --timestep               The time step size" );
     opt->addUsage( "" );
@@ -205,10 +235,23 @@ void Parameters<T>::setUsage(AnyOption *opt)
     opt->addUsage( "      -s  --checkpoint         [F] Flag to save data to file" );
     opt->addUsage( "      -o  --checkpoint-file        The output file *template*");
     opt->addUsage( "          --checkpoint-stride      The frequency of saving to file (in time scale)" );
+    opt->addUsage( "          --checkpoint-bin     [F] Write the checkpoints in binary format" );
+    opt->addUsage( "          --checkpoint-parallel [F] Write one checkpoint file for all processes (with MPI-IO)" );
     opt->addUsage( "          --write-vtk              Write VTK file along with checkpoint" );
+    opt->addUsage( "          --vtk-order              The SH order of the VTK surfaces (default to sh-order)" );
+    opt->addUsage( "          --vtk-collective     [F] Write one VTK file for all processes (with MPI-IO)" );
+    opt->addUsage( "          --vtk-float          [F] Write the VTK data in single precision" );
+    opt->addUsage( "          --trajectory-file        The trajectory file *template* (the shapes truncated at filter-freq, for post-processing)" );
+    opt->addUsage( "          --trajectory-stride      The frequency of the trajectory frames (in time scale)" );
+    opt->addUsage( "          --trajectory-quantize [F] Quantize the trajectory coefficients to 16 bits" );
+    opt->addUsage( "          --rheology-file          The rheology time series file *template* (the bulk stresslet and shape statistics)" );
+    opt->addUsage( "          --rheology-stride        The frequency of the rheology statistics (in time scale)" );
+    opt->addUsage( "          --rheology-bins          The number of bins of the deformation and inclination histograms" );
     opt->addUsage( "" );
     opt->addUsage( "  Miscellaneous:" );
     opt->addUsage( "          --num-threads            The number OpenMP threads" );
+    opt->addUsage( "          --telemetry-file         The per-step telemetry file *template* (one JSON record per time step)" );
+    opt->addUsage( "          --profile-step       [F] Print the profile of every time step" );
     opt->addUsage( "" );
 }
 
@@ -221,11 +264,19 @@ void Parameters<T>::setOptions(AnyOption *opt)
     // a flag (takes no argument), supporting long and short forms
     opt->setCommandFlag( "help", 'h' );
     opt->setFlag( "checkpoint", 's' );
+    opt->setFlag( "checkpoint-bin" );
+    opt->setFlag( "checkpoint-parallel" );
     opt->setFlag( "interaction-upsample" );
     opt->setFlag( "rep-upsample" );
     opt->setFlag( "solve-for-velocity" );
     opt->setFlag( "pseudospectral" );
+    opt->setFlag( "profile-step" );
+    opt->setFlag( "mixed-precision" );
     opt->setFlag( "time-adaptive" );
+    opt->setFlag( "time-adap-doubling" );
+    opt->setFlag( "trajectory-quantize" );
+    opt->setFlag( "vtk-collective" );
+    opt->setFlag( "vtk-float" );
     opt->setOption( "write-vtk" );
 
     //an option (takes an argument), supporting long and short forms
@@ -245,6 +296,7 @@ void Parameters<T>::setOptions(AnyOption *opt)
     opt->setOption( "n-surfs" );
     opt->setOption( "num-threads" );
     opt->setOption( "periodic-length" );
+    opt->setOption( "precond-coarse-order" );
 
     opt->setOption( "rep-type" );
     opt->setOption( "rep-filter-freq" );
@@ -257,15 +309,27 @@ void Parameters<T>::setOptions(AnyOption *opt)
 
     opt->setOption( "checkpoint-stride" );
     opt->setOption( "sh-order" );
+    opt->setOption( "rheology-bins" );
+    opt->setOption( "rheology-file" );
+    opt->setOption( "rheology-stride" );
+    opt->setOption( "telemetry-file" );
+    opt->setOption( "refine-iter-max" );
+    opt->setOption( "rollback-max" );
     opt->setOption( "singular-stokes" );
+    opt->setOption( "snapshot-count" );
+    opt->setOption( "snapshot-stride" );
     opt->setOption( "time-horizon" );
     opt->setOption( "time-iter-max" );
     opt->setOption( "time-precond" );
     opt->setOption( "time-scheme" );
+    opt->setOption( "time-sdc-order" );
     opt->setOption( "time-tol" );
     opt->setOption( "timestep" );
+    opt->setOption( "trajectory-file" );
+    opt->setOption( "trajectory-stride" );
     opt->setOption( "upsample-freq" );
     opt->setOption( "viscosity-contrast" );
+    opt->setOption( "vtk-order" );
     opt->setOption( "gravity-field" );
     opt->setOption( "excess-density" );
 
@@ -284,6 +348,12 @@ void Parameters<T>::getOptionValues(AnyOption *opt)
     if( opt->getFlag( "checkpoint" ) || opt->getFlag( 's' ) )
         checkpoint = true;
 
+    if( opt->getFlag( "checkpoint-bin" ) )
+        checkpoint_bin = true;
+
+    if( opt->getFlag( "checkpoint-parallel" ) )
+        checkpoint_parallel = true;
+
     if( opt->getFlag( "interaction-upsample" ) )
         interaction_upsample = true;
 
@@ -296,12 +366,33 @@ void Parameters<T>::getOptionValues(AnyOption *opt)
     if( opt->getFlag( "pseudospectral" ) )
         pseudospectral = true;
 
+    if( opt->getFlag( "profile-step" ) )
+        profile_step = true;
+
+    if( opt->getFlag( "mixed-precision" ) )
+        mixed_precision = true;
+
     if( opt->getFlag( "time-adaptive" ) )
         time_adaptive = true;
 
+    if( opt->getFlag( "time-adap-doubling" ) )
+        time_adap_doubling = true;
+
+    if( opt->getFlag( "trajectory-quantize" ) )
+        trajectory_quantize = true;
+
     if( opt->getValue( "write-vtk" ) !=NULL )
         write_vtk = opt->getValue( "write-vtk" );
 
+    if( opt->getFlag( "vtk-collective" ) )
+        vtk_collective = true;
+
+    if( opt->getFlag( "vtk-float" ) )
+        vtk_float = true;
+
+    if( opt->getValue( "vtk-order" ) != NULL  )
+        vtk_order =  atoi(opt->getValue( "vtk-order" ));
+
     //an option (takes an argument), supporting long and short forms
     if( opt->getValue( "shape-gallery-file" ) != NULL )
         shape_gallery_file = opt->getValue( "shape-gallery-file" );
@@ -388,6 +479,24 @@ void Parameters<T>::getOptionValues(AnyOption *opt)
     if( opt->getValue( "checkpoint-stride" ) != NULL  )
         checkpoint_stride =  atof(opt->getValue( "checkpoint-stride" ));
 
+    if( opt->getValue( "trajectory-file" ) != NULL )
+        trajectory_file_name = opt->getValue( "trajectory-file" );
+
+    if( opt->getValue( "trajectory-stride" ) != NULL  )
+        trajectory_stride =  atof(opt->getValue( "trajectory-stride" ));
+
+    if( opt->getValue( "rheology-file" ) != NULL )
+        rheology_file_name = opt->getValue( "rheology-file" );
+
+    if( opt->getValue( "rheology-stride" ) != NULL  )
+        rheology_stride =  atof(opt->getValue( "rheology-stride" ));
+
+    if( opt->getValue( "rheology-bins" ) != NULL  )
+        rheology_bins =  atoi(opt->getValue( "rheology-bins" ));
+
+    if( opt->getValue( "telemetry-file" ) != NULL )
+        telemetry_file_name = opt->getValue( "telemetry-file" );
+
     if( opt->getValue( "time-scheme" ) != NULL  )
         scheme = EnumifyScheme(opt->getValue( "time-scheme" ));
     ASSERT(scheme != UnknownScheme, "Failed to parse the time scheme name");
@@ -396,6 +505,9 @@ void Parameters<T>::getOptionValues(AnyOption *opt)
         time_precond = EnumifyPrecond(opt->getValue( "time-precond" ));
     ASSERT(time_precond != UnknownPrecond, "Failed to parse the preconditioner name" );
 
+    if( opt->getValue( "precond-coarse-order" ) != NULL  )
+        precond_coarse_order =  atoi(opt->getValue( "precond-coarse-order" ));
+
     if( opt->getValue( "singular-stokes" ) != NULL  )
         singular_stokes = EnumifyStokesRot(opt->getValue( "singular-stokes" ));
 
@@ -417,13 +529,96 @@ void Parameters<T>::getOptionValues(AnyOption *opt)
     if( opt->getValue( "time-iter-max" ) != NULL  )
         time_iter_max =  atof(opt->getValue( "time-iter-max" ));
 
+    if( opt->getValue( "refine-iter-max" ) != NULL  )
+        refine_iter_max =  atoi(opt->getValue( "refine-iter-max" ));
+
+    if( opt->getValue( "snapshot-stride" ) != NULL  )
+        snapshot_stride =  atoi(opt->getValue( "snapshot-stride" ));
+
+    if( opt->getValue( "snapshot-count" ) != NULL  )
+        snapshot_count =  atoi(opt->getValue( "snapshot-count" ));
+
+    if( opt->getValue( "rollback-max" ) != NULL  )
+        rollback_max =  atoi(opt->getValue( "rollback-max" ));
+
+    if( opt->getValue( "time-sdc-order" ) != NULL  )
+        time_sdc_order =  atoi(opt->getValue( "time-sdc-order" ));
+
     //   other methods: (bool) opt.getFlag( ... long or short ... )
 }
 
 template<typename T>
 Error_t Parameters<T>::pack(std::ostream &os, Format format) const
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        // the same order as ASCII, the enums as int32 and the flags as int8
+        CHK(pack_header(os, "PARAMETERS", sizeof(T), BIN_FORMAT));
+        CHK(pack_string(os, Streamable::name_));
+        CHK(pack_value(os, static_cast<int32_t>(n_surfs)));
+        CHK(pack_value(os, static_cast<int32_t>(sh_order)));
+        CHK(pack_value(os, static_cast<int32_t>(filter_freq)));
+        CHK(pack_value(os, static_cast<int32_t>(upsample_freq)));
+        CHK(pack_value(os, bending_modulus));
+        CHK(pack_value(os, viscosity_contrast));
+        CHK(pack_value(os, time_horizon));
+        CHK(pack_value(os, ts));
+        CHK(pack_value(os, time_tol));
+        CHK(pack_value(os, static_cast<int32_t>(time_iter_max)));
+        CHK(pack_value(os, static_cast<int8_t>(time_adaptive)));
+        CHK(pack_value(os, static_cast<int8_t>(solve_for_velocity)));
+        CHK(pack_value(os, static_cast<int8_t>(pseudospectral)));
+        CHK(pack_value(os, static_cast<int32_t>(scheme)));
+        CHK(pack_value(os, static_cast<int32_t>(time_precond)));
+        CHK(pack_value(os, static_cast<int32_t>(bg_flow)));
+        CHK(pack_value(os, static_cast<int32_t>(singular_stokes)));
+        CHK(pack_value(os, static_cast<int32_t>(rep_type)));
+        CHK(pack_value(os, static_cast<int32_t>(rep_maxit)));
+        CHK(pack_value(os, static_cast<int8_t>(rep_upsample)));
+        CHK(pack_value(os, static_cast<int32_t>(rep_filter_freq)));
+        CHK(pack_value(os, rep_ts));
+        CHK(pack_value(os, rep_tol));
+        CHK(pack_value(os, rep_exponent));
+        CHK(pack_value(os, repul_dist));
+        CHK(pack_value(os, bg_flow_param));
+        CHK(pack_value(os, periodic_length));
+        CHK(pack_value(os, static_cast<int8_t>(interaction_upsample)));
+        CHK(pack_value(os, static_cast<int8_t>(checkpoint)));
+        CHK(pack_value(os, checkpoint_stride));
+        CHK(pack_string(os, write_vtk));
+        CHK(pack_string(os, shape_gallery_file));
+        CHK(pack_string(os, vesicle_geometry_file));
+        CHK(pack_string(os, vesicle_props_file));
+        CHK(pack_string(os, checkpoint_file_name));
+        CHK(pack_string(os, load_checkpoint));
+        CHK(pack_value(os, error_factor));
+        CHK(pack_value(os, static_cast<int32_t>(num_threads)));
+        CHK(pack_value(os, excess_density));
+        CHK(pack_value(os, gravity_field[0]));
+        CHK(pack_value(os, gravity_field[1]));
+        CHK(pack_value(os, gravity_field[2]));
+        CHK(pack_value(os, static_cast<int8_t>(mixed_precision)));
+        CHK(pack_value(os, static_cast<int32_t>(precond_coarse_order)));
+        CHK(pack_value(os, static_cast<int32_t>(time_sdc_order)));
+        CHK(pack_value(os, static_cast<int8_t>(checkpoint_bin)));
+        CHK(pack_value(os, static_cast<int8_t>(checkpoint_parallel)));
+        CHK(pack_string(os, trajectory_file_name));
+        CHK(pack_value(os, trajectory_stride));
+        CHK(pack_value(os, static_cast<int8_t>(trajectory_quantize)));
+        CHK(pack_value(os, static_cast<int32_t>(vtk_order)));
+        CHK(pack_value(os, static_cast<int8_t>(vtk_collective)));
+        CHK(pack_value(os, static_cast<int8_t>(vtk_float)));
+        CHK(pack_value(os, static_cast<int32_t>(snapshot_stride)));
+        CHK(pack_value(os, static_cast<int32_t>(snapshot_count)));
+        CHK(pack_value(os, static_cast<int32_t>(rollback_max)));
+        CHK(pack_string(os, rheology_file_name));
+        CHK(pack_value(os, rheology_stride));
+        CHK(pack_value(os, static_cast<int32_t>(rheology_bins)));
+        CHK(pack_string(os, telemetry_file_name));
+        CHK(pack_value(os, static_cast<int8_t>(profile_step)));
+        CHK(pack_value(os, static_cast<int32_t>(refine_iter_max)));
+        CHK(pack_value(os, static_cast<int8_t>(time_adap_doubling)));
+        return ErrorEvent::Success;
+    }
 
     os<<"PARAMETERS\n";
     os<<"version: "<<VERSION<<"\n";
@@ -468,6 +663,27 @@ Error_t Parameters<T>::pack(std::ostream &os, Format format) const
     os<<"num_threads: "<<num_threads<<"\n";
     os<<"excess_density: "<<excess_density<<"\n";
     os<<"gravity_field: "<<gravity_field[0]<<" "<<gravity_field[1]<<" "<<gravity_field[2]<<"\n";
+    os<<"mixed_precision: "<<mixed_precision<<"\n";
+    os<<"precond_coarse_order: "<<precond_coarse_order<<"\n";
+    os<<"time_sdc_order: "<<time_sdc_order<<"\n";
+    os<<"checkpoint_bin: "<<checkpoint_bin<<"\n";
+    os<<"checkpoint_parallel: "<<checkpoint_parallel<<"\n";
+    os<<"trajectory_file_name: "<<trajectory_file_name<<" |\n"; //added | to stop >> from consuming next line if string is empty
+    os<<"trajectory_stride: "<<trajectory_stride<<"\n";
+    os<<"trajectory_quantize: "<<trajectory_quantize<<"\n";
+    os<<"vtk_order: "<<vtk_order<<"\n";
+    os<<"vtk_collective: "<<vtk_collective<<"\n";
+    os<<"vtk_float: "<<vtk_float<<"\n";
+    os<<"snapshot_stride: "<<snapshot_stride<<"\n";
+    os<<"snapshot_count: "<<snapshot_count<<"\n";
+    os<<"rollback_max: "<<rollback_max<<"\n";
+    os<<"rheology_file_name: "<<rheology_file_name<<" |\n";
+    os<<"rheology_stride: "<<rheology_stride<<"\n";
+    os<<"rheology_bins: "<<rheology_bins<<"\n";
+    os<<"telemetry_file_name: "<<telemetry_file_name<<" |\n";
+    os<<"profile_step: "<<profile_step<<"\n";
+    os<<"refine_iter_max: "<<refine_iter_max<<"\n";
+    os<<"time_adap_doubling: "<<time_adap_doubling<<"\n";
     os<<"/PARAMETERS\n";
     return ErrorEvent::Success;
 }
@@ -475,7 +691,89 @@ Error_t Parameters<T>::pack(std::ostream &os, Format format) const
 template<typename T>
 Error_t Parameters<T>::unpack(std::istream &is, Format format)
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        int version(0), bin_format(0);
+        int32_t i32;
+        int8_t i8;
+        Error_t ierr(unpack_header(is, "PARAMETERS", sizeof(T), version, bin_format, BIN_FORMAT));
+        if (ierr) return ierr;
+
+        CHK(unpack_string(is, Streamable::name_));
+        CHK(unpack_value(is, i32)); n_surfs = i32;
+        CHK(unpack_value(is, i32)); sh_order = i32;
+        CHK(unpack_value(is, i32)); filter_freq = i32;
+        CHK(unpack_value(is, i32)); upsample_freq = i32;
+        CHK(unpack_value(is, bending_modulus));
+        CHK(unpack_value(is, viscosity_contrast));
+        CHK(unpack_value(is, time_horizon));
+        CHK(unpack_value(is, ts));
+        CHK(unpack_value(is, time_tol));
+        CHK(unpack_value(is, i32)); time_iter_max = i32;
+        CHK(unpack_value(is, i8)); time_adaptive = i8;
+        CHK(unpack_value(is, i8)); solve_for_velocity = i8;
+        CHK(unpack_value(is, i8)); pseudospectral = i8;
+        CHK(unpack_value(is, i32)); scheme = static_cast<SolverScheme>(i32);
+        CHK(unpack_value(is, i32)); time_precond = static_cast<PrecondScheme>(i32);
+        CHK(unpack_value(is, i32)); bg_flow = static_cast<BgFlowType>(i32);
+        CHK(unpack_value(is, i32)); singular_stokes = static_cast<SingularStokesRot>(i32);
+        CHK(unpack_value(is, i32)); rep_type = static_cast<ReparamType>(i32);
+        CHK(unpack_value(is, i32)); rep_maxit = i32;
+        CHK(unpack_value(is, i8)); rep_upsample = i8;
+        CHK(unpack_value(is, i32)); rep_filter_freq = i32;
+        CHK(unpack_value(is, rep_ts));
+        CHK(unpack_value(is, rep_tol));
+        CHK(unpack_value(is, rep_exponent));
+        CHK(unpack_value(is, repul_dist));
+        CHK(unpack_value(is, bg_flow_param));
+        CHK(unpack_value(is, periodic_length));
+        CHK(unpack_value(is, i8)); interaction_upsample = i8;
+        CHK(unpack_value(is, i8)); checkpoint = i8;
+        CHK(unpack_value(is, checkpoint_stride));
+        CHK(unpack_string(is, write_vtk));
+        CHK(unpack_string(is, shape_gallery_file));
+        CHK(unpack_string(is, vesicle_geometry_file));
+        CHK(unpack_string(is, vesicle_props_file));
+        CHK(unpack_string(is, checkpoint_file_name));
+        CHK(unpack_string(is, load_checkpoint));
+        CHK(unpack_value(is, error_factor));
+        CHK(unpack_value(is, i32)); num_threads = i32;
+        CHK(unpack_value(is, excess_density));
+        CHK(unpack_value(is, gravity_field[0]));
+        CHK(unpack_value(is, gravity_field[1]));
+        CHK(unpack_value(is, gravity_field[2]));
+        CHK(unpack_value(is, i8)); mixed_precision = i8;
+        CHK(unpack_value(is, i32)); precond_coarse_order = i32;
+        CHK(unpack_value(is, i32)); time_sdc_order = i32;
+        CHK(unpack_value(is, i8)); checkpoint_bin = i8;
+        CHK(unpack_value(is, i8)); checkpoint_parallel = i8;
+        CHK(unpack_string(is, trajectory_file_name));
+        CHK(unpack_value(is, trajectory_stride));
+        CHK(unpack_value(is, i8)); trajectory_quantize = i8;
+        CHK(unpack_value(is, i32)); vtk_order = i32;
+        CHK(unpack_value(is, i8)); vtk_collective = i8;
+        CHK(unpack_value(is, i8)); vtk_float = i8;
+        CHK(unpack_value(is, i32)); snapshot_stride = i32;
+        CHK(unpack_value(is, i32)); snapshot_count = i32;
+        CHK(unpack_value(is, i32)); rollback_max = i32;
+        CHK(unpack_string(is, rheology_file_name));
+        CHK(unpack_value(is, rheology_stride));
+        CHK(unpack_value(is, i32)); rheology_bins = i32;
+        CHK(unpack_string(is, telemetry_file_name));
+        CHK(unpack_value(is, i8)); profile_step = i8;
+
+        // the fields of a newer format
+        if (bin_format>=2){
+            CHK(unpack_value(is, i32)); refine_iter_max = i32;
+        }
+        if (bin_format>=3){
+            CHK(unpack_value(is, i8)); time_adap_doubling = i8;
+        }
+
+        INFO("Unpacked "<<Streamable::name_<<" data from version "<<version
+            <<" format "<<bin_format<<" (current version "<<VERSION<<")");
+        return ErrorEvent::Success;
+    }
+
     std::string s, key;
     int version(0);
     is>>s;
@@ -573,7 +871,43 @@ Error_t Parameters<T>::unpack(std::istream &is, Format format)
     is>>key>>gravity_field[0]>>gravity_field[1]>>gravity_field[2];
     ASSERT(key=="gravity_field:", "Unexpected key (expected gravity_field)");
 
+    // keys added after gravity_field are optional so that older
+    // checkpoints (that don't have them) can still be loaded
     is>>s;
+    while (is.good() && s!="/PARAMETERS"){
+        if      (s=="mixed_precision:") is>>mixed_precision;
+        else if (s=="precond_coarse_order:") is>>precond_coarse_order;
+        else if (s=="time_sdc_order:") is>>time_sdc_order;
+        else if (s=="checkpoint_bin:") is>>checkpoint_bin;
+        else if (s=="checkpoint_parallel:") is>>checkpoint_parallel;
+        else if (s=="trajectory_file_name:") {
+            is>>s;
+            if (s!="|"){trajectory_file_name=s; is>>s; /* consume | */}else{trajectory_file_name="";}
+        }
+        else if (s=="trajectory_stride:") is>>trajectory_stride;
+        else if (s=="trajectory_quantize:") is>>trajectory_quantize;
+        else if (s=="vtk_order:") is>>vtk_order;
+        else if (s=="vtk_collective:") is>>vtk_collective;
+        else if (s=="vtk_float:") is>>vtk_float;
+        else if (s=="snapshot_stride:") is>>snapshot_stride;
+        else if (s=="snapshot_count:") is>>snapshot_count;
+        else if (s=="rollback_max:") is>>rollback_max;
+        else if (s=="refine_iter_max:") is>>refine_iter_max;
+        else if (s=="time_adap_doubling:") is>>time_adap_doubling;
+        else if (s=="rheology_file_name:") {
+            is>>s;
+            if (s!="|"){rheology_file_name=s; is>>s; /* consume | */}else{rheology_file_name="";}
+        }
+        else if (s=="rheology_stride:") is>>rheology_stride;
+        else if (s=="rheology_bins:") is>>rheology_bins;
+        else if (s=="telemetry_file_name:") {
+            is>>s;
+            if (s!="|"){telemetry_file_name=s; is>>s; /* consume | */}else{telemetry_file_name="";}
+        }
+        else if (s=="profile_step:") is>>profile_step;
+        else    ASSERT(false, "Unexpected key "<<s);
+        is>>s;
+    }
     ASSERT(s=="/PARAMETERS", "Bad input string (missing footer).");
 
     INFO("Unpacked "<<Streamable::name_<<" data from version "<<version<<" (current version "<<VERSION<<")");
@@ -609,11 +943,19 @@ std::ostream& operator<<(std::ostream& output, const Parameters<T>& par)
     output<<"   Scheme                   : "<<par.scheme<<std::endl;
     output<<"   Time tol                 : "<<par.time_tol<<std::endl;
     output<<"   Time iter max            : "<<par.time_iter_max<<std::endl;
+    output<<"   Time SDC order           : "<<par.time_sdc_order<<std::endl;
     output<<"   Time adaptivity          : "<<std::boolalpha<<par.time_adaptive<<std::endl;
+    output<<"   Time adap. doubling      : "<<std::boolalpha<<par.time_adap_doubling<<std::endl;
+    output<<"   Snapshot stride          : "<<par.snapshot_stride<<std::endl;
+    output<<"   Snapshot count           : "<<par.snapshot_count<<std::endl;
+    output<<"   Rollback max             : "<<par.rollback_max<<std::endl;
     output<<"   Precond                  : "<<par.time_precond<<std::endl;
+    output<<"   Precond coarse order     : "<<par.precond_coarse_order<<std::endl;
     output<<"   Error Factor             : "<<par.error_factor<<std::endl;
     output<<"   Solve for velocity       : "<<std::boolalpha<<par.solve_for_velocity<<std::endl;
     output<<"   Pseudospectral           : "<<std::boolalpha<<par.pseudospectral<<std::endl;
+    output<<"   Mixed precision          : "<<std::boolalpha<<par.mixed_precision<<std::endl;
+    output<<"   Refine iter max          : "<<par.refine_iter_max<<std::endl;
 
     output<<"------------------------------------"<<std::endl;
     output<<" Reparametrization:"<<std::endl;
@@ -637,10 +979,23 @@ std::ostream& operator<<(std::ostream& output, const Parameters<T>& par)
     output<<"------------------------------------"<<std::endl;
     output<<" Checkpointing:"<<std::endl;
     output<<"   Checkpoint               : "<<std::boolalpha<<par.checkpoint<<std::endl;
+    output<<"   Checkpoint binary        : "<<std::boolalpha<<par.checkpoint_bin<<std::endl;
+    output<<"   Checkpoint parallel      : "<<std::boolalpha<<par.checkpoint_parallel<<std::endl;
     output<<"   Checkpoint file name     : "<<par.checkpoint_file_name<<std::endl;
     output<<"   Checkpoint stride        : "<<par.checkpoint_stride<<std::endl;
     output<<"   Load checkpoint          : "<<par.load_checkpoint<<std::endl;
     output<<"   Write VTK                : "<<par.write_vtk<<std::endl;
+    output<<"   VTK order                : "<<par.vtk_order<<std::endl;
+    output<<"   VTK collective           : "<<std::boolalpha<<par.vtk_collective<<std::endl;
+    output<<"   VTK float                : "<<std::boolalpha<<par.vtk_float<<std::endl;
+    output<<"   Trajectory file name     : "<<par.trajectory_file_name<<std::endl;
+    output<<"   Trajectory stride        : "<<par.trajectory_stride<<std::endl;
+    output<<"   Trajectory quantize      : "<<std::boolalpha<<par.trajectory_quantize<<std::endl;
+    output<<"   Rheology file name       : "<<par.rheology_file_name<<std::endl;
+    output<<"   Rheology stride          : "<<par.rheology_stride<<std::endl;
+    output<<"   Rheology bins            : "<<par.rheology_bins<<std::endl;
+    output<<"   Telemetry file name      : "<<par.telemetry_file_name<<std::endl;
+    output<<"   Profile every step       : "<<std::boolalpha<<par.profile_step<<std::endl;
 
     output<<"------------------------------------"<<std::endl;
     output<<" Background flow:"<<std::endl;
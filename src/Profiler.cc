@@ -0,0 +1,289 @@
+/**
+ * @file   Profiler.cc
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  The implementation of the Profiler class.
+ */
+
+#include "Profiler.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <omp.h>
+
+//! A call path of a thread, the time and flop are inclusive
+struct ProfileNode
+{
+    std::string key;
+    std::string label;
+    bool named;
+    std::vector<ProfileNode*> children;
+    unsigned long calls;
+    double time;
+    double flop;
+};
+
+namespace {
+    // the names of a path are joined by a character that sorts
+    // before the names, so the children follow their parent
+    const char SEP('\001');
+
+    // the fields of a path reduced over the processes
+    const int CALLS = 0;
+    const int INCL  = 1;
+    const int EXCL  = 2;
+    const int FLOP  = 3;
+    const int NUM_FIELDS = 4;
+
+    struct Record
+    {
+        double v[NUM_FIELDS];
+        Record(){ std::fill(v, v + NUM_FIELDS, 0); }
+    };
+    typedef std::map<std::string, Record> PathMap;
+
+    // the roots of the threads; the tree of a thread is only
+    // modified by that thread
+    std::vector<ProfileNode*> roots;
+    ProfileNode *root(NULL);
+    Profiler::Scope *top(NULL);
+#pragma omp threadprivate(root, top)
+
+    ProfileNode* NewNode(const char *name)
+    {
+        ProfileNode *node(new ProfileNode);
+        node->key   = name;
+        node->label = name;
+        node->named = false;
+        node->calls = 0;
+        node->time  = 0;
+        node->flop  = 0;
+        return node;
+    }
+
+    ProfileNode* Child(ProfileNode *node, const char *name)
+    {
+        for (size_t ii=0; ii<node->children.size(); ++ii)
+            if (node->children[ii]->key == name)
+                return node->children[ii];
+
+        node->children.push_back(NewNode(name));
+        return node->children.back();
+    }
+
+    void Zero(ProfileNode *node)
+    {
+        node->calls = 0;
+        node->time  = 0;
+        node->flop  = 0;
+        for (size_t ii=0; ii<node->children.size(); ++ii)
+            Zero(node->children[ii]);
+    }
+
+    void Flatten(const ProfileNode *node, const std::string &path, PathMap &paths)
+    {
+        for (size_t ii=0; ii<node->children.size(); ++ii){
+            const ProfileNode *c(node->children[ii]);
+            std::string p(path.empty() ? c->label : path + SEP + c->label);
+            double excl(c->time);
+            for (size_t jj=0; jj<c->children.size(); ++jj)
+                excl -= c->children[jj]->time;
+
+            Record &rec(paths[p]);
+            rec.v[CALLS] += c->calls;
+            rec.v[INCL]  += c->time;
+            rec.v[EXCL]  += excl;
+            rec.v[FLOP]  += c->flop;
+            Flatten(c, p, paths);
+        }
+    }
+
+    // the paths of all processes, each process may have called a
+    // different set
+    void UnionPaths(PathMap &paths)
+    {
+#ifdef HAS_MPI
+        int np(1);
+        MPI_Comm_size(VES3D_COMM_WORLD, &np);
+
+        std::string keys;
+        for (PathMap::const_iterator it(paths.begin()); it != paths.end(); ++it)
+            keys += it->first + '\n';
+
+        int len(keys.size());
+        std::vector<int> lens(np), displs(np + 1, 0);
+        MPI_Allgather(&len, 1, MPI_INT, &lens[0], 1, MPI_INT, VES3D_COMM_WORLD);
+        for (int ii=0; ii<np; ++ii) displs[ii + 1] = displs[ii] + lens[ii];
+
+        std::vector<char> all(displs[np] + 1);
+        MPI_Allgatherv(const_cast<char*>(keys.c_str()), len, MPI_CHAR, &all[0],
+            &lens[0], &displs[0], MPI_CHAR, VES3D_COMM_WORLD);
+
+        std::string::size_type start(0);
+        std::string joined(all.begin(), all.begin() + displs[np]);
+        for (std::string::size_type end(joined.find('\n')); end != std::string::npos;
+             start = end + 1, end = joined.find('\n', start))
+            paths[joined.substr(start, end - start)];
+#endif
+    }
+}
+
+Profiler::Scope::Scope(const char *name) :
+    parent_(top),
+    child_flop_(0),
+    active_(true)
+{
+    if (root == NULL){
+        root = NewNode("");
+#pragma omp critical (profilerRoots)
+        roots.push_back(root);
+    }
+
+    node_ = Child(parent_ ? parent_->node_ : root, name);
+    top = this;
+    tic_ = GETSECONDS();
+}
+
+Profiler::Scope::~Scope()
+{
+    Stop();
+}
+
+void Profiler::Scope::Stop(const char *prefix, double flop)
+{
+    if (!active_) return;
+    double time(GETSECONDS() - tic_);
+    active_ = false;
+
+    if (!node_->named){
+        node_->label = std::string(prefix) + node_->key;
+        node_->named = true;
+    }
+
+    flop += child_flop_;
+    ++node_->calls;
+    node_->time += time;
+    node_->flop += flop;
+
+    if (parent_) parent_->child_flop_ += flop;
+    top = parent_;
+}
+
+double Profiler::Scope::ChildFlop() const
+{
+    return child_flop_;
+}
+
+void Profiler::Clear()
+{
+#pragma omp critical (profilerRoots)
+    for (size_t ii=0; ii<roots.size(); ++ii)
+        Zero(roots[ii]);
+}
+
+void Profiler::Collect(std::vector<ProfileStat> &stats)
+{
+    PathMap paths;
+#pragma omp critical (profilerRoots)
+    for (size_t ii=0; ii<roots.size(); ++ii)
+        Flatten(roots[ii], "", paths);
+    UnionPaths(paths);
+
+    size_t n(paths.size());
+    std::vector<double> loc(NUM_FIELDS * n + 1);
+    std::vector<double> mn(loc.size()), mx(loc.size()), sm(loc.size());
+    size_t idx(0);
+    for (PathMap::const_iterator it(paths.begin()); it != paths.end(); ++it, ++idx)
+        std::copy(it->second.v, it->second.v + NUM_FIELDS, &loc[NUM_FIELDS * idx]);
+
+    int np(1);
+#ifdef HAS_MPI
+    MPI_Comm_size(VES3D_COMM_WORLD, &np);
+    int count(NUM_FIELDS * n);
+    MPI_Allreduce(&loc[0], &mn[0], count, MPI_DOUBLE, MPI_MIN, VES3D_COMM_WORLD);
+    MPI_Allreduce(&loc[0], &mx[0], count, MPI_DOUBLE, MPI_MAX, VES3D_COMM_WORLD);
+    MPI_Allreduce(&loc[0], &sm[0], count, MPI_DOUBLE, MPI_SUM, VES3D_COMM_WORLD);
+#else
+    mn = mx = sm = loc;
+#endif
+
+    stats.resize(n);
+    idx = 0;
+    for (PathMap::const_iterator it(paths.begin()); it != paths.end(); ++it, ++idx){
+        ProfileStat &s(stats[idx]);
+        const double *lo(&mn[NUM_FIELDS * idx]);
+        const double *hi(&mx[NUM_FIELDS * idx]);
+        const double *av(&sm[NUM_FIELDS * idx]);
+
+        s.path  = it->first;
+        s.depth = std::count(s.path.begin(), s.path.end(), SEP);
+        std::replace(s.path.begin(), s.path.end(), SEP, '/');
+
+        s.calls   = av[CALLS] / np;
+        s.incl[0] = lo[INCL];
+        s.incl[1] = av[INCL] / np;
+        s.incl[2] = hi[INCL];
+        s.excl[0] = lo[EXCL];
+        s.excl[1] = av[EXCL] / np;
+        s.excl[2] = hi[EXCL];
+        s.flop    = av[FLOP] / np;
+        s.imbalance = (s.incl[1] > 0) ? s.incl[2] / s.incl[1] : 1;
+    }
+}
+
+void Profiler::Report(enum ReportFormat rf)
+{
+    std::vector<ProfileStat> stats;
+    Collect(stats);
+
+    int rank(0);
+#ifdef HAS_MPI
+    MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+#endif
+    if (rank) return;
+
+    // the tree order or the descending order of a field, the sorted
+    // reports show the full call path and the cleared paths are
+    // skipped
+    std::vector<std::pair<double, size_t> > order(stats.size());
+    for (size_t ii=0; ii<stats.size(); ++ii){
+        const ProfileStat &s(stats[ii]);
+        double rate(s.incl[1] > 0 ? s.flop / s.incl[1] : 0);
+        double key(ii);
+        switch ( rf )
+        {
+            case SortFunName:  key = ii;           break;
+            case SortNumCalls: key = -s.calls;     break;
+            case SortTime:     key = -s.incl[1];   break;
+            case SortFlop:     key = -s.flop;      break;
+            case SortFlopRate: key = -rate;        break;
+        }
+        order[ii] = std::make_pair(key, ii);
+    }
+    std::sort(order.begin(), order.end());
+
+    printf("=====================================================================================================\n"
+        "  Calls      Incl(min)   Incl(mean)  Incl(max)   Excl(mean)  Imbal   GFlop/sec   Call path\n"
+        "-----------------------------------------------------------------------------------------------------\n");
+    for (size_t ii=0; ii<order.size(); ++ii){
+        const ProfileStat &s(stats[order[ii].second]);
+        if (s.calls == 0) continue;
+
+        std::string name(s.path);
+        if (rf == SortFunName)
+            name = std::string(2 * s.depth, ' ') + name.substr(name.rfind('/') + 1);
+
+        printf("  %-10.0f %-4.3e   %-4.3e   %-4.3e   %-4.3e   %-6.2f  %-4.3e   %s\n",
+            s.calls, s.incl[0], s.incl[1], s.incl[2], s.excl[1], s.imbalance,
+            s.incl[1] > 0 ? s.flop / s.incl[1] / 1e9 : 0, name.c_str());
+    }
+    printf("=====================================================================================================\n");
+    fflush(stdout);
+}
+
+double Profiler::GetFlops()
+{
+    return top ? top->ChildFlop() : 0;
+}
@@ -45,7 +45,7 @@ Repartition<T>::~Repartition()
 template<typename T>
 template<typename VecContainer, typename ScaContainer>
 Error_t Repartition<T>::operator()(VecContainer &coord,
-    ScaContainer &tension) const
+    ScaContainer &tension, bool *moved) const
 {
     assert( typeid(T) == typeid(typename VecContainer::value_type) );
     assert( typeid(T) == typeid(typename ScaContainer::value_type) );
@@ -86,9 +86,19 @@ Error_t Repartition<T>::operator()(VecContainer &coord,
 
 #pragma omp barrier
 
+    // compared before nv_ is set to the new number of vesicles
+    if ( moved != NULL )
+        *moved = (nvr_ != nv_) || !std::equal(all_pos_,
+            all_pos_ + VecContainer::getTheDim() * stride * nv_, posr_);
+
     int oldnv(nv);
     nv = getNvShare();
     idx = this->getCpyIdx(nv, stride);
+
+    // the content is overwritten below, it is not copied when the
+    // containers need to grow
+    if ( nv * coord.getSubLength() > coord.capacity() ) coord.resize(0);
+    if ( nv * tension.getSubLength() > tension.capacity() ) tension.resize(0);
     coord.resize(nv);
     tension.resize(nv);
 
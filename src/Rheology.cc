@@ -0,0 +1,208 @@
+template<typename SurfContainer>
+Rheology<SurfContainer>::Rheology(int n_bins, value_type period, MPI_Comm comm) :
+    comm_(comm),
+    n_bins_(n_bins > 0 ? n_bins : 1),
+    period_(period),
+    t_(0),
+    t_prev_(0),
+    glb_(NUM_FIELDS + 2 * n_bins_, 0)
+{}
+
+template<typename SurfContainer>
+Rheology<SurfContainer>::~Rheology()
+{}
+
+template<typename SurfContainer>
+Error_t Rheology<SurfContainer>::Compute(const SurfContainer &S, const Vec_t &f,
+    value_type t)
+{
+    PROFILESTART();
+    size_t nv(S.getNumberOfSurfaces());
+    int nm(SurfContainer::getNumMoments(2));
+
+    S.moments(moms_, 2);
+    S.stresslet(f, strs_);
+    host_moms_.resize(moms_.size());
+    host_strs_.resize(strs_.size());
+    if (nv){
+        moms_.getDevice().Memcpy(&host_moms_[0], moms_.begin(),
+            moms_.size() * sizeof(value_type), device_type::MemcpyDeviceToHost);
+        strs_.getDevice().Memcpy(&host_strs_[0], strs_.begin(),
+            strs_.size() * sizeof(value_type), device_type::MemcpyDeviceToHost);
+    }
+
+    // the centroids of the previous call are of the same vesicles
+    // when their number is unchanged (and the time has advanced),
+    // the caller resets the history when the vesicles are exchanged
+    bool has_vel(t > t_prev_ && cent_prev_.size() == DIM * nv);
+    cent_prev_.resize(DIM * nv);
+
+    loc_.assign(NUM_FIELDS + 2 * n_bins_, 0);
+    loc_[NUM_VES] = nv;
+    value_type *dhist(&loc_[NUM_FIELDS]), *ihist(&loc_[NUM_FIELDS + n_bins_]);
+    for (size_t iv=0; iv<nv; ++iv){
+        const value_type *m(&host_moms_[iv * nm]), *s(&host_strs_[iv * 9]);
+        loc_[VOLUME] += m[1];
+        for (int ii=0; ii<6; ++ii)
+            loc_[STRESSLET + ii] += s[DIM + ii];
+
+        value_type D, theta;
+        Shape(m + 2 + DIM, D, theta);
+        loc_[DEFORM]    += D;
+        loc_[DEFORM_SQ] += D * D;
+        loc_[INCLIN]    += theta;
+        int bd(D * n_bins_), bi((theta / M_PI + 0.5) * n_bins_);
+        ++dhist[std::max(0, std::min(bd, n_bins_ - 1))];
+        ++ihist[std::max(0, std::min(bi, n_bins_ - 1))];
+
+        for (int dd=0; dd<DIM; ++dd){
+            if (has_vel){
+                // the nearest periodic image of the previous centroid
+                value_type disp(m[2 + dd] - cent_prev_[DIM * iv + dd]);
+                if (period_ > 0)
+                    disp -= period_ * std::floor(disp / period_ + value_type(0.5));
+                loc_[VELOCITY + dd] += disp / (t - t_prev_);
+            }
+            cent_prev_[DIM * iv + dd] = m[2 + dd];
+        }
+        loc_[NUM_VEL] += has_vel;
+    }
+    t_prev_ = t_ = t;
+
+    glb_.resize(loc_.size());
+    MPI_Allreduce(&loc_[0], &glb_[0], loc_.size(),
+        (sizeof(value_type)==sizeof(double)) ? MPI_DOUBLE : MPI_FLOAT,
+        MPI_SUM, comm_);
+
+    COUTDEBUG("Rheology of "<<glb_[NUM_VES]<<" vesicles at t = "<<t);
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
+template<typename SurfContainer>
+typename Rheology<SurfContainer>::value_type
+Rheology<SurfContainer>::mean_deformation() const
+{
+    return glb_[NUM_VES] ? glb_[DEFORM] / glb_[NUM_VES] : 0;
+}
+
+template<typename SurfContainer>
+typename Rheology<SurfContainer>::value_type
+Rheology<SurfContainer>::mean_inclination() const
+{
+    return glb_[NUM_VES] ? glb_[INCLIN] / glb_[NUM_VES] : 0;
+}
+
+template<typename SurfContainer>
+void Rheology<SurfContainer>::mean_velocity(value_type *vel) const
+{
+    for (int dd=0; dd<DIM; ++dd)
+        vel[dd] = glb_[NUM_VEL] ? glb_[VELOCITY + dd] / glb_[NUM_VEL] : 0;
+}
+
+template<typename SurfContainer>
+void Rheology<SurfContainer>::WriteHeader(std::ostream &os) const
+{
+    os<<"# t n_ves volume S_xx S_xy S_xz S_yy S_yz S_zz"
+      <<" D_mean D_std inclin_mean vel_x vel_y vel_z";
+    for (int ii=0; ii<n_bins_; ++ii) os<<" D_hist_"<<ii;
+    for (int ii=0; ii<n_bins_; ++ii) os<<" inclin_hist_"<<ii;
+    os<<"\n";
+}
+
+template<typename SurfContainer>
+void Rheology<SurfContainer>::WriteLine(std::ostream &os) const
+{
+    value_type Dm(mean_deformation()), vel[DIM];
+    value_type Ds(glb_[NUM_VES] ? glb_[DEFORM_SQ] / glb_[NUM_VES] - Dm * Dm : 0);
+    mean_velocity(vel);
+
+    std::ios_base::fmtflags flags(os.flags());
+    std::streamsize prec(os.precision(9));
+    os<<std::scientific<<t_<<" "<<static_cast<size_t>(glb_[NUM_VES])<<" "<<glb_[VOLUME];
+    for (int ii=0; ii<6; ++ii) os<<" "<<glb_[STRESSLET + ii];
+    os<<" "<<Dm<<" "<<std::sqrt(std::max(Ds, value_type(0)))<<" "<<mean_inclination();
+    for (int dd=0; dd<DIM; ++dd) os<<" "<<vel[dd];
+    for (int ii=0; ii<2 * n_bins_; ++ii)
+        os<<" "<<static_cast<size_t>(glb_[NUM_FIELDS + ii]);
+    os<<"\n";
+    os.flags(flags);
+    os.precision(prec);
+}
+
+template<typename SurfContainer>
+void Rheology<SurfContainer>::Shape(const value_type *mom, value_type &deform,
+    value_type &inclin)
+{
+    // the second moments of an ellipsoid are a^2/5 along its axes
+    value_type lambda[DIM], vec[DIM * DIM];
+    SymEig3(mom, lambda, vec);
+    value_type L(std::sqrt(std::max(lambda[2], value_type(0))));
+    value_type B(std::sqrt(std::max(lambda[0], value_type(0))));
+    deform = (L + B > 0) ? (L - B) / (L + B) : 0;
+
+    // the long axis is the last column, its sign is arbitrary
+    inclin = std::atan2(vec[8], vec[2]);
+    if (inclin >= M_PI / 2) inclin -= M_PI;
+    if (inclin < -M_PI / 2) inclin += M_PI;
+}
+
+template<typename SurfContainer>
+void Rheology<SurfContainer>::SymEig3(const value_type *a, value_type *lambda,
+    value_type *vec)
+{
+    value_type m[DIM][DIM] = {{a[0], a[1], a[2]},
+                              {a[1], a[3], a[4]},
+                              {a[2], a[4], a[5]}};
+    value_type v[DIM][DIM] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    value_type eps(std::numeric_limits<value_type>::epsilon());
+
+    // cyclic Jacobi rotations, the off-diagonal entries that are
+    // negligible relative to their diagonal are dropped
+    for (int sweep=0; sweep<50; ++sweep){
+        bool rotated(false);
+        for (int p=0; p<DIM-1; ++p){
+            for (int q=p+1; q<DIM; ++q){
+                if (std::abs(m[p][q]) <= eps * (std::abs(m[p][p]) + std::abs(m[q][q]))){
+                    m[p][q] = m[q][p] = 0;
+                    continue;
+                }
+                rotated = true;
+                value_type theta((m[q][q] - m[p][p]) / (2 * m[p][q]));
+                value_type t((theta >= 0 ? 1 : -1) /
+                    (std::abs(theta) + std::sqrt(theta * theta + 1)));
+                value_type c(1 / std::sqrt(t * t + 1)), s(t * c);
+
+                for (int k=0; k<DIM; ++k){
+                    value_type mp(m[k][p]), mq(m[k][q]);
+                    m[k][p] = c * mp - s * mq;
+                    m[k][q] = s * mp + c * mq;
+                }
+                for (int k=0; k<DIM; ++k){
+                    value_type mp(m[p][k]), mq(m[q][k]);
+                    m[p][k] = c * mp - s * mq;
+                    m[q][k] = s * mp + c * mq;
+                }
+                for (int k=0; k<DIM; ++k){
+                    value_type vp(v[k][p]), vq(v[k][q]);
+                    v[k][p] = c * vp - s * vq;
+                    v[k][q] = s * vp + c * vq;
+                }
+            }
+        }
+        if (!rotated) break;
+    }
+
+    // ascending order
+    int idx[DIM] = {0, 1, 2};
+    for (int ii=0; ii<DIM; ++ii)
+        for (int jj=ii+1; jj<DIM; ++jj)
+            if (m[idx[jj]][idx[jj]] < m[idx[ii]][idx[ii]])
+                std::swap(idx[ii], idx[jj]);
+
+    for (int jj=0; jj<DIM; ++jj){
+        lambda[jj] = m[idx[jj]][idx[jj]];
+        for (int k=0; k<DIM; ++k)
+            vec[k * DIM + jj] = v[k][idx[jj]];
+    }
+}
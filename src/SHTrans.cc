@@ -85,18 +85,33 @@ void SHTrans<Container, Mats>::back(const value_type *inputs,
     value_type *trans, value_type *dft) const
 {
     PROFILESTART();
+    Telemetry::Timer timer(Telemetry::SHT);
+    backDLT(inputs, work_arr, n_funs, outputs, trans);
+    backDFT(work_arr, n_funs, outputs, dft);
+    PROFILEEND("SHT_",0);
+}
+
+template<typename Container, typename Mats>
+void SHTrans<Container, Mats>::backDLT(const value_type *inputs,
+    value_type *work_arr, int n_funs, value_type *outputs,
+    value_type *trans) const
+{
     int num_dft_inputs = n_funs * (p + 1);
     DLT(trans, inputs, outputs, p + 1, 2 * n_funs, p + 1, 0, 0, 1);
 
     device_.Transpose(outputs, dft_size, num_dft_inputs, work_arr);
+}
 
+template<typename Container, typename Mats>
+void SHTrans<Container, Mats>::backDFT(const value_type *work_arr,
+    int n_funs, value_type *outputs, value_type *dft) const
+{
     PROFILESTART();
+    int num_dft_inputs = n_funs * (p + 1);
     device_.gemm("T", "N", &dft_size, &num_dft_inputs,
         &dft_size, &alpha_, dft, &dft_size,
         work_arr, &dft_size, &beta_, outputs, &dft_size);
     PROFILEEND("SHT_DFT_",0);
-
-    PROFILEEND("SHT_",0);
 }
 
 template<typename Container, typename Mats>
@@ -104,14 +119,17 @@ void SHTrans<Container, Mats>::forward(const Container &in, Container &work,
     Container &shc) const
 {
     PROFILESTART();
+    Telemetry::Timer timer(Telemetry::SHT);
     int n_funs = in.getNumSubFuncs();
     int num_dft_inputs = n_funs * (p + 1);
 
-    PROFILESTART();
-    device_.gemm("N", "N", &dft_size, &num_dft_inputs, &dft_size,
-        &alpha_, mats_.dft_, &dft_size,in.begin(), &dft_size, &beta_,
-        shc.begin(), &dft_size);
-    PROFILEEND("SHT_DFT_",0);
+    {
+        PROFILESTART();
+        device_.gemm("N", "N", &dft_size, &num_dft_inputs, &dft_size,
+            &alpha_, mats_.dft_, &dft_size,in.begin(), &dft_size, &beta_,
+            shc.begin(), &dft_size);
+        PROFILEEND("SHT_DFT_",0);
+    }
 
     device_.Transpose(shc.begin(), num_dft_inputs, dft_size, work.begin());
     DLT(mats_.dlt_, work.begin(), shc.begin(), p + 1, 2 * n_funs, p + 1, 1, 0, 0);
@@ -169,6 +187,28 @@ void SHTrans<Container, Mats>::backward_duv(const Container &shc,
         mats_.dlt_inv_d1_, mats_.dft_inv_d1_);
 }
 
+template<typename Container, typename Mats>
+void SHTrans<Container, Mats>::AllDerivatives(const Container &shc,
+    Container &work, Container &du, Container &dv, Container &d2u,
+    Container &d2v, Container &duv) const
+{
+    PROFILESTART();
+    Telemetry::Timer timer(Telemetry::SHT);
+    int n_funs = shc.getNumSubFuncs();
+
+    backDLT(shc.begin(), work.begin(), n_funs, dv.begin(), mats_.dlt_inv_);
+    backDFT(work.begin(), n_funs, dv.begin() , mats_.dft_inv_d1_);
+    backDFT(work.begin(), n_funs, d2v.begin(), mats_.dft_inv_d2_);
+
+    backDLT(shc.begin(), work.begin(), n_funs, du.begin(), mats_.dlt_inv_d1_);
+    backDFT(work.begin(), n_funs, du.begin() , mats_.dft_inv_);
+    backDFT(work.begin(), n_funs, duv.begin(), mats_.dft_inv_d1_);
+
+    backDLT(shc.begin(), work.begin(), n_funs, d2u.begin(), mats_.dlt_inv_d2_);
+    backDFT(work.begin(), n_funs, d2u.begin(), mats_.dft_inv_);
+    PROFILEEND("SHT_",0);
+}
+
 template<typename Container, typename Mats>
 void SHTrans<Container, Mats>::lowPassFilter(const Container &in, Container &work,
     Container &shc, Container &out) const
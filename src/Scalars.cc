@@ -144,6 +144,16 @@ void Scalars<T, DT, DEVICE>::match_size(Scalars<T, DT, DEVICE> const& rhs)
     this->resize(rhs.getNumSubFuncs(), rhs.getShOrder(), rhs.getGridDim());
 }
 
+template <typename T, typename DT, const DT &DEVICE>
+void Scalars<T, DT, DEVICE>::swap(Scalars<T, DT, DEVICE> &rhs)
+{
+    array_type::swap(rhs);
+    std::swap(sh_order_, rhs.sh_order_);
+    std::swap(grid_dim_, rhs.grid_dim_);
+    std::swap(stride_, rhs.stride_);
+    std::swap(num_sub_funcs_, rhs.num_sub_funcs_);
+}
+
 template <typename T, typename DT, const DT &DEVICE>
 typename Scalars<T, DT, DEVICE>::iterator
 Scalars<T, DT, DEVICE>::getSubN_begin(size_t n)
@@ -219,7 +229,15 @@ Scalars<T, DT, DEVICE>::getSubFuncN_end(size_t n) const
 template<typename T, typename DT, const DT &DEVICE>
 Error_t Scalars<T, DT, DEVICE>::pack(std::ostream &os, Streamable::Format format) const
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        CHK(this->pack_header(os, "SCALARS", sizeof(T)));
+        CHK(this->pack_value(os, static_cast<uint64_t>(getNumSubs())));
+        CHK(this->pack_value(os, static_cast<int32_t>(sh_order_)));
+        CHK(this->pack_value(os, static_cast<int32_t>(grid_dim_.first)));
+        CHK(this->pack_value(os, static_cast<int32_t>(grid_dim_.second)));
+        CHK(this->pack_value(os, static_cast<uint64_t>(stride_)));
+        return array_type::pack(os, format);
+    }
 
     os<<"SCALARS\n";
     os<<"version: "<<VERSION<<"\n";
@@ -237,7 +255,24 @@ Error_t Scalars<T, DT, DEVICE>::pack(std::ostream &os, Streamable::Format format
 template<typename T, typename DT, const DT &DEVICE>
 Error_t Scalars<T, DT, DEVICE>::unpack(std::istream &is, Streamable::Format format)
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        int version(0);
+        uint64_t nsub, stride;
+        int32_t shorder, gridx, gridy;
+        Error_t ierr(this->unpack_header(is, "SCALARS", sizeof(T), version));
+        if (ierr) return ierr;
+        if (this->unpack_value(is, nsub)    ||
+            this->unpack_value(is, shorder) ||
+            this->unpack_value(is, gridx)   ||
+            this->unpack_value(is, gridy)   ||
+            this->unpack_value(is, stride))
+            return ErrorEvent::IOBadStream;
+        resize(nsub, shorder, std::make_pair<int,int>(gridx,gridy));
+        ASSERT(stride_ == stride, "Incorrect resizing stride");
+
+        return array_type::unpack(is, format);
+    }
+
     std::string s,key;
     int version(0);
     is>>s;
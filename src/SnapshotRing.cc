@@ -0,0 +1,73 @@
+template<typename Vec, typename Sca>
+SnapshotRing<Vec, Sca>::SnapshotRing(int capacity) :
+    snaps_(std::max(capacity, 0), NULL),
+    head_(0),
+    size_(0)
+{
+    // the containers are not copyable
+    for (size_t ii=0; ii<snaps_.size(); ++ii)
+        snaps_[ii] = new Snapshot();
+}
+
+template<typename Vec, typename Sca>
+SnapshotRing<Vec, Sca>::~SnapshotRing()
+{
+    for (size_t ii=0; ii<snaps_.size(); ++ii)
+        delete snaps_[ii];
+}
+
+template<typename Vec, typename Sca>
+void SnapshotRing<Vec, Sca>::Take(value_type t, value_type dt, const Vec &x,
+    const Sca &tension, const Vec &dx_prev, value_type dt_prev)
+{
+    if (snaps_.empty()) return;
+
+    Snapshot &s(*snaps_[head_]);
+    s.t       = t;
+    s.dt      = dt;
+    s.dt_prev = dt_prev;
+    Copy(x, s.x);
+    Copy(tension, s.tension);
+    Copy(dx_prev, s.dx_prev);
+
+    head_ = (head_ + 1) % snaps_.size();
+    size_ = std::min<int>(size_ + 1, snaps_.size());
+    COUTDEBUG("Took a snapshot at t="<<t<<" ("<<size_<<" in the ring)");
+}
+
+template<typename Vec, typename Sca>
+bool SnapshotRing<Vec, Sca>::Restore(value_type &t, value_type &dt, Vec &x,
+    Sca &tension, Vec &dx_prev, value_type &dt_prev)
+{
+    if (size_ == 0) return false;
+
+    head_ = (head_ + snaps_.size() - 1) % snaps_.size();
+    --size_;
+
+    const Snapshot &s(*snaps_[head_]);
+    t       = s.t;
+    dt      = s.dt;
+    dt_prev = s.dt_prev;
+    Copy(s.x, x);
+    Copy(s.tension, tension);
+    Copy(s.dx_prev, dx_prev);
+
+    return true;
+}
+
+template<typename Vec, typename Sca>
+typename SnapshotRing<Vec, Sca>::value_type SnapshotRing<Vec, Sca>::newest_time() const
+{
+    ASSERT(size_ > 0, "The ring is empty");
+    return snaps_[(head_ + snaps_.size() - 1) % snaps_.size()]->t;
+}
+
+template<typename Vec, typename Sca>
+template<typename Container>
+void SnapshotRing<Vec, Sca>::Copy(const Container &src, Container &dst)
+{
+    dst.replicate(src);
+    if (src.size())
+        dst.getDevice().Memcpy(dst.begin(), src.begin(),
+            src.size() * sizeof(value_type), device_type::MemcpyDeviceToDevice);
+}
@@ -384,6 +384,7 @@ const StokesVelocity<Real>::PVFMMVec& StokesVelocity<Real>::operator()(){
 
   if(!S_vel.Dim()){ // Compute self interaction
     pvfmm::Profile::Tic("SelfInteraction",&comm);
+    Telemetry::Timer timer(Telemetry::Self);
     bool prof_state=pvfmm::Profile::Enable(false);
     assert(!S_vel_up.Dim());
     static PVFMMVec vel_up, vel_pole, Vcoef;
@@ -476,6 +477,7 @@ const StokesVelocity<Real>::PVFMMVec& StokesVelocity<Real>::operator()(){
   PVFMMVec& trg_coord=(trg_is_surf?tcoord_repl:tcoord);
   if(!fmm_vel.Dim()){ // Compute far interaction
     pvfmm::Profile::Tic("FarInteraction",&comm,true);
+    Telemetry::Timer timer(Telemetry::FMM);
     bool prof_state=pvfmm::Profile::Enable(false);
     fmm_vel.ReInit(trg_coord.Dim());
     PVFMMEval(&scoord_far[0],
@@ -491,6 +493,7 @@ const StokesVelocity<Real>::PVFMMVec& StokesVelocity<Real>::operator()(){
 
   if(!trg_vel.Dim()){ // Compute near interaction
     pvfmm::Profile::Tic("NearInteraction",&comm,true);
+    Telemetry::Timer timer(Telemetry::Near);
     bool prof_state=pvfmm::Profile::Enable(false);
     const PVFMMVec& near_vel=near_singular();
     { // Compute trg_vel = fmm_vel + near_vel
@@ -770,7 +773,7 @@ void StokesVelocity<Real>::Test(){
 
 
 template <class Real>
-void WriteVTK(const pvfmm::Vector<Real>& S, long p0, long p1, const char* fname, Real period=0, const pvfmm::Vector<Real>* v_ptr=NULL, MPI_Comm comm=MPI_COMM_WORLD){
+Error_t WriteVTK(const pvfmm::Vector<Real>& S, long p0, long p1, const char* fname, Real period=0, const pvfmm::Vector<Real>* v_ptr=NULL, MPI_Comm comm=MPI_COMM_WORLD, bool collective=false, bool single=false){
   typedef double VTKReal;
   int data__dof=COORD_DIM;
 
@@ -871,116 +874,16 @@ void WriteVTK(const pvfmm::Vector<Real>& S, long p0, long p1, const char* fname,
     }
   }
 
-  int myrank, np;
-  MPI_Comm_size(comm,&np);
-  MPI_Comm_rank(comm,&myrank);
-
-  std::vector<VTKReal>& coord=point_coord;
-  std::vector<VTKReal>& value=point_value;
-  std::vector<int32_t> connect=poly_connect;
-  std::vector<int32_t> offset=poly_offset;
-
-  int pt_cnt=coord.size()/COORD_DIM;
-  int poly_cnt=poly_offset.size();
-
-  //Open file for writing.
-  std::stringstream vtufname;
-  vtufname<<fname<<"_"<<std::setfill('0')<<std::setw(6)<<myrank<<".vtp";
-  std::ofstream vtufile;
-  vtufile.open(vtufname.str().c_str());
-  if(vtufile.fail()) return;
-
-  bool isLittleEndian;
-  {
-    uint16_t number = 0x1;
-    uint8_t *numPtr = (uint8_t*)&number;
-    isLittleEndian=(numPtr[0] == 1);
-  }
-
-  //Proceed to write to file.
-  size_t data_size=0;
-  vtufile<<"<?xml version=\"1.0\"?>\n";
-  if(isLittleEndian) vtufile<<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
-  else               vtufile<<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"BigEndian\">\n";
-  //===========================================================================
-  vtufile<<"  <PolyData>\n";
-  vtufile<<"    <Piece NumberOfPoints=\""<<pt_cnt<<"\" NumberOfVerts=\"0\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\""<<poly_cnt<<"\">\n";
-
-  //---------------------------------------------------------------------------
-  vtufile<<"      <Points>\n";
-  vtufile<<"        <DataArray type=\"Float"<<sizeof(VTKReal)*8<<"\" NumberOfComponents=\""<<COORD_DIM<<"\" Name=\"Position\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-  data_size+=sizeof(uint32_t)+coord.size()*sizeof(VTKReal);
-  vtufile<<"      </Points>\n";
-  //---------------------------------------------------------------------------
-  if(value.size()){ // value
-    vtufile<<"      <PointData>\n";
-    vtufile<<"        <DataArray type=\"Float"<<sizeof(VTKReal)*8<<"\" NumberOfComponents=\""<<value.size()/pt_cnt<<"\" Name=\""<<"value"<<"\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-    data_size+=sizeof(uint32_t)+value.size()*sizeof(VTKReal);
-    vtufile<<"      </PointData>\n";
-  }
-  //---------------------------------------------------------------------------
-  vtufile<<"      <Polys>\n";
-  vtufile<<"        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-  data_size+=sizeof(uint32_t)+connect.size()*sizeof(int32_t);
-  vtufile<<"        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
-  data_size+=sizeof(uint32_t)+offset.size() *sizeof(int32_t);
-  vtufile<<"      </Polys>\n";
-  //---------------------------------------------------------------------------
-
-  vtufile<<"    </Piece>\n";
-  vtufile<<"  </PolyData>\n";
-  //===========================================================================
-  vtufile<<"  <AppendedData encoding=\"raw\">\n";
-  vtufile<<"    _";
-
-  int32_t block_size;
-  block_size=coord.size()*sizeof(VTKReal); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&coord  [0], coord.size()*sizeof(VTKReal));
-  if(value.size()){ // value
-    block_size=value.size()*sizeof(VTKReal); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&value  [0], value.size()*sizeof(VTKReal));
-  }
-  block_size=connect.size()*sizeof(int32_t); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&connect[0], connect.size()*sizeof(int32_t));
-  block_size=offset .size()*sizeof(int32_t); vtufile.write((char*)&block_size, sizeof(int32_t)); vtufile.write((char*)&offset [0], offset .size()*sizeof(int32_t));
-
-  vtufile<<"\n";
-  vtufile<<"  </AppendedData>\n";
-  //===========================================================================
-  vtufile<<"</VTKFile>\n";
-  vtufile.close();
-
-
-  if(myrank) return;
-  std::stringstream pvtufname;
-  pvtufname<<fname<<".pvtp";
-  std::ofstream pvtufile;
-  pvtufile.open(pvtufname.str().c_str());
-  if(pvtufile.fail()) return;
-  pvtufile<<"<?xml version=\"1.0\"?>\n";
-  pvtufile<<"<VTKFile type=\"PPolyData\">\n";
-  pvtufile<<"  <PPolyData GhostLevel=\"0\">\n";
-  pvtufile<<"      <PPoints>\n";
-  pvtufile<<"        <PDataArray type=\"Float"<<sizeof(VTKReal)*8<<"\" NumberOfComponents=\""<<COORD_DIM<<"\" Name=\"Position\"/>\n";
-  pvtufile<<"      </PPoints>\n";
-  if(value.size()){ // value
-    pvtufile<<"      <PPointData>\n";
-    pvtufile<<"        <PDataArray type=\"Float"<<sizeof(VTKReal)*8<<"\" NumberOfComponents=\""<<value.size()/pt_cnt<<"\" Name=\""<<"value"<<"\"/>\n";
-    pvtufile<<"      </PPointData>\n";
-  }
-  {
-    // Extract filename from path.
-    std::stringstream vtupath;
-    vtupath<<'/'<<fname;
-    std::string pathname = vtupath.str();
-    unsigned found = pathname.find_last_of("/\\");
-    std::string fname_ = pathname.substr(found+1);
-    for(int i=0;i<np;i++) pvtufile<<"      <Piece Source=\""<<fname_<<"_"<<std::setfill('0')<<std::setw(6)<<i<<".vtp\"/>\n";
-  }
-  pvtufile<<"  </PPolyData>\n";
-  pvtufile<<"</VTKFile>\n";
-  pvtufile.close();
+  VTKPiece piece;
+  piece.coord.swap(point_coord);
+  piece.value.swap(point_value);
+  piece.connect.swap(poly_connect);
+  piece.offset.swap(poly_offset);
+  return VTKWriter::Write(fname, piece, VTKWriter::PolyData, collective, single, comm);
 }
 
 template <class Surf>
-void WriteVTK(const Surf& S, const char* fname, MPI_Comm comm=MPI_COMM_WORLD, const typename Surf::Vec_t* v_ptr=NULL, int order=-1, typename Surf::value_type period=0){
+Error_t WriteVTK(const Surf& S, const char* fname, MPI_Comm comm=MPI_COMM_WORLD, const typename Surf::Vec_t* v_ptr=NULL, int order=-1, typename Surf::value_type period=0, bool collective=false, bool single=false){
   typedef typename Surf::value_type Real;
   typedef typename Surf::Vec_t Vec;
   size_t p0=S.getShOrder();
@@ -989,6 +892,6 @@ void WriteVTK(const Surf& S, const char* fname, MPI_Comm comm=MPI_COMM_WORLD, co
   pvfmm::Vector<Real> S_, v_;
   S_.ReInit(S.getPosition().size(),(Real*)S.getPosition().begin(),false);
   if(v_ptr) v_.ReInit(v_ptr->size(),(Real*)v_ptr->begin(),false);
-  WriteVTK(S_, p0, p1, fname, period, (v_ptr?&v_:NULL), comm);
+  return WriteVTK(S_, p0, p1, fname, period, (v_ptr?&v_:NULL), comm, collective, single);
 }
 
@@ -47,6 +47,11 @@ template<typename T>
 Error_t Streamable::pack_array(std::ostream &os, Format format, const T* arr, size_t n, const char *sep) const
 {
     ASSERT(sep=="\n" || sep=="\t" || sep==" ", "unsupported separator");
+    if (format==BIN){
+        os.write(reinterpret_cast<const char*>(arr), n * sizeof(T));
+        return os.good() ? ErrorEvent::Success : ErrorEvent::IOBadStream;
+    }
+
     if(n>0) {
 	for (size_t ii=0; ii+1<n; ++ii) os<<arr[ii]<<sep;
 	os<<arr[n-1]; //to skip the separator for the last one
@@ -58,6 +63,13 @@ template<typename T>
 Error_t Streamable::unpack_array(std::istream &is, Format format, T* arr, size_t &n, const char* sep) const
 {
     ASSERT(sep=="\n" || sep=="\t" || sep==" ", "unsupported separator");
+    if (format==BIN){
+        is.read(reinterpret_cast<char*>(arr), n * sizeof(T));
+        size_t N(n);
+        n = is.gcount() / sizeof(T);
+        return (n==N) ? ErrorEvent::Success : ErrorEvent::IOBadStream;
+    }
+
     size_t N(n);
     for (n=0; n<N; ++n){
 	if(!is.good()) return ErrorEvent::IOBadStream;
@@ -66,6 +78,138 @@ Error_t Streamable::unpack_array(std::istream &is, Format format, T* arr, size_t
     return ErrorEvent::Success;
 }
 
+inline Error_t Streamable::pack_bin(void** buffer, size_t &len, size_t offset) const
+{
+    std::stringstream ss;
+    CHK(pack(ss, BIN));
+    size_t n(ss.tellp());
+
+    if (*buffer==NULL){
+        *buffer = malloc(offset + n);
+        if (*buffer==NULL) return ErrorEvent::MemoryError;
+    } else if (len < offset + n){
+        return ErrorEvent::MemoryError;
+    }
+
+    ss.read(static_cast<char*>(*buffer) + offset, n);
+    len = n;
+    return ErrorEvent::Success;
+}
+
+inline Error_t Streamable::unpack_bin(const void* buffer, size_t len, size_t offset)
+{
+    std::stringstream ss(std::string(static_cast<const char*>(buffer) + offset, len));
+    return unpack(ss, BIN);
+}
+
+inline Streamable::Format Streamable::peek_format(std::istream &is)
+{
+    uint32_t magic(0);
+    std::streampos pos(is.tellg());
+    is.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    is.clear();
+    is.seekg(pos);
+
+    return (magic==BIN_MAGIC) ? BIN : ASCII;
+}
+
+inline Error_t Streamable::pack_header(std::ostream &os, const char *tag, int value_size, int format) const
+{
+    BinHeader h;
+    std::string t(tag);
+    ASSERT(t.size()<BIN_TAG_LENGTH, "tag is too long");
+
+    h.magic = BIN_MAGIC;
+    t.copy(h.tag, BIN_TAG_LENGTH);
+    std::fill(h.tag + t.size(), h.tag + BIN_TAG_LENGTH, '\0');
+    h.version = version_number();
+    h.format = format;
+    h.value_size = value_size;
+
+    os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    return os.good() ? ErrorEvent::Success : ErrorEvent::IOBadStream;
+}
+
+inline Error_t Streamable::unpack_header(std::istream &is, const char *tag, int value_size, int &version) const
+{
+    int format(0);
+    return unpack_header(is, tag, value_size, version, format, 1);
+}
+
+inline Error_t Streamable::unpack_header(std::istream &is, const char *tag, int value_size, int &version,
+    int &format, int max_format) const
+{
+    BinHeader h;
+    is.read(reinterpret_cast<char*>(&h), sizeof(h));
+    if (!is.good()) return ErrorEvent::IOBadStream;
+
+    if (h.magic!=BIN_MAGIC){
+        CERR("Bad binary header for "<<tag<<((h.magic==__builtin_bswap32(BIN_MAGIC)) ?
+                " (different byte order)" : ""));
+        return ErrorEvent::IOBadStream;
+    }
+
+    h.tag[BIN_TAG_LENGTH-1] = '\0';
+    if (std::string(h.tag)!=tag){
+        CERR("Bad input (expected "<<tag<<" but found "<<h.tag<<")");
+        return ErrorEvent::IOBadStream;
+    }
+
+    if (h.value_size!=value_size){
+        CERR("Incompatible data for "<<tag<<" (precision of the data is "
+            <<h.value_size<<" bytes instead of "<<value_size<<")");
+        return ErrorEvent::IOBadStream;
+    }
+
+    if (h.format<1 || h.format>max_format){
+        CERR("Unsupported data for "<<tag<<" (format "<<h.format<<" of version "
+            <<h.version<<", the newest readable format is "<<max_format<<")");
+        return ErrorEvent::IOBadStream;
+    }
+
+    version = h.version;
+    format  = h.format;
+    return ErrorEvent::Success;
+}
+
+template<typename T>
+Error_t Streamable::pack_value(std::ostream &os, const T &val) const
+{
+    os.write(reinterpret_cast<const char*>(&val), sizeof(T));
+    return os.good() ? ErrorEvent::Success : ErrorEvent::IOBadStream;
+}
+
+template<typename T>
+Error_t Streamable::unpack_value(std::istream &is, T &val) const
+{
+    is.read(reinterpret_cast<char*>(&val), sizeof(T));
+    return is.good() ? ErrorEvent::Success : ErrorEvent::IOBadStream;
+}
+
+inline Error_t Streamable::pack_string(std::ostream &os, const std::string &str) const
+{
+    uint64_t len(str.size());
+    CHK(pack_value(os, len));
+    os.write(str.data(), len);
+    return os.good() ? ErrorEvent::Success : ErrorEvent::IOBadStream;
+}
+
+inline Error_t Streamable::unpack_string(std::istream &is, std::string &str) const
+{
+    uint64_t len(0);
+    if (unpack_value(is, len)!=ErrorEvent::Success) return ErrorEvent::IOBadStream;
+    str.resize(len);
+    if (len>0) is.read(&str[0], len);
+    return is.good() ? ErrorEvent::Success : ErrorEvent::IOBadStream;
+}
+
+inline int Streamable::version_number()
+{
+    int version(atoi(VERSION.c_str()));
+    if (VERSION.find('+')!=std::string::npos) ++version;
+    return version;
+}
+
 std::ostream& operator<<(std::ostream& os, const Streamable *o)
 {
     o->pack(os, Streamable::ASCII);
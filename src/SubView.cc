@@ -0,0 +1,16 @@
+template<typename Container>
+SubView<Container>::SubView(Container &c, size_t first, size_t num_subs)
+{
+    reset(c, first, num_subs);
+}
+
+template<typename Container>
+void SubView<Container>::reset(Container &c, size_t first, size_t num_subs)
+{
+    ASSERT(first + num_subs <= c.getNumSubs(), "The view is out of the container range");
+
+    // shape of c with num_subs sub-components, without allocation
+    this->resize(0, c.getShOrder(), c.getGridDim());
+    this->setNumSubs(num_subs);
+    this->setView(c.getSubN_begin(first), num_subs * c.getSubLength());
+}
@@ -5,6 +5,9 @@
  *
  * @brief  The implementation of the surface class.
  */
+template <typename ScalarContainer, typename VectorContainer>
+size_t Surface<ScalarContainer, VectorContainer>::version_counter_(0);
+
 template <typename ScalarContainer, typename VectorContainer>
 Surface<ScalarContainer, VectorContainer>::Surface(
     int sh_order, const OperatorsMats<Arr_t> &mats,
@@ -23,8 +26,12 @@ Surface<ScalarContainer, VectorContainer>::Surface(
     containers_are_stale_(true),
     first_forms_are_stale_(true),
     second_forms_are_stale_(true),
-    checked_out_work_sca_(0),
-    checked_out_work_vec_(0)
+    position_version_(++version_counter_),
+    resampled_src_version_(0),
+    resampled_version_(0),
+    shc_x_version_(0),
+    sca_work_("Surface"),
+    vec_work_("Surface")
 {
     if (sh_order_ == mats.p_ )
 	sht_resample_ = new SHMats_t(mats.p_up_, mats.mats_p_up_);
@@ -47,10 +54,6 @@ Surface<ScalarContainer, VectorContainer>::Surface(
 template <typename ScalarContainer, typename VectorContainer>
 Surface<ScalarContainer, VectorContainer>::~Surface()
 {
-    ASSERT(!checked_out_work_sca_,"All scalar are not returned to work pool");
-    ASSERT(!checked_out_work_vec_,"All vectors are not returned to work pool");
-
-    purgeTheWorkSpace();
     delete sht_resample_;
 }
 
@@ -58,24 +61,52 @@ template <typename ScalarContainer, typename VectorContainer>
 void Surface<ScalarContainer, VectorContainer>::setPosition(const Vec_t& x_in)
 {
     PROFILESTART();
-    containers_are_stale_ = true;
-    first_forms_are_stale_ = true;
-    second_forms_are_stale_ = true;
+    positionChanged();
 
     x_.replicate(x_in);
     axpy(static_cast<value_type>(1), x_in, x_);
     PROFILEEND("",0);
 }
 
+template <typename ScalarContainer, typename VectorContainer>
+void Surface<ScalarContainer, VectorContainer>::swapPosition(Vec_t& x)
+{
+    ASSERT(x.getShOrder() == sh_order_, "The position should be of order "<<sh_order_);
+    positionChanged();
+    x_.swap(x);
+}
+
 template <typename ScalarContainer, typename VectorContainer>
 VectorContainer&
 Surface<ScalarContainer,VectorContainer>::getPositionModifiable()
+{
+    positionChanged();
+    return(x_);
+}
+
+template <typename ScalarContainer, typename VectorContainer>
+const VectorContainer&
+Surface<ScalarContainer,VectorContainer>::getPositionCoeffs() const
+{
+    if (shc_x_version_ != position_version_){
+        COUTDEBUG("Computing the position coefficients");
+        std::auto_ptr<Vec_t> wrk(checkoutVec());
+        shc_x_.replicate(x_);
+        sht_.forward(x_, *wrk, shc_x_);
+        recycle(wrk);
+        shc_x_version_ = position_version_;
+    }
+
+    return(shc_x_);
+}
+
+template <typename ScalarContainer, typename VectorContainer>
+void Surface<ScalarContainer,VectorContainer>::positionChanged()
 {
     containers_are_stale_ = true;
     first_forms_are_stale_ = true;
     second_forms_are_stale_ = true;
-
-    return(x_);
+    position_version_ = ++version_counter_;
 }
 
 template <typename ScalarContainer, typename VectorContainer>
@@ -166,37 +197,38 @@ mapToTangentSpace(Vec_t &vec_fld, bool upsample) const
         std::auto_ptr<Vec_t> wrk(checkoutVec());
         std::auto_ptr<Vec_t> shc(checkoutVec());
         std::auto_ptr<Vec_t> fld(checkoutVec());
+        std::auto_ptr<Vec_t> nrm(checkoutVec());
 
-        //up-sampling
+        //up-sampling (the normal is upsampled to a work container,
+        //normal_ is not changed)
         int usf(sht_resample_->getShOrder());
 
         scp->resize(scp->getNumSubs(), usf);
         wrk->resize(wrk->getNumSubs(), usf);
         shc->resize(shc->getNumSubs(), usf);
         fld->resize(fld->getNumSubs(), usf);
-        normal_.resize(normal_.getNumSubs(), usf);
+        nrm->resize(nrm->getNumSubs(), usf);
 
         Resample(vec_fld, sht_, *sht_resample_, *shc, *wrk, *fld);
-        Resample(normal_, sht_, *sht_resample_, *shc, *wrk, normal_);
+        Resample(normal_, sht_, *sht_resample_, *shc, *wrk, *nrm);
 
         //re-normalizing
-        GeometricDot(normal_, normal_, *scp);
+        GeometricDot(*nrm, *nrm, *scp);
         Sqrt(*scp, *scp);
-        uyInv(normal_, *scp, normal_);
+        uyInv(*nrm, *scp, *nrm);
 
         //mapping to tangent
-        GeometricDot(*fld, normal_, *scp);
+        GeometricDot(*fld, *nrm, *scp);
         axpy(static_cast<value_type>(-1.0), *scp, *scp);
-        xvpw(*scp, normal_, *fld, *fld);
+        xvpw(*scp, *nrm, *fld, *fld);
 
         //down-sampling
-        Resample(*fld   , *sht_resample_, sht_, *shc, *wrk, vec_fld);
-        Resample(normal_, *sht_resample_, sht_, *shc, *wrk, normal_);
-        normal_.resize(normal_.getNumSubs(), sht_.getShOrder());
+        Resample(*fld, *sht_resample_, sht_, *shc, *wrk, vec_fld);
 
         recycle(wrk);
         recycle(shc);
         recycle(fld);
+        recycle(nrm);
     } else {
         scp->replicate(vec_fld);
         GeometricDot(vec_fld, normal_, *scp);
@@ -217,45 +249,25 @@ updateFirstForms() const
     if(containers_are_stale_)
         checkContainers();
 
+    const Vec_t &shc(getPositionCoeffs());
     std::auto_ptr<Vec_t> wrk(checkoutVec());
-    std::auto_ptr<Vec_t> shc(checkoutVec());
-    std::auto_ptr<Vec_t> dif(checkoutVec());
-    std::auto_ptr<Sca_t> scp(checkoutSca());
-
-    // Spherical harmonic coefficient (dif=du,normal=dv)
-    sht_.FirstDerivatives(x_, *wrk, *shc, *dif, normal_);
-
-    // First fundamental coefficients
-    GeometricDot(*dif, *dif, E);
-    GeometricDot(*dif, normal_, F);
-    GeometricDot(normal_, normal_, G);
+    std::auto_ptr<Vec_t> du(checkoutVec());
+    std::auto_ptr<Vec_t> dv(checkoutVec());
 
-    // Area element
-    xy(E, G, w_);
-    xy(F, F, *scp);
-    axpy(static_cast<value_type>(-1), *scp, w_, w_);
+    sht_.backward_du(shc, *wrk, *du);
+    sht_.backward_dv(shc, *wrk, *dv);
 
-    // Dividing EFG by W^2
-    xyInv(E, w_, E);
-    xyInv(F, w_, F);
-    xyInv(G, w_, G);
-    Sqrt(w_, w_);
-
-    //Div and Grad coefficients
-    xv(F, normal_, cu_);
-    axpy(static_cast<value_type>(-1), cu_, cu_);
-    xvpw(G, *dif, cu_, cu_);
-
-    xv(F, *dif, cv_);
-    axpy(static_cast<value_type>(-1), cv_, cv_);
-    xvpw(E, normal_, cv_, cv_);
-    GeometricCross(*dif, normal_, normal_);
-    uyInv(normal_, w_, normal_);
+    // First fundamental coefficients (divided by W^2), area element,
+    // normal, and div and grad coefficients in one pass
+    x_.getDevice().FundamentalForms(du->begin(), dv->begin(),
+        (value_type*) NULL, (value_type*) NULL, (value_type*) NULL,
+        x_.getStride(), x_.getNumSubs(), E.begin(), F.begin(),
+        G.begin(), w_.begin(), normal_.begin(), cu_.begin(),
+        cv_.begin(), (value_type*) NULL, (value_type*) NULL);
 
     recycle(wrk);
-    recycle(shc);
-    recycle(dif);
-    recycle(scp);
+    recycle(du);
+    recycle(dv);
 
     first_forms_are_stale_ = false;
     PROFILEEND("",0);
@@ -267,54 +279,39 @@ updateAll() const
 {
     PROFILESTART();
     COUTDEBUG("Updating all fundamental forms");
-    if(first_forms_are_stale_)
-        updateFirstForms();
+    if(containers_are_stale_)
+        checkContainers();
 
     std::auto_ptr<Vec_t> wrk(checkoutVec());
     std::auto_ptr<Vec_t> shc(checkoutVec());
-    std::auto_ptr<Vec_t> dif(checkoutVec());
-
-    sht_.forward(x_, *wrk, *shc);
-
-    sht_.backward_duv(*shc, *wrk, *dif);
-    GeometricDot(*dif, normal_, h_);
-
-    xy(h_, h_, k_);
-    axpy(static_cast<value_type>(-1), k_, k_);
-
-    xy(F, h_, h_);
-    axpy(static_cast<value_type>(-1), h_, h_);
-
-    std::auto_ptr<Sca_t> L(checkoutSca());
-    sht_.backward_d2u(*shc, *wrk, *dif);
-    GeometricDot(*dif, normal_, *L);
-
-    std::auto_ptr<Sca_t> N(checkoutSca());
-    xy(G, *L, *N);
-    axpy(static_cast<value_type>(.5), *N, h_, h_);
-
-
-    sht_.backward_d2v(*shc, *wrk, *dif);
-    GeometricDot(*dif, normal_, *N);
-
-    xy(*L, *N, *L);
-    axpy(static_cast<value_type>(1), *L, k_, k_);
-
-    xyInv(k_,w_,k_);
-    xyInv(k_,w_,k_);
-
-    xy(E, *N, *N);
-    axpy(static_cast<value_type>(.5), *N, h_, h_);
+    std::auto_ptr<Vec_t> du(checkoutVec());
+    std::auto_ptr<Vec_t> dv(checkoutVec());
+    std::auto_ptr<Vec_t> d2u(checkoutVec());
+    std::auto_ptr<Vec_t> d2v(checkoutVec());
+    std::auto_ptr<Vec_t> duv(checkoutVec());
+
+    // The first forms are recomputed along with the second ones,
+    // their derivatives share the Legendre transforms with duv and d2v
+    sht_.AllDerivatives(getPositionCoeffs(), *wrk, *du, *dv, *d2u, *d2v, *duv);
+
+    x_.getDevice().FundamentalForms(du->begin(), dv->begin(),
+        duv->begin(), d2u->begin(), d2v->begin(),
+        x_.getStride(), x_.getNumSubs(), E.begin(), F.begin(),
+        G.begin(), w_.begin(), normal_.begin(), cu_.begin(),
+        cv_.begin(), h_.begin(), k_.begin());
+    first_forms_are_stale_ = false;
 
-    recycle(L);
-    recycle(N);
+    recycle(du);
+    recycle(dv);
+    recycle(d2u);
+    recycle(d2v);
+    recycle(duv);
 
     sht_.lowPassFilter(k_, *wrk, *shc, k_);
     sht_.lowPassFilter(h_, *wrk, *shc, h_);
 
     recycle(wrk);
     recycle(shc);
-    recycle(dif);
 
     second_forms_are_stale_ = false;
     PROFILEEND("",0);
@@ -427,14 +424,97 @@ getCenters(Vec_t &centers) const
     integrator_(*vcw, w_, centers);
     recycle(vcw);
 
-    scw = checkoutSca();
-    scw->replicate(centers);
+    scw = sca_work_.checkout(centers);
     volume(*scw);
     uyInv(centers, *scw, centers);
     recycle(scw);
     PROFILEEND("",0);
 }
 
+template< typename ScalarContainer, typename VectorContainer>
+int Surface<ScalarContainer, VectorContainer>::
+getNumMoments(int degree, bool with_field)
+{
+    return(2 + (degree > 0) * 3 + (degree > 1) * 6 + with_field * 2);
+}
+
+template< typename ScalarContainer, typename VectorContainer>
+void Surface<ScalarContainer, VectorContainer>::
+moments(Arr_t &moms, int degree, const Sca_t *f) const
+{
+    PROFILESTART();
+    COUTDEBUG("Computing moments of degree "<<degree);
+    if(first_forms_are_stale_)
+        updateFirstForms();
+
+    ASSERT(f==NULL || f->getShOrder()==x_.getShOrder(), "The field should have the same order as the surface");
+    size_t ns(x_.getNumSubs());
+    moms.resize(ns * getNumMoments(degree, f!=NULL));
+
+    x_.getDevice().SurfaceMoments(x_.begin(), normal_.begin(), w_.begin(),
+        integrator_.getQuadWeights(x_.getShOrder())->begin(),
+        (f==NULL) ? (value_type*) NULL : f->begin(), x_.getStride(),
+        ns, degree, moms.begin());
+    PROFILEEND("",0);
+}
+
+template< typename ScalarContainer, typename VectorContainer>
+void Surface<ScalarContainer, VectorContainer>::
+stresslet(const Vec_t &f, Arr_t &strs) const
+{
+    PROFILESTART();
+    COUTDEBUG("Computing stresslets");
+    if(first_forms_are_stale_)
+        updateFirstForms();
+
+    ASSERT(f.getShOrder()==x_.getShOrder(), "The traction should have the same order as the surface");
+    ASSERT(f.getNumSubs()==x_.getNumSubs(), "The traction should have the same number of surfaces");
+    size_t ns(x_.getNumSubs());
+    strs.resize(ns * 9);
+
+    x_.getDevice().SurfaceStresslet(x_.begin(), normal_.begin(), w_.begin(),
+        integrator_.getQuadWeights(x_.getShOrder())->begin(),
+        f.begin(), x_.getStride(), ns, strs.begin());
+    PROFILEEND("",0);
+}
+
+template< typename ScalarContainer, typename VectorContainer>
+void Surface<ScalarContainer, VectorContainer>::
+areaVolumeStats(AreaVolumeStats<value_type> &stats, Arr_t &moms,
+    const Arr_t *moms0) const
+{
+    PROFILESTART();
+    moments(moms);
+    if (moms0 == NULL) moms0 = &moms;
+    ASSERT(moms0->size()==moms.size(), "The reference should have the same number of surfaces");
+
+    size_t n(moms.size());
+    std::vector<value_type> m(2*n);
+    if (n){
+        moms.getDevice().Memcpy(&m[0], moms.begin(), n*sizeof(value_type),
+            device_type::MemcpyDeviceToHost);
+        moms.getDevice().Memcpy(&m[n], moms0->begin(), n*sizeof(value_type),
+            device_type::MemcpyDeviceToHost);
+    }
+
+    value_type loc[4] = {0, 0, 0, 0};
+    for (size_t ii=0; ii<n; ii+=2){
+        loc[0] = std::max(loc[0], std::abs(m[n+ii  ]));
+        loc[1] = std::max(loc[1], std::abs(m[n+ii+1]));
+        loc[2] = std::max(loc[2], std::abs(m[ii  ]-m[n+ii  ]));
+        loc[3] = std::max(loc[3], std::abs(m[ii+1]-m[n+ii+1]));
+    }
+
+    value_type glb[4];
+    MPI_Allreduce(loc, glb, 4, (sizeof(value_type)==sizeof(double)) ? MPI_DOUBLE : MPI_FLOAT,
+        MPI_MAX, VES3D_COMM_WORLD);
+    stats.area     = glb[0];
+    stats.vol      = glb[1];
+    stats.area_err = glb[2];
+    stats.vol_err  = glb[3];
+    PROFILEEND("",0);
+}
+
 template <typename ScalarContainer, typename VectorContainer>
 void Surface<ScalarContainer, VectorContainer>::
 checkContainers() const
@@ -457,72 +537,28 @@ template <typename ScalarContainer, typename VectorContainer>
 std::auto_ptr<ScalarContainer> Surface<ScalarContainer, VectorContainer>::
 checkoutSca() const
 {
-    std::auto_ptr<Sca_t> scp;
-
-   if(scalar_work_q_.empty())
-        scp = static_cast<std::auto_ptr<Sca_t> >(new ScalarContainer);
-    else
-    {
-        scp = static_cast<std::auto_ptr<Sca_t> >(scalar_work_q_.front());
-        scalar_work_q_.pop();
-    }
-
-    scp->replicate(x_);
-    ++checked_out_work_sca_;
-    return(scp);
+    return(sca_work_.checkout(x_));
 }
 
 template <typename ScalarContainer, typename VectorContainer>
 void Surface<ScalarContainer, VectorContainer>::
 recycle(std::auto_ptr<Sca_t> scp) const
 {
-    scalar_work_q_.push(scp.release());
-    --checked_out_work_sca_;
+    sca_work_.recycle(scp);
 }
 
 template <typename ScalarContainer, typename VectorContainer>
 std::auto_ptr<VectorContainer> Surface<ScalarContainer, VectorContainer>::
 checkoutVec() const
 {
-    std::auto_ptr<Vec_t> vcp;
-
-    if(vector_work_q_.empty())
-        vcp = static_cast<std::auto_ptr<Vec_t> >(new VectorContainer);
-    else
-    {
-        vcp = static_cast<std::auto_ptr<Vec_t> >(vector_work_q_.front());
-        vector_work_q_.pop();
-    }
-
-    vcp->replicate(x_);
-    ++checked_out_work_vec_;
-
-    return(vcp);
+    return(vec_work_.checkout(x_));
 }
 
 template <typename ScalarContainer, typename VectorContainer>
 void Surface<ScalarContainer, VectorContainer>::recycle(
     std::auto_ptr<Vec_t> vcp) const
 {
-    vector_work_q_.push(vcp.release());
-    --checked_out_work_vec_;
-}
-
-template <typename ScalarContainer, typename VectorContainer>
-void Surface<ScalarContainer, VectorContainer>::
-purgeTheWorkSpace() const
-{
-    while ( !scalar_work_q_.empty() )
-    {
-        delete scalar_work_q_.front();
-        scalar_work_q_.pop();
-    }
-
-    while ( !vector_work_q_.empty() )
-    {
-        delete vector_work_q_.front();
-        vector_work_q_.pop();
-    }
+    vec_work_.recycle(vcp);
 }
 
 template <typename ScalarContainer, typename VectorContainer>
@@ -570,35 +606,50 @@ linearizedMeanCurv(const Vec_t &x_new, Sca_t &h_lin) const
 
 template <typename S, typename V>
 Error_t Surface<S, V>::resample(int new_sh_freq, Surface **new_surf /* delete when you're done */ ) const{
-    /* current implementation doesn't permit resampling to arbitrary freq */
-    if (new_sh_freq != sht_resample_->getShOrder())
+    /* without a target, the order should have precomputed matrices */
+    if (*new_surf == NULL && new_sh_freq != mats_->p_ && new_sh_freq != mats_->p_up_)
 	return ErrorEvent::NotImplementedError;
 
     PROFILESTART();
 
-    // resample x to the target freq
-    std::auto_ptr<Vec_t> wrk(checkoutVec());
-    std::auto_ptr<Vec_t> shc(checkoutVec());
-    std::auto_ptr<Vec_t> xre(checkoutVec());
-    wrk->resize(wrk->getNumSubs(), new_sh_freq);
-    shc->resize(shc->getNumSubs(), new_sh_freq);
-    xre->resize(xre->getNumSubs(), new_sh_freq);
-    Resample(x_, sht_, *sht_resample_, *shc, *wrk, *xre);
+    if (*new_surf != NULL &&
+        (*new_surf)->resampled_src_version_ == position_version_ &&
+        (*new_surf)->resampled_version_ == (*new_surf)->position_version_){
+        COUTDEBUG("Position is not changed, reusing the resampled surface");
+        ASSERT((*new_surf)->getShOrder()==new_sh_freq, "Container should have the same order as the argument");
+        PROFILEEND("",0);
+        return ErrorEvent::Success;
+    }
 
     // construct new object
     if (*new_surf == NULL){
         COUTDEBUG("Constructing new surface container");
-        *new_surf = new Surface(new_sh_freq, *mats_, xre.get(),
+        *new_surf = new Surface(new_sh_freq, *mats_, NULL,
             diff_filter_freq_*new_sh_freq/sh_order_ /* keep it relative */,
             reparam_filter_freq_                    /* not relative     */ );
+        // its position is swapped into the work space below, it has
+        // the size of the work containers so that later checkouts
+        // do not grow it
+        (*new_surf)->x_.resize(x_.getNumSubs(), new_sh_freq);
     } else {
         COUTDEBUG("Reusing the surface container");
         ASSERT((*new_surf)->getShOrder()==new_sh_freq, "Container should have the same order as the argument");
-        (*new_surf)->setPosition(*xre);
     }
+    Surface *sq(*new_surf);
+
+    // resample the coefficients of x to the target freq, they are
+    // directly written to the target's coefficient cache
+    std::auto_ptr<Vec_t> wrk(vec_work_.checkout(x_.getNumSubs(), new_sh_freq));
+    std::auto_ptr<Vec_t> xre(vec_work_.checkout(x_.getNumSubs(), new_sh_freq));
+    sq->shc_x_.resize(x_.getNumSubs(), new_sh_freq);
+    ResampleShc(getPositionCoeffs(), sq->sht_, sq->shc_x_, *wrk, *xre);
+
+    sq->swapPosition(*xre);
+    sq->shc_x_version_          = sq->position_version_;
+    sq->resampled_src_version_  = position_version_;
+    sq->resampled_version_      = sq->position_version_;
 
     recycle(wrk);
-    recycle(shc);
     recycle(xre);
     PROFILEEND("",0);
 
@@ -608,7 +659,19 @@ Error_t Surface<S, V>::resample(int new_sh_freq, Surface **new_surf /* delete wh
 template <typename S, typename V>
 Error_t Surface<S, V>::pack(std::ostream &os, Streamable::Format format) const{
 
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        CHK(pack_header(os, "SURFACE", sizeof(value_type)));
+        CHK(pack_string(os, Streamable::name_));
+        CHK(pack_value(os, static_cast<int32_t>(x_.getShOrder())));
+        CHK(pack_value(os, static_cast<int32_t>(sht_.getShOrder())));
+        CHK(pack_value(os, static_cast<int32_t>(sht_rep_filter_.getShOrder())));
+        CHK(pack_value(os, static_cast<value_type>(sht_rep_filter_.getShFilterExponent())));
+        CHK(pack_value(os, static_cast<int32_t>(sht_resample_->getShOrder())));
+        CHK(pack_value(os, static_cast<int32_t>(diff_filter_freq_)));
+        CHK(pack_value(os, static_cast<int32_t>(reparam_filter_freq_)));
+        CHK(pack_value(os, static_cast<int32_t>(reparam_type_)));
+        return x_.pack(os,format);
+    }
 
     os<<"SURFACE\n";
     os<<"version: "<<VERSION<<"\n";
@@ -629,7 +692,37 @@ Error_t Surface<S, V>::pack(std::ostream &os, Streamable::Format format) const{
 template <typename S, typename V>
 Error_t Surface<S, V>::unpack(std::istream &is, Streamable::Format format){
 
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        int version(0);
+        int32_t order, sht_order, rep_order, resample_order, filter_freq, rep_freq, rep_type;
+        value_type rep_exponent;
+        Error_t ierr(unpack_header(is, "SURFACE", sizeof(value_type), version));
+        if (ierr) return ierr;
+        CHK(unpack_string(is, Streamable::name_));
+        CHK(unpack_value(is, order));
+        CHK(unpack_value(is, sht_order));
+        CHK(unpack_value(is, rep_order));
+        CHK(unpack_value(is, rep_exponent));
+        CHK(unpack_value(is, resample_order));
+        CHK(unpack_value(is, filter_freq));
+        CHK(unpack_value(is, rep_freq));
+        CHK(unpack_value(is, rep_type));
+
+        ASSERT(sht_order==sht_.getShOrder(), "incompatible data (different sh_order), cannot unpack");
+        ASSERT(rep_order==sht_rep_filter_.getShOrder(), "incompatible data (different sh_order), cannot unpack");
+        ASSERT(rep_exponent==sht_rep_filter_.getShFilterExponent(), "incompatible data (different sh_filter_exponent), cannot unpack");
+        ASSERT(resample_order==sht_resample_->getShOrder(), "incompatible data (different sh_order), cannot unpack");
+        ASSERT(filter_freq==diff_filter_freq_, "incompatible data (different filter_freq), cannot unpack");
+        ASSERT(rep_freq==reparam_filter_freq_, "incompatible data (different rep_filter_freq), cannot unpack");
+        if(rep_type!=reparam_type_) WARN("Reparametrization type switched from "
+            <<static_cast<ReparamType>(rep_type)<<" to "<<reparam_type_);
+
+        ierr = getPositionModifiable().unpack(is, format);
+        if (ierr) return ierr;
+        INFO("Unpacked "<<Streamable::name_<<" data from version "<<version<<" (current version "<<VERSION<<")");
+        return ErrorEvent::Success;
+    }
+
     std::string s,key;
     int ii,version(0);
     value_type v;
@@ -678,7 +771,7 @@ Error_t Surface<S, V>::unpack(std::istream &is, Streamable::Format format){
     ReparamType rt(EnumifyReparam(s.c_str()));
     if(rt!=reparam_type_) WARN("Reparametrization type switched from "<<rt<<" to "<<reparam_type_);
 
-    x_.unpack(is, format);
+    getPositionModifiable().unpack(is, format);
     is>>s;
     ASSERT(s=="/SURFACE", "Bad input string (missing footer).");
 
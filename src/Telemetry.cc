@@ -0,0 +1,212 @@
+/**
+ * @file   Telemetry.cc
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  The implementation of the Telemetry class.
+ */
+
+#include "Telemetry.h"
+#include "Logger.h"
+#include "AsyncWriter.h"
+#include "CachingAllocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace {
+    // the reduced counters of a process: the step time, the phase
+    // times, the live bytes and the system allocations
+    const int STEP_TIME = 0;
+    const int BYTES_LIVE = 1 + Telemetry::NUM_PHASES;
+    const int SYS_ALLOCS = 2 + Telemetry::NUM_PHASES;
+    const int NUM_COUNTERS = 3 + Telemetry::NUM_PHASES;
+
+    bool enabled(false);
+    std::string fname;
+    int rank(0), nproc(1);
+    size_t step(0);
+    double t_step(0), tic_step(0);
+    size_t sys_allocs0(0);
+    double phase_time[Telemetry::NUM_PHASES];
+    size_t iterations(0);
+    std::vector<double> residuals;
+    std::string buffer;
+
+#ifdef HAS_MPI
+    MPI_Op minmaxsum_op;
+
+    // the buffer holds the counters three times, reduced by min,
+    // max, and sum respectively
+    void MinMaxSum(void *in, void *inout, int *len, MPI_Datatype *)
+    {
+        const double *a(static_cast<const double*>(in));
+        double *b(static_cast<double*>(inout));
+        int n(*len / 3);
+        for (int ii=0; ii<n; ++ii){
+            b[ii]       = std::min(a[ii], b[ii]);
+            b[n + ii]   = std::max(a[n + ii], b[n + ii]);
+            b[2*n + ii] += a[2*n + ii];
+        }
+    }
+#endif
+
+    // JSON has no representation of inf and nan
+    void WriteNumber(std::ostream &os, double v)
+    {
+        if (std::isfinite(v)) os<<v;
+        else os<<"null";
+    }
+
+    void WriteStats(std::ostream &os, const char *name, const double *glb, int idx)
+    {
+        os<<", \""<<name<<"\": {\"min\": ";
+        WriteNumber(os, glb[idx]);
+        os<<", \"max\": ";
+        WriteNumber(os, glb[NUM_COUNTERS + idx]);
+        os<<", \"avg\": ";
+        WriteNumber(os, glb[2 * NUM_COUNTERS + idx] / nproc);
+        os<<"}";
+    }
+}
+
+Error_t Telemetry::Open(const std::string &file_name)
+{
+    Close();
+    if (file_name.empty()) return ErrorEvent::Success;
+
+#ifdef HAS_MPI
+    MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+    MPI_Comm_size(VES3D_COMM_WORLD, &nproc);
+    MPI_Op_create(&MinMaxSum, 1, &minmaxsum_op);
+#endif
+
+    // the file is started empty, the records are appended
+    fname = file_name;
+    Error_t err(ErrorEvent::Success);
+    if (rank == 0){
+        buffer.clear();
+        err = AsyncWriter::Submit(fname, buffer);
+    }
+
+    enabled = true;
+    step = 0;
+    residuals.reserve(MAX_RESIDUALS);
+    INFO("Writing the per-step telemetry to "<<fname);
+    return err;
+}
+
+Error_t Telemetry::Close()
+{
+    if (!enabled) return ErrorEvent::Success;
+    enabled = false;
+#ifdef HAS_MPI
+    MPI_Op_free(&minmaxsum_op);
+#endif
+    return (rank == 0) ? AsyncWriter::Flush() : ErrorEvent::Success;
+}
+
+bool Telemetry::Enabled()
+{
+    return enabled;
+}
+
+void Telemetry::BeginStep(double t)
+{
+    if (!enabled) return;
+    t_step  = t;
+    tic_step = GETSECONDS();
+    sys_allocs0 = memory::CachingAllocator::GetStats().sys_allocs;
+    for (int ii=0; ii<NUM_PHASES; ++ii) phase_time[ii] = 0;
+    iterations = 0;
+    residuals.clear();
+}
+
+Error_t Telemetry::EndStep(bool accepted, double dt, double advance,
+    double dt_next)
+{
+    if (!enabled) return ErrorEvent::Success;
+
+    memory::AllocStats st(memory::CachingAllocator::GetStats());
+    double loc[3 * NUM_COUNTERS], glb[3 * NUM_COUNTERS];
+    loc[STEP_TIME]  = GETSECONDS() - tic_step;
+    loc[BYTES_LIVE] = st.live;
+    loc[SYS_ALLOCS] = st.sys_allocs - sys_allocs0;
+    for (int ii=0; ii<NUM_PHASES; ++ii) loc[1 + ii] = phase_time[ii];
+    for (int ii=1; ii<3; ++ii)
+        std::copy(loc, loc + NUM_COUNTERS, loc + ii * NUM_COUNTERS);
+
+#ifdef HAS_MPI
+    MPI_Reduce(loc, glb, 3 * NUM_COUNTERS, MPI_DOUBLE, minmaxsum_op, 0, VES3D_COMM_WORLD);
+#else
+    std::copy(loc, loc + 3 * NUM_COUNTERS, glb);
+#endif
+
+    Error_t err(ErrorEvent::Success);
+    if (rank == 0){
+        std::ostringstream os;
+        os<<std::setprecision(6);
+        os<<"{\"step\": "<<step<<", \"t\": ";
+        WriteNumber(os, t_step);
+        os<<", \"dt\": ";
+        WriteNumber(os, dt);
+        os<<", \"advance\": ";
+        WriteNumber(os, advance);
+        os<<", \"dt_next\": ";
+        WriteNumber(os, dt_next);
+        os<<", \"accepted\": "<<(accepted ? "true" : "false")
+          <<", \"iterations\": "<<iterations<<", \"residuals\": [";
+        for (size_t ii=0; ii<residuals.size(); ++ii){
+            if (ii) os<<", ";
+            WriteNumber(os, residuals[ii]);
+        }
+        os<<"]";
+
+        WriteStats(os, "step_time", glb, STEP_TIME);
+        for (int ii=0; ii<NUM_PHASES; ++ii)
+            WriteStats(os, PhaseName(static_cast<Phase>(ii)), glb, 1 + ii);
+        WriteStats(os, "bytes_live", glb, BYTES_LIVE);
+        WriteStats(os, "sys_allocs", glb, SYS_ALLOCS);
+        os<<"}\n";
+
+        buffer = os.str();
+        err = AsyncWriter::Submit(fname, buffer, true);
+    }
+    ++step;
+    return err;
+}
+
+void Telemetry::AddTime(Phase phase, double seconds)
+{
+    if (enabled && !omp_in_parallel()) phase_time[phase] += seconds;
+}
+
+void Telemetry::AddIterations(size_t iter)
+{
+    if (enabled) iterations += iter;
+}
+
+void Telemetry::AddResidual(double res)
+{
+    if (enabled && residuals.size() < MAX_RESIDUALS) residuals.push_back(res);
+}
+
+const char* Telemetry::PhaseName(Phase phase)
+{
+    static const char* names[NUM_PHASES] = {"fmm", "near", "self", "sht",
+                                            "reparam", "area_volume",
+                                            "repartition", "io"};
+    return names[phase];
+}
+
+Telemetry::Timer::Timer(Phase phase) :
+    phase_(phase),
+    tic_(enabled ? GETSECONDS() : -1)
+{}
+
+Telemetry::Timer::~Timer()
+{
+    if (tic_ >= 0) AddTime(phase_, GETSECONDS() - tic_);
+}
@@ -0,0 +1,217 @@
+template<typename Container>
+Trajectory<Container>::Trajectory(int sh_order, int freq, bool quantize) :
+    Streamable("trajectory"),
+    sh_order_(sh_order),
+    freq_((freq <= 0 || freq > sh_order) ? sh_order : freq),
+    quantize_(quantize)
+{}
+
+template<typename Container>
+Trajectory<Container>::~Trajectory()
+{}
+
+template<typename Container>
+size_t Trajectory<Container>::NumCoeffs() const
+{
+    return freq_ * (freq_ + 2);
+}
+
+template<typename Container>
+template<typename SHT>
+Error_t Trajectory<Container>::WriteFrame(std::ostream &os, const SHT &sht,
+    value_type t, size_t first_id, const Container &x)
+{
+    ASSERT(sht.getShOrder() == sh_order_, "The transform should be of the trajectory order");
+    ASSERT(x.getPointOrder() == AxisMajor, "The positions should be AxisMajor");
+
+    shc_.replicate(x);
+    wrk_.replicate(x);
+    sht.forward(x, wrk_, shc_);
+    return WriteCoeffs(os, t, first_id, shc_);
+}
+
+template<typename Container>
+Error_t Trajectory<Container>::WriteCoeffs(std::ostream &os, value_type t,
+    size_t first_id, const Container &shc) const
+{
+    PROFILESTART();
+    ASSERT(shc.getShOrder() == sh_order_, "The coefficients should be of the trajectory order");
+
+    int p(sh_order_), q(freq_);
+    size_t nv(shc.getNumSubs());
+    size_t dim(shc.getTheDim());
+    size_t n_funs(nv * dim);
+    size_t nc(NumCoeffs());
+
+    host_.resize(shc.size());
+    shc.getDevice().Memcpy(&host_[0], shc.begin(), shc.size() * sizeof(value_type),
+        device_type::MemcpyDeviceToHost);
+    fbuf_.resize(nc);
+    qbuf_.resize(nc);
+
+    Error_t err(pack_value(os, static_cast<double>(t)));
+    if (!err) err = pack_value(os, static_cast<uint64_t>(nv));
+
+    for (size_t f(0); f<n_funs && !err; ++f){
+        if (f % dim == 0)
+            err = pack_value(os, static_cast<uint64_t>(first_id + f / dim));
+
+        // the coefficients of function f up to freq (see ResampleCoeffs)
+        const value_type *row(&host_[0]);
+        size_t idx(0);
+        for (int ii(0); ii<2*q; ++ii){
+            int len_p(p + 1 - (ii + 1) / 2);
+            int len_q(q + 1 - (ii + 1) / 2);
+            for (int jj(0); jj<len_q; ++jj)
+                fbuf_[idx++] = row[f * len_p + jj];
+            row += n_funs * len_p;
+        }
+
+        if (!quantize_){
+            if (!err) err = pack_array(os, Streamable::BIN, &fbuf_[0], nc);
+            continue;
+        }
+
+        // the mean is kept, the rest are scaled by their maximum
+        float amax(0);
+        for (size_t ii(1); ii<nc; ++ii)
+            amax = std::max(amax, std::fabs(fbuf_[ii]));
+        float scale(amax / 32767);
+
+        for (size_t ii(1); ii<nc; ++ii)
+            qbuf_[ii-1] = (scale > 0) ?
+                static_cast<int16_t>(std::floor(fbuf_[ii] / scale + 0.5)) : 0;
+
+        if (!err) err = pack_value(os, fbuf_[0]);
+        if (!err) err = pack_value(os, scale);
+        if (!err) err = pack_array(os, Streamable::BIN, &qbuf_[0], nc - 1);
+    }
+
+    PROFILEEND("",0);
+    return err;
+}
+
+template<typename Container>
+template<typename SHT>
+Error_t Trajectory<Container>::ReadFrame(std::istream &is, const SHT &sht,
+    value_type &t, std::vector<size_t> &ids, Container &x)
+{
+    Error_t err(ReadCoeffs(is, t, ids, shcq_));
+    if (err) return err;
+
+    int p(sht.getShOrder());
+    shc_.resize(ids.size(), p);
+    wrk_.resize(ids.size(), p);
+    x.resize(ids.size(), p);
+    ResampleShc(shcq_, sht, shc_, wrk_, x);
+
+    return ErrorEvent::Success;
+}
+
+template<typename Container>
+Error_t Trajectory<Container>::ReadCoeffs(std::istream &is, value_type &t,
+    std::vector<size_t> &ids, Container &shc) const
+{
+    PROFILESTART();
+    double t64(0);
+    uint64_t nv(0);
+    Error_t err(unpack_value(is, t64));
+    if (!err) err = unpack_value(is, nv);
+    if (err){
+        CERR("Failed to read the trajectory frame");
+        return err;
+    }
+
+    int q(freq_);
+    size_t nc(NumCoeffs());
+    shc.resize(nv, q);
+    size_t dim(shc.getTheDim());
+    size_t n_funs(nv * dim);
+
+    host_.assign(shc.size(), 0);
+    fbuf_.resize(nc);
+    qbuf_.resize(nc);
+    ids.resize(nv);
+    t = t64;
+
+    for (size_t f(0); f<n_funs && !err; ++f){
+        if (f % dim == 0){
+            uint64_t id(0);
+            err = unpack_value(is, id);
+            ids[f / dim] = id;
+        }
+
+        size_t n(nc);
+        if (!quantize_){
+            if (!err) err = unpack_array(is, Streamable::BIN, &fbuf_[0], n);
+        } else if (nc > 0){
+            float scale(0);
+            --n;
+            if (!err) err = unpack_value(is, fbuf_[0]);
+            if (!err) err = unpack_value(is, scale);
+            if (!err) err = unpack_array(is, Streamable::BIN, &qbuf_[0], n);
+            for (size_t ii(1); ii<nc; ++ii)
+                fbuf_[ii] = scale * qbuf_[ii-1];
+        }
+
+        // scattered as the coefficients of order freq
+        value_type *row(&host_[0]);
+        size_t idx(0);
+        for (int ii(0); ii<2*q; ++ii){
+            int len_q(q + 1 - (ii + 1) / 2);
+            for (int jj(0); jj<len_q; ++jj)
+                row[f * len_q + jj] = fbuf_[idx++];
+            row += n_funs * len_q;
+        }
+    }
+
+    if (err){
+        CERR("The trajectory frame at t="<<t<<" is truncated");
+        return err;
+    }
+
+    shc.getDevice().Memcpy(shc.begin(), &host_[0], shc.size() * sizeof(value_type),
+        device_type::MemcpyHostToDevice);
+
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
+template<typename Container>
+bool Trajectory<Container>::AtEnd(std::istream &is)
+{
+    return is.peek() == std::char_traits<char>::eof();
+}
+
+template<typename Container>
+Error_t Trajectory<Container>::pack(std::ostream &os, Streamable::Format format) const
+{
+    ASSERT(format==Streamable::BIN, "The trajectory is only in BIN format");
+
+    CHK(pack_header(os, "TRAJECTORY", sizeof(float)));
+    CHK(pack_value(os, static_cast<int32_t>(sh_order_)));
+    CHK(pack_value(os, static_cast<int32_t>(freq_)));
+    CHK(pack_value(os, static_cast<int8_t>(quantize_)));
+
+    return ErrorEvent::Success;
+}
+
+template<typename Container>
+Error_t Trajectory<Container>::unpack(std::istream &is, Streamable::Format format)
+{
+    ASSERT(format==Streamable::BIN, "The trajectory is only in BIN format");
+
+    int version(0);
+    int32_t i32;
+    int8_t i8;
+    Error_t err(unpack_header(is, "TRAJECTORY", sizeof(float), version));
+    if (err) return err;
+
+    CHK(unpack_value(is, i32)); sh_order_ = i32;
+    CHK(unpack_value(is, i32)); freq_ = i32;
+    CHK(unpack_value(is, i8)); quantize_ = i8;
+
+    INFO("Trajectory of order "<<sh_order_<<" truncated at "<<freq_
+        <<(quantize_ ? " (quantized)" : ""));
+    return ErrorEvent::Success;
+}
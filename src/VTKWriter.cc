@@ -0,0 +1,326 @@
+/**
+ * @file   VTKWriter.cc
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ *
+ * @brief  The implementation of the VTKWriter class.
+ */
+
+#include "VTKWriter.h"
+
+#ifdef HAS_MPI
+
+#include "Logger.h"
+#include "AsyncWriter.h"
+
+#include <climits>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    const char* MeshName(VTKWriter::MeshType type)
+    {
+        return (type == VTKWriter::PolyData) ? "PolyData" : "UnstructuredGrid";
+    }
+
+    const char* Extension(VTKWriter::MeshType type)
+    {
+        return (type == VTKWriter::PolyData) ? "vtp" : "vtu";
+    }
+
+    bool IsLittleEndian()
+    {
+        uint16_t number(0x1);
+        return (reinterpret_cast<uint8_t*>(&number)[0] == 1);
+    }
+
+    template<typename T, typename S>
+    void AppendArray(std::string &bytes, const std::vector<S> &v, S shift = 0)
+    {
+        std::vector<T> tmp(v.size());
+        for (size_t ii=0; ii<v.size(); ++ii) tmp[ii] = v[ii] + shift;
+        if (tmp.size())
+            bytes.append(reinterpret_cast<const char*>(&tmp[0]), tmp.size() * sizeof(T));
+    }
+
+    // the data arrays of the piece, in the order of the XML header,
+    // with the connectivity shifted by pt_shift and the offsets by
+    // conn_shift; ncomp and rank_data are the point data of all the
+    // pieces (the piece may have no points)
+    void LocalArrays(const VTKPiece &piece, int ncomp, bool rank_data,
+        VTKWriter::MeshType type, bool single, bool int64, int64_t pt_shift,
+        int64_t conn_shift, int rank, std::vector<std::string> &arrays)
+    {
+        arrays.clear();
+        arrays.push_back(std::string());
+        if (single) AppendArray<float>(arrays.back(), piece.coord);
+        else        AppendArray<double>(arrays.back(), piece.coord);
+
+        if (ncomp){
+            arrays.push_back(std::string());
+            if (single) AppendArray<float>(arrays.back(), piece.value);
+            else        AppendArray<double>(arrays.back(), piece.value);
+        }
+
+        if (rank_data){
+            std::vector<int32_t> ranks(piece.coord.size() / 3, rank);
+            arrays.push_back(std::string());
+            AppendArray<int32_t>(arrays.back(), ranks);
+        }
+
+        std::vector<int64_t> connect(piece.connect.begin(), piece.connect.end());
+        std::vector<int64_t> offset(piece.offset.begin(), piece.offset.end());
+        arrays.push_back(std::string());
+        if (int64) AppendArray<int64_t>(arrays.back(), connect, pt_shift);
+        else       AppendArray<int32_t>(arrays.back(), connect, pt_shift);
+        arrays.push_back(std::string());
+        if (int64) AppendArray<int64_t>(arrays.back(), offset, conn_shift);
+        else       AppendArray<int32_t>(arrays.back(), offset, conn_shift);
+
+        if (type == VTKWriter::UnstructuredGrid){
+            arrays.push_back(std::string());
+            AppendArray<uint8_t>(arrays.back(), piece.types);
+        }
+    }
+
+    // the XML up to the start of the appended data, sizes are the
+    // sizes of the data arrays (in bytes) and header_size the size of
+    // the integer that precedes each array
+    std::string Header(int ncomp, bool rank_data, VTKWriter::MeshType type,
+        bool single, bool int64, int header_size, uint64_t n_pts,
+        uint64_t n_cells, const std::vector<uint64_t> &sizes)
+    {
+        std::ostringstream os;
+        int real_bits(single ? 32 : 64);
+        int int_bits(int64 ? 64 : 32);
+        bool poly(type == VTKWriter::PolyData);
+        size_t ia(0);
+        uint64_t data_size(0);
+
+        os<<"<?xml version=\"1.0\"?>\n";
+        os<<"<VTKFile type=\""<<MeshName(type)<<"\""
+          <<(header_size == 8 ? " version=\"1.0\" header_type=\"UInt64\"" : " version=\"0.1\"")
+          <<" byte_order=\""<<(IsLittleEndian() ? "LittleEndian" : "BigEndian")<<"\">\n";
+        //===========================================================================
+        os<<"  <"<<MeshName(type)<<">\n";
+        if (poly)
+            os<<"    <Piece NumberOfPoints=\""<<n_pts<<"\" NumberOfVerts=\"0\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\""<<n_cells<<"\">\n";
+        else
+            os<<"    <Piece NumberOfPoints=\""<<n_pts<<"\" NumberOfCells=\""<<n_cells<<"\">\n";
+
+        //---------------------------------------------------------------------------
+        os<<"      <Points>\n";
+        os<<"        <DataArray type=\"Float"<<real_bits<<"\" NumberOfComponents=\"3\" Name=\"Position\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
+        data_size += header_size + sizes[ia++];
+        os<<"      </Points>\n";
+        //---------------------------------------------------------------------------
+        if (ncomp || rank_data){
+            os<<"      <PointData>\n";
+            if (ncomp){
+                os<<"        <DataArray type=\"Float"<<real_bits<<"\" NumberOfComponents=\""<<ncomp<<"\" Name=\"value\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
+                data_size += header_size + sizes[ia++];
+            }
+            if (rank_data){
+                os<<"        <DataArray type=\"Int32\" NumberOfComponents=\"1\" Name=\"mpi_rank\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
+                data_size += header_size + sizes[ia++];
+            }
+            os<<"      </PointData>\n";
+        }
+        //---------------------------------------------------------------------------
+        os<<"      <"<<(poly ? "Polys" : "Cells")<<">\n";
+        os<<"        <DataArray type=\"Int"<<int_bits<<"\" Name=\"connectivity\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
+        data_size += header_size + sizes[ia++];
+        os<<"        <DataArray type=\"Int"<<int_bits<<"\" Name=\"offsets\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
+        data_size += header_size + sizes[ia++];
+        if (!poly){
+            os<<"        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\""<<data_size<<"\" />\n";
+            data_size += header_size + sizes[ia++];
+        }
+        os<<"      </"<<(poly ? "Polys" : "Cells")<<">\n";
+        //---------------------------------------------------------------------------
+
+        os<<"    </Piece>\n";
+        os<<"  </"<<MeshName(type)<<">\n";
+        //===========================================================================
+        os<<"  <AppendedData encoding=\"raw\">\n";
+        os<<"    _";
+        return os.str();
+    }
+
+    const char *FOOTER = "\n  </AppendedData>\n</VTKFile>\n";
+}
+
+Error_t VTKWriter::Write(const std::string &fname, const VTKPiece &piece,
+    MeshType type, bool collective, bool single, MPI_Comm comm,
+    const char *piece_sep)
+{
+    ASSERT(piece.coord.size() % 3 == 0, "The points should have three coordinates");
+    ASSERT(piece.offset.size() == 0 || piece.offset.back() == piece.connect.size(),
+        "The offsets do not match the connectivity");
+    ASSERT(type == PolyData || piece.types.size() == piece.offset.size(),
+        "The cell types should be set for an unstructured grid");
+
+    // the layout of the processes with points, a process with values
+    // of a different number of components is an error on all of them
+    size_t n_pts(piece.coord.size() / 3);
+    int loc[3] = {n_pts ? int(piece.value.size() / n_pts) : 0, piece.rank_data, 0}, glb[3];
+    MPI_Allreduce(loc, glb, 2, MPI_INT, MPI_MAX, comm);
+    loc[2] = (piece.value.size() != glb[0] * n_pts);
+    MPI_Allreduce(loc + 2, glb + 2, 1, MPI_INT, MPI_MAX, comm);
+    if (glb[2]){
+        CERR("The pieces have values of different number of components");
+        return ErrorEvent::InvalidParameterError;
+    }
+
+    return collective ?
+        WriteCollective(fname, piece, glb[0], glb[1], type, single, comm) :
+        WritePieces(fname, piece, glb[0], glb[1], type, single, comm, piece_sep);
+}
+
+Error_t VTKWriter::WritePieces(const std::string &fname, const VTKPiece &piece,
+    int ncomp, bool rank_data, MeshType type, bool single, MPI_Comm comm,
+    const char *piece_sep)
+{
+    int rank, np;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &np);
+
+    std::vector<std::string> arrays;
+    LocalArrays(piece, ncomp, rank_data, type, single, false, 0, 0, rank, arrays);
+    std::vector<uint64_t> sizes(arrays.size());
+    for (size_t ii=0; ii<arrays.size(); ++ii) sizes[ii] = arrays[ii].size();
+
+    std::ostringstream vtufname;
+    vtufname<<fname<<piece_sep<<std::setfill('0')<<std::setw(6)<<rank<<"."<<Extension(type);
+
+    std::string content(Header(ncomp, rank_data, type, single, false, sizeof(uint32_t),
+            piece.coord.size() / 3, piece.offset.size(), sizes));
+    for (size_t ii=0; ii<arrays.size(); ++ii){
+        uint32_t block_size(arrays[ii].size());
+        content.append(reinterpret_cast<const char*>(&block_size), sizeof(block_size));
+        content.append(arrays[ii]);
+    }
+    content.append(FOOTER);
+    Error_t err(AsyncWriter::Submit(vtufname.str(), content));
+
+    if (rank) return err;
+
+    // the index file
+    const char *mesh(MeshName(type));
+    int real_bits(single ? 32 : 64);
+    std::ostringstream pvtufname, pvtufile;
+    pvtufname<<fname<<".p"<<Extension(type);
+    pvtufile<<"<?xml version=\"1.0\"?>\n";
+    pvtufile<<"<VTKFile type=\"P"<<mesh<<"\">\n";
+    pvtufile<<"  <P"<<mesh<<" GhostLevel=\"0\">\n";
+    pvtufile<<"      <PPoints>\n";
+    pvtufile<<"        <PDataArray type=\"Float"<<real_bits<<"\" NumberOfComponents=\"3\" Name=\"Position\"/>\n";
+    pvtufile<<"      </PPoints>\n";
+    if (ncomp || rank_data){
+        pvtufile<<"      <PPointData>\n";
+        if (ncomp)
+            pvtufile<<"        <PDataArray type=\"Float"<<real_bits<<"\" NumberOfComponents=\""<<ncomp<<"\" Name=\"value\"/>\n";
+        if (rank_data)
+            pvtufile<<"        <PDataArray type=\"Int32\" NumberOfComponents=\"1\" Name=\"mpi_rank\"/>\n";
+        pvtufile<<"      </PPointData>\n";
+    }
+    {
+        // the pieces are relative to the index file
+        std::string fname_(fname.substr(fname.find_last_of("/\\") + 1));
+        for (int ii=0; ii<np; ++ii)
+            pvtufile<<"      <Piece Source=\""<<fname_<<piece_sep<<std::setfill('0')<<std::setw(6)<<ii<<"."<<Extension(type)<<"\"/>\n";
+    }
+    pvtufile<<"  </P"<<mesh<<">\n";
+    pvtufile<<"</VTKFile>\n";
+    std::string pvtubuf(pvtufile.str());
+    Error_t ierr(AsyncWriter::Submit(pvtufname.str(), pvtubuf));
+
+    return err ? err : ierr;
+}
+
+Error_t VTKWriter::WriteCollective(const std::string &fname, const VTKPiece &piece,
+    int ncomp, bool rank_data, MeshType type, bool single, MPI_Comm comm)
+{
+    PROFILESTART();
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    // the points and connectivity of the lower ranks
+    uint64_t counts[3] = {piece.coord.size() / 3, piece.offset.size(), piece.connect.size()};
+    uint64_t shifts[3] = {0, 0, 0}, totals[3];
+    MPI_Exscan(counts, shifts, 3, MPI_UINT64_T, MPI_SUM, comm);
+    MPI_Allreduce(counts, totals, 3, MPI_UINT64_T, MPI_SUM, comm);
+    if (rank == 0) shifts[0] = shifts[1] = shifts[2] = 0;
+
+    std::vector<std::string> arrays;
+    LocalArrays(piece, ncomp, rank_data, type, single, true, shifts[0], shifts[2],
+        rank, arrays);
+
+    // the part of each array that is written by this process
+    int na(arrays.size());
+    std::vector<uint64_t> sizes(na), offsets(na, 0), total_sizes(na);
+    for (int ii=0; ii<na; ++ii) sizes[ii] = arrays[ii].size();
+    MPI_Exscan(&sizes[0], &offsets[0], na, MPI_UINT64_T, MPI_SUM, comm);
+    MPI_Allreduce(&sizes[0], &total_sizes[0], na, MPI_UINT64_T, MPI_SUM, comm);
+    if (rank == 0) std::fill(offsets.begin(), offsets.end(), 0);
+
+    // the file name of the first process is used
+    std::ostringstream vtufname;
+    vtufname<<fname<<"."<<Extension(type);
+    std::string name(vtufname.str());
+    int len(name.size());
+    MPI_Bcast(&len, 1, MPI_INT, 0, comm);
+    name.resize(len);
+    MPI_Bcast(&name[0], len, MPI_CHAR, 0, comm);
+
+    // the processes leave together when the file is not opened on
+    // any of them (the following calls are collective)
+    MPI_File fh;
+    int ierr(MPI_File_open(comm, const_cast<char*>(name.c_str()),
+            MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh));
+    int open_loc(ierr != MPI_SUCCESS), open_glb(0);
+    MPI_Allreduce(&open_loc, &open_glb, 1, MPI_INT, MPI_MAX, comm);
+    if (open_glb){
+        if (!open_loc) MPI_File_close(&fh);
+        CERR("Could not open the file "<<name);
+        return ErrorEvent::IOError;
+    }
+    MPI_File_set_size(fh, 0);
+
+    std::string header(Header(ncomp, rank_data, type, single, true, sizeof(uint64_t),
+            totals[0], totals[1], total_sizes));
+    MPI_Offset block(header.size());
+    if (rank == 0 && ierr == MPI_SUCCESS)
+        ierr = MPI_File_write_at(fh, 0, &header[0], header.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    for (int ii=0; ii<na; ++ii){
+        if (rank == 0 && ierr == MPI_SUCCESS)
+            ierr = MPI_File_write_at(fh, block, &total_sizes[ii], 1, MPI_UINT64_T, MPI_STATUS_IGNORE);
+
+        ASSERT(arrays[ii].size() < INT_MAX, "The data of a process is too large");
+        int err(MPI_File_write_at_all(fh, block + sizeof(uint64_t) + offsets[ii],
+                const_cast<char*>(arrays[ii].data()), arrays[ii].size(), MPI_BYTE,
+                MPI_STATUS_IGNORE));
+        if (ierr == MPI_SUCCESS) ierr = err;
+        block += sizeof(uint64_t) + total_sizes[ii];
+    }
+
+    if (rank == 0 && ierr == MPI_SUCCESS)
+        ierr = MPI_File_write_at(fh, block, const_cast<char*>(FOOTER), strlen(FOOTER),
+            MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+
+    // all the processes return the same error
+    int loc(ierr != MPI_SUCCESS), glb(0);
+    MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MAX, comm);
+    if (glb){
+        CERR("Failed to write the file "<<name);
+        return ErrorEvent::IOError;
+    }
+
+    COUTDEBUG("Wrote "<<totals[0]<<" points and "<<totals[1]<<" cells to "<<name);
+    PROFILEEND("",0);
+    return ErrorEvent::Success;
+}
+
+#endif //HAS_MPI
@@ -82,10 +82,21 @@ enum CoordinateOrder Vectors<T, DT, DEVICE>::getPointOrder() const
     return(point_order_);
 }
 
+template<typename T, typename DT, const DT &DEVICE>
+void Vectors<T, DT, DEVICE>::swap(Vectors<T, DT, DEVICE> &rhs)
+{
+    scalars_type::swap(rhs);
+    std::swap(point_order_, rhs.point_order_);
+}
+
 template<typename T, typename DT, const DT &DEVICE>
 Error_t Vectors<T, DT, DEVICE>::pack(std::ostream &os, Streamable::Format format) const
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        CHK(this->pack_header(os, "VECTORS", sizeof(T)));
+        CHK(this->pack_value(os, static_cast<int32_t>(point_order_)));
+        return scalars_type::pack(os, format);
+    }
 
     os<<"VECTORS\n";
     os<<"version: "<<VERSION<<"\n";
@@ -99,7 +110,17 @@ Error_t Vectors<T, DT, DEVICE>::pack(std::ostream &os, Streamable::Format format
 template<typename T, typename DT, const DT &DEVICE>
 Error_t Vectors<T, DT, DEVICE>::unpack(std::istream &is, Streamable::Format format)
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        int version(0);
+        int32_t order;
+        Error_t ierr(this->unpack_header(is, "VECTORS", sizeof(T), version));
+        if (ierr) return ierr;
+        ierr = this->unpack_value(is, order);
+        if (ierr) return ierr;
+        setPointOrder(static_cast<CoordinateOrder>(order));
+        return scalars_type::unpack(is, format);
+    }
+
     std::string s, key;
     int version(0);
 
@@ -77,7 +77,7 @@ Error_t VesInteraction<T>::operator()(
     }
     else
     {
-        value_type* buffer(new value_type[n_cpy]);
+        value_type* buffer((value_type*) memory::CachingAllocator::Malloc(n_cpy * sizeof(value_type)));
 
         position.getDevice().Memcpy(buffer, position.begin(),
             n_cpy * sizeof(value_type),
@@ -93,7 +93,7 @@ Error_t VesInteraction<T>::operator()(
         for(size_t ii=0; ii<n_cpy; ++ii)
             *(all_den_ + idx + ii) = static_cast<T>(buffer[ii]);
 
-        delete[] buffer;
+        memory::CachingAllocator::Free(buffer);
     }
 
     // call user interaction routine
@@ -113,7 +113,7 @@ Error_t VesInteraction<T>::operator()(
     }
     else
     {
-        value_type* buffer(new value_type[n_cpy]);
+        value_type* buffer((value_type*) memory::CachingAllocator::Malloc(n_cpy * sizeof(value_type)));
 
         for(size_t ii=0; ii<n_cpy; ++ii)
             buffer[ii] = static_cast<T>(*(all_pot_ + idx + ii));
@@ -122,7 +122,7 @@ Error_t VesInteraction<T>::operator()(
             n_cpy * sizeof(value_type),
             device_type::MemcpyHostToDevice);
 
-        delete[] buffer;
+        memory::CachingAllocator::Free(buffer);
     }
 
     COUTDEBUG("Interaction resolved");
@@ -39,7 +39,7 @@ Error_t VesicleProperties<T>::update(){
         dl_coeff.begin(), nves, dl_coeff.begin());
 
     // bending coefficient
-    bending_modulus.getDevice().axpy<value_type>(-1.0,bending_modulus.begin(),
+    bending_modulus.getDevice().template axpy<value_type>(-1.0,bending_modulus.begin(),
         NULL, nves, bending_coeff.begin());
 
     // check contrast and excess density to set flags
@@ -72,6 +72,11 @@ T* VesicleProperties<T>::getPropIdx(int i){
     }
 }
 
+template<typename T>
+const T* VesicleProperties<T>::getPropIdx(int i) const{
+    return const_cast<VesicleProperties*>(this)->getPropIdx(i);
+}
+
 template<typename T>
 Error_t VesicleProperties<T>::setFromParams(Parameters<value_type> &params){
 
@@ -109,7 +114,15 @@ Error_t VesicleProperties<T>::setFromParams(Parameters<value_type> &params){
 template<typename T>
 Error_t VesicleProperties<T>::pack(std::ostream &os, Format format) const
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        CHK(pack_header(os, "VESICLEPROPS", sizeof(value_type)));
+        CHK(pack_string(os, Streamable::name_));
+        CHK(bending_modulus   .pack(os,format));
+        CHK(viscosity_contrast.pack(os,format));
+        CHK(excess_density    .pack(os,format));
+        return ErrorEvent::Success;
+    }
+
     os<<"VESICLEPROPS\n";
     os<<"version: "<<VERSION<<"\n";
     os<<"name: "<<Streamable::name_<<"\n";
@@ -123,7 +136,20 @@ Error_t VesicleProperties<T>::pack(std::ostream &os, Format format) const
 template<typename T>
 Error_t VesicleProperties<T>::unpack(std::istream &is, Format format)
 {
-    ASSERT(format==Streamable::ASCII, "BIN is not supported yet");
+    if (format==Streamable::BIN){
+        int version(0);
+        Error_t ierr(unpack_header(is, "VESICLEPROPS", sizeof(value_type), version));
+        if (ierr) return ierr;
+        CHK(unpack_string(is, Streamable::name_));
+        if (bending_modulus   .unpack(is,format) ||
+            viscosity_contrast.unpack(is,format) ||
+            excess_density    .unpack(is,format))
+            return ErrorEvent::IOBadStream;
+        update();
+        INFO("Unpacked "<<Streamable::name_<<" data from version "<<version<<" (current version "<<VERSION<<")");
+        return ErrorEvent::Success;
+    }
+
     std::string s,key;
     int version(0);
 
@@ -0,0 +1,109 @@
+template<typename Container>
+typename WorkSpace<Container>::FreeMap_t WorkSpace<Container>::free_;
+
+template<typename Container>
+typename WorkSpace<Container>::Stats WorkSpace<Container>::pool_stats_;
+
+template<typename Container>
+typename WorkSpace<Container>::StatsMap_t WorkSpace<Container>::subsystem_stats_;
+
+template<typename Container>
+WorkSpace<Container>::WorkSpace(const std::string &name) :
+    name_(name)
+{
+#pragma omp critical (workspace)
+    subsystem_ = &subsystem_stats_[name_];
+}
+
+template<typename Container>
+WorkSpace<Container>::~WorkSpace()
+{
+    ASSERT(!stats_.checked_out, "All containers are not returned to the workspace ("<<name_<<")");
+    COUTDEBUG("Workspace "<<name_<<": high water = "<<stats_.high_water
+        <<", allocations = "<<stats_.allocs);
+}
+
+template<typename Container>
+template<typename Shape>
+std::auto_ptr<Container> WorkSpace<Container>::checkout(
+    const Shape &shape) const
+{
+    return(checkout(shape.getNumSubs(), shape.getShOrder(), shape.getGridDim()));
+}
+
+template<typename Container>
+std::auto_ptr<Container> WorkSpace<Container>::checkout(size_t num_subs,
+    int sh_order, std::pair<int, int> grid_dim) const
+{
+    grid_dim = (grid_dim == EMPTY_GRID) ? SpharmGridDim(sh_order) : grid_dim;
+    size_t len(num_subs * Container::getTheDim() * grid_dim.first * grid_dim.second);
+    Container *c(NULL);
+
+#pragma omp critical (workspace)
+    {
+        // the smallest free container that is large enough, otherwise
+        // a new one (the smaller ones are kept for smaller requests)
+        typename FreeMap_t::iterator it(free_.lower_bound(len));
+        if (it != free_.end()){
+            c = it->second;
+            free_.erase(it);
+        } else {
+            c = new Container;
+        }
+        count(1, c->capacity() < len);
+    }
+
+    c->resize(num_subs, sh_order, grid_dim);
+    return(std::auto_ptr<Container>(c));
+}
+
+template<typename Container>
+void WorkSpace<Container>::recycle(std::auto_ptr<Container> c) const
+{
+#pragma omp critical (workspace)
+    {
+        size_t cap(c->capacity());
+        free_.insert(std::make_pair(cap, c.release()));
+        count(-1, false);
+    }
+}
+
+template<typename Container>
+void WorkSpace<Container>::count(int checkout, bool alloc) const
+{
+    Stats *st[3] = {&stats_, subsystem_, &pool_stats_};
+    for (int ii=0; ii<3; ++ii){
+        st[ii]->checked_out += checkout;
+        st[ii]->high_water   = std::max(st[ii]->high_water, st[ii]->checked_out);
+        st[ii]->allocs      += alloc;
+    }
+}
+
+template<typename Container>
+size_t WorkSpace<Container>::getNumFree()
+{
+    return(free_.size());
+}
+
+template<typename Container>
+size_t WorkSpace<Container>::getFreeCapacity()
+{
+    size_t cap(0);
+    typename FreeMap_t::const_iterator it(free_.begin());
+    for ( ; it != free_.end(); ++it)
+        cap += it->first;
+
+    return(cap);
+}
+
+template<typename Container>
+void WorkSpace<Container>::purge()
+{
+#pragma omp critical (workspace)
+    {
+        typename FreeMap_t::iterator it(free_.begin());
+        for ( ; it != free_.end(); ++it)
+            delete it->second;
+        free_.clear();
+    }
+}
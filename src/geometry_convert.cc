@@ -0,0 +1,86 @@
+#include "ves3d_common.h"
+#include "Logger.h"
+#include "Error.h"
+#include "DataIO.h"
+#include "GeometryFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+/*
+ * Converts the ASCII geometry spec file (and optionally the vesicle
+ * properties file) to the binary geometry file that can be passed as
+ * --vesicle-geometry-file, see GeometryFile. The vesicles are ordered
+ * along the Morton curve of their centers unless --no-sort is given.
+ *
+ * usage: geometry_convert [--no-sort] <geometry spec> <output> [<vesicle props>]
+ */
+
+// the number of values in the first (non-empty) line of the file
+size_t num_columns(const std::string &fname)
+{
+    std::ifstream file(fname.c_str());
+    std::string line;
+    while (getline(file, line) && line.empty());
+
+    std::istringstream is(line);
+    double d;
+    size_t n(0);
+    while (is>>d) ++n;
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    SET_ERR_CALLBACK(&cb_abort);
+    VES3D_INITIALIZE(&argc, &argv, NULL, NULL);
+
+    bool sort(true);
+    std::vector<std::string> files;
+    for (int ii=1; ii<argc; ++ii){
+        if (strcmp(argv[ii], "--no-sort") == 0)
+            sort = false;
+        else
+            files.push_back(argv[ii]);
+    }
+
+    if (files.size() < 2 || files.size() > 3){
+        COUT("usage: "<<argv[0]<<" [--no-sort] <geometry spec> <output> [<vesicle props>]");
+        VES3D_FINALIZE();
+        return 1;
+    }
+
+    int rank(0);
+    MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+    Error_t ierr(ErrorEvent::Success);
+
+    // the file is converted by the first process only
+    if (rank == 0){
+        DataIO io;
+        std::vector<double> spec, props;
+        INFO("Reading geometry file "<<files[0]);
+        io.ReadDataStl(files[0], spec, DataIO::ASCII);
+        spec.resize(spec.size() / GeometryFile<double>::NUM_FIELDS
+            * GeometryFile<double>::NUM_FIELDS);
+        size_t nv(spec.size() / GeometryFile<double>::NUM_FIELDS);
+
+        if (files.size() > 2){
+            size_t nprops(num_columns(files[2]));
+            INFO("Reading vesicle properties file "<<files[2]<<" ("<<nprops<<" properties)");
+            io.ReadDataStl(files[2], props, DataIO::ASCII);
+            if (props.size() < nv * nprops){
+                CERR("The properties file has "<<props.size() / std::max<size_t>(nprops, 1)
+                    <<" vesicles instead of "<<nv);
+                ierr = ErrorEvent::IOBadStream;
+            }
+            props.resize(nv * nprops);
+        }
+
+        GeometryFile<double> gf(VES3D_COMM_SELF);
+        if (!ierr) ierr = gf.Write(files[1], spec, props, sort);
+    }
+
+    VES3D_FINALIZE();
+    return ierr != ErrorEvent::Success;
+}
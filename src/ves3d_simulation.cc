@@ -35,6 +35,7 @@
 template<typename DT, const DT &DEVICE>
 Simulation<DT,DEVICE>::Simulation(const Param_t &ip) :
     load_checkpoint_(false),
+    checkpoint_format_(Streamable::ASCII),
     ves_props_(NULL),
     Mats_(NULL),
     vInf_(NULL),
@@ -48,6 +49,7 @@ Simulation<DT,DEVICE>::Simulation(const Param_t &ip) :
 template<typename DT, const DT &DEVICE>
 Simulation<DT,DEVICE>::Simulation(int argc, char** argv, const DictString_t *dict) :
     load_checkpoint_(false),
+    checkpoint_format_(Streamable::ASCII),
     ves_props_(NULL),
     Mats_(NULL),
     vInf_(NULL),
@@ -118,8 +120,27 @@ Error_t Simulation<DT,DEVICE>::setup_basics(){
 template<typename DT, const DT &DEVICE>
 Error_t Simulation<DT,DEVICE>::setup_from_checkpoint(){
 
+#ifdef HAS_MPI
+    if (parallel_checkpoint_.size()){
+        // the vesicles of this process (that may be a different
+        // number of processes from the one that wrote the file)
+        PCheckpoint_t pc;
+        Param_t p;
+        CHK(pc.ReadHeader(parallel_checkpoint_, p));
+
+        Vec_t x0(0, run_params_.sh_order);
+        ves_props_ = new VProp_t();
+        CHK(pc.ReadState(parallel_checkpoint_, x0, *ves_props_));
+        run_params_.n_surfs = pc.num_vesicles();
+
+        timestepper_ = new Evolve_t(&run_params_, *Mats_, vInf_, NULL,
+            interaction_, NULL, ksp_, &x0, ves_props_);
+        return ErrorEvent::Success;
+    }
+#endif
+
     timestepper_ = new Evolve_t(&run_params_, *Mats_, vInf_, NULL, interaction_, NULL, ksp_);
-    timestepper_->unpack(checkpoint_data_, Streamable::ASCII);
+    timestepper_->unpack(checkpoint_data_, checkpoint_format_);
     return ErrorEvent::Success;
 }
 
@@ -143,6 +164,10 @@ Error_t Simulation<DT,DEVICE>::setup_from_options()
     // load centers and transformations for current mpi process
     ASSERT(run_params_.vesicle_geometry_file.size()>0,"geometry file is required");
     fname = FullPath(run_params_.vesicle_geometry_file);
+#ifdef HAS_MPI
+    if (GeometryFile<double>::IsGeometryFile(fname))
+        return setup_from_geometry_file(fname, shapes);
+#endif
     INFO("Reading geometry file "<<fname);
     std::vector<value_type> all_geo_spec;
     io.ReadDataStl(fname, all_geo_spec, DataIO::ASCII);
@@ -201,6 +226,63 @@ Error_t Simulation<DT,DEVICE>::setup_from_options()
     return ErrorEvent::Success;
 }
 
+#ifdef HAS_MPI
+template<typename DT, const DT &DEVICE>
+Error_t Simulation<DT,DEVICE>::setup_from_geometry_file(const std::string &fname,
+    const std::vector<value_type> &shapes)
+{
+    // each process reads its slice of the vesicles (the number of
+    // vesicles is set by the file)
+    INFO("Reading binary geometry file "<<fname);
+    GeometryFile<double> gf;
+    std::vector<double> spec, props;
+    CHK(gf.Read(fname, spec, props));
+
+    int nves(gf.num_vesicles());
+    run_params_.n_surfs = nves;
+    Vec_t x0(nves, run_params_.sh_order);
+
+    INFO("Initializing the starting shapes");
+    std::vector<value_type> geo_spec(spec.begin(), spec.end());
+    InitializeShapes(x0, shapes, geo_spec);
+
+    ves_props_ = new VProp_t();
+    int nprops(VProp_t::n_props);
+
+    if (gf.num_props() == nprops) {
+        INFO("Loading vesicle properties from the geometry file");
+        Arr_t propsf(nprops * nves);
+        Arr_t propsv(nprops * nves);
+        std::copy(props.begin(), props.end(), propsf.begin());
+
+        //order by property (column)
+        propsv.getDevice().Transpose(propsf.begin(),nves,nprops,propsv.begin());
+
+        for (int iP(0);iP<nprops;++iP){
+            typename VProp_t::container_type* prp(ves_props_->getPropIdx(iP));
+            prp->resize(nves);
+            prp->getDevice().Memcpy(prp->begin(),
+                propsv.begin() + iP*nves,
+                nves * sizeof(VProp_t::value_type),
+                DT::MemcpyDeviceToDevice);
+        }
+        ves_props_->update();
+    } else {
+        if (gf.num_props())
+            CERR("The geometry file has "<<gf.num_props()<<" vesicle properties instead of "<<nprops);
+        if (run_params_.vesicle_props_file.size())
+            WARN("The vesicle properties file is ignored with a binary geometry file"
+                <<" (the properties should be converted with the geometry)");
+        CHK(ves_props_->setFromParams(run_params_));
+    }
+
+    timestepper_ = new Evolve_t(&run_params_, *Mats_, vInf_, NULL,
+        interaction_, NULL, ksp_, &x0, ves_props_);
+
+    return ErrorEvent::Success;
+}
+#endif
+
 template<typename DT, const DT &DEVICE>
 Error_t Simulation<DT,DEVICE>::cleanup_run()
 {
@@ -213,6 +295,8 @@ Error_t Simulation<DT,DEVICE>::cleanup_run()
     delete timestepper_; timestepper_ = NULL;
 
     load_checkpoint_ = false;
+    checkpoint_format_ = Streamable::ASCII;
+    parallel_checkpoint_.clear();
     checkpoint_data_.str("");
     checkpoint_data_.clear();
     return ErrorEvent::Success;
@@ -237,16 +321,32 @@ Error_t Simulation<DT,DEVICE>::prepare_run_params(const Param_t &ip)
     if (ip.load_checkpoint != ""){
         std::string fname = FullPath(ip.load_checkpoint);
         INFO("Loading checkpoint file "<<fname);
-        DataIO::SlurpFile(fname.c_str(), checkpoint_data_);
+#ifdef HAS_MPI
+        if (PCheckpoint_t::IsParallelCheckpoint(fname)){
+            // only the parameters are read here, the vesicles are
+            // read in setup_from_checkpoint
+            PCheckpoint_t pc;
+            Param_t p;
+            CHK(pc.ReadHeader(fname, p));
+            p.pack(checkpoint_data_, Streamable::BIN);
+            checkpoint_format_ = Streamable::BIN;
+            parallel_checkpoint_ = fname;
+        } else
+#endif
+        {
+            DataIO::SlurpFile(fname.c_str(), checkpoint_data_);
+            checkpoint_format_ = Streamable::peek_format(checkpoint_data_);
+        }
         load_checkpoint_ = true;
     } else {
         ip.pack(checkpoint_data_, Streamable::ASCII);
+        checkpoint_format_ = Streamable::ASCII;
         load_checkpoint_ = false;
     }
 
     //consume the first part of checkpoint (see Monitor for how
     //it is dumped
-    run_params_.unpack(checkpoint_data_, Streamable::ASCII);
+    run_params_.unpack(checkpoint_data_, checkpoint_format_);
 
     return ErrorEvent::Success;
 }
@@ -89,6 +89,14 @@ void test_array(){
 	d.pack(s3, Streamable::ASCII);
 	ASSERT(s3.str()==ref, "bad stream d");
 
+	// a corrupt binary header is rejected before the size is read
+	a.pack(s4, Streamable::BIN);
+	std::string bin(s4.str());
+	bin[sizeof(uint32_t)] = 'X';
+	std::stringstream s5(bin);
+	ASSERT(b.unpack(s5, Streamable::BIN)!=ErrorEvent::Success, "corrupt header is not rejected");
+	ASSERT(b.size()==sz, "corrupt header resized the array");
+
 	delete[] c;
     }
 }
@@ -0,0 +1,115 @@
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+
+#include "Logger.h"
+#include "Error.h"
+#include "AsyncWriter.h"
+
+using namespace std;
+
+#ifndef Doxygen_skip
+
+string ReadBack(const string &fname)
+{
+    ifstream file(fname.c_str(), ios::in | ios::binary);
+    stringstream ss;
+    ss<<file.rdbuf();
+    return ss.str();
+}
+
+string Content(int idx, size_t len)
+{
+    string s(len, 'a' + idx % 26);
+    s[0] = '\0'; // binary content
+    return s;
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  AsyncWriter Test:"
+        <<"\n ==============================");
+
+    bool res(true);
+    int nfiles(6);
+    size_t len(1 << 20);
+    char fname[64];
+
+    // more files than buffers, the content is handed over
+    string buffer;
+    for (int ii(0); ii<nfiles; ++ii){
+        buffer = Content(ii, len);
+        sprintf(fname, "AsyncWriterTest_%d.txt", ii);
+        res = res && (AsyncWriter::Submit(fname, buffer) == ErrorEvent::Success);
+        res = res && buffer.empty();
+    }
+    res = res && (AsyncWriter::Flush() == ErrorEvent::Success);
+
+    for (int ii(0); ii<nfiles; ++ii){
+        sprintf(fname, "AsyncWriterTest_%d.txt", ii);
+        res = res && (ReadBack(fname) == Content(ii, len));
+    }
+
+    WriterStats st(AsyncWriter::GetStats());
+    res = res && (st.files == size_t(nfiles)) && (st.bytes == nfiles * len);
+    res = res && (st.blocked_calls <= size_t(nfiles - AsyncWriter::NUM_BUFFERS));
+
+    // appending to a written file
+    buffer = Content(3, 10);
+    AsyncWriter::Submit("AsyncWriterTest_2.txt", buffer, true);
+    AsyncWriter::Flush();
+    res = res && (ReadBack("AsyncWriterTest_2.txt") == Content(2, len) + Content(3, 10));
+
+    // the same file is written in the order of submission
+    for (int ii(0); ii<3; ++ii){
+        buffer = Content(ii, 100);
+        AsyncWriter::Submit("AsyncWriterTest_0.txt", buffer);
+    }
+    AsyncWriter::Flush();
+    res = res && (ReadBack("AsyncWriterTest_0.txt") == Content(2, 100));
+
+    // the content is formatted in place, in the memory of the buffer
+    // that a submission handed back
+    buffer.reserve(len);
+    const char *mem(buffer.data());
+    {
+        BufferStream os(buffer);
+        os<<"frame "<<3<<" "<<0.5;
+        os.write(Content(4, 10).data(), 10);
+    }
+    res = res && (buffer == "frame 3 0.5" + Content(4, 10)) && (buffer.data() == mem);
+    res = res && (AsyncWriter::Submit("AsyncWriterTest_3.txt", buffer) == ErrorEvent::Success);
+    AsyncWriter::Flush();
+    res = res && (ReadBack("AsyncWriterTest_3.txt") == "frame 3 0.5" + Content(4, 10));
+
+    // the write errors are returned by the following call
+    buffer = "x";
+    AsyncWriter::Submit("no_such_dir/AsyncWriterTest.txt", buffer);
+    res = res && (AsyncWriter::Flush() == ErrorEvent::IOError);
+    res = res && (AsyncWriter::Flush() == ErrorEvent::Success);
+
+    // synchronous writes
+    AsyncWriter::SetAsync(false);
+    buffer = Content(7, 10);
+    res = res && (AsyncWriter::Submit("AsyncWriterTest_1.txt", buffer) == ErrorEvent::Success);
+    res = res && (ReadBack("AsyncWriterTest_1.txt") == Content(7, 10));
+    AsyncWriter::SetAsync(true);
+
+    AsyncWriter::Report();
+    for (int ii(0); ii<nfiles; ++ii){
+        sprintf(fname, "AsyncWriterTest_%d.txt", ii);
+        remove(fname);
+    }
+
+    if (res) {
+        COUT(emph<<"AsyncWriter test passed"<<emph);
+    } else {
+        COUT(alert<<"AsyncWriter test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
@@ -0,0 +1,143 @@
+#include <sstream>
+#include <algorithm>
+
+#include "Logger.h"
+#include "Error.h"
+#include "Device.h"
+
+#include "Scalars.h"
+#include "HelperFuns.h"
+#include "BiCGStabBatched.h"
+
+typedef double real;
+
+using namespace std;
+
+#ifndef Doxygen_skip
+
+// diagonal matvec, with a different spectrum for each subfield so
+// that the blocks converge at different iterations
+template<typename Container>
+class MatVec
+{
+  public:
+    typedef typename Container::value_type T;
+    typedef typename Container::device_type DT;
+    Container diag;
+
+    MatVec(int nf, int p)
+    {
+        diag.resize(nf, p);
+        size_t size = diag.size();
+        size_t stride = diag.getStride();
+
+        T* buffer = new T[size];
+        for(int ii=0; ii<size;++ii)
+            buffer[ii] = 1 + (ii % stride) * (ii / stride + 1) / 10.0;
+
+        diag.getDevice().Memcpy(diag.begin(), buffer,
+            size * sizeof(T), DT::MemcpyHostToDevice);
+
+        delete[] buffer;
+    }
+
+    void operator()(const Container &x, Container &ax) const
+    {
+        xy(diag, x, ax);
+    }
+};
+#endif //Doxygen_skip
+
+typedef Device<CPU> DCPU;
+extern const DCPU the_cpu_dev(0);
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  BiCGStabBatched Test:"
+        <<"\n ==============================");
+
+    typedef Scalars<real,DCPU, the_cpu_dev> ScaCPU_t;
+    typedef ScaCPU_t::array_type Arr_t;
+
+    int p = 12;
+    int nfuns(4);
+    ScaCPU_t x_ref(nfuns,p), b_ref(nfuns,p);
+    MatVec<ScaCPU_t> Ax(nfuns, p);
+    const int iter = 200;
+    const real tol = 1e-8;
+
+    for(int ii(0);ii<x_ref.size();++ii)
+        *(x_ref.begin() + ii) = drand48();
+    Ax(x_ref, b_ref);
+
+    ScaCPU_t x(nfuns, p), b(nfuns,p);
+    x.getDevice().Memset(x.begin(), 0, x.mem_size());
+    b.getDevice().Memcpy(b.begin(), b_ref.begin(),
+        b.size() * sizeof(real), DCPU::MemcpyHostToDevice);
+
+    BiCGStabBatched<ScaCPU_t, MatVec<ScaCPU_t> > Solver;
+    int iter_in(iter);
+    real tt(tol);
+
+    enum BiCGSReturn ret = Solver(Ax, x, b, iter_in, tt);
+
+    Ax(x,b);
+    axpy((real) -1.0, b_ref, b, b);
+
+    Arr_t err, nrm;
+    AlgebraicDot(b, b, err);
+    AlgebraicDot(b_ref, b_ref, nrm);
+
+    bool res(ret == BiCGSSuccess);
+    ostringstream cpu_o(stringstream::out);
+    cpu_o<<"\n  The solver returned with: "<<ret;
+    cpu_o<<"\n    Residual     : "<<tt;
+    cpu_o<<"\n    Iter         : "<<iter_in;
+    for (int ii(0); ii<nfuns; ++ii){
+        real relres(sqrt(err.begin()[ii]/nrm.begin()[ii]));
+        res = res && (relres < 10 * tol);
+        cpu_o<<"\n    Block "<<ii<<" iter : "<<Solver.IterationNumbers()[ii]
+             <<", true relres : "<<relres;
+    }
+    COUT(cpu_o.str());
+
+    // an easy (well conditioned) and a hard block in one batch, the
+    // easy block converges first and is not changed by the iterations
+    // of the hard block
+    MatVec<ScaCPU_t> Am(2, p);
+    for(int ii(0);ii<Am.diag.getStride();++ii)
+        *(Am.diag.begin() + ii) = 1 + 1e-3 * ii;
+    ScaCPU_t xm_ref(2, p), bm(2, p), xm(2, p), xe(2, p);
+    for(int ii(0);ii<xm_ref.size();++ii)
+        *(xm_ref.begin() + ii) = drand48();
+    Am(xm_ref, bm);
+
+    xm.getDevice().Memset(xm.begin(), 0, xm.mem_size());
+    iter_in = iter;
+    tt = tol;
+    ret = Solver(Am, xm, bm, iter_in, tt);
+    int easy_iter(Solver.IterationNumbers()[0]), hard_iter(Solver.IterationNumbers()[1]);
+    res = res && (ret == BiCGSSuccess) && (easy_iter < hard_iter);
+
+    // stopped when the easy block converged, the easy block is the
+    // same and the hard block isn't
+    xe.getDevice().Memset(xe.begin(), 0, xe.mem_size());
+    iter_in = easy_iter;
+    tt = tol;
+    Solver(Am, xe, bm, iter_in, tt);
+    size_t stride(xm.getStride());
+    res = res && std::equal(xm.begin(), xm.begin() + stride, xe.begin());
+    res = res && !std::equal(xm.begin() + stride, xm.end(), xe.begin() + stride);
+    COUT("\n  Easy block iter : "<<easy_iter<<", hard block iter : "<<hard_iter);
+
+    if (res) {
+        COUT(emph<<"BiCGStabBatched test passed"<<emph);
+    } else {
+        COUT(alert<<"BiCGStabBatched test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
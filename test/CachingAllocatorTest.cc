@@ -0,0 +1,152 @@
+#include <sstream>
+#include <pthread.h>
+#include <omp.h>
+
+#include "Logger.h"
+#include "Error.h"
+#include "Device.h"
+#include "Scalars.h"
+#include "Vectors.h"
+#include "CachingAllocator.h"
+
+typedef double real;
+
+using namespace std;
+using memory::CachingAllocator;
+using memory::AllocStats;
+
+typedef Device<CPU> DCPU;
+extern const DCPU the_cpu_dev(0);
+
+#ifndef Doxygen_skip
+
+// the temporaries of a mock time step
+template<typename Sca_t, typename Vec_t>
+void time_step(int nves, int p, int p_up)
+{
+    Vec_t x(nves, p), xu(nves, p_up);
+    Sca_t t(nves, p);
+    x.resize(2 * nves);
+    t.resize(nves, p_up);
+
+    real *buffer((real*) the_cpu_dev.Malloc(x.size() * sizeof(real)));
+    the_cpu_dev.Free(buffer);
+}
+
+// the work of a thread that exits, the last block is kept
+void* thread_work(void *arg)
+{
+    for (int ii(0); ii<10; ++ii)
+        CachingAllocator::Free(CachingAllocator::Malloc(1 << 12));
+    *static_cast<void**>(arg) = CachingAllocator::Malloc(1 << 12);
+    return(NULL);
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  CachingAllocator Test:"
+        <<"\n ==============================");
+
+    typedef Scalars<real, DCPU, the_cpu_dev> ScaCPU_t;
+    typedef Vectors<real, DCPU, the_cpu_dev> VecCPU_t;
+
+    bool res(true);
+    ostringstream cpu_o(stringstream::out);
+
+    // size classes and alignment
+    size_t sizes[] = {1, 63, 64, 65, 1000, 4097, 123457, 3 << 20};
+    for (int ii(0); ii<8; ++ii){
+        size_t sc(CachingAllocator::SizeClass(sizes[ii]));
+        res = res && (sc >= sizes[ii]) && (sc % CachingAllocator::ALIGNMENT == 0);
+        res = res && (sc <= sizes[ii] + sizes[ii] / 4 + CachingAllocator::ALIGNMENT);
+
+        void *ptr(CachingAllocator::Malloc(sizes[ii]));
+        res = res && ((size_t) ptr % CachingAllocator::ALIGNMENT == 0);
+        CachingAllocator::Free(ptr);
+    }
+    res = res && (CachingAllocator::Malloc(0) == NULL);
+
+    // a freed block is handed out again
+    void *p1(CachingAllocator::Malloc(1000));
+    CachingAllocator::Free(p1);
+    void *p2(CachingAllocator::Malloc(1010));
+    res = res && (p1 == p2);
+    CachingAllocator::Free(p2);
+
+    // the steady state steps do not allocate from the system
+    int nves(3), p(12), p_up(24), nsteps(5);
+    CachingAllocator::SetPhase("warm up");
+    time_step<ScaCPU_t, VecCPU_t>(nves, p, p_up);
+
+    CachingAllocator::SetPhase("time stepping");
+    for (int ii(0); ii<nsteps; ++ii)
+        time_step<ScaCPU_t, VecCPU_t>(nves, p, p_up);
+
+    AllocStats warm(CachingAllocator::GetPhaseStats("warm up"));
+    AllocStats steady(CachingAllocator::GetPhaseStats("time stepping"));
+    cpu_o<<"\n  Warm up step       : requests = "<<warm.requests
+         <<", system allocations = "<<warm.sys_allocs;
+    cpu_o<<"\n  Next "<<nsteps<<" steps       : requests = "<<steady.requests
+         <<", system allocations = "<<steady.sys_allocs;
+    res = res && (warm.sys_allocs > 0) && (steady.requests > 0);
+    res = res && (steady.sys_allocs == 0) && (steady.live == 0);
+
+    // per thread free lists
+#pragma omp parallel
+    {
+        for (int ii(0); ii<10; ++ii){
+            void *ptr(CachingAllocator::Malloc(1 << 16));
+            CachingAllocator::Free(ptr);
+        }
+    }
+
+    // a block freed by another thread goes back to the cache of the
+    // thread that allocated it
+    void *remote(NULL), *local(NULL);
+#pragma omp parallel num_threads(2)
+    {
+        int tid(omp_get_thread_num());
+        if (tid == 0) remote = CachingAllocator::Malloc(5000);
+#pragma omp barrier
+        if (tid == 1 || omp_get_num_threads() == 1)
+            CachingAllocator::Free(remote);
+#pragma omp barrier
+        if (tid == 0) local = CachingAllocator::Malloc(5000);
+    }
+    res = res && (local == remote);
+    CachingAllocator::Free(local);
+
+    // the cache of an exited thread is released, its blocks that
+    // are still used can be freed
+    size_t cached(CachingAllocator::GetStats().cached);
+    void *orphan(NULL);
+    pthread_t thread;
+    pthread_create(&thread, NULL, &thread_work, &orphan);
+    pthread_join(thread, NULL);
+    res = res && (orphan != NULL) && (CachingAllocator::GetStats().cached == cached);
+    res = res && (CachingAllocator::GetStats().live == (size_t) CachingAllocator::SizeClass(1 << 12));
+    CachingAllocator::Free(orphan);
+    res = res && (CachingAllocator::GetStats().cached == cached);
+
+    AllocStats st(CachingAllocator::GetStats());
+    cpu_o<<"\n  Total              : live = "<<st.live<<" B, peak = "<<st.peak
+         <<" B, cached = "<<st.cached<<" B";
+    res = res && (st.live == 0) && (st.peak > 0) && (st.cached > 0);
+    res = res && (st.sys_allocs < st.requests);
+
+    CachingAllocator::Purge();
+    res = res && (CachingAllocator::GetStats().cached == 0);
+    COUT(cpu_o.str());
+
+    if (res) {
+        COUT(emph<<"CachingAllocator test passed"<<emph);
+    } else {
+        COUT(alert<<"CachingAllocator test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
@@ -30,12 +30,14 @@ int main(int argc, char** argv)
     }
 
     SolverScheme schemes [] = {JacobiBlockExplicit, JacobiBlockGaussSeidel, JacobiBlockImplicit,
-                               GloballyImplicit, UnknownScheme};
+                               GloballyImplicit, GloballyImplicitBDF2, GloballyImplicitSDC,
+                               UnknownScheme};
 
     const char* snames[] = {"JacobiBlockExplicit", "JacobiBlockGaussSeidel", "JacobiBlockImplicit",
-                            "GloballyImplicit", "UnknownScheme"};
+                            "GloballyImplicit", "GloballyImplicitBDF2", "GloballyImplicitSDC",
+                            "UnknownScheme"};
 
-    N = 5;
+    N = 7;
     for (int i=0; i<N; ++i){
      	strm stream;
         stream<<schemes[i];
@@ -46,6 +48,20 @@ int main(int argc, char** argv)
         testtools::AssertTrue(sc==schemes[i],msg, "bad enum");
     }
 
+    PrecondScheme preconds [] = {DiagonalSpectral, TwoLevelSpectral, NoPrecond, UnknownPrecond};
+    const char* pnames[] = {"DiagonalSpectral", "TwoLevelSpectral", "NoPrecond", "UnknownPrecond"};
+
+    N = 4;
+    for (int i=0; i<N; ++i){
+     	strm stream;
+        stream<<preconds[i];
+        string msg("testing ");
+        msg += pnames[i];
+        testtools::AssertTrue(stream.str()==pnames[i], msg, "bad string");
+        PrecondScheme pc = EnumifyPrecond(pnames[i]);
+        testtools::AssertTrue(pc==preconds[i],msg, "bad enum");
+    }
+
     COUT(emph<<"** EnumTest passed **"<<emph<<std::endl);
     VES3D_FINALIZE();
 }
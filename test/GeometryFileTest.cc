@@ -0,0 +1,117 @@
+#include <cstdio>
+#include <fstream>
+
+#include "Logger.h"
+#include "Error.h"
+#include "DataIO.h"
+#include "GeometryFile.h"
+
+typedef double real;
+
+using namespace std;
+
+typedef GeometryFile<real> Geo_t;
+
+#ifndef Doxygen_skip
+
+// the vesicles are on a 4x4x4 grid (in a shuffled order), their
+// scale is the id and their properties depend on the id
+const int NV = 64, NPROPS = 3;
+
+real property(real id, int ip){ return 10 * ip + id; }
+
+void fill(vector<real> &spec, vector<real> &props)
+{
+    int nf(Geo_t::NUM_FIELDS);
+    spec.assign(NV * nf, 0);
+    props.resize(NV * NPROPS);
+    for (int iv(0); iv<NV; ++iv){
+        int cell((iv * 37) % NV);
+        spec[iv * nf + 1] = iv;
+        spec[iv * nf + 2] = cell % 4;
+        spec[iv * nf + 3] = (cell / 4) % 4;
+        spec[iv * nf + 4] = cell / 16;
+        for (int ip(0); ip<NPROPS; ++ip)
+            props[iv * NPROPS + ip] = property(iv, ip);
+    }
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  GeometryFile Test:"
+        <<"\n ==============================");
+
+    int rank;
+    MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+    int nf(Geo_t::NUM_FIELDS);
+    string fname("GeometryFileTest_out.bin");
+
+    bool res(true);
+    if (rank == 0){
+        vector<real> spec, props;
+        fill(spec, props);
+        Geo_t gw(VES3D_COMM_SELF);
+        res = res && (gw.Write(fname, spec, props) == ErrorEvent::Success);
+
+        // the first and last vesicles are at the corners of the grid
+        res = res && (spec[2] == 0) && (spec[3] == 0) && (spec[4] == 0);
+        res = res && (spec[(NV-1) * nf + 2] == 3) && (spec[(NV-1) * nf + 3] == 3) &&
+            (spec[(NV-1) * nf + 4] == 3);
+    }
+    MPI_Barrier(VES3D_COMM_WORLD);
+
+    res = res && Geo_t::IsGeometryFile(fname);
+    res = res && !Geo_t::IsGeometryFile(FullPath("precomputed/geometry_spec_periodic.txt"));
+
+    Geo_t gr;
+    vector<real> spec, props;
+    res = res && (gr.Read(fname, spec, props) == ErrorEvent::Success);
+    res = res && (gr.total_vesicles() == NV) && (gr.num_props() == NPROPS);
+    res = res && (spec.size() == gr.num_vesicles() * nf);
+    res = res && (props.size() == gr.num_vesicles() * NPROPS);
+
+    // the properties are read with their vesicle
+    for (size_t iv(0); iv<gr.num_vesicles() && res; ++iv)
+        for (int ip(0); ip<NPROPS; ++ip)
+            res = res && (props[iv * NPROPS + ip] == property(spec[iv * nf + 1], ip));
+
+    // all the vesicles are read once
+    real sum(0), glb_sum(0);
+    unsigned long count(gr.num_vesicles()), glb_count(0);
+    for (size_t iv(0); iv<gr.num_vesicles(); ++iv) sum += spec[iv * nf + 1];
+    MPI_Allreduce(&sum, &glb_sum, 1, MPI_DOUBLE, MPI_SUM, VES3D_COMM_WORLD);
+    MPI_Allreduce(&count, &glb_count, 1, MPI_UNSIGNED_LONG, MPI_SUM, VES3D_COMM_WORLD);
+    res = res && (glb_count == NV) && (glb_sum == NV * (NV - 1) / 2);
+
+    // a truncated file is an error
+    MPI_Barrier(VES3D_COMM_WORLD);
+    if (rank == 0){
+        ifstream in(fname.c_str(), ios::binary);
+        string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        in.close();
+        ofstream out(fname.c_str(), ios::binary | ios::trunc);
+        out.write(content.data(), content.size() - 10);
+    }
+    MPI_Barrier(VES3D_COMM_WORLD);
+    Error_t err(gr.Read(fname, spec, props));
+    res = res && (err != ErrorEvent::Success);
+
+    MPI_Barrier(VES3D_COMM_WORLD);
+    if (rank == 0) remove(fname.c_str());
+
+    int loc(!res), glb(0);
+    MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MAX, VES3D_COMM_WORLD);
+    res = !glb;
+
+    if (res) {
+        COUT(emph<<"GeometryFile test passed"<<emph);
+    } else {
+        COUT(alert<<"GeometryFile test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
@@ -32,6 +32,9 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <cmath>
+#include <vector>
+
 #include "InterfacialVelocity.h"
 #include "ves3d_common.h"
 #include "Vectors.h"
@@ -77,6 +80,21 @@ int main(int argc, char** argv){
     sim_par.expand_templates();
     COUT(sim_par);
 
+    INFO("Quadrature of the SDC weights");
+    for (int M(2); M<=5; ++M){
+        std::vector<value_type> W;
+        IntVel_t::SDCWeights(M, W);
+        for (int m(1); m<=M; ++m)
+            for (int k(0); k<M; ++k){
+                // the polynomials of degree less than M are exact
+                value_type q(0), a((m-1)*1.0/M), b(m*1.0/M);
+                for (int j(1); j<=M; ++j)
+                    q += W[(m-1)*M+j-1]*pow(j*1.0/M, k);
+                value_type exact((pow(b, k+1) - pow(a, k+1))/(k+1));
+                ASSERT(fabs(q-exact)<1e-12, "SDC weights of "<<M<<" nodes are not exact for degree "<<k);
+            }
+    }
+
     {
         Vec_t v1(nves,p), v2(nves,p), v3(nves,p);
         Sca_t t1(nves,p), t2(nves,p), t3(nves,p);
@@ -124,6 +142,30 @@ int main(int argc, char** argv){
         err = MaxAbs(dxv);
         COUT("Difference in solving for position or velocity: "<<err);
         ASSERT(err<tol,"large error between velocity and position solve");
+
+        INFO("Mixed precision iterative refinement (fixed geometry)");
+        value_type time_tol(sim.run_params()->time_tol);
+        Logger::Tic();
+        F->updateImplicit(*E->S_,ts,dxx);
+        double t_double(Logger::Toc());
+
+        sim.run_params()->mixed_precision=true;
+        E->ReinitInterfacialVelocity();
+        F = E->F_;
+        Vec_t dxm(nves,p);
+        Logger::Tic();
+        Error_t ierr(F->updateImplicit(*E->S_,ts,dxm));
+        double t_mixed(Logger::Toc());
+        ASSERT(ierr==ErrorEvent::Success,"refinement did not converge in "
+            <<sim.run_params()->refine_iter_max<<" steps");
+
+        // both solves are to time_tol, their difference is of the
+        // same order
+        axpy(-1.0,dxx,dxm,dxm);
+        err = MaxAbs(dxm)/MaxAbs(dxx);
+        COUT("Mixed precision: relative difference "<<err<<", wall time "
+            <<t_mixed<<"s (double precision "<<t_double<<"s)");
+        ASSERT(err<10*time_tol,"large error between mixed and double precision solve");
     }
     VES3D_FINALIZE();
 }
@@ -0,0 +1,169 @@
+#include <sstream>
+#include <cstdio>
+
+#include "Logger.h"
+#include "Error.h"
+#include "Device.h"
+#include "Array.h"
+#include "DataIO.h"
+#include "Vectors.h"
+#include "Parameters.h"
+#include "VesicleProps.h"
+#include "ParallelCheckpoint.h"
+
+typedef double real;
+
+using namespace std;
+
+typedef Device<CPU> DCPU;
+extern const DCPU the_cpu_dev(0);
+
+typedef Array<real, DCPU, the_cpu_dev> Arr_t;
+typedef Vectors<real, DCPU, the_cpu_dev> Vec_t;
+typedef VesicleProperties<Arr_t> VProp_t;
+typedef ParallelCheckpoint<Vec_t, VProp_t> PCheckpoint_t;
+
+#ifndef Doxygen_skip
+
+// the values depend on the vesicle ID (not on the process)
+real position(size_t id, size_t idx){ return id + 1e-4 * idx; }
+real property(size_t id, int ip){ return 10 * ip + id; }
+
+void fill(size_t first, Vec_t &x, VProp_t &props)
+{
+    size_t vsize(x.getTheDim() * x.getStride());
+    for (size_t iv(0); iv<x.getNumSubs(); ++iv)
+        for (size_t ii(0); ii<vsize; ++ii)
+            x.begin()[iv * vsize + ii] = position(first + iv, ii);
+
+    for (int ip(0); ip<VProp_t::n_props; ++ip){
+        Arr_t *prp(props.getPropIdx(ip));
+        prp->resize(x.getNumSubs());
+        for (size_t iv(0); iv<prp->size(); ++iv)
+            prp->begin()[iv] = property(first + iv, ip);
+    }
+    props.update();
+}
+
+bool check(const PCheckpoint_t &pc, const Vec_t &x, VProp_t &props)
+{
+    bool res(x.getNumSubs() == pc.num_vesicles());
+    size_t vsize(x.getTheDim() * x.getStride());
+    size_t first(pc.first_vesicle());
+
+    for (size_t iv(0); iv<x.getNumSubs(); ++iv)
+        for (size_t ii(0); ii<vsize; ++ii)
+            res = res && (x.begin()[iv * vsize + ii] == position(first + iv, ii));
+
+    for (int ip(0); ip<VProp_t::n_props; ++ip){
+        Arr_t *prp(props.getPropIdx(ip));
+        res = res && (prp->size() == x.getNumSubs());
+        for (size_t iv(0); iv<prp->size(); ++iv)
+            res = res && (prp->begin()[iv] == property(first + iv, ip));
+    }
+    return res;
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  ParallelCheckpoint Test:"
+        <<"\n ==============================");
+
+    int nproc(1), rank(0);
+    MPI_Comm_size(VES3D_COMM_WORLD, &nproc);
+    MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+
+    bool res(true);
+    string fname("ParallelCheckpointTest.chk");
+    int p(6);
+
+    // uneven number of vesicles on each process
+    Parameters<real> params;
+    params.sh_order = p;
+    params.n_surfs  = rank + 2;
+    params.ts       = 1e-3;
+
+    Vec_t x(rank + 2, p);
+    VProp_t props;
+    size_t first(rank * (rank + 3) / 2); // sum of (r + 2) for lower ranks
+    fill(first, x, props);
+
+    // the calls are collective, they are not short circuited
+    PCheckpoint_t pcw;
+    Error_t err(pcw.Write(fname, params, x, props));
+    bool is_pc(PCheckpoint_t::IsParallelCheckpoint(fname));
+    res = res && (err == ErrorEvent::Success) && is_pc;
+    res = res && (pcw.first_vesicle() == first);
+    res = res && (pcw.total_vesicles() == size_t((nproc * (nproc + 3)) / 2));
+
+    // the same number of processes gets the same vesicles
+    {
+        PCheckpoint_t pc;
+        Parameters<real> pr;
+        Vec_t xr(0, p);
+        VProp_t pp;
+        err = pc.ReadHeader(fname, pr);
+        res = res && (err == ErrorEvent::Success);
+        res = res && (pr.ts == params.ts) && (pr.sh_order == p);
+        err = pc.ReadState(fname, xr, pp);
+        res = res && (err == ErrorEvent::Success);
+        res = res && (pc.first_vesicle() == first) && check(pc, xr, pp);
+    }
+
+    // a single process gets all the vesicles (and with more than
+    // one process, the vesicles are redistributed)
+    {
+        PCheckpoint_t pc(VES3D_COMM_SELF);
+        Parameters<real> pr;
+        Vec_t xr(0, p);
+        VProp_t pp;
+        err = pc.ReadHeader(fname, pr);
+        res = res && (err == ErrorEvent::Success);
+        err = pc.ReadState(fname, xr, pp);
+        res = res && (err == ErrorEvent::Success);
+        res = res && (pc.first_vesicle() == 0) && (pc.num_vesicles() == pcw.total_vesicles());
+        res = res && check(pc, xr, pp);
+    }
+
+    // a mismatched sh_order is an error
+    {
+        PCheckpoint_t pc;
+        Parameters<real> pr;
+        Vec_t xr(0, p + 2);
+        VProp_t pp;
+        pc.ReadHeader(fname, pr);
+        err = pc.ReadState(fname, xr, pp);
+        res = res && (err != ErrorEvent::Success);
+    }
+
+    // other files are not parallel checkpoints
+    {
+        stringstream ss;
+        params.pack(ss, Streamable::BIN);
+        if (rank == 0) DataIO::DumpFile("ParallelCheckpointTest.bin", ss);
+        MPI_Barrier(VES3D_COMM_WORLD);
+        is_pc = PCheckpoint_t::IsParallelCheckpoint("ParallelCheckpointTest.bin");
+        res = res && !is_pc;
+    }
+
+    int loc(res), glb(0);
+    MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MIN, VES3D_COMM_WORLD);
+    res = glb;
+
+    if (rank == 0){
+        remove(fname.c_str());
+        remove("ParallelCheckpointTest.bin");
+    }
+
+    if (res) {
+        COUT(emph<<"ParallelCheckpoint test passed"<<emph);
+    } else {
+        COUT(alert<<"ParallelCheckpoint test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
@@ -34,6 +34,7 @@
 
 #include "Parameters.h"
 #include <sstream>
+#include <cstddef>
 
 template<typename P>
 class ParametersTest
@@ -76,9 +77,12 @@ bool ParametersTest<P>::TestStream(const P &p)
     ASSERT(p.ts == pc.ts , "incorrect ts");
     ASSERT(p.time_tol == pc.time_tol , "incorrect time_tol");
     ASSERT(p.time_iter_max == pc.time_iter_max , "incorrect time_iter_max");
+    ASSERT(p.time_sdc_order == pc.time_sdc_order , "incorrect time_sdc_order");
     ASSERT(p.solve_for_velocity == pc.solve_for_velocity , "incorrect solve_for_velocity");
+    ASSERT(p.mixed_precision == pc.mixed_precision , "incorrect mixed_precision");
     ASSERT(p.scheme == pc.scheme , "incorrect scheme");
     ASSERT(p.time_precond == pc.time_precond , "incorrect time_precond");
+    ASSERT(p.precond_coarse_order == pc.precond_coarse_order , "incorrect precond_coarse_order");
     ASSERT(p.bg_flow == pc. bg_flow , "incorrect  bg_flow");
     ASSERT(p.singular_stokes == pc. singular_stokes , "incorrect  singular_stokes");
     ASSERT(p.rep_maxit == pc.rep_maxit , "incorrect rep_maxit");
@@ -89,9 +93,27 @@ bool ParametersTest<P>::TestStream(const P &p)
     ASSERT(p.bg_flow_param == pc.bg_flow_param , "incorrect bg_flow_param");
     ASSERT(p.interaction_upsample == pc.interaction_upsample , "incorrect interaction_upsample");
     ASSERT(p.checkpoint == pc.checkpoint , "incorrect checkpoint");
+    ASSERT(p.checkpoint_bin == pc.checkpoint_bin , "incorrect checkpoint_bin");
+    ASSERT(p.checkpoint_parallel == pc.checkpoint_parallel , "incorrect checkpoint_parallel");
     ASSERT(p.checkpoint_stride == pc.checkpoint_stride , "incorrect checkpoint_stride");
     ASSERT(p.checkpoint_file_name == pc.checkpoint_file_name , "incorrect checkpoint_file_name");
     ASSERT(p.load_checkpoint == pc.load_checkpoint , "incorrect load_checkpoint");
+    ASSERT(p.trajectory_file_name == pc.trajectory_file_name , "incorrect trajectory_file_name");
+    ASSERT(p.trajectory_stride == pc.trajectory_stride , "incorrect trajectory_stride");
+    ASSERT(p.trajectory_quantize == pc.trajectory_quantize , "incorrect trajectory_quantize");
+    ASSERT(p.vtk_order == pc.vtk_order , "incorrect vtk_order");
+    ASSERT(p.vtk_collective == pc.vtk_collective , "incorrect vtk_collective");
+    ASSERT(p.vtk_float == pc.vtk_float , "incorrect vtk_float");
+    ASSERT(p.snapshot_stride == pc.snapshot_stride , "incorrect snapshot_stride");
+    ASSERT(p.snapshot_count == pc.snapshot_count , "incorrect snapshot_count");
+    ASSERT(p.rollback_max == pc.rollback_max , "incorrect rollback_max");
+    ASSERT(p.refine_iter_max == pc.refine_iter_max , "incorrect refine_iter_max");
+    ASSERT(p.time_adap_doubling == pc.time_adap_doubling , "incorrect time_adap_doubling");
+    ASSERT(p.rheology_file_name == pc.rheology_file_name , "incorrect rheology_file_name");
+    ASSERT(p.rheology_stride == pc.rheology_stride , "incorrect rheology_stride");
+    ASSERT(p.rheology_bins == pc.rheology_bins , "incorrect rheology_bins");
+    ASSERT(p.telemetry_file_name == pc.telemetry_file_name , "incorrect telemetry_file_name");
+    ASSERT(p.profile_step == pc.profile_step , "incorrect profile_step");
     ASSERT(p.error_factor == pc.error_factor , "incorrect error_factor");
     ASSERT(p.num_threads == pc.num_threads , "incorrect num_threads");
     ASSERT(p.excess_density == pc.excess_density , "incorrect excess_density");
@@ -100,6 +122,57 @@ bool ParametersTest<P>::TestStream(const P &p)
 
     pc.pack(s2,P::Streamable::ASCII);
     ASSERT(s1.str()==s2.str(),"different streams");
+
+    // binary round trip is exact
+    std::stringstream b1,b2;
+    p.pack(b1, P::Streamable::BIN);
+    ASSERT(P::Streamable::peek_format(b1)==P::Streamable::BIN, "bad format detection");
+    P pb(b1, P::Streamable::BIN);
+    ASSERT(p.ts == pb.ts , "incorrect ts");
+    ASSERT(p.rep_type == pb.rep_type , "incorrect rep_type");
+    ASSERT(p.checkpoint_bin == pb.checkpoint_bin , "incorrect checkpoint_bin");
+    ASSERT(p.checkpoint_parallel == pb.checkpoint_parallel , "incorrect checkpoint_parallel");
+    ASSERT(p.vesicle_props_file == pb.vesicle_props_file , "incorrect vesicle_props_file");
+    ASSERT(p.write_vtk == pb.write_vtk , "incorrect write_vtk");
+    ASSERT(p.trajectory_file_name == pb.trajectory_file_name , "incorrect trajectory_file_name");
+    ASSERT(p.trajectory_quantize == pb.trajectory_quantize , "incorrect trajectory_quantize");
+    ASSERT(p.vtk_order == pb.vtk_order , "incorrect vtk_order");
+    ASSERT(p.vtk_collective == pb.vtk_collective , "incorrect vtk_collective");
+    ASSERT(p.snapshot_stride == pb.snapshot_stride , "incorrect snapshot_stride");
+    ASSERT(p.rollback_max == pb.rollback_max , "incorrect rollback_max");
+    ASSERT(p.refine_iter_max == pb.refine_iter_max , "incorrect refine_iter_max");
+    ASSERT(p.time_adap_doubling == pb.time_adap_doubling , "incorrect time_adap_doubling");
+    ASSERT(p.rheology_file_name == pb.rheology_file_name , "incorrect rheology_file_name");
+    ASSERT(p.rheology_bins == pb.rheology_bins , "incorrect rheology_bins");
+    ASSERT(p.telemetry_file_name == pb.telemetry_file_name , "incorrect telemetry_file_name");
+    ASSERT(p.profile_step == pb.profile_step , "incorrect profile_step");
+    ASSERT(p.gravity_field[1] == pb.gravity_field[1] , "incorrect gravity_field");
+    pb.pack(b2, P::Streamable::BIN);
+    ASSERT(b1.str()==b2.str(),"different binary streams");
+    ASSERT(b1.str().size()<s1.str().size(),"binary stream is larger than ascii");
+
+    // data of a newer format is rejected
+    std::string nb(b1.str());
+    int32_t fmt(P::BIN_FORMAT + 1);
+    nb.replace(offsetof(Streamable::BinHeader, format), sizeof(fmt),
+        reinterpret_cast<const char*>(&fmt), sizeof(fmt));
+    std::stringstream b3(nb);
+    P pn;
+    ASSERT(pn.unpack(b3, P::Streamable::BIN)==ErrorEvent::IOBadStream, "newer format is not rejected");
+
+    // data of the first format has none of the fields of the later
+    // formats, that keep their defaults
+    std::string ob(b1.str(), 0, b1.str().size() - sizeof(int32_t) - sizeof(int8_t));
+    fmt = 1;
+    ob.replace(offsetof(Streamable::BinHeader, format), sizeof(fmt),
+        reinterpret_cast<const char*>(&fmt), sizeof(fmt));
+    std::stringstream b4(ob);
+    P po;
+    ASSERT(po.unpack(b4, P::Streamable::BIN)==ErrorEvent::Success, "failed to unpack the first format");
+    ASSERT(po.rollback_max == p.rollback_max , "incorrect rollback_max");
+    ASSERT(po.refine_iter_max == 10 , "incorrect default refine_iter_max");
+    ASSERT(!po.time_adap_doubling , "incorrect default time_adap_doubling");
+
     return true;
 }
 
@@ -113,6 +186,25 @@ int main(int argc, char** argv){
 		    "-l", "a.txt",
 		    "--rep-upsample",
 		    "--interaction-upsample",
+		    "--mixed-precision",
+		    "--time-adap-doubling",
+		    "--checkpoint-bin",
+		    "--checkpoint-parallel",
+		    "--trajectory-file", "traj_{{sh_order}}.bin",
+		    "--trajectory-stride", "0.5",
+		    "--trajectory-quantize",
+		    "--vtk-order", "16",
+		    "--vtk-collective",
+		    "--snapshot-stride", "5",
+		    "--rollback-max", "2",
+		    "--refine-iter-max", "7",
+		    "--rheology-file", "rheo_{{sh_order}}.txt",
+		    "--rheology-stride", "0.25",
+		    "--rheology-bins", "12",
+		    "--telemetry-file", "telemetry.json",
+		    "--profile-step",
+		    "--precond-coarse-order", "4",
+		    "--time-sdc-order", "3",
 		    "--excess-density", "5",
             "--gravity-field", "1.1 2e1 -3",
             "--rep-type", "Box",
@@ -0,0 +1,139 @@
+#include <cmath>
+#include <omp.h>
+
+#include "Logger.h"
+#include "Error.h"
+#include "Profiler.h"
+
+using namespace std;
+
+#ifndef Doxygen_skip
+
+void Wait(double sec)
+{
+    double tic(GETSECONDS());
+    while (GETSECONDS() - tic < sec);
+}
+
+void Inner()
+{
+    Profiler::Scope scope("inner");
+    Wait(0.01);
+    scope.Stop("", 10);
+}
+
+void Outer()
+{
+    Profiler::Scope scope("outer");
+    Wait(0.01);
+    Inner();
+    Inner();
+    scope.Stop("", 5);
+}
+
+const ProfileStat* Find(const vector<ProfileStat> &stats, const string &path)
+{
+    for (size_t ii(0); ii<stats.size(); ++ii)
+        if (stats[ii].path == path) return &stats[ii];
+    return NULL;
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  Profiler Test:"
+        <<"\n ==============================");
+
+    int rank, np;
+    MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+    MPI_Comm_size(VES3D_COMM_WORLD, &np);
+
+    // the nested scopes, the flop include those of the children
+    Outer();
+    vector<ProfileStat> stats;
+    Profiler::Collect(stats);
+
+    bool res(true);
+    const ProfileStat *o(Find(stats, "outer")), *i(Find(stats, "outer/inner"));
+    res = res && o && i && (o->depth == 0) && (i->depth == 1);
+    res = res && (o->calls == 1) && (i->calls == 2);
+    res = res && (o->flop == 25) && (i->flop == 20);
+    res = res && (o->incl[1] >= 0.03) && (i->incl[1] >= 0.02);
+    res = res && (fabs(o->excl[1] - (o->incl[1] - i->incl[1])) < 1e-12);
+    res = res && (o->excl[1] >= 0.01) && (o->excl[1] <= o->incl[1]);
+    res = res && (i->incl[1] <= o->incl[1]);
+
+    // the prefix is added to the name and an unstopped scope is
+    // closed at the end of its block
+    {
+        Profiler::Scope scope("prefixed");
+        scope.Stop("P_", 0);
+        Profiler::Scope open("open");
+    }
+
+    // each thread has its own stack, the paths of the threads are
+    // merged
+    int nthreads(1);
+    bool tic_ok(true);
+    double outer_tic(Logger::Tic());
+#pragma omp parallel
+    {
+#pragma omp master
+        nthreads = omp_get_num_threads();
+
+        Profiler::Scope scope("parallel");
+        Logger::Tic();
+        Inner();
+        double toc(Logger::Toc());
+#pragma omp critical
+        tic_ok = tic_ok && (toc >= 0.01);
+    }
+    double outer_toc(Logger::Toc());
+    res = res && tic_ok && (outer_toc >= 0.01) && (outer_tic > 0);
+
+    // some work of a process, a path of the first process only
+    {
+        Profiler::Scope scope("imbalance");
+        Wait(0.01 * (rank + 1));
+    }
+    if (rank == 0){
+        Profiler::Scope scope("first");
+    }
+
+    Profiler::Collect(stats);
+    const ProfileStat *p(Find(stats, "P_prefixed")), *op(Find(stats, "open"));
+    const ProfileStat *par(Find(stats, "parallel")), *pi(Find(stats, "parallel/inner"));
+    const ProfileStat *im(Find(stats, "imbalance")), *f(Find(stats, "first"));
+    res = res && p && op && (p->calls == 1) && (op->calls == 1);
+    res = res && par && pi && (par->calls == nthreads) && (pi->calls == nthreads);
+    res = res && (pi->flop == 10 * nthreads);
+    res = res && im && (im->incl[0] >= 0.01) && (im->incl[2] >= 0.01 * np);
+    res = res && (im->imbalance >= 1) && (im->incl[0] <= im->incl[1]) &&
+        (im->incl[1] <= im->incl[2]);
+    res = res && f && (f->calls == 1.0 / np);
+    res = res && (f->incl[0] == 0 || np == 1);
+
+    // clearing zeros the records
+    Profiler::Clear();
+    Profiler::Collect(stats);
+    for (size_t ii(0); ii<stats.size(); ++ii)
+        res = res && (stats[ii].calls == 0) && (stats[ii].incl[2] == 0);
+
+    Outer();
+    Profiler::Report(SortFunName);
+
+    int loc(!res), glb(0);
+    MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MAX, VES3D_COMM_WORLD);
+    res = !glb;
+
+    if (res) {
+        COUT(emph<<"Profiler test passed"<<emph);
+    } else {
+        COUT(alert<<"Profiler test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
@@ -0,0 +1,200 @@
+#include <cmath>
+#include <sstream>
+
+#include "Logger.h"
+#include "Error.h"
+#include "Device.h"
+#include "DataIO.h"
+#include "HelperFuns.h"
+#include "Scalars.h"
+#include "Vectors.h"
+#include "OperatorsMats.h"
+#include "Parameters.h"
+#include "Surface.h"
+#include "Rheology.h"
+
+typedef double real;
+
+using namespace std;
+
+typedef Device<CPU> DCPU;
+extern const DCPU the_cpu_dev(0);
+
+typedef Scalars<real, DCPU, the_cpu_dev> Sca_t;
+typedef Sca_t::array_type Arr_t;
+typedef Vectors<real, DCPU, the_cpu_dev> Vec_t;
+typedef Surface<Sca_t, Vec_t> Sur_t;
+typedef OperatorsMats<Arr_t> Mats_t;
+typedef Rheology<Sur_t> Rheo_t;
+
+#ifndef Doxygen_skip
+
+// the second moments of the ellipsoid with semi-axes (a, b, b)
+// rotated by alpha in the x-z plane
+void ellipsoid_moments(real a, real b, real alpha, real *mom)
+{
+    real c(cos(alpha)), s(sin(alpha));
+    real a2(a * a / 5), b2(b * b / 5);
+    mom[0] = a2 * c * c + b2 * s * s;
+    mom[1] = 0;
+    mom[2] = (a2 - b2) * c * s;
+    mom[3] = b2;
+    mom[4] = 0;
+    mom[5] = a2 * s * s + b2 * c * c;
+}
+
+bool check_eig(const real *a)
+{
+    real lambda[3], vec[9];
+    Rheo_t::SymEig3(a, lambda, vec);
+    real m[3][3] = {{a[0], a[1], a[2]}, {a[1], a[3], a[4]}, {a[2], a[4], a[5]}};
+
+    bool res(lambda[0] <= lambda[1] && lambda[1] <= lambda[2]);
+    for (int jj(0); jj<3; ++jj)
+        for (int ii(0); ii<3; ++ii){
+            real av(0);
+            for (int k(0); k<3; ++k) av += m[ii][k] * vec[k * 3 + jj];
+            res = res && fabs(av - lambda[jj] * vec[ii * 3 + jj]) < 1e-12;
+        }
+    return res;
+}
+
+// each vesicle is the first shape of the gallery shifted along x by
+// three times its index
+void fill(int p, int nv, Vec_t &x)
+{
+    DataIO io;
+    vector<real> shapes;
+    io.ReadDataStl(FullPath("precomputed/shape_gallery_6.txt"), shapes, DataIO::ASCII);
+    size_t stride(x.getStride());
+    ASSERT(p == 6 && shapes.size() >= DIM * stride, "The gallery should be of order 6");
+
+    for (int iv(0); iv<nv; ++iv)
+        for (size_t ii(0); ii<DIM * stride; ++ii)
+            x.getSubN_begin(iv)[ii] = shapes[ii] + (ii < stride ? 3 * iv : 0);
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  Rheology Test:"
+        <<"\n ==============================");
+
+    int np(1);
+    MPI_Comm_size(VES3D_COMM_WORLD, &np);
+
+    // the eigen decomposition and the shape of an ellipsoid
+    bool res(true);
+    real diag[6] = {3, 0, 0, 1, 0, 2};
+    real full[6] = {2, -1, 0.5, 3, 0.25, 1};
+    res = res && check_eig(diag) && check_eig(full);
+
+    real mom[6], D, theta;
+    ellipsoid_moments(2, 1, 0.3, mom);
+    Rheo_t::Shape(mom, D, theta);
+    res = res && fabs(D - 1.0 / 3) < 1e-12 && fabs(theta - 0.3) < 1e-12;
+    ellipsoid_moments(2, 1, 1.4, mom);
+    Rheo_t::Shape(mom, D, theta);
+    res = res && fabs(theta - 1.4) < 1e-12;
+    ellipsoid_moments(2, 1, 2.0, mom);
+    Rheo_t::Shape(mom, D, theta);
+    res = res && fabs(theta - (2.0 - M_PI)) < 1e-12;
+
+    // the stresslet of a uniform pressure is the volume times the identity
+    Parameters<real> params;
+    params.sh_order = 6;
+    params.upsample_freq = 6;
+    Mats_t mats(true, params);
+
+    int p(6), nv(2), nbins(5);
+    Vec_t x(nv, p);
+    fill(p, nv, x);
+    Sur_t S(p, mats, &x);
+
+    Arr_t moms, strs;
+    S.moments(moms, 0);
+    S.stresslet(S.getNormal(), strs);
+    for (int iv(0); iv<nv; ++iv){
+        real V(moms.begin()[2 * iv + 1]);
+        const real *s(strs.begin() + 9 * iv);
+        res = res && fabs(s[0]) < 1e-6 * V && fabs(s[1]) < 1e-6 * V && fabs(s[2]) < 1e-6 * V;
+        res = res && fabs(s[3] / V - 1) < 1e-6 && fabs(s[6] / V - 1) < 1e-6 &&
+            fabs(s[8] / V - 1) < 1e-6;
+        res = res && fabs(s[4]) < 1e-6 * V && fabs(s[5]) < 1e-6 * V && fabs(s[7]) < 1e-6 * V;
+    }
+
+    // the aggregates over the processes and the centroid velocity
+    Rheo_t rheo(nbins);
+    res = res && (rheo.Compute(S, S.getNormal(), 0) == ErrorEvent::Success);
+    res = res && (rheo.num_vesicles() == size_t(nv * np));
+
+    real vel[3];
+    rheo.mean_velocity(vel);
+    res = res && (vel[0] == 0) && (vel[1] == 0) && (vel[2] == 0);
+
+    Vec_t &xm(S.getPositionModifiable());
+    for (int iv(0); iv<nv; ++iv)
+        for (size_t ii(0); ii<x.getStride(); ++ii)
+            xm.getSubN_begin(iv)[ii] += 1;
+    res = res && (rheo.Compute(S, S.getNormal(), 0.5) == ErrorEvent::Success);
+
+    rheo.mean_velocity(vel);
+    res = res && fabs(vel[0] - 2) < 1e-10 && fabs(vel[1]) < 1e-10 && fabs(vel[2]) < 1e-10;
+
+    // no velocity after the vesicles are exchanged
+    rheo.ResetHistory();
+    res = res && (rheo.Compute(S, S.getNormal(), 1) == ErrorEvent::Success);
+    rheo.mean_velocity(vel);
+    res = res && (vel[0] == 0) && (vel[1] == 0) && (vel[2] == 0);
+
+    // a vesicle that leaves a periodic domain and enters from the
+    // other side moved by the shortest displacement
+    Rheo_t prheo(nbins, 4);
+    prheo.Compute(S, S.getNormal(), 0);
+    for (int iv(0); iv<nv; ++iv)
+        for (size_t ii(0); ii<x.getStride(); ++ii)
+            xm.getSubN_begin(iv)[ii] += 3.5;
+    prheo.Compute(S, S.getNormal(), 0.5);
+    prheo.mean_velocity(vel);
+    res = res && fabs(vel[0] + 1) < 1e-10 && fabs(vel[1]) < 1e-10 && fabs(vel[2]) < 1e-10;
+
+    real V(moms.begin()[1]);
+    const real *bulk(rheo.stresslet());
+    res = res && fabs(bulk[0] / (nv * np * V) - 1) < 1e-6 && fabs(bulk[1]) < 1e-6 * V;
+
+    real nd(0), ni(0);
+    for (int ii(0); ii<nbins; ++ii){
+        nd += rheo.deformation_hist()[ii];
+        ni += rheo.inclination_hist()[ii];
+    }
+    res = res && (nd == nv * np) && (ni == nv * np);
+    res = res && (rheo.mean_deformation() > 0) && (rheo.mean_deformation() < 1);
+
+    // one line of the time series per call
+    stringstream ss;
+    rheo.WriteHeader(ss);
+    rheo.WriteLine(ss);
+    string header, line, word;
+    getline(ss, header);
+    getline(ss, line);
+    istringstream hs(header), ls(line);
+    int nh(-1), nl(0);
+    while (hs>>word) ++nh;
+    while (ls>>word) ++nl;
+    res = res && (header[0] == '#') && (nh == nl) && (nl == Rheo_t::NUM_FIELDS + 2 * nbins);
+
+    int loc(!res), glb(0);
+    MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MAX, VES3D_COMM_WORLD);
+    res = !glb;
+
+    if (res) {
+        COUT(emph<<"Rheology test passed"<<emph);
+    } else {
+        COUT(alert<<"Rheology test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
@@ -7,6 +7,7 @@
  */
 
 #include "Logger.h"
+#include "SubView.h"
 #include <cstring>
 #include <iostream>
 #include <sstream>
@@ -21,6 +22,7 @@ class ScalarsTest
     bool TestResize();
     bool TestReplicate();
     bool TestStream();
+    bool TestSwapView();
 };
 
 template<typename Container>
@@ -29,7 +31,8 @@ bool ScalarsTest<Container>::PerformAll()
     bool test_result;
     test_result = TestResize() &&
         TestReplicate() &&
-	TestStream();
+	TestStream() &&
+        TestSwapView();
 
     if (test_result){
         COUT(emph<<" *** The container "
@@ -153,3 +156,42 @@ bool ScalarsTest<Container>::TestStream()
 
     return true;
 }
+
+template<typename Container>
+bool ScalarsTest<Container>::TestSwapView()
+{
+    COUT(". Swap and view");
+    int p(6), nsubs(4);
+
+    Container sa(nsubs, p), sb(1, p+2);
+    typedef typename Container::value_type T;
+    const T *da(sa.begin()), *db(sb.begin());
+    size_t la(sa.size()), lb(sb.size());
+
+    sa.swap(sb);
+    ASSERT(sa.begin()==db && sb.begin()==da, "swap should not copy");
+    ASSERT(sa.size()==lb && sb.size()==la, "bad swap");
+    ASSERT(sa.getNumSubs()==1 && sb.getNumSubs()==nsubs, "bad swap");
+    ASSERT(sa.getShOrder()==p+2 && sb.getShOrder()==p, "bad swap");
+
+    // view of the third sub-component
+    SubView<Container> sv(sb, 2);
+    ASSERT(sv.isView() && !sb.isView(), "bad view");
+    ASSERT(sv.begin()==sb.getSubN_begin(2), "the view should share the memory");
+    ASSERT(sv.getNumSubs()==1 && sv.size()==sb.getSubLength(), "bad view shape");
+    ASSERT(sv.getShOrder()==sb.getShOrder(), "bad view shape");
+
+    T val(3);
+    sv.getDevice().Memcpy(sv.begin(), &val, sizeof(T),
+        Container::device_type::MemcpyHostToDevice);
+    T cpy(0);
+    sb.getDevice().Memcpy(&cpy, sb.getSubN_begin(2), sizeof(T),
+        Container::device_type::MemcpyDeviceToHost);
+    ASSERT(cpy==val, "writing to the view should write to the viewed container");
+
+    // a grown view owns its memory
+    sv.resize(2);
+    ASSERT(!sv.isView() && sv.begin()!=sb.getSubN_begin(2), "bad resize of view");
+
+    return true;
+}
@@ -0,0 +1,88 @@
+#include "Logger.h"
+#include "Error.h"
+#include "Device.h"
+#include "Scalars.h"
+#include "Vectors.h"
+#include "SnapshotRing.h"
+
+typedef double real;
+
+typedef Device<CPU> DCPU;
+extern const DCPU the_cpu_dev(0);
+
+typedef Scalars<real, DCPU, the_cpu_dev> Sca_t;
+typedef Vectors<real, DCPU, the_cpu_dev> Vec_t;
+typedef SnapshotRing<Vec_t, Sca_t> Ring_t;
+
+#ifndef Doxygen_skip
+
+// the state of step n is filled with n
+void fill(real n, Vec_t &x, Sca_t &tension, Vec_t &dx)
+{
+    for (size_t ii(0); ii<x.size(); ++ii) x.begin()[ii] = n;
+    for (size_t ii(0); ii<dx.size(); ++ii) dx.begin()[ii] = -n;
+    for (size_t ii(0); ii<tension.size(); ++ii) tension.begin()[ii] = 2 * n;
+}
+
+bool check(real n, const Vec_t &x, const Sca_t &tension, const Vec_t &dx)
+{
+    bool res(x.size() > 0 && tension.size() > 0 && dx.size() == x.size());
+    for (size_t ii(0); ii<x.size(); ++ii) res = res && (x.begin()[ii] == n);
+    for (size_t ii(0); ii<dx.size(); ++ii) res = res && (dx.begin()[ii] == -n);
+    for (size_t ii(0); ii<tension.size(); ++ii) res = res && (tension.begin()[ii] == 2 * n);
+    return res;
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  SnapshotRing Test:"
+        <<"\n ==============================");
+
+    int p(6), nv(2);
+    Vec_t x(nv, p), dx(nv, p);
+    Sca_t tension(nv, p);
+    real t, dt, dt_prev;
+    bool res(true);
+
+    // five steps in a ring of three, the newest are kept
+    Ring_t ring(3);
+    for (int n(1); n<=5; ++n){
+        fill(n, x, tension, dx);
+        ring.Take(n, 0.1 * n, x, tension, dx, 0.01 * n);
+    }
+    res = res && (ring.size() == 3) && (ring.newest_time() == 5);
+
+    // the state is overwritten and restored newest first
+    fill(0, x, tension, dx);
+    for (int n(5); n>=3; --n){
+        Vec_t xr, dxr;
+        Sca_t tr;
+        res = res && ring.Restore(t, dt, xr, tr, dxr, dt_prev);
+        res = res && (t == n) && (dt == 0.1 * n) && (dt_prev == 0.01 * n);
+        res = res && check(n, xr, tr, dxr);
+    }
+    res = res && (ring.size() == 0) && !ring.Restore(t, dt, x, tension, dx, dt_prev);
+
+    // the slots are reused after a restore
+    fill(7, x, tension, dx);
+    ring.Take(7, 0.7, x, tension, dx, 0.07);
+    fill(0, x, tension, dx);
+    res = res && ring.Restore(t, dt, x, tension, dx, dt_prev) && (t == 7) && check(7, x, tension, dx);
+
+    // no snapshot is kept without capacity
+    Ring_t none(0);
+    none.Take(1, 0.1, x, tension, dx, 0.01);
+    res = res && (none.size() == 0) && !none.Restore(t, dt, x, tension, dx, dt_prev);
+
+    if (res) {
+        COUT(emph<<"SnapshotRing test passed"<<emph);
+    } else {
+        COUT(alert<<"SnapshotRing test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
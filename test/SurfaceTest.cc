@@ -84,6 +84,17 @@ void test_geo_props(const ST &S){
     real cntr(MaxAbs(Cntrs));
     ASSERT( fabs(cntr)<1e-8,"Expected center");
 
+    COUT("Computing moments");
+    typename ST::Arr_t Moms;
+    S.moments(Moms, 1);
+    int nm(ST::getNumMoments(1));
+    for (int ii=0; ii<nVec; ++ii){
+        ASSERT( fabs(Moms.begin()[ii*nm  ]/16.2179377312307-1)<5e-8, "Expected area from moments");
+        ASSERT( fabs(Moms.begin()[ii*nm+1]/5.24886489292959-1)<5e-8, "Expected volume from moments");
+        for (int jj=2; jj<nm; ++jj)
+            ASSERT( fabs(Moms.begin()[ii*nm+jj])<1e-8, "Expected center from moments");
+    }
+
     COUT("Computing mean curvature");
     Sca_t H(nVec,p);
     axpy((real) 0, H, S.getMeanCurv(),H);
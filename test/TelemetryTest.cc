@@ -0,0 +1,95 @@
+#include <cstdio>
+#include <fstream>
+
+#include "Logger.h"
+#include "Error.h"
+#include "AsyncWriter.h"
+#include "Telemetry.h"
+
+using namespace std;
+
+#ifndef Doxygen_skip
+
+// some work that is timed as a phase
+double work(int n)
+{
+    Telemetry::Timer timer(Telemetry::SHT);
+    double s(0);
+    for (int ii(0); ii<n; ++ii) s += 1.0 / (ii + 1);
+    return s;
+}
+
+int count(const string &line, const string &key)
+{
+    int n(0);
+    for (size_t pos(line.find(key)); pos != string::npos; pos = line.find(key, pos + 1))
+        ++n;
+    return n;
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  Telemetry Test:"
+        <<"\n ==============================");
+
+    int rank;
+    MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+    string fname("TelemetryTest_out.json");
+
+    // disabled by an empty file name
+    bool res(true);
+    res = res && (Telemetry::Open("") == ErrorEvent::Success);
+    res = res && !Telemetry::Enabled();
+
+    res = res && (Telemetry::Open(fname) == ErrorEvent::Success);
+    res = res && Telemetry::Enabled();
+
+    int nsteps(3);
+    double s(0);
+    for (int step(0); step<nsteps; ++step){
+        Telemetry::BeginStep(0.1 * step);
+        s += work(100000 * (rank + 1));
+        Telemetry::AddIterations(step + 1);
+        Telemetry::AddResidual(1.0 / (step + 1));
+        res = res && (Telemetry::EndStep(step != 1, 0.1, (step != 1) * 0.2, 0.1)
+            == ErrorEvent::Success);
+    }
+    res = res && (Telemetry::Close() == ErrorEvent::Success) && (s > 0);
+    res = res && !Telemetry::Enabled();
+
+    // one record per step, written by the first process
+    if (rank == 0){
+        ifstream in(fname.c_str());
+        string line;
+        int nlines(0);
+        while (getline(in, line)){
+            res = res && (line[0] == '{') && (line[line.size() - 1] == '}');
+            res = res && (line.find(nlines == 1 ? "\"accepted\": false" : "\"accepted\": true")
+                != string::npos);
+            res = res && (line.find(nlines == 1 ? "\"dt\": 0.1, \"advance\": 0,"
+                    : "\"dt\": 0.1, \"advance\": 0.2,") != string::npos);
+            res = res && (count(line, "\"min\"") == Telemetry::NUM_PHASES + 3);
+            res = res && (line.find("\"sht\": {\"min\": 0,") == string::npos);
+            res = res && (line.find("\"fmm\": {\"min\": 0, \"max\": 0, \"avg\": 0}") != string::npos);
+            ++nlines;
+        }
+        res = res && (nlines == nsteps);
+        remove(fname.c_str());
+    }
+
+    int loc(!res), glb(0);
+    MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MAX, VES3D_COMM_WORLD);
+    res = !glb;
+
+    if (res) {
+        COUT(emph<<"Telemetry test passed"<<emph);
+    } else {
+        COUT(alert<<"Telemetry test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file
+ * @author Rahimian, Abtin <arahimian@acm.org>
+ * @revision $Revision$
+ * @tags $Tags$
+ * @date $Date$
+ *
+ * @brief The error of the adaptive time stepping with step doubling
+ * and with the embedded estimate, and the order of the second order
+ * multistep scheme
+ */
+
+/*
+ * Copyright (c) 2014, Abtin Rahimian
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ves3d_common.h"
+#include "Vectors.h"
+#include "ParallelLinSolver_Petsc.h"
+#include "ves3d_simulation.h"
+
+#define DT CPU
+typedef Device<DT> Dev;
+
+extern const Dev the_device(0);
+
+typedef Simulation<Dev, the_device> Sim_t;
+typedef Sim_t::Param_t Param_t;
+typedef Sim_t::Vec_t Vec_t;
+
+#ifndef Doxygen_skip
+
+// the final position of a run
+void run(const Param_t &par, Vec_t &x)
+{
+    Sim_t sim(par);
+    CHK(sim.Run());
+    x.replicate(sim.time_stepper()->S_->getPosition());
+    axpy(static_cast<real_t>(1.0), sim.time_stepper()->S_->getPosition(), x);
+}
+#endif //Doxygen_skip
+
+int main(int argc, char** argv){
+    VES3D_INITIALIZE(&argc, &argv, NULL, NULL);
+    COUT("\n ==============================\n"
+        <<"  TimeAdaptive Test:"
+        <<"\n ==============================");
+
+    SET_ERR_CALLBACK(&cb_abort);
+
+    int p(12), nves(2);
+    Param_t sim_par;
+    sim_par.n_surfs               = nves;
+    sim_par.sh_order              = p;
+    sim_par.filter_freq           = p;
+    sim_par.upsample_freq         = p;
+    sim_par.rep_filter_freq       = p;
+    sim_par.scheme                = GloballyImplicit;
+    sim_par.time_precond          = DiagonalSpectral;
+    sim_par.bg_flow               = ShearFlow;
+    sim_par.bg_flow_param         = 1;
+    sim_par.time_horizon          = 0.5;
+    sim_par.error_factor          = 1e-2;
+    sim_par.shape_gallery_file    = "precomputed/shape_gallery_{{sh_order}}.txt";
+    sim_par.vesicle_geometry_file = "precomputed/lattice_geometry_rand_spec.txt";
+    sim_par.expand_templates();
+
+    // the reference with a small fixed step
+    Vec_t x_ref, x_dbl, x_emb;
+    Param_t ref_par(sim_par);
+    ref_par.ts            = 1e-3;
+    ref_par.time_adaptive = false;
+    run(ref_par, x_ref);
+
+    // the two error estimates are for the same error per unit time
+    Param_t dbl_par(sim_par), emb_par(sim_par);
+    dbl_par.ts = emb_par.ts = 0.05;
+    dbl_par.time_adaptive = emb_par.time_adaptive = true;
+    dbl_par.time_adap_doubling = true;
+    emb_par.time_adap_doubling = false;
+    run(dbl_par, x_dbl);
+    run(emb_par, x_emb);
+
+    axpy(static_cast<real_t>(-1.0), x_ref, x_dbl, x_dbl);
+    axpy(static_cast<real_t>(-1.0), x_ref, x_emb, x_emb);
+    real_t err_dbl(MaxAbs(x_dbl)), err_emb(MaxAbs(x_emb));
+    COUT("Final error: step doubling "<<err_dbl<<", embedded "<<err_emb);
+
+    bool res(err_emb < 4 * err_dbl && err_dbl < 4 * err_emb);
+    res = res && (err_dbl < sim_par.error_factor) && (err_emb < sim_par.error_factor);
+
+    // halving the step of BDF2 divides the error by about four (two
+    // for a first order scheme)
+    Param_t bdf_par(sim_par);
+    bdf_par.scheme        = GloballyImplicitBDF2;
+    bdf_par.time_adaptive = false;
+    bdf_par.time_horizon  = 0.2;
+    Vec_t x_bref, x_h, x_h2;
+    bdf_par.ts = 0.02 / 16;
+    run(bdf_par, x_bref);
+    bdf_par.ts = 0.02;
+    run(bdf_par, x_h);
+    bdf_par.ts = 0.01;
+    run(bdf_par, x_h2);
+
+    axpy(static_cast<real_t>(-1.0), x_bref, x_h, x_h);
+    axpy(static_cast<real_t>(-1.0), x_bref, x_h2, x_h2);
+    real_t ratio(MaxAbs(x_h) / MaxAbs(x_h2));
+    COUT("BDF2 error ratio of halving the step: "<<ratio);
+    res = res && (ratio > 3);
+
+    if (res) {
+        COUT(emph<<"TimeAdaptive test passed"<<emph);
+    } else {
+        COUT(alert<<"TimeAdaptive test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
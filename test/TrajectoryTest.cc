@@ -0,0 +1,136 @@
+#include <sstream>
+
+#include "Logger.h"
+#include "Error.h"
+#include "Device.h"
+#include "DataIO.h"
+#include "SHTMats.h"
+#include "HelperFuns.h"
+#include "Scalars.h"
+#include "Vectors.h"
+#include "Trajectory.h"
+
+typedef double real;
+
+using namespace std;
+
+typedef Device<CPU> DCPU;
+extern const DCPU the_cpu_dev(0);
+
+typedef Scalars<real, DCPU, the_cpu_dev> Sca_t;
+typedef Sca_t::array_type Arr_t;
+typedef Vectors<real, DCPU, the_cpu_dev> Vec_t;
+typedef SHTMats<real, DCPU> SMats_t;
+typedef SHTrans<Sca_t, SMats_t> Sh_t;
+typedef Trajectory<Vec_t> Traj_t;
+
+#ifndef Doxygen_skip
+
+// the matrices of order p used by the forward and backward transforms
+SMats_t read_mats(int p, Arr_t &data)
+{
+    data.resize(SMats_t::getDataLength(p));
+    SMats_t mats(the_cpu_dev, p, data.begin(), true);
+
+    DataIO IO;
+    char fname[200];
+    sprintf(fname, "precomputed/legTrans%d_double.txt", p);
+    IO.ReadData(FullPath(fname), data, DataIO::ASCII, mats.dlt_ - data.begin(),
+        mats.getDLTLength());
+    sprintf(fname, "precomputed/legTransInv%d_double.txt", p);
+    IO.ReadData(FullPath(fname), data, DataIO::ASCII, mats.dlt_inv_ - data.begin(),
+        mats.getDLTLength());
+    return mats;
+}
+
+// the error relative to the largest value of x
+real rel_err(const Vec_t &x, const Vec_t &y)
+{
+    Vec_t d;
+    d.replicate(x);
+    axpy(static_cast<real>(-1), x, y, d);
+    return MaxAbs(d) / MaxAbs(x);
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  Trajectory Test:"
+        <<"\n ==============================");
+
+    int p(6), q(12), freq(4), nv(3);
+    Arr_t data_p, data_q;
+    SMats_t mats_p(read_mats(p, data_p)), mats_q(read_mats(q, data_q));
+    Sh_t sht_p(p, mats_p), sht_q(q, mats_q);
+
+    // random shapes with frequencies up to freq
+    Vec_t x(nv, p), shc(nv, p), wrk(nv, p), shcf(nv, freq);
+    fillRand(x);
+    sht_p.forward(x, wrk, shc);
+    ResampleCoeffs(shc, shcf);
+    ResampleShc(shcf, sht_p, shc, wrk, x);
+
+    // the reference at the higher order
+    Vec_t xq(nv, q), shcq(nv, q), wrkq(nv, q);
+    ResampleShc(shcf, sht_q, shcq, wrkq, xq);
+
+    bool res(true);
+    size_t bytes[2];
+    for (int quantize(0); quantize<2; ++quantize){
+        real tol(quantize ? 1e-4 : 1e-6);
+
+        // two frames, the second with half the vesicles
+        stringstream ss;
+        Traj_t tw(p, freq, quantize);
+        Vec_t xh(nv / 2 + 1, p);
+        std::copy(x.begin(), x.begin() + xh.size(), xh.begin());
+        CHK(tw.pack(ss, Streamable::BIN));
+        res = res && (tw.WriteFrame(ss, sht_p, 0.5, 10, x) == ErrorEvent::Success);
+        res = res && (tw.WriteFrame(ss, sht_p, 1.0, 20, xh) == ErrorEvent::Success);
+        bytes[quantize] = ss.str().size();
+
+        Traj_t tr;
+        real t(0);
+        vector<size_t> ids;
+        Vec_t xr;
+        res = res && (tr.unpack(ss, Streamable::BIN) == ErrorEvent::Success);
+        res = res && (tr.sh_order() == p) && (tr.freq() == freq) && (tr.quantize() == quantize);
+
+        // reconstructed at the order of the simulation
+        res = res && (tr.ReadFrame(ss, sht_p, t, ids, xr) == ErrorEvent::Success);
+        res = res && (t == 0.5) && (ids.size() == nv) && (ids[0] == 10) && (ids[2] == 12);
+        res = res && (xr.getShOrder() == p) && (rel_err(x, xr) < tol);
+        COUT("  quantize = "<<quantize<<", error = "<<rel_err(x, xr));
+
+        // and at a higher order
+        res = res && (tr.ReadFrame(ss, sht_q, t, ids, xr) == ErrorEvent::Success);
+        res = res && (t == 1.0) && (ids.size() == xh.getNumSubs()) && (ids[0] == 20);
+        res = res && (xr.getShOrder() == q);
+        Vec_t xqh(xh.getNumSubs(), q);
+        std::copy(xq.begin(), xq.begin() + xqh.size(), xqh.begin());
+        res = res && (rel_err(xqh, xr) < tol);
+
+        res = res && Traj_t::AtEnd(ss);
+
+        // a truncated frame is an error
+        stringstream sc(ss.str().substr(0, ss.str().size() - 10));
+        tr.unpack(sc, Streamable::BIN);
+        tr.ReadFrame(sc, sht_p, t, ids, xr);
+        res = res && (tr.ReadFrame(sc, sht_p, t, ids, xr) != ErrorEvent::Success);
+    }
+
+    // the frame is smaller than the positions
+    COUT("  stream size = "<<bytes[0]<<" (float), "<<bytes[1]<<" (quantized)");
+    res = res && (bytes[1] < bytes[0]) && (bytes[0] < x.size() * sizeof(real));
+
+    if (res) {
+        COUT(emph<<"Trajectory test passed"<<emph);
+    } else {
+        COUT(alert<<"Trajectory test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
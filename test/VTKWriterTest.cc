@@ -0,0 +1,178 @@
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#include "Logger.h"
+#include "Error.h"
+#include "AsyncWriter.h"
+#include "VTKWriter.h"
+
+using namespace std;
+
+#ifndef Doxygen_skip
+
+// the points of rank r are one polygon of r+3 points, with sparse
+// the odd ranks have no points
+size_t num_points(int r, bool sparse = false){ return (sparse && r % 2) ? 0 : r + 3; }
+size_t num_cells(int r, bool sparse = false){ return num_points(r, sparse) ? 1 : 0; }
+double coord(int r, size_t ii){ return 100 * r + ii; }
+
+void fill(int rank, VTKPiece &piece, bool sparse = false)
+{
+    size_t n(num_points(rank, sparse));
+    if (!n) return;
+    for (size_t ii(0); ii<3 * n; ++ii){
+        piece.coord.push_back(coord(rank, ii));
+        piece.value.push_back(-coord(rank, ii));
+    }
+    for (size_t ii(0); ii<n; ++ii)
+        piece.connect.push_back(ii);
+    piece.offset.push_back(n);
+}
+
+// the next block of the appended data
+bool read_block(istream &is, string &data)
+{
+    uint64_t size(0);
+    is.read(reinterpret_cast<char*>(&size), sizeof(size));
+    data.resize(size);
+    if (size) is.read(&data[0], size);
+    return is.good();
+}
+
+bool check_collective(const string &fname, int np, bool single, bool sparse = false)
+{
+    ifstream fh(fname.c_str(), ios::binary);
+    string content((istreambuf_iterator<char>(fh)), istreambuf_iterator<char>());
+
+    size_t n_pts(0), n_cells(0), n_conn(0);
+    for (int r(0); r<np; ++r){
+        n_pts   += num_points(r, sparse);
+        n_cells += num_cells(r, sparse);
+    }
+
+    stringstream ss;
+    ss<<"NumberOfPoints=\""<<n_pts<<"\"";
+    bool res(content.find(ss.str()) != string::npos);
+    res = res && (content.find("NumberOfComponents=\"3\" Name=\"value\"") != string::npos);
+    res = res && (content.find(single ? "Float32" : "Float64") != string::npos);
+
+    size_t start(content.find("<AppendedData encoding=\"raw\">"));
+    start = content.find('_', start);
+    res = res && (start != string::npos);
+    if (!res) return res;
+
+    istringstream is(content.substr(start + 1));
+    string pos, val, conn, offs;
+    res = res && read_block(is, pos) && read_block(is, val);
+    res = res && read_block(is, conn) && read_block(is, offs);
+
+    // the points of the ranks in order
+    size_t sz(single ? sizeof(float) : sizeof(double));
+    res = res && (pos.size() == 3 * n_pts * sz) && (val.size() == pos.size());
+    res = res && (conn.size() == n_pts * sizeof(int64_t));
+    res = res && (offs.size() == n_cells * sizeof(int64_t));
+    if (!res) return res;
+
+    size_t idx(0), icell(0);
+    for (int r(0); r<np; ++r){
+        if (!num_points(r, sparse)) continue;
+        for (size_t ii(0); ii<3 * num_points(r); ++ii, ++idx){
+            double x(single ?
+                reinterpret_cast<const float*>(pos.data())[idx] :
+                reinterpret_cast<const double*>(pos.data())[idx]);
+            res = res && (x == coord(r, ii));
+        }
+
+        // the connectivity is shifted by the points of the lower ranks
+        const int64_t *c(reinterpret_cast<const int64_t*>(conn.data()));
+        for (size_t ii(0); ii<num_points(r); ++ii)
+            res = res && (c[n_conn + ii] == static_cast<int64_t>(n_conn + ii));
+        n_conn += num_points(r);
+        res = res && (reinterpret_cast<const int64_t*>(offs.data())[icell++] ==
+            static_cast<int64_t>(n_conn));
+    }
+
+    res = res && (content.find("</VTKFile>", start) != string::npos);
+    return res;
+}
+
+bool exists(const string &fname)
+{
+    ifstream fh(fname.c_str());
+    return fh.good();
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  VTKWriter Test:"
+        <<"\n ==============================");
+
+    int rank, np;
+    MPI_Comm_rank(VES3D_COMM_WORLD, &rank);
+    MPI_Comm_size(VES3D_COMM_WORLD, &np);
+
+    VTKPiece piece;
+    fill(rank, piece);
+    string fname("VTKWriterTest_out");
+
+    bool res(true);
+    for (int single(0); single<2; ++single){
+        // one file for all processes
+        res = res && (VTKWriter::Write(fname, piece, VTKWriter::PolyData, true,
+                single, VES3D_COMM_WORLD) == ErrorEvent::Success);
+        if (rank == 0)
+            res = res && check_collective(fname + ".vtp", np, single);
+        MPI_Barrier(VES3D_COMM_WORLD);
+        if (rank == 0) remove((fname + ".vtp").c_str());
+    }
+
+    // the processes without points write the same arrays
+    VTKPiece sparse;
+    fill(rank, sparse, true);
+    res = res && (VTKWriter::Write(fname, sparse, VTKWriter::PolyData, true,
+            false, VES3D_COMM_WORLD) == ErrorEvent::Success);
+    if (rank == 0)
+        res = res && check_collective(fname + ".vtp", np, false, true);
+    MPI_Barrier(VES3D_COMM_WORLD);
+    if (rank == 0) remove((fname + ".vtp").c_str());
+
+    // values of a different number of components are rejected on all
+    // processes
+    VTKPiece bad(piece);
+    if (rank == np - 1) bad.value.resize(piece.coord.size() / 3);
+    res = res && (VTKWriter::Write(fname, bad, VTKWriter::PolyData, true,
+            false, VES3D_COMM_WORLD) != ErrorEvent::Success || np == 1);
+
+    // one file per process, with the default and an empty separator
+    const char *sep[2] = {"_", ""};
+    for (int is(0); is<2; ++is){
+        res = res && (VTKWriter::Write(fname, sparse, VTKWriter::PolyData, false,
+                false, VES3D_COMM_WORLD, sep[is]) == ErrorEvent::Success);
+        AsyncWriter::Flush();
+        MPI_Barrier(VES3D_COMM_WORLD);
+        char vtpname[200];
+        sprintf(vtpname, "%s%s%06d.vtp", fname.c_str(), sep[is], rank);
+        res = res && exists(vtpname);
+        if (rank == 0) res = res && exists(fname + ".pvtp");
+        MPI_Barrier(VES3D_COMM_WORLD);
+        remove(vtpname);
+        if (rank == 0) remove((fname + ".pvtp").c_str());
+    }
+
+    int loc(!res), glb(0);
+    MPI_Allreduce(&loc, &glb, 1, MPI_INT, MPI_MAX, VES3D_COMM_WORLD);
+    res = !glb;
+
+    if (res) {
+        COUT(emph<<"VTKWriter test passed"<<emph);
+    } else {
+        COUT(alert<<"VTKWriter test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}
@@ -34,8 +34,11 @@
 
 #include "Logger.h"
 #include "Enums.h"
+#include "Expressions.h"
 #include <string>
 #include <sstream>
+#include <vector>
+#include <cmath>
 
 template<typename V>
 class VectorsTest
@@ -54,6 +57,7 @@ class VectorsTest
     bool TestReplicate();
     bool TestPointOrder();
     bool TestStream();
+    bool TestExpressions();
 };
 
 template<typename V>
@@ -72,6 +76,7 @@ bool VectorsTest<V>::PerformAll()
         && TestReplicate()
         && TestPointOrder()
 	&& TestStream()
+        && TestExpressions()
         ;
 
     if (test_result){
@@ -440,7 +445,84 @@ bool VectorsTest<V>::TestStream()
     ASSERT(vc.getShOrder()==p, "bad streaming p");
     ASSERT(vc.getNumSubs()==ns, "bad streaming NumSubs");
     ASSERT(vc.getNumSubFuncs()==ns*v.getTheDim(), "bad streaming NumSubs");
+
+    // binary, through the stream and the buffer interface
+    std::stringstream b1,b2;
+    v.setPointOrder(PointMajor);
+    v.pack(b1, V::Streamable::BIN);
+    V vb(b1, V::Streamable::BIN);
+    vb.pack(b2, V::Streamable::BIN);
+    ASSERT(b1.str()==b2.str(),"bad binary streaming");
+    ASSERT(vb.getShOrder()==p, "bad binary streaming p");
+    ASSERT(vb.getNumSubs()==ns, "bad binary streaming NumSubs");
+    ASSERT(vb.getPointOrder()==PointMajor, "bad binary streaming point order");
+    ASSERT(vb.name()=="VVV", "bad binary streaming name");
+
+    void *buffer(NULL);
+    size_t len(0);
+    ASSERT(v.pack_bin(&buffer, len, 0)==ErrorEvent::Success, "bad pack_bin");
+    ASSERT(len==b1.str().size(), "bad pack_bin length");
+    V vv;
+    ASSERT(vv.unpack_bin(buffer, len, 0)==ErrorEvent::Success, "bad unpack_bin");
+    ASSERT(vv.size()==v.size() && vv.getStride()==v.getStride(), "bad unpack_bin");
+    free(buffer);
+
     return true;
 }
 
+template<typename V>
+bool VectorsTest<V>::TestExpressions()
+{
+    COUT(". TestExpressions");
+    typedef typename V::value_type T;
+    int ns(3), p(6);
+    V u(ns,p), v(ns,p), w(ns,p);
+    S x(ns,p), y(ns,p);
+    A a(ns);
+
+    std::vector<T> hu(u.size()), hv(v.size()), hx(x.size()), ha(ns);
+    for (size_t ii=0; ii<hu.size(); ++ii){
+        hu[ii] = ii % 7 + 1;
+        hv[ii] = 0.5 * (ii % 5);
+    }
+    for (size_t ii=0; ii<hx.size(); ++ii) hx[ii] = ii % 3 + 1;
+    for (int ii=0; ii<ns; ++ii) ha[ii] = ii + 2;
+
+    u.getDevice().Memcpy(u.begin(), &hu[0], u.mem_size(), V::device_type::MemcpyHostToDevice);
+    v.getDevice().Memcpy(v.begin(), &hv[0], v.mem_size(), V::device_type::MemcpyHostToDevice);
+    x.getDevice().Memcpy(x.begin(), &hx[0], x.mem_size(), V::device_type::MemcpyHostToDevice);
+    a.getDevice().Memcpy(a.begin(), &ha[0], a.mem_size(), V::device_type::MemcpyHostToDevice);
+
+    // vector expression with scalar, per-sub, and constant terms
+    Evaluate(expr(a) * (static_cast<T>(2) * expr(x) * expr(u) + expr(v)) -
+        expr(u) / expr(x), w);
+
+    // scalar expression, in place
+    Evaluate(expr(x) * expr(x) - static_cast<T>(1) / expr(x), x);
+
+    std::vector<T> hw(w.size()), hy(x.size());
+    w.getDevice().Memcpy(&hw[0], w.begin(), w.mem_size(), V::device_type::MemcpyDeviceToHost);
+    x.getDevice().Memcpy(&hy[0], x.begin(), x.mem_size(), V::device_type::MemcpyDeviceToHost);
+
+    bool res = true;
+    size_t stride(u.getStride());
+    for (int ss=0; ss<ns; ++ss)
+        for (int dd=0; dd<u.getTheDim(); ++dd)
+            for (size_t ii=0; ii<stride; ++ii){
+                size_t iv((ss * u.getTheDim() + dd) * stride + ii);
+                size_t is(ss * stride + ii);
+                T ref(ha[ss] * (2 * hx[is] * hu[iv] + hv[iv]) - hu[iv] / hx[is]);
+                res &= std::abs(hw[iv] - ref) <= 1e-6 * std::abs(ref);
+            }
+    ASSERT(res, "bad vector expression");
+
+    for (size_t ii=0; ii<hy.size(); ++ii){
+        T ref(hx[ii] * hx[ii] - 1 / hx[ii]);
+        res &= std::abs(hy[ii] - ref) <= 1e-6 * std::abs(ref);
+    }
+    ASSERT(res, "bad scalar expression");
+
+    return res;
+}
+
 #endif
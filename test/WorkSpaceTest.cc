@@ -0,0 +1,197 @@
+#include <sstream>
+
+#include "Logger.h"
+#include "Error.h"
+#include "Device.h"
+
+#include "Scalars.h"
+#include "Vectors.h"
+#include "WorkSpace.h"
+#include "DataIO.h"
+#include "HelperFuns.h"
+#include "OperatorsMats.h"
+#include "Parameters.h"
+#include "Surface.h"
+#include "CachingAllocator.h"
+
+typedef double real;
+
+using namespace std;
+
+typedef Device<CPU> DCPU;
+extern const DCPU the_cpu_dev(0);
+
+#ifndef Doxygen_skip
+
+// mimics the use of the work containers in a time step: the surface
+// and the interfacial velocity check out containers of order p and
+// the upsampled order p_up, with nested checkouts and out-of-order
+// returns
+template<typename Sca_t, typename Vec_t>
+void time_step(const WorkSpace<Sca_t> &srf_sca, const WorkSpace<Vec_t> &srf_vec,
+    const WorkSpace<Sca_t> &vel_sca, const WorkSpace<Vec_t> &vel_vec,
+    const Vec_t &x, int p_up)
+{
+    // surface geometry
+    std::auto_ptr<Vec_t> du(srf_vec.checkout(x));
+    std::auto_ptr<Vec_t> dv(srf_vec.checkout(x));
+    std::auto_ptr<Sca_t> ae(srf_sca.checkout(x));
+    srf_sca.recycle(ae);
+    srf_vec.recycle(du);
+
+    // upsampled interaction
+    std::auto_ptr<Vec_t> pos(vel_vec.checkout(x.getNumSubs(), p_up));
+    std::auto_ptr<Vec_t> den(vel_vec.checkout(x.getNumSubs(), p_up));
+    std::auto_ptr<Vec_t> vel(vel_vec.checkout(x));
+    std::auto_ptr<Sca_t> ten(vel_sca.checkout(x));
+    srf_vec.recycle(dv);
+    vel_vec.recycle(den);
+
+    // solver workspace
+    std::auto_ptr<Vec_t> wrk(vel_vec.checkout(x));
+    std::auto_ptr<Sca_t> tns(vel_sca.checkout(x.getNumSubs(), p_up));
+    vel_vec.recycle(pos);
+    vel_vec.recycle(wrk);
+    vel_sca.recycle(tns);
+    vel_sca.recycle(ten);
+    vel_vec.recycle(vel);
+}
+
+// the geometry of a time step of the surface: the position is moved,
+// the forms are updated, the surface is upsampled, and a field is
+// mapped to the tangent space (directly and by upsampling)
+template<typename Sur_t, typename Vec_t>
+void surface_step(Sur_t &S, Sur_t *&S_up, Vec_t &fld, int p_up)
+{
+    typedef typename Vec_t::value_type T;
+    Vec_t &x(S.getPositionModifiable());
+    for (size_t ii(0); ii<x.size(); ++ii)
+        x.begin()[ii] *= T(1.001);
+
+    S.getMeanCurv();
+    S.resample(p_up, &S_up);
+    S_up->getMeanCurv();
+
+    fld.replicate(x);
+    axpy(T(1), x, fld);
+    S.mapToTangentSpace(fld, false);
+    S.mapToTangentSpace(fld, true);
+}
+
+template<typename Container>
+void report(ostringstream &o, const char* type)
+{
+    typedef typename WorkSpace<Container>::StatsMap_t StatsMap_t;
+    const StatsMap_t &ss(WorkSpace<Container>::getSubsystemStats());
+    for (typename StatsMap_t::const_iterator it(ss.begin()); it != ss.end(); ++it)
+        o<<"\n    "<<type<<" "<<it->first<<" : high water = "<<it->second.high_water
+         <<", allocations = "<<it->second.allocs;
+    o<<"\n    "<<type<<" free containers : "<<WorkSpace<Container>::getNumFree()
+     <<" ("<<WorkSpace<Container>::getFreeCapacity()<<" elements)";
+}
+#endif //Doxygen_skip
+
+int main(int argc, char **argv)
+{
+    VES3D_INITIALIZE(&argc,&argv,NULL,NULL);
+    COUT("\n ==============================\n"
+        <<"  WorkSpace Test:"
+        <<"\n ==============================");
+
+    typedef Scalars<real, DCPU, the_cpu_dev> ScaCPU_t;
+    typedef Vectors<real, DCPU, the_cpu_dev> VecCPU_t;
+    typedef WorkSpace<ScaCPU_t> ScaWork_t;
+    typedef WorkSpace<VecCPU_t> VecWork_t;
+
+    int p(12), p_up(24), nves(3), nsteps(10);
+    VecCPU_t x(nves, p);
+
+    bool res(true);
+    ostringstream cpu_o(stringstream::out);
+    {
+        ScaWork_t srf_sca("Surface"), vel_sca("InterfacialVelocity");
+        VecWork_t srf_vec("Surface"), vel_vec("InterfacialVelocity");
+
+        time_step(srf_sca, srf_vec, vel_sca, vel_vec, x, p_up);
+        size_t warm_sca(ScaWork_t::getPoolStats().allocs);
+        size_t warm_vec(VecWork_t::getPoolStats().allocs);
+
+        for (int ii(1); ii<nsteps; ++ii)
+            time_step(srf_sca, srf_vec, vel_sca, vel_vec, x, p_up);
+
+        size_t steady_sca(ScaWork_t::getPoolStats().allocs - warm_sca);
+        size_t steady_vec(VecWork_t::getPoolStats().allocs - warm_vec);
+        cpu_o<<"\n  Allocations in the first step   : "<<warm_sca + warm_vec;
+        cpu_o<<"\n  Allocations in the next "<<nsteps-1<<" steps : "
+             <<steady_sca + steady_vec;
+        report<ScaCPU_t>(cpu_o, "Scalars");
+        report<VecCPU_t>(cpu_o, "Vectors");
+
+        res = res && (steady_sca == 0) && (steady_vec == 0);
+        res = res && (ScaWork_t::getPoolStats().checked_out == 0);
+        res = res && (VecWork_t::getPoolStats().checked_out == 0);
+        res = res && (VecWork_t::getSubsystemStats().find("Surface")->second.high_water == 2);
+        res = res && (VecWork_t::getSubsystemStats().find("InterfacialVelocity")->second.high_water == 3);
+        res = res && (srf_vec.getStats().high_water == 2);
+    }
+
+    // a second handle of a subsystem reuses the warm pool
+    {
+        size_t allocs(VecWork_t::getPoolStats().allocs);
+        VecWork_t srf_vec("Surface");
+        std::auto_ptr<VecCPU_t> v(srf_vec.checkout(nves, p_up));
+        srf_vec.recycle(v);
+        res = res && (VecWork_t::getPoolStats().allocs == allocs);
+    }
+
+    // the steps of a surface do not allocate after the first one
+    {
+        typedef OperatorsMats<ScaCPU_t::array_type> Mats_t;
+        typedef Surface<ScaCPU_t, VecCPU_t> Sur_t;
+        using memory::CachingAllocator;
+
+        Parameters<real> params;
+        params.sh_order = 6;
+        params.upsample_freq = 6;
+        Mats_t mats(true, params);
+
+        int sp(params.sh_order);
+        VecCPU_t xs(nves, sp), fld;
+        DataIO io;
+        vector<real> shapes;
+        io.ReadDataStl(FullPath("precomputed/shape_gallery_6.txt"), shapes, DataIO::ASCII);
+        size_t stride(xs.getStride());
+        for (int iv(0); iv<nves; ++iv)
+            for (size_t ii(0); ii<DIM * stride; ++ii)
+                xs.getSubN_begin(iv)[ii] = shapes[ii] + (ii < stride ? 3 * iv : 0);
+
+        Sur_t S(sp, mats, &xs);
+        Sur_t *S_up(NULL);
+        surface_step(S, S_up, fld, params.upsample_freq);
+        size_t warm(CachingAllocator::GetStats().sys_allocs);
+        size_t normal_cap(S.getNormal().capacity());
+
+        for (int ii(1); ii<nsteps; ++ii)
+            surface_step(S, S_up, fld, params.upsample_freq);
+
+        size_t steady(CachingAllocator::GetStats().sys_allocs - warm);
+        cpu_o<<"\n  Surface steps, system allocations after the first : "<<steady;
+        res = res && (steady == 0);
+        res = res && (S.getNormal().capacity() == normal_cap);
+        delete S_up;
+    }
+
+    ScaWork_t::purge();
+    VecWork_t::purge();
+    res = res && (ScaWork_t::getNumFree() == 0) && (VecWork_t::getNumFree() == 0);
+    COUT(cpu_o.str());
+
+    if (res) {
+        COUT(emph<<"WorkSpace test passed"<<emph);
+    } else {
+        COUT(alert<<"WorkSpace test failed"<<alert);
+    }
+
+    VES3D_FINALIZE();
+    return !res;
+}